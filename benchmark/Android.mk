@@ -21,6 +21,7 @@ include art/build/Android.common_build.mk
 LIBARTBENCHMARK_COMMON_SRC_FILES := \
   jobject-benchmark/jobject_benchmark.cc \
   jni-perf/perf_jni.cc \
+  jni-transitions/jni_transitions.cc \
   scoped-primitive-array/scoped_primitive_array.cc
 
 # $(1): target or host
@@ -0,0 +1,274 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jni.h"
+
+#include "base/logging.h"
+
+namespace art {
+
+namespace {
+
+// Call transitions. The bodies are trivial so that the measured cost is the stub and the thread
+// state change; the arguments are combined to keep them live.
+
+extern "C" JNIEXPORT void JNICALL Java_JniTransitionsBenchmark_staticEmpty(JNIEnv*, jclass) {}
+
+extern "C" JNIEXPORT void JNICALL Java_JniTransitionsBenchmark_instanceEmpty(JNIEnv*, jobject) {}
+
+extern "C" JNIEXPORT jint JNICALL Java_JniTransitionsBenchmark_staticIII(
+    JNIEnv*, jclass, jint a, jint b, jint c) {
+  return a + b + c;
+}
+
+extern "C" JNIEXPORT jint JNICALL Java_JniTransitionsBenchmark_instanceIII(
+    JNIEnv*, jobject, jint a, jint b, jint c) {
+  return a + b + c;
+}
+
+extern "C" JNIEXPORT jlong JNICALL Java_JniTransitionsBenchmark_staticJJJJ(
+    JNIEnv*, jclass, jlong a, jlong b, jlong c, jlong d) {
+  return a + b + c + d;
+}
+
+extern "C" JNIEXPORT jdouble JNICALL Java_JniTransitionsBenchmark_staticFDFD(
+    JNIEnv*, jclass, jfloat a, jdouble b, jfloat c, jdouble d) {
+  return a + b + c + d;
+}
+
+extern "C" JNIEXPORT jint JNICALL Java_JniTransitionsBenchmark_staticManyArgs(
+    JNIEnv*, jclass, jint a, jlong b, jfloat c, jdouble d, jint e, jlong f, jfloat g, jdouble h,
+    jint i, jlong j) {
+  return static_cast<jint>(a + b + c + d + e + f + g + h + i + j);
+}
+
+extern "C" JNIEXPORT jobject JNICALL Java_JniTransitionsBenchmark_staticObjects(
+    JNIEnv*, jclass, jobject a, jobject b, jobject c) {
+  return (a != nullptr) ? a : ((b != nullptr) ? b : c);
+}
+
+extern "C" JNIEXPORT jobject JNICALL Java_JniTransitionsBenchmark_instanceObjects(
+    JNIEnv*, jobject, jobject a, jobject b, jobject c) {
+  return (a != nullptr) ? a : ((b != nullptr) ? b : c);
+}
+
+extern "C" JNIEXPORT void JNICALL Java_JniTransitionsBenchmark_fastStaticEmpty(JNIEnv*, jclass) {}
+
+extern "C" JNIEXPORT jint JNICALL Java_JniTransitionsBenchmark_fastStaticIII(
+    JNIEnv*, jclass, jint a, jint b, jint c) {
+  return a + b + c;
+}
+
+extern "C" JNIEXPORT jobject JNICALL Java_JniTransitionsBenchmark_fastStaticObjects(
+    JNIEnv*, jclass, jobject a, jobject b, jobject c) {
+  return (a != nullptr) ? a : ((b != nullptr) ? b : c);
+}
+
+// @CriticalNative methods receive neither the JNIEnv* nor the jclass.
+extern "C" JNIEXPORT void JNICALL Java_JniTransitionsBenchmark_criticalStaticEmpty() {}
+
+extern "C" JNIEXPORT jint JNICALL Java_JniTransitionsBenchmark_criticalStaticIII(
+    jint a, jint b, jint c) {
+  return a + b + c;
+}
+
+extern "C" JNIEXPORT jdouble JNICALL Java_JniTransitionsBenchmark_criticalStaticFDFD(
+    jfloat a, jdouble b, jfloat c, jdouble d) {
+  return a + b + c + d;
+}
+
+// Primitive array access.
+
+extern "C" JNIEXPORT jlong JNICALL Java_JniTransitionsBenchmark_measureGetIntArrayElements(
+    JNIEnv* env, jclass, jint reps, jintArray arr) {
+  jsize length = env->GetArrayLength(arr);
+  jlong ret = 0;
+  for (jint i = 0; i < reps; ++i) {
+    jint* elements = env->GetIntArrayElements(arr, nullptr);
+    ret += elements[0] + elements[length - 1];
+    env->ReleaseIntArrayElements(arr, elements, JNI_ABORT);
+  }
+  return ret;
+}
+
+extern "C" JNIEXPORT jlong JNICALL Java_JniTransitionsBenchmark_measureGetPrimitiveArrayCritical(
+    JNIEnv* env, jclass, jint reps, jintArray arr) {
+  jsize length = env->GetArrayLength(arr);
+  jlong ret = 0;
+  for (jint i = 0; i < reps; ++i) {
+    jint* elements = reinterpret_cast<jint*>(env->GetPrimitiveArrayCritical(arr, nullptr));
+    ret += elements[0] + elements[length - 1];
+    env->ReleasePrimitiveArrayCritical(arr, elements, JNI_ABORT);
+  }
+  return ret;
+}
+
+extern "C" JNIEXPORT jlong JNICALL Java_JniTransitionsBenchmark_measureGetIntArrayRegion(
+    JNIEnv* env, jclass, jint reps, jintArray arr) {
+  jsize length = env->GetArrayLength(arr);
+  jlong ret = 0;
+  for (jint i = 0; i < reps; ++i) {
+    jint first;
+    jint last;
+    env->GetIntArrayRegion(arr, 0, 1, &first);
+    env->GetIntArrayRegion(arr, length - 1, 1, &last);
+    ret += first + last;
+  }
+  return ret;
+}
+
+// Objects, fields and methods.
+
+extern "C" JNIEXPORT void JNICALL Java_JniTransitionsBenchmark_measureNewObject(
+    JNIEnv* env, jclass, jint reps, jclass payload_class) {
+  jmethodID init = env->GetMethodID(payload_class, "<init>", "()V");
+  CHECK(init != nullptr);
+  for (jint i = 0; i < reps; ++i) {
+    jobject obj = env->NewObject(payload_class, init);
+    env->DeleteLocalRef(obj);
+  }
+}
+
+extern "C" JNIEXPORT jlong JNICALL Java_JniTransitionsBenchmark_measureGetIntField(
+    JNIEnv* env, jclass, jint reps, jobject payload) {
+  jclass payload_class = env->GetObjectClass(payload);
+  jfieldID field = env->GetFieldID(payload_class, "intField", "I");
+  CHECK(field != nullptr);
+  jlong ret = 0;
+  for (jint i = 0; i < reps; ++i) {
+    ret += env->GetIntField(payload, field);
+  }
+  return ret;
+}
+
+extern "C" JNIEXPORT void JNICALL Java_JniTransitionsBenchmark_measureSetIntField(
+    JNIEnv* env, jclass, jint reps, jobject payload) {
+  jclass payload_class = env->GetObjectClass(payload);
+  jfieldID field = env->GetFieldID(payload_class, "intField", "I");
+  CHECK(field != nullptr);
+  for (jint i = 0; i < reps; ++i) {
+    env->SetIntField(payload, field, i);
+  }
+}
+
+extern "C" JNIEXPORT jlong JNICALL Java_JniTransitionsBenchmark_measureGetStaticObjectField(
+    JNIEnv* env, jclass, jint reps, jclass payload_class) {
+  jfieldID field = env->GetStaticFieldID(payload_class, "staticField", "Ljava/lang/Object;");
+  CHECK(field != nullptr);
+  jlong ret = 0;
+  for (jint i = 0; i < reps; ++i) {
+    jobject value = env->GetStaticObjectField(payload_class, field);
+    ret += (value != nullptr) ? 1 : 0;
+    env->DeleteLocalRef(value);
+  }
+  return ret;
+}
+
+extern "C" JNIEXPORT jlong JNICALL Java_JniTransitionsBenchmark_measureCallIntMethod(
+    JNIEnv* env, jclass, jint reps, jobject payload) {
+  jclass payload_class = env->GetObjectClass(payload);
+  jmethodID method = env->GetMethodID(payload_class, "getIntField", "()I");
+  CHECK(method != nullptr);
+  jlong ret = 0;
+  for (jint i = 0; i < reps; ++i) {
+    ret += env->CallIntMethod(payload, method);
+  }
+  return ret;
+}
+
+extern "C" JNIEXPORT jlong JNICALL Java_JniTransitionsBenchmark_measureCallStaticIntMethod(
+    JNIEnv* env, jclass, jint reps, jclass payload_class) {
+  jmethodID method = env->GetStaticMethodID(payload_class, "add", "(II)I");
+  CHECK(method != nullptr);
+  jlong ret = 0;
+  for (jint i = 0; i < reps; ++i) {
+    ret += env->CallStaticIntMethod(payload_class, method, i, 1);
+  }
+  return ret;
+}
+
+// Exceptions.
+
+extern "C" JNIEXPORT jint JNICALL Java_JniTransitionsBenchmark_measureExceptionCheck(
+    JNIEnv* env, jclass, jint reps) {
+  jint ret = 0;
+  for (jint i = 0; i < reps; ++i) {
+    ret += (env->ExceptionCheck() == JNI_TRUE) ? 1 : 0;
+  }
+  return ret;
+}
+
+extern "C" JNIEXPORT jint JNICALL Java_JniTransitionsBenchmark_measureExceptionOccurred(
+    JNIEnv* env, jclass, jint reps) {
+  jint ret = 0;
+  for (jint i = 0; i < reps; ++i) {
+    jthrowable exception = env->ExceptionOccurred();
+    ret += (exception != nullptr) ? 1 : 0;
+  }
+  return ret;
+}
+
+extern "C" JNIEXPORT void JNICALL Java_JniTransitionsBenchmark_measureThrowAndClear(
+    JNIEnv* env, jclass, jint reps, jthrowable exception) {
+  for (jint i = 0; i < reps; ++i) {
+    env->Throw(exception);
+    env->ExceptionClear();
+  }
+}
+
+// Local and global references.
+
+extern "C" JNIEXPORT void JNICALL Java_JniTransitionsBenchmark_measureNewDeleteLocalRef(
+    JNIEnv* env, jclass, jint reps, jobject obj) {
+  for (jint i = 0; i < reps; ++i) {
+    jobject ref = env->NewLocalRef(obj);
+    env->DeleteLocalRef(ref);
+  }
+}
+
+// Creates a burst of local references per iteration and drops them with the frame, which
+// exercises IRT growth and segment reset rather than single add/remove pairs.
+extern "C" JNIEXPORT void JNICALL Java_JniTransitionsBenchmark_measurePushPopLocalFrame(
+    JNIEnv* env, jclass, jint reps, jobject obj) {
+  static constexpr jint kRefsPerFrame = 64;
+  for (jint i = 0; i < reps; ++i) {
+    CHECK_EQ(env->PushLocalFrame(kRefsPerFrame), JNI_OK);
+    for (jint j = 0; j < kRefsPerFrame; ++j) {
+      env->NewLocalRef(obj);
+    }
+    env->PopLocalFrame(nullptr);
+  }
+}
+
+extern "C" JNIEXPORT void JNICALL Java_JniTransitionsBenchmark_measureNewDeleteGlobalRef(
+    JNIEnv* env, jclass, jint reps, jobject obj) {
+  for (jint i = 0; i < reps; ++i) {
+    jobject ref = env->NewGlobalRef(obj);
+    env->DeleteGlobalRef(ref);
+  }
+}
+
+extern "C" JNIEXPORT void JNICALL Java_JniTransitionsBenchmark_measureNewDeleteWeakGlobalRef(
+    JNIEnv* env, jclass, jint reps, jobject obj) {
+  for (jint i = 0; i < reps; ++i) {
+    jweak ref = env->NewWeakGlobalRef(obj);
+    env->DeleteWeakGlobalRef(ref);
+  }
+}
+
+}  // namespace
+
+}  // namespace art
@@ -0,0 +1,275 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import com.google.caliper.SimpleBenchmark;
+
+import dalvik.annotation.optimization.CriticalNative;
+import dalvik.annotation.optimization.FastNative;
+
+import java.lang.reflect.Method;
+
+public class JniTransitionsBenchmark extends SimpleBenchmark {
+  static class Payload {
+    static Object staticField = new Object();
+    int intField = 1;
+
+    int getIntField() {
+      return intField;
+    }
+
+    static int add(int a, int b) {
+      return a + b;
+    }
+  }
+
+  // Call transitions.
+  static native void staticEmpty();
+  native void instanceEmpty();
+  static native int staticIII(int a, int b, int c);
+  native int instanceIII(int a, int b, int c);
+  static native long staticJJJJ(long a, long b, long c, long d);
+  static native double staticFDFD(float a, double b, float c, double d);
+  static native int staticManyArgs(int a, long b, float c, double d, int e, long f, float g,
+                                   double h, int i, long j);
+  static native Object staticObjects(Object a, Object b, Object c);
+  native Object instanceObjects(Object a, Object b, Object c);
+
+  @FastNative static native void fastStaticEmpty();
+  @FastNative static native int fastStaticIII(int a, int b, int c);
+  @FastNative static native Object fastStaticObjects(Object a, Object b, Object c);
+
+  @CriticalNative static native void criticalStaticEmpty();
+  @CriticalNative static native int criticalStaticIII(int a, int b, int c);
+  @CriticalNative static native double criticalStaticFDFD(float a, double b, float c, double d);
+
+  // Loops below run in native code so that only the JNI function itself is measured.
+  static native long measureGetIntArrayElements(int reps, int[] arr);
+  static native long measureGetPrimitiveArrayCritical(int reps, int[] arr);
+  static native long measureGetIntArrayRegion(int reps, int[] arr);
+  static native void measureNewObject(int reps, Class<?> payloadClass);
+  static native long measureGetIntField(int reps, Object payload);
+  static native void measureSetIntField(int reps, Object payload);
+  static native long measureGetStaticObjectField(int reps, Class<?> payloadClass);
+  static native long measureCallIntMethod(int reps, Object payload);
+  static native long measureCallStaticIntMethod(int reps, Class<?> payloadClass);
+  static native int measureExceptionCheck(int reps);
+  static native int measureExceptionOccurred(int reps);
+  static native void measureThrowAndClear(int reps, Throwable exception);
+  static native void measureNewDeleteLocalRef(int reps, Object obj);
+  static native void measurePushPopLocalFrame(int reps, Object obj);
+  static native void measureNewDeleteGlobalRef(int reps, Object obj);
+  static native void measureNewDeleteWeakGlobalRef(int reps, Object obj);
+
+  static final int smallLength = 16;
+  static final int largeLength = 8096;
+  static int[] smallInts = new int[smallLength];
+  static int[] largeInts = new int[largeLength];
+
+  final Payload payload = new Payload();
+  final Object obj = new Object();
+  final RuntimeException exception = new RuntimeException();
+
+  public void timeStaticEmpty(int reps) {
+    for (int i = 0; i < reps; i++) {
+      staticEmpty();
+    }
+  }
+
+  public void timeInstanceEmpty(int reps) {
+    for (int i = 0; i < reps; i++) {
+      instanceEmpty();
+    }
+  }
+
+  public void timeStaticIII(int reps) {
+    for (int i = 0; i < reps; i++) {
+      staticIII(i, 1, 2);
+    }
+  }
+
+  public void timeInstanceIII(int reps) {
+    for (int i = 0; i < reps; i++) {
+      instanceIII(i, 1, 2);
+    }
+  }
+
+  public void timeStaticJJJJ(int reps) {
+    for (int i = 0; i < reps; i++) {
+      staticJJJJ(i, 1L, 2L, 3L);
+    }
+  }
+
+  public void timeStaticFDFD(int reps) {
+    for (int i = 0; i < reps; i++) {
+      staticFDFD(i, 1.0, 2.0f, 3.0);
+    }
+  }
+
+  public void timeStaticManyArgs(int reps) {
+    for (int i = 0; i < reps; i++) {
+      staticManyArgs(i, 1L, 2.0f, 3.0, 4, 5L, 6.0f, 7.0, 8, 9L);
+    }
+  }
+
+  public void timeStaticObjects(int reps) {
+    for (int i = 0; i < reps; i++) {
+      staticObjects(null, obj, payload);
+    }
+  }
+
+  public void timeInstanceObjects(int reps) {
+    for (int i = 0; i < reps; i++) {
+      instanceObjects(null, obj, payload);
+    }
+  }
+
+  public void timeFastStaticEmpty(int reps) {
+    for (int i = 0; i < reps; i++) {
+      fastStaticEmpty();
+    }
+  }
+
+  public void timeFastStaticIII(int reps) {
+    for (int i = 0; i < reps; i++) {
+      fastStaticIII(i, 1, 2);
+    }
+  }
+
+  public void timeFastStaticObjects(int reps) {
+    for (int i = 0; i < reps; i++) {
+      fastStaticObjects(null, obj, payload);
+    }
+  }
+
+  public void timeCriticalStaticEmpty(int reps) {
+    for (int i = 0; i < reps; i++) {
+      criticalStaticEmpty();
+    }
+  }
+
+  public void timeCriticalStaticIII(int reps) {
+    for (int i = 0; i < reps; i++) {
+      criticalStaticIII(i, 1, 2);
+    }
+  }
+
+  public void timeCriticalStaticFDFD(int reps) {
+    for (int i = 0; i < reps; i++) {
+      criticalStaticFDFD(i, 1.0, 2.0f, 3.0);
+    }
+  }
+
+  public void timeSmallGetIntArrayElements(int reps) {
+    measureGetIntArrayElements(reps, smallInts);
+  }
+
+  public void timeLargeGetIntArrayElements(int reps) {
+    measureGetIntArrayElements(reps, largeInts);
+  }
+
+  public void timeSmallGetPrimitiveArrayCritical(int reps) {
+    measureGetPrimitiveArrayCritical(reps, smallInts);
+  }
+
+  public void timeLargeGetPrimitiveArrayCritical(int reps) {
+    measureGetPrimitiveArrayCritical(reps, largeInts);
+  }
+
+  public void timeSmallGetIntArrayRegion(int reps) {
+    measureGetIntArrayRegion(reps, smallInts);
+  }
+
+  public void timeLargeGetIntArrayRegion(int reps) {
+    measureGetIntArrayRegion(reps, largeInts);
+  }
+
+  public void timeNewObject(int reps) {
+    measureNewObject(reps, Payload.class);
+  }
+
+  public void timeGetIntField(int reps) {
+    measureGetIntField(reps, payload);
+  }
+
+  public void timeSetIntField(int reps) {
+    measureSetIntField(reps, payload);
+  }
+
+  public void timeGetStaticObjectField(int reps) {
+    measureGetStaticObjectField(reps, Payload.class);
+  }
+
+  public void timeCallIntMethod(int reps) {
+    measureCallIntMethod(reps, payload);
+  }
+
+  public void timeCallStaticIntMethod(int reps) {
+    measureCallStaticIntMethod(reps, Payload.class);
+  }
+
+  public void timeExceptionCheck(int reps) {
+    measureExceptionCheck(reps);
+  }
+
+  public void timeExceptionOccurred(int reps) {
+    measureExceptionOccurred(reps);
+  }
+
+  public void timeThrowAndClear(int reps) {
+    measureThrowAndClear(reps, exception);
+  }
+
+  public void timeNewDeleteLocalRef(int reps) {
+    measureNewDeleteLocalRef(reps, obj);
+  }
+
+  public void timePushPopLocalFrame(int reps) {
+    measurePushPopLocalFrame(reps, obj);
+  }
+
+  public void timeNewDeleteGlobalRef(int reps) {
+    measureNewDeleteGlobalRef(reps, obj);
+  }
+
+  public void timeNewDeleteWeakGlobalRef(int reps) {
+    measureNewDeleteWeakGlobalRef(reps, obj);
+  }
+
+  // Runs every benchmark without caliper and prints one "name,reps,ns_per_op" line each, e.g.
+  //   dalvikvm -cp JniTransitionsBenchmark.jar JniTransitionsBenchmark [reps]
+  // The output is meant to be diffed between runtime versions to spot JNI overhead regressions.
+  public static void main(String[] args) throws Exception {
+    int reps = (args.length > 0) ? Integer.parseInt(args[0]) : 1000000;
+    JniTransitionsBenchmark benchmark = new JniTransitionsBenchmark();
+    System.out.println("benchmark,reps,ns_per_op");
+    for (Method method : JniTransitionsBenchmark.class.getDeclaredMethods()) {
+      if (!method.getName().startsWith("time")) {
+        continue;
+      }
+      // Warm up so that the JIT and the native method lookup are out of the measurement.
+      method.invoke(benchmark, reps / 10);
+      long start = System.nanoTime();
+      method.invoke(benchmark, reps);
+      long elapsed = System.nanoTime() - start;
+      System.out.println(method.getName().substring(4) + "," + reps + "," +
+                         ((double) elapsed / reps));
+    }
+  }
+
+  static {
+    System.loadLibrary("artbenchmark");
+  }
+}
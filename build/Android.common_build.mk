@@ -328,6 +328,10 @@ ifeq ($(ART_USE_READ_BARRIER),true)
   art_cflags += -fstack-protector
 endif
 
+ifeq ($(ART_USE_HASHED_DEX_CACHE_STRINGS),true)
+  art_cflags += -DART_USE_HASHED_DEX_CACHE_STRINGS=1
+endif
+
 ifeq ($(ART_USE_TLAB),true)
   art_cflags += -DART_USE_TLAB=1
 endif
@@ -500,6 +504,12 @@ ifneq ($(ART_HOST_CLANG),true)
 endif
 
 ART_TARGET_LDFLAGS :=
+ART_TARGET_LDFLAGS_mips :=
+ifeq ($(ART_USE_HASHED_DEX_CACHE_STRINGS),true)
+  # MIPS32 has no lock-free 8-byte atomics, std::atomic<mirror::StringDexCachePair> falls back
+  # to the __atomic_* library calls.
+  ART_TARGET_LDFLAGS_mips += -latomic
+endif
 
 # $(1): ndebug_or_debug
 define set-target-local-cflags-vars
@@ -507,6 +517,7 @@ define set-target-local-cflags-vars
   LOCAL_CFLAGS_x86 += $(ART_TARGET_CFLAGS_x86)
   LOCAL_ASFLAGS += $(ART_TARGET_ASFLAGS)
   LOCAL_LDFLAGS += $(ART_TARGET_LDFLAGS)
+  LOCAL_LDFLAGS_mips += $(ART_TARGET_LDFLAGS_mips)
   art_target_cflags_ndebug_or_debug := $(1)
   ifeq ($$(art_target_cflags_ndebug_or_debug),debug)
     LOCAL_CFLAGS += $(ART_TARGET_DEBUG_CFLAGS)
@@ -618,6 +618,10 @@ static void CompileMethod(Thread* self,
         InstructionSetHasGenericJniStub(driver->GetInstructionSet())) {
       // Leaving this empty will trigger the generic JNI version
     } else {
+      // Dex access flags do not carry @FastNative and @CriticalNative, look them up so that the
+      // stub matches what the class linker sets on the ArtMethod.
+      access_flags |= dex_file.GetNativeMethodAnnotationAccessFlags(
+          dex_file.GetClassDef(class_def_idx), method_idx, access_flags);
       compiled_method = driver->GetCompiler()->JniCompile(access_flags, method_idx, dex_file);
       CHECK(compiled_method != nullptr);
     }
@@ -2921,7 +2925,7 @@ bool CompilerDriver::MayInlineInternal(const DexFile* inlined_from,
 void CompilerDriver::InitializeThreadPools() {
   size_t parallel_count = parallel_thread_count_ > 0 ? parallel_thread_count_ - 1 : 0;
   parallel_thread_pool_.reset(
-      new ThreadPool("Compiler driver thread pool", parallel_count));
+      new WorkStealingThreadPool("Compiler driver thread pool", parallel_count));
   single_thread_pool_.reset(new ThreadPool("Single-threaded Compiler driver thread pool", 0));
 }
 
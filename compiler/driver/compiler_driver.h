@@ -157,6 +157,11 @@ class CompilerDriver {
     return *compiler_options_;
   }
 
+  // Returns null if the compilation is not profile guided.
+  const ProfileCompilationInfo* GetProfileCompilationInfo() const {
+    return profile_compilation_info_;
+  }
+
   Compiler* GetCompiler() const {
     return compiler_.get();
   }
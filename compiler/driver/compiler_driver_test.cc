@@ -107,10 +107,11 @@ TEST_F(CompilerDriverTest, DISABLED_LARGE_CompileDexLibCore) {
   ASSERT_TRUE(java_lang_dex_file_ != nullptr);
   const DexFile& dex = *java_lang_dex_file_;
   mirror::DexCache* dex_cache = class_linker_->FindDexCache(soa.Self(), dex);
-  EXPECT_EQ(dex.NumStringIds(), dex_cache->NumStrings());
+  EXPECT_EQ(mirror::DexCache::StringsArraySize(dex.NumStringIds()), dex_cache->NumStrings());
   for (size_t i = 0; i < dex_cache->NumStrings(); i++) {
-    const mirror::String* string = dex_cache->GetResolvedString(i);
-    EXPECT_TRUE(string != nullptr) << "string_idx=" << i;
+    // Each slot of the strings array holds one of the strings mapping to it.
+    const mirror::String* string = mirror::StringDexCachePair::ReadSlot(dex_cache->GetStrings(), i);
+    EXPECT_TRUE(string != nullptr) << "slot=" << i;
   }
   EXPECT_EQ(dex.NumTypeIds(), dex_cache->NumResolvedTypes());
   for (size_t i = 0; i < dex_cache->NumResolvedTypes(); i++) {
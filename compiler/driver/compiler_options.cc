@@ -176,6 +176,10 @@ bool CompilerOptions::ParseCompilerOption(const StringPiece& option, UsageFn Usa
     generate_mini_debug_info_ = false;
   } else if (option == "--debuggable") {
     debuggable_ = true;
+  } else if (option == "--implicit-suspend-checks") {
+    implicit_suspend_checks_ = true;
+  } else if (option == "--no-implicit-suspend-checks") {
+    implicit_suspend_checks_ = false;
   } else if (option.starts_with("--top-k-profile-threshold=")) {
     ParseDouble(option.data(), '=', 0.0, 100.0, &top_k_profile_threshold_, Usage);
   } else if (option == "--include-patch-information") {
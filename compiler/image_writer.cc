@@ -397,6 +397,13 @@ void ImageWriter::SetImageBinSlot(mirror::Object* object, BinSlot bin_slot) {
       LOG(FATAL) << "Thin locked object " << object << " found during object copy";
       break;
     }
+    case LockWord::kBiased: {
+      // A biased lock which isn't held is equivalent to an unlocked lock word.
+      if (lw.BiasedLockCount() != 0) {
+        LOG(FATAL) << "Biased locked object " << object << " found during object copy";
+      }
+      break;
+    }
     case LockWord::kUnlocked:
       // No hash, don't need to save it.
       break;
@@ -1406,6 +1413,8 @@ void ImageWriter::CalculateNewObjectOffsets() {
       runtime->GetCalleeSaveMethod(Runtime::kRefsOnly);
   image_methods_[ImageHeader::kRefsAndArgsSaveMethod] =
       runtime->GetCalleeSaveMethod(Runtime::kRefsAndArgs);
+  image_methods_[ImageHeader::kSaveEverythingMethod] =
+      runtime->GetCalleeSaveMethod(Runtime::kSaveEverything);
   // Visit image methods first to have the main runtime methods in the first image.
   for (auto* m : image_methods_) {
     CHECK(m != nullptr);
@@ -1504,6 +1513,14 @@ void ImageWriter::CalculateNewObjectOffsets() {
           bin_offset = RoundUp(bin_offset, target_ptr_size_);
           break;
         }
+        case kBinDexCacheArray: {
+          // The pairs of hashed strings arrays are 8-byte aligned, which 32-bit targets do not
+          // otherwise need.
+          if (kUseHashedDexCacheStrings) {
+            bin_offset = RoundUp(bin_offset, alignof(mirror::StringDexCacheType));
+          }
+          break;
+        }
         default: {
           // Normal alignment.
         }
@@ -2110,7 +2127,7 @@ void ImageWriter::FixupDexCache(mirror::DexCache* orig_dex_cache,
   // 64-bit values here, clearing the top 32 bits for 32-bit targets. The zero-extension is
   // done by casting to the unsigned type uintptr_t before casting to int64_t, i.e.
   //     static_cast<int64_t>(reinterpret_cast<uintptr_t>(image_begin_ + offset))).
-  GcRoot<mirror::String>* orig_strings = orig_dex_cache->GetStrings();
+  mirror::StringDexCacheType* orig_strings = orig_dex_cache->GetStrings();
   if (orig_strings != nullptr) {
     copy_dex_cache->SetFieldPtrWithSize<false>(mirror::DexCache::StringsOffset(),
                                                NativeLocationInImage(orig_strings),
@@ -103,7 +103,7 @@ JitCompiler::JitCompiler() {
       CompilerOptions::kDefaultGenerateDebugInfo,
       /* implicit_null_checks */ true,
       /* implicit_so_checks */ true,
-      /* implicit_suspend_checks */ false,
+      Runtime::Current()->ImplicitSuspendChecks(),
       /* pic */ true,  // TODO: Support non-PIC in optimizing.
       /* verbose_methods */ nullptr,
       /* init_failure_output */ nullptr,
@@ -174,6 +174,9 @@ class JniCompilerTest : public CommonCompilerTest {
   void StackArgsFloatsFirstImpl();
   void StackArgsMixedImpl();
   void StackArgsSignExtendedMips64Impl();
+  void FastNativeStaticIntIntMethodImpl();
+  void CriticalNativeStaticIntIntMethodImpl();
+  void CriticalNativeStaticLongDoubleMethodImpl();
 
   JNIEnv* env_;
   jstring library_search_path_;
@@ -1772,4 +1775,75 @@ void JniCompilerTest::StackArgsSignExtendedMips64Impl() {
 
 JNI_TEST(StackArgsSignExtendedMips64)
 
+int gJava_MyClassNatives_fastSII_calls = 0;
+jint Java_MyClassNatives_fastSII(JNIEnv* env, jclass klass, jint x, jint y) {
+  // @FastNative does not transition out of Runnable.
+  EXPECT_EQ(kRunnable, Thread::Current()->GetState());
+  EXPECT_EQ(Thread::Current()->GetJniEnv(), env);
+  EXPECT_TRUE(klass != nullptr);
+  gJava_MyClassNatives_fastSII_calls++;
+  return x + y;
+}
+
+void JniCompilerTest::FastNativeStaticIntIntMethodImpl() {
+  SetUpForTest(true, "fastSII", "(II)I",
+               reinterpret_cast<void*>(&Java_MyClassNatives_fastSII));
+
+  EXPECT_EQ(0, gJava_MyClassNatives_fastSII_calls);
+  jint result = env_->CallStaticIntMethod(jklass_, jmethod_, 20, 30);
+  EXPECT_EQ(50, result);
+  EXPECT_EQ(1, gJava_MyClassNatives_fastSII_calls);
+
+  gJava_MyClassNatives_fastSII_calls = 0;
+}
+
+JNI_TEST(FastNativeStaticIntIntMethod)
+
+// @CriticalNative functions get neither a JNIEnv* nor a jclass.
+int gJava_MyClassNatives_criticalSII_calls = 0;
+jint Java_MyClassNatives_criticalSII(jint x, jint y) {
+  EXPECT_EQ(kRunnable, Thread::Current()->GetState());
+  gJava_MyClassNatives_criticalSII_calls++;
+  return x + y;
+}
+
+void JniCompilerTest::CriticalNativeStaticIntIntMethodImpl() {
+  SetUpForTest(true, "criticalSII", "(II)I",
+               reinterpret_cast<void*>(&Java_MyClassNatives_criticalSII));
+
+  EXPECT_EQ(0, gJava_MyClassNatives_criticalSII_calls);
+  jint result = env_->CallStaticIntMethod(jklass_, jmethod_, 20, 30);
+  EXPECT_EQ(50, result);
+  EXPECT_EQ(1, gJava_MyClassNatives_criticalSII_calls);
+  result = env_->CallStaticIntMethod(jklass_, jmethod_, -1, 0x7fffffff);
+  EXPECT_EQ(0x7ffffffe, result);
+  EXPECT_EQ(2, gJava_MyClassNatives_criticalSII_calls);
+
+  gJava_MyClassNatives_criticalSII_calls = 0;
+}
+
+JNI_TEST(CriticalNativeStaticIntIntMethod)
+
+int gJava_MyClassNatives_criticalSJD_calls = 0;
+jdouble Java_MyClassNatives_criticalSJD(jlong x, jdouble y) {
+  EXPECT_EQ(kRunnable, Thread::Current()->GetState());
+  gJava_MyClassNatives_criticalSJD_calls++;
+  return static_cast<jdouble>(x) + y;
+}
+
+void JniCompilerTest::CriticalNativeStaticLongDoubleMethodImpl() {
+  // Without a JNIEnv* the long starts in the first argument register (pair).
+  SetUpForTest(true, "criticalSJD", "(JD)D",
+               reinterpret_cast<void*>(&Java_MyClassNatives_criticalSJD));
+
+  EXPECT_EQ(0, gJava_MyClassNatives_criticalSJD_calls);
+  jdouble result = env_->CallStaticDoubleMethod(jklass_, jmethod_, INT64_C(1) << 40, 0.5);
+  EXPECT_DOUBLE_EQ(static_cast<jdouble>(INT64_C(1) << 40) + 0.5, result);
+  EXPECT_EQ(1, gJava_MyClassNatives_criticalSJD_calls);
+
+  gJava_MyClassNatives_criticalSJD_calls = 0;
+}
+
+JNI_TEST(CriticalNativeStaticLongDoubleMethod)
+
 }  // namespace art
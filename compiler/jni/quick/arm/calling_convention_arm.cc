@@ -206,13 +206,21 @@ const ManagedRegisterEntrySpills& ArmManagedRuntimeCallingConvention::EntrySpill
 }
 // JNI calling convention
 
-ArmJniCallingConvention::ArmJniCallingConvention(bool is_static, bool is_synchronized,
+ArmJniCallingConvention::ArmJniCallingConvention(bool is_static,
+                                                 bool is_synchronized,
+                                                 bool is_critical_native,
                                                  const char* shorty)
-    : JniCallingConvention(is_static, is_synchronized, shorty, kFramePointerSize) {
+    : JniCallingConvention(is_static,
+                           is_synchronized,
+                           is_critical_native,
+                           shorty,
+                           kFramePointerSize) {
   // Compute padding to ensure longs and doubles are not split in AAPCS. Ignore the 'this' jobject
   // or jclass for static methods and the JNIEnv. We start at the aligned register r2.
   size_t padding = 0;
-  for (size_t cur_arg = IsStatic() ? 0 : 1, cur_reg = 2; cur_arg < NumArgs(); cur_arg++) {
+  // A @CriticalNative method has no JNIEnv* or jclass and starts at the first register.
+  size_t first_reg = IsCriticalNative() ? 0 : 2;
+  for (size_t cur_arg = IsStatic() ? 0 : 1, cur_reg = first_reg; cur_arg < NumArgs(); cur_arg++) {
     if (IsParamALongOrDouble(cur_arg)) {
       if ((cur_reg & 1) != 0) {
         padding += 4;
@@ -274,7 +282,7 @@ size_t ArmJniCallingConvention::OutArgSize() {
 void ArmJniCallingConvention::Next() {
   JniCallingConvention::Next();
   size_t arg_pos = itr_args_ - NumberOfExtraArgumentsForJni();
-  if ((itr_args_ >= 2) &&
+  if (!IsCurrentArgExtraForJni() &&
       (arg_pos < NumArgs()) &&
       IsParamALongOrDouble(arg_pos)) {
     // itr_slots_ needs to be an even number, according to AAPCS.
@@ -298,9 +306,10 @@ static const Register kJniArgumentRegisters[] = {
 ManagedRegister ArmJniCallingConvention::CurrentParamRegister() {
   CHECK_LT(itr_slots_, 4u);
   int arg_pos = itr_args_ - NumberOfExtraArgumentsForJni();
-  if ((itr_args_ >= 2) && IsParamALongOrDouble(arg_pos)) {
-    CHECK_EQ(itr_slots_, 2u);
-    return ArmManagedRegister::FromRegisterPair(R2_R3);
+  if (!IsCurrentArgExtraForJni() && IsParamALongOrDouble(arg_pos)) {
+    // Only a @CriticalNative method can have a long or double in the first register pair.
+    CHECK(itr_slots_ == 2u || (IsCriticalNative() && itr_slots_ == 0u)) << itr_slots_;
+    return ArmManagedRegister::FromRegisterPair(itr_slots_ == 0u ? R0_R1 : R2_R3);
   } else {
     return
       ArmManagedRegister::FromCoreRegister(kJniArgumentRegisters[itr_slots_]);
@@ -315,11 +324,13 @@ FrameOffset ArmJniCallingConvention::CurrentParamStackOffset() {
 }
 
 size_t ArmJniCallingConvention::NumberOfOutgoingStackArgs() {
-  size_t static_args = IsStatic() ? 1 : 0;  // count jclass
+  // count JNIEnv* and jclass, if any
+  size_t jni_args = NumberOfExtraArgumentsForJni();
   // regular argument parameters and this
   size_t param_args = NumArgs() + NumLongOrDoubleArgs();
-  // count JNIEnv* less arguments in registers
-  return static_args + param_args + 1 - 4;
+  // less arguments in registers
+  size_t total_args = jni_args + param_args;
+  return (total_args > 4u) ? total_args - 4u : 0u;
 }
 
 }  // namespace arm
@@ -149,6 +149,7 @@ bool ManagedRuntimeCallingConvention::IsCurrentParamALong() {
 std::unique_ptr<JniCallingConvention> JniCallingConvention::Create(ArenaAllocator* arena,
                                                                    bool is_static,
                                                                    bool is_synchronized,
+                                                                   bool is_critical_native,
                                                                    const char* shorty,
                                                                    InstructionSet instruction_set) {
   switch (instruction_set) {
@@ -156,32 +157,38 @@ std::unique_ptr<JniCallingConvention> JniCallingConvention::Create(ArenaAllocato
     case kArm:
     case kThumb2:
       return std::unique_ptr<JniCallingConvention>(
-          new (arena) arm::ArmJniCallingConvention(is_static, is_synchronized, shorty));
+          new (arena) arm::ArmJniCallingConvention(
+              is_static, is_synchronized, is_critical_native, shorty));
 #endif
 #ifdef ART_ENABLE_CODEGEN_arm64
     case kArm64:
       return std::unique_ptr<JniCallingConvention>(
-          new (arena) arm64::Arm64JniCallingConvention(is_static, is_synchronized, shorty));
+          new (arena) arm64::Arm64JniCallingConvention(
+              is_static, is_synchronized, is_critical_native, shorty));
 #endif
 #ifdef ART_ENABLE_CODEGEN_mips
     case kMips:
       return std::unique_ptr<JniCallingConvention>(
-          new (arena) mips::MipsJniCallingConvention(is_static, is_synchronized, shorty));
+          new (arena) mips::MipsJniCallingConvention(
+              is_static, is_synchronized, is_critical_native, shorty));
 #endif
 #ifdef ART_ENABLE_CODEGEN_mips64
     case kMips64:
       return std::unique_ptr<JniCallingConvention>(
-          new (arena) mips64::Mips64JniCallingConvention(is_static, is_synchronized, shorty));
+          new (arena) mips64::Mips64JniCallingConvention(
+              is_static, is_synchronized, is_critical_native, shorty));
 #endif
 #ifdef ART_ENABLE_CODEGEN_x86
     case kX86:
       return std::unique_ptr<JniCallingConvention>(
-          new (arena) x86::X86JniCallingConvention(is_static, is_synchronized, shorty));
+          new (arena) x86::X86JniCallingConvention(
+              is_static, is_synchronized, is_critical_native, shorty));
 #endif
 #ifdef ART_ENABLE_CODEGEN_x86_64
     case kX86_64:
       return std::unique_ptr<JniCallingConvention>(
-          new (arena) x86_64::X86_64JniCallingConvention(is_static, is_synchronized, shorty));
+          new (arena) x86_64::X86_64JniCallingConvention(
+              is_static, is_synchronized, is_critical_native, shorty));
 #endif
     default:
       LOG(FATAL) << "Unknown InstructionSet: " << instruction_set;
@@ -190,6 +197,10 @@ std::unique_ptr<JniCallingConvention> JniCallingConvention::Create(ArenaAllocato
 }
 
 size_t JniCallingConvention::ReferenceCount() const {
+  if (IsCriticalNative()) {
+    DCHECK_EQ(NumReferenceArgs(), 0u);
+    return 0u;
+  }
   return NumReferenceArgs() + (IsStatic() ? 1 : 0);
 }
 
@@ -204,7 +215,7 @@ FrameOffset JniCallingConvention::ReturnValueSaveLocation() const {
 }
 
 bool JniCallingConvention::HasNext() {
-  if (itr_args_ <= kObjectOrClass) {
+  if (IsCurrentArgExtraForJni()) {
     return true;
   } else {
     unsigned int arg_pos = itr_args_ - NumberOfExtraArgumentsForJni();
@@ -214,7 +225,7 @@ bool JniCallingConvention::HasNext() {
 
 void JniCallingConvention::Next() {
   CHECK(HasNext());
-  if (itr_args_ > kObjectOrClass) {
+  if (!IsCurrentArgExtraForJni()) {
     int arg_pos = itr_args_ - NumberOfExtraArgumentsForJni();
     if (IsParamALongOrDouble(arg_pos)) {
       itr_longs_and_doubles_++;
@@ -232,6 +243,9 @@ void JniCallingConvention::Next() {
 }
 
 bool JniCallingConvention::IsCurrentParamAReference() {
+  if (IsCriticalNative()) {
+    return IsParamAReference(itr_args_);  // No JNIEnv* or jclass.
+  }
   switch (itr_args_) {
     case kJniEnv:
       return false;  // JNIEnv*
@@ -245,10 +259,13 @@ bool JniCallingConvention::IsCurrentParamAReference() {
 }
 
 bool JniCallingConvention::IsCurrentParamJniEnv() {
-  return (itr_args_ == kJniEnv);
+  return IsCurrentArgExtraForJni() && (itr_args_ == kJniEnv);
 }
 
 bool JniCallingConvention::IsCurrentParamAFloatOrDouble() {
+  if (IsCriticalNative()) {
+    return IsParamAFloatOrDouble(itr_args_);  // No JNIEnv* or jclass.
+  }
   switch (itr_args_) {
     case kJniEnv:
       return false;  // JNIEnv*
@@ -262,6 +279,9 @@ bool JniCallingConvention::IsCurrentParamAFloatOrDouble() {
 }
 
 bool JniCallingConvention::IsCurrentParamADouble() {
+  if (IsCriticalNative()) {
+    return IsParamADouble(itr_args_);  // No JNIEnv* or jclass.
+  }
   switch (itr_args_) {
     case kJniEnv:
       return false;  // JNIEnv*
@@ -275,6 +295,9 @@ bool JniCallingConvention::IsCurrentParamADouble() {
 }
 
 bool JniCallingConvention::IsCurrentParamALong() {
+  if (IsCriticalNative()) {
+    return IsParamALong(itr_args_);  // No JNIEnv* or jclass.
+  }
   switch (itr_args_) {
     case kJniEnv:
       return false;  // JNIEnv*
@@ -298,7 +321,7 @@ FrameOffset JniCallingConvention::CurrentParamHandleScopeEntryOffset() {
 }
 
 size_t JniCallingConvention::CurrentParamSize() {
-  if (itr_args_ <= kObjectOrClass) {
+  if (IsCurrentArgExtraForJni()) {
     return frame_pointer_size_;  // JNIEnv or jobject/jclass
   } else {
     int arg_pos = itr_args_ - NumberOfExtraArgumentsForJni();
@@ -307,6 +330,10 @@ size_t JniCallingConvention::CurrentParamSize() {
 }
 
 size_t JniCallingConvention::NumberOfExtraArgumentsForJni() {
+  if (IsCriticalNative()) {
+    // @CriticalNative methods take no JNIEnv* and no jclass.
+    return 0;
+  }
   // The first argument is the JNIEnv*.
   // Static methods have an extra argument which is the jclass.
   return IsStatic() ? 2 : 1;
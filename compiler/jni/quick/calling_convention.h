@@ -279,6 +279,7 @@ class JniCallingConvention : public CallingConvention {
   static std::unique_ptr<JniCallingConvention> Create(ArenaAllocator* arena,
                                                       bool is_static,
                                                       bool is_synchronized,
+                                                      bool is_critical_native,
                                                       const char* shorty,
                                                       InstructionSet instruction_set);
 
@@ -348,6 +349,12 @@ class JniCallingConvention : public CallingConvention {
                        HandleScope::ReferencesOffset(frame_pointer_size_));
   }
 
+  // A @CriticalNative method is called with its managed arguments only, without JNIEnv* or
+  // jclass, and needs no handle scope.
+  bool IsCriticalNative() const {
+    return is_critical_native_;
+  }
+
   virtual ~JniCallingConvention() {}
 
  protected:
@@ -357,9 +364,10 @@ class JniCallingConvention : public CallingConvention {
     kObjectOrClass = 1
   };
 
-  JniCallingConvention(bool is_static, bool is_synchronized, const char* shorty,
-                       size_t frame_pointer_size)
-      : CallingConvention(is_static, is_synchronized, shorty, frame_pointer_size) {}
+  JniCallingConvention(bool is_static, bool is_synchronized, bool is_critical_native,
+                       const char* shorty, size_t frame_pointer_size)
+      : CallingConvention(is_static, is_synchronized, shorty, frame_pointer_size),
+        is_critical_native_(is_critical_native) {}
 
   // Number of stack slots for outgoing arguments, above which the handle scope is
   // located
@@ -367,6 +375,14 @@ class JniCallingConvention : public CallingConvention {
 
  protected:
   size_t NumberOfExtraArgumentsForJni();
+
+  // Whether the current iterator position is the JNIEnv* or the jclass/jobject argument.
+  bool IsCurrentArgExtraForJni() const {
+    return !is_critical_native_ && itr_args_ <= kObjectOrClass;
+  }
+
+ private:
+  const bool is_critical_native_;
 };
 
 }  // namespace art
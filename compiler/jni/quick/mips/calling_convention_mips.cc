@@ -144,13 +144,21 @@ const ManagedRegisterEntrySpills& MipsManagedRuntimeCallingConvention::EntrySpil
 }
 // JNI calling convention
 
-MipsJniCallingConvention::MipsJniCallingConvention(bool is_static, bool is_synchronized,
+MipsJniCallingConvention::MipsJniCallingConvention(bool is_static,
+                                                   bool is_synchronized,
+                                                   bool is_critical_native,
                                                    const char* shorty)
-    : JniCallingConvention(is_static, is_synchronized, shorty, kFramePointerSize) {
+    : JniCallingConvention(is_static,
+                           is_synchronized,
+                           is_critical_native,
+                           shorty,
+                           kFramePointerSize) {
   // Compute padding to ensure longs and doubles are not split in AAPCS. Ignore the 'this' jobject
   // or jclass for static methods and the JNIEnv. We start at the aligned register A2.
   size_t padding = 0;
-  for (size_t cur_arg = IsStatic() ? 0 : 1, cur_reg = 2; cur_arg < NumArgs(); cur_arg++) {
+  // A @CriticalNative method has no JNIEnv* or jclass and starts at the first register.
+  size_t first_reg = IsCriticalNative() ? 0 : 2;
+  for (size_t cur_arg = IsStatic() ? 0 : 1, cur_reg = first_reg; cur_arg < NumArgs(); cur_arg++) {
     if (IsParamALongOrDouble(cur_arg)) {
       if ((cur_reg & 1) != 0) {
         padding += 4;
@@ -162,6 +170,11 @@ MipsJniCallingConvention::MipsJniCallingConvention(bool is_static, bool is_synch
   }
   padding_ = padding;
 
+  // o32 passes the first two arguments in F12 and F14 if they are floating point and no integer
+  // argument precedes them. Only a @CriticalNative method can start with such an argument, as
+  // everything else starts with the JNIEnv*. The core register slots are still reserved.
+  use_fp_arg_registers_ = IsCriticalNative() && NumArgs() > 0u && IsParamAFloatOrDouble(0u);
+
   callee_save_regs_.push_back(MipsManagedRegister::FromCoreRegister(S2));
   callee_save_regs_.push_back(MipsManagedRegister::FromCoreRegister(S3));
   callee_save_regs_.push_back(MipsManagedRegister::FromCoreRegister(S4));
@@ -201,7 +214,7 @@ size_t MipsJniCallingConvention::OutArgSize() {
 void MipsJniCallingConvention::Next() {
   JniCallingConvention::Next();
   size_t arg_pos = itr_args_ - NumberOfExtraArgumentsForJni();
-  if ((itr_args_ >= 2) &&
+  if (!IsCurrentArgExtraForJni() &&
       (arg_pos < NumArgs()) &&
       IsParamALongOrDouble(arg_pos)) {
     // itr_slots_ needs to be an even number, according to AAPCS.
@@ -225,9 +238,13 @@ static const Register kJniArgumentRegisters[] = {
 ManagedRegister MipsJniCallingConvention::CurrentParamRegister() {
   CHECK_LT(itr_slots_, 4u);
   int arg_pos = itr_args_ - NumberOfExtraArgumentsForJni();
-  if ((itr_args_ >= 2) && IsParamALongOrDouble(arg_pos)) {
-    CHECK_EQ(itr_slots_, 2u);
-    return MipsManagedRegister::FromRegisterPair(A2_A3);
+  if (use_fp_arg_registers_ && arg_pos < 2 && IsParamAFloatOrDouble(arg_pos)) {
+    // Loads of an FRegister are sized by the parameter, so F12 and F14 cover doubles too.
+    return MipsManagedRegister::FromFRegister(arg_pos == 0 ? F12 : F14);
+  } else if (!IsCurrentArgExtraForJni() && IsParamALongOrDouble(arg_pos)) {
+    // Only a @CriticalNative method can have a long or double in the first register pair.
+    CHECK(itr_slots_ == 2u || (IsCriticalNative() && itr_slots_ == 0u)) << itr_slots_;
+    return MipsManagedRegister::FromRegisterPair(itr_slots_ == 0u ? A0_A1 : A2_A3);
   } else {
     return
       MipsManagedRegister::FromCoreRegister(kJniArgumentRegisters[itr_slots_]);
@@ -242,11 +259,11 @@ FrameOffset MipsJniCallingConvention::CurrentParamStackOffset() {
 }
 
 size_t MipsJniCallingConvention::NumberOfOutgoingStackArgs() {
-  size_t static_args = IsStatic() ? 1 : 0;  // count jclass
+  // count JNIEnv* and jclass, if any
+  size_t jni_args = NumberOfExtraArgumentsForJni();
   // regular argument parameters and this
   size_t param_args = NumArgs() + NumLongOrDoubleArgs();
-  // count JNIEnv*
-  return static_args + param_args + 1;
+  return jni_args + param_args;
 }
 }  // namespace mips
 }  // namespace art
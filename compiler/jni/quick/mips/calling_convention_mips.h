@@ -48,7 +48,10 @@ class MipsManagedRuntimeCallingConvention FINAL : public ManagedRuntimeCallingCo
 
 class MipsJniCallingConvention FINAL : public JniCallingConvention {
  public:
-  MipsJniCallingConvention(bool is_static, bool is_synchronized, const char* shorty);
+  MipsJniCallingConvention(bool is_static,
+                           bool is_synchronized,
+                           bool is_critical_native,
+                           const char* shorty);
   ~MipsJniCallingConvention() OVERRIDE {}
   // Calling convention
   ManagedRegister ReturnRegister() OVERRIDE;
@@ -86,6 +89,9 @@ class MipsJniCallingConvention FINAL : public JniCallingConvention {
   // Padding to ensure longs and doubles are not split in AAPCS
   size_t padding_;
 
+  // Whether the leading floating point arguments go to F12 and F14 (@CriticalNative only).
+  bool use_fp_arg_registers_;
+
   DISALLOW_COPY_AND_ASSIGN(MipsJniCallingConvention);
 };
 
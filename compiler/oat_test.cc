@@ -30,6 +30,7 @@
 #include "elf_writer.h"
 #include "elf_writer_quick.h"
 #include "entrypoints/quick/quick_entrypoints.h"
+#include "jit/offline_profiling_info.h"
 #include "linker/multi_oat_relative_patcher.h"
 #include "linker/vector_output_stream.h"
 #include "mirror/class-inl.h"
@@ -90,7 +91,8 @@ class OatTest : public CommonCompilerTest {
   void SetupCompiler(Compiler::Kind compiler_kind,
                      InstructionSet insn_set,
                      const std::vector<std::string>& compiler_options,
-                     /*out*/std::string* error_msg) {
+                     /*out*/std::string* error_msg,
+                     ProfileCompilationInfo* profile_compilation_info = nullptr) {
     ASSERT_TRUE(error_msg != nullptr);
     insn_features_.reset(InstructionSetFeatures::FromVariant(insn_set, "default", error_msg));
     ASSERT_TRUE(insn_features_ != nullptr) << error_msg;
@@ -121,7 +123,7 @@ class OatTest : public CommonCompilerTest {
                                               /* dump_passes */ true,
                                               timer_.get(),
                                               /* swap_fd */ -1,
-                                              /* profile_compilation_info */ nullptr));
+                                              profile_compilation_info));
   }
 
   bool WriteElf(File* file,
@@ -140,7 +142,7 @@ class OatTest : public CommonCompilerTest {
         return false;
       }
     }
-    return DoWriteElf(file, oat_writer, key_value_store, verify);
+    return DoWriteElf(file, oat_writer, key_value_store, verify, &dex_files);
   }
 
   bool WriteElf(File* file,
@@ -170,10 +172,13 @@ class OatTest : public CommonCompilerTest {
     return DoWriteElf(file, oat_writer, key_value_store, verify);
   }
 
+  // Lays out the code of `compiled_dex_files` if not null, otherwise of the dex files the
+  // OatWriter opens, which have no compiled code since the driver looks it up by DexFile.
   bool DoWriteElf(File* file,
                   OatWriter& oat_writer,
                   SafeMap<std::string, std::string>& key_value_store,
-                  bool verify) {
+                  bool verify,
+                  const std::vector<const DexFile*>* compiled_dex_files = nullptr) {
     std::unique_ptr<ElfWriter> elf_writer = CreateElfWriterQuick(
         compiler_driver_->GetInstructionSet(),
         compiler_driver_->GetInstructionSetFeatures(),
@@ -196,10 +201,14 @@ class OatTest : public CommonCompilerTest {
     Runtime* runtime = Runtime::Current();
     ClassLinker* const class_linker = runtime->GetClassLinker();
     std::vector<const DexFile*> dex_files;
-    for (const std::unique_ptr<const DexFile>& dex_file : opened_dex_files) {
-      dex_files.push_back(dex_file.get());
-      ScopedObjectAccess soa(Thread::Current());
-      class_linker->RegisterDexFile(*dex_file, nullptr);
+    if (compiled_dex_files != nullptr) {
+      dex_files = *compiled_dex_files;
+    } else {
+      for (const std::unique_ptr<const DexFile>& dex_file : opened_dex_files) {
+        dex_files.push_back(dex_file.get());
+        ScopedObjectAccess soa(Thread::Current());
+        class_linker->RegisterDexFile(*dex_file, nullptr);
+      }
     }
     linker::MultiOatRelativePatcher patcher(compiler_driver_->GetInstructionSet(),
                                             instruction_set_features_.get());
@@ -233,8 +242,41 @@ class OatTest : public CommonCompilerTest {
   void TestDexFileInput(bool verify, bool low_4gb);
   void TestZipFileInput(bool verify);
 
+  // Compiles ProfileTestMultiDex with a profile of the virtual methods of all its classes that
+  // records the last class, or all of them, see IsStartupClass(), as loaded at startup, and writes
+  // it to `file`.
+  void WriteElfWithProfile(File* file,
+                           bool all_startup_classes,
+                           /*out*/ std::vector<const DexFile*>* dex_files);
+
+  bool IsStartupClass(const std::vector<const DexFile*>& dex_files,
+                      size_t dex_file_index,
+                      uint32_t class_def_index) const {
+    return all_startup_classes_ ||
+        (dex_file_index == dex_files.size() - 1u &&
+         class_def_index == dex_files[dex_file_index]->NumClassDefs() - 1u);
+  }
+
+  // Collects the methods with compiled code, split by whether their class is a startup class.
+  void GetCompiledMethods(const OatFile& oat_file,
+                          const std::vector<const DexFile*>& dex_files,
+                          /*out*/ std::vector<OatFile::OatMethod>* startup_methods,
+                          /*out*/ std::vector<OatFile::OatMethod>* other_methods) const;
+
+  // Returns the offset past the code of the method that is laid out last.
+  static uint32_t GetCodeEnd(const std::vector<OatFile::OatMethod>& methods) {
+    uint32_t code_end = 0u;
+    for (const OatFile::OatMethod& method : methods) {
+      code_end = std::max(code_end,
+                          RoundDown(method.GetCodeOffset(), 2u) + method.GetQuickCodeSize());
+    }
+    return code_end;
+  }
+
   std::unique_ptr<const InstructionSetFeatures> insn_features_;
   std::unique_ptr<QuickCompilerCallbacks> callbacks_;
+  ProfileCompilationInfo profile_;
+  bool all_startup_classes_ = false;
 };
 
 class ZipBuilder {
@@ -441,7 +483,7 @@ TEST_F(OatTest, WriteRead) {
 TEST_F(OatTest, OatHeaderSizeCheck) {
   // If this test is failing and you have to update these constants,
   // it is time to update OatHeader::kOatVersion
-  EXPECT_EQ(72U, sizeof(OatHeader));
+  EXPECT_EQ(76U, sizeof(OatHeader));
   EXPECT_EQ(4U, sizeof(OatMethodOffsets));
   EXPECT_EQ(20U, sizeof(OatQuickMethodHeader));
 #ifdef MTK_ART_COMMON
@@ -518,6 +560,200 @@ TEST_F(OatTest, EmptyTextSection) {
   EXPECT_LT(static_cast<size_t>(oat_file->Size()), static_cast<size_t>(tmp.GetFile()->GetLength()));
 }
 
+void OatTest::WriteElfWithProfile(File* file,
+                                  bool all_startup_classes,
+                                  /*out*/ std::vector<const DexFile*>* dex_files) {
+  TimingLogger timings("OatTest::WriteElfWithProfile", false, false);
+  all_startup_classes_ = all_startup_classes;
+
+  InstructionSet insn_set = kRuntimeISA;
+  if (insn_set == kArm) insn_set = kThumb2;
+  std::string error_msg;
+  // Do not deduplicate the code, so that each method has code at its own offset.
+  std::vector<std::string> compiler_options;
+  compiler_options.push_back("--debuggable");
+  SetupCompiler(Compiler::kOptimizing, insn_set, compiler_options, /*out*/ &error_msg, &profile_);
+
+  jobject class_loader;
+  {
+    ScopedObjectAccess soa(Thread::Current());
+    class_loader = LoadDex("ProfileTestMultiDex");
+  }
+  ASSERT_TRUE(class_loader != nullptr);
+  *dex_files = GetDexFiles(class_loader);
+  ASSERT_TRUE(!dex_files->empty());
+
+  std::vector<MethodReference> methods;
+  std::set<DexCacheResolvedClasses> startup_classes;
+  ClassLinker* const class_linker = Runtime::Current()->GetClassLinker();
+  for (size_t i = 0; i != dex_files->size(); ++i) {
+    const DexFile* dex_file = (*dex_files)[i];
+    // Methods that are not compiled go through the dex-to-dex compiler.
+    ASSERT_TRUE(dex_file->EnableWrite());
+    ScopedObjectAccess soa(Thread::Current());
+    class_linker->RegisterDexFile(*dex_file, soa.Decode<mirror::ClassLoader*>(class_loader));
+    DexCacheResolvedClasses resolved_classes(dex_file->GetLocation(),
+                                             DexFile::GetBaseLocation(dex_file->GetLocation()),
+                                             dex_file->GetLocationChecksum());
+    for (uint32_t class_def_index = 0; class_def_index != dex_file->NumClassDefs();
+         ++class_def_index) {
+      if (IsStartupClass(*dex_files, i, class_def_index)) {
+        uint16_t startup_class_def_index = class_def_index;
+        resolved_classes.AddClasses(&startup_class_def_index, &startup_class_def_index + 1);
+      }
+      const uint8_t* class_data = dex_file->GetClassData(dex_file->GetClassDef(class_def_index));
+      if (class_data == nullptr) {
+        continue;
+      }
+      ClassDataItemIterator it(*dex_file, class_data);
+      while (it.HasNextStaticField() || it.HasNextInstanceField() || it.HasNextDirectMethod()) {
+        it.Next();
+      }
+      for (; it.HasNextVirtualMethod(); it.Next()) {
+        methods.push_back(MethodReference(dex_file, it.GetMemberIndex()));
+      }
+    }
+    startup_classes.insert(resolved_classes);
+  }
+  ASSERT_TRUE(profile_.AddMethodsAndClasses(methods, startup_classes));
+
+  compiler_driver_->SetDexFilesForOatFile(*dex_files);
+  compiler_driver_->CompileAll(class_loader, *dex_files, &timings);
+
+  SafeMap<std::string, std::string> key_value_store;
+  key_value_store.Put(OatHeader::kImageLocationKey, "test.art");
+  bool success = WriteElf(file, *dex_files, key_value_store, false);
+  ASSERT_TRUE(success);
+}
+
+void OatTest::GetCompiledMethods(const OatFile& oat_file,
+                                 const std::vector<const DexFile*>& dex_files,
+                                 /*out*/ std::vector<OatFile::OatMethod>* startup_methods,
+                                 /*out*/ std::vector<OatFile::OatMethod>* other_methods) const {
+  for (size_t i = 0; i != dex_files.size(); ++i) {
+    const DexFile& dex_file = *dex_files[i];
+    uint32_t dex_file_checksum = dex_file.GetLocationChecksum();
+    const OatFile::OatDexFile* oat_dex_file =
+        oat_file.GetOatDexFile(dex_file.GetLocation().c_str(), &dex_file_checksum);
+    ASSERT_TRUE(oat_dex_file != nullptr);
+    for (uint32_t class_def_index = 0; class_def_index != dex_file.NumClassDefs();
+         ++class_def_index) {
+      const uint8_t* class_data = dex_file.GetClassData(dex_file.GetClassDef(class_def_index));
+      if (class_data == nullptr) {
+        continue;
+      }
+      ClassDataItemIterator it(dex_file, class_data);
+      size_t num_methods = it.NumDirectMethods() + it.NumVirtualMethods();
+      const OatFile::OatClass oat_class = oat_dex_file->GetOatClass(class_def_index);
+      for (size_t method_index = 0; method_index != num_methods; ++method_index) {
+        const OatFile::OatMethod oat_method = oat_class.GetOatMethod(method_index);
+        if (oat_method.GetCodeOffset() == 0u) {
+          continue;
+        }
+        if (IsStartupClass(dex_files, i, class_def_index)) {
+          startup_methods->push_back(oat_method);
+        } else {
+          other_methods->push_back(oat_method);
+        }
+      }
+    }
+  }
+}
+
+TEST_F(OatTest, StartupClassCodeFirst) {
+  TEST_DISABLED_FOR_READ_BARRIER_WITH_OPTIMIZING_FOR_UNSUPPORTED_INSTRUCTION_SETS();
+  ScratchFile tmp;
+  std::vector<const DexFile*> dex_files;
+  WriteElfWithProfile(tmp.GetFile(), /* all_startup_classes */ false, &dex_files);
+
+  std::string error_msg;
+  std::unique_ptr<OatFile> oat_file(OatFile::Open(tmp.GetFilename(),
+                                                  tmp.GetFilename(),
+                                                  nullptr,
+                                                  nullptr,
+                                                  false,
+                                                  /*low_4gb*/false,
+                                                  nullptr,
+                                                  &error_msg));
+  ASSERT_TRUE(oat_file != nullptr) << error_msg;
+  // Only the profiled methods are compiled, so all the classes have hot code.
+  std::vector<OatFile::OatMethod> startup_methods;
+  std::vector<OatFile::OatMethod> other_methods;
+  GetCompiledMethods(*oat_file, dex_files, &startup_methods, &other_methods);
+  ASSERT_TRUE(!startup_methods.empty());
+  ASSERT_TRUE(!other_methods.empty());
+
+  // The startup class is defined last but its code comes first.
+  for (const OatFile::OatMethod& startup_method : startup_methods) {
+    for (const OatFile::OatMethod& other_method : other_methods) {
+      EXPECT_LT(startup_method.GetCodeOffset(), other_method.GetCodeOffset());
+    }
+  }
+}
+
+TEST_F(OatTest, HotCodeSize) {
+  TEST_DISABLED_FOR_READ_BARRIER_WITH_OPTIMIZING_FOR_UNSUPPORTED_INSTRUCTION_SETS();
+  ScratchFile tmp;
+  std::vector<const DexFile*> dex_files;
+  WriteElfWithProfile(tmp.GetFile(), /* all_startup_classes */ false, &dex_files);
+
+  std::string error_msg;
+  std::unique_ptr<OatFile> oat_file(OatFile::Open(tmp.GetFilename(),
+                                                  tmp.GetFilename(),
+                                                  nullptr,
+                                                  nullptr,
+                                                  false,
+                                                  /*low_4gb*/false,
+                                                  nullptr,
+                                                  &error_msg));
+  ASSERT_TRUE(oat_file != nullptr) << error_msg;
+  std::vector<OatFile::OatMethod> startup_methods;
+  std::vector<OatFile::OatMethod> other_methods;
+  GetCompiledMethods(*oat_file, dex_files, &startup_methods, &other_methods);
+  ASSERT_TRUE(!startup_methods.empty());
+  ASSERT_TRUE(!other_methods.empty());
+
+  const OatHeader& oat_header = oat_file->GetOatHeader();
+  EXPECT_NE(0u, oat_header.GetHotCodeSize());
+  uint32_t hot_code_end = oat_header.GetExecutableOffset() + oat_header.GetHotCodeSize();
+  // The hot prefix ends with the code of the last startup method.
+  EXPECT_EQ(hot_code_end, GetCodeEnd(startup_methods));
+  // The other methods start after it, method headers included.
+  for (const OatFile::OatMethod& other_method : other_methods) {
+    EXPECT_LE(hot_code_end,
+              RoundDown(other_method.GetCodeOffset(), 2u) - sizeof(OatQuickMethodHeader));
+  }
+}
+
+TEST_F(OatTest, HotCodeSizeAllStartupClasses) {
+  TEST_DISABLED_FOR_READ_BARRIER_WITH_OPTIMIZING_FOR_UNSUPPORTED_INSTRUCTION_SETS();
+  ScratchFile tmp;
+  std::vector<const DexFile*> dex_files;
+  WriteElfWithProfile(tmp.GetFile(), /* all_startup_classes */ true, &dex_files);
+
+  std::string error_msg;
+  std::unique_ptr<OatFile> oat_file(OatFile::Open(tmp.GetFilename(),
+                                                  tmp.GetFilename(),
+                                                  nullptr,
+                                                  nullptr,
+                                                  false,
+                                                  /*low_4gb*/false,
+                                                  nullptr,
+                                                  &error_msg));
+  ASSERT_TRUE(oat_file != nullptr) << error_msg;
+  std::vector<OatFile::OatMethod> startup_methods;
+  std::vector<OatFile::OatMethod> other_methods;
+  GetCompiledMethods(*oat_file, dex_files, &startup_methods, &other_methods);
+  ASSERT_TRUE(!startup_methods.empty());
+  ASSERT_TRUE(other_methods.empty());
+
+  // The code is in definition order and all of it is startup code.
+  const OatHeader& oat_header = oat_file->GetOatHeader();
+  EXPECT_NE(0u, oat_header.GetHotCodeSize());
+  EXPECT_EQ(oat_header.GetExecutableOffset() + oat_header.GetHotCodeSize(),
+            GetCodeEnd(startup_methods));
+}
+
 static void MaybeModifyDexFileToFail(bool verify, std::unique_ptr<const DexFile>& data) {
   // If in verify mode (= fail the verifier mode), make sure we fail early. We'll fail already
   // because of the missing map, but that may lead to out of bounds reads.
@@ -38,6 +38,7 @@
 #include "gc/space/space.h"
 #include "handle_scope-inl.h"
 #include "image_writer.h"
+#include "jit/offline_profiling_info.h"
 #include "linker/multi_oat_relative_patcher.h"
 #include "linker/output_stream.h"
 #include "mirror/array.h"
@@ -280,6 +281,7 @@ OatWriter::OatWriter(bool compiling_boot_image, TimingLogger* timings)
     bss_size_(0u),
     oat_data_offset_(0u),
     oat_header_(nullptr),
+    num_hot_classes_(0u),
     size_dex_file_alignment_(0),
     size_executable_offset_alignment_(0),
     size_oat_header_(0),
@@ -497,6 +499,10 @@ void OatWriter::PrepareLayout(const CompilerDriver* compiler,
     TimingLogger::ScopedTiming split("InitOatCode", timings_);
     offset = InitOatCode(offset);
   }
+  {
+    TimingLogger::ScopedTiming split("InitCodeLayout", timings_);
+    InitCodeLayout();
+  }
   {
     TimingLogger::ScopedTiming split("InitOatCodeDexFiles", timings_);
     offset = InitOatCodeDexFiles(offset);
@@ -576,23 +582,27 @@ class OatWriter::OatDexMethodVisitor : public DexMethodVisitor {
   OatDexMethodVisitor(OatWriter* writer, size_t offset)
     : DexMethodVisitor(writer, offset),
       oat_class_index_(0u),
+      num_visited_classes_(0u),
       method_offsets_index_(0u) {
   }
 
   bool StartClass(const DexFile* dex_file, size_t class_def_index) {
     DexMethodVisitor::StartClass(dex_file, class_def_index);
+    // Classes are not necessarily visited in definition order, see VisitDexMethodsInCodeLayout().
+    oat_class_index_ = writer_->GetOatClassIndex(dex_file, class_def_index);
     DCHECK_LT(oat_class_index_, writer_->oat_classes_.size());
     method_offsets_index_ = 0u;
     return true;
   }
 
   bool EndClass() {
-    ++oat_class_index_;
+    ++num_visited_classes_;
     return DexMethodVisitor::EndClass();
   }
 
  protected:
   size_t oat_class_index_;
+  size_t num_visited_classes_;
   size_t method_offsets_index_;
 };
 
@@ -669,7 +679,11 @@ class OatWriter::InitCodeMethodVisitor : public OatDexMethodVisitor {
 
   bool EndClass() {
     OatDexMethodVisitor::EndClass();
-    if (oat_class_index_ == writer_->oat_classes_.size()) {
+    if (num_visited_classes_ == writer_->num_hot_classes_) {
+      // Let the runtime prefetch the code of the profiled classes, see InitCodeLayout().
+      writer_->oat_header_->SetHotCodeSize(offset_ - writer_->oat_header_->GetExecutableOffset());
+    }
+    if (num_visited_classes_ == writer_->oat_classes_.size()) {
       offset_ = writer_->relative_patcher_->ReserveSpaceEnd(offset_);
     }
     return true;
@@ -977,7 +991,7 @@ class OatWriter::WriteCodeMethodVisitor : public OatDexMethodVisitor {
 
   bool EndClass() SHARED_REQUIRES(Locks::mutator_lock_) {
     bool result = OatDexMethodVisitor::EndClass();
-    if (oat_class_index_ == writer_->oat_classes_.size()) {
+    if (num_visited_classes_ == writer_->oat_classes_.size()) {
       DCHECK(result);  // OatDexMethodVisitor::EndClass() never fails.
       offset_ = writer_->relative_patcher_->WriteThunks(out_, offset_);
       if (UNLIKELY(offset_ == 0u)) {
@@ -1168,7 +1182,15 @@ class OatWriter::WriteCodeMethodVisitor : public OatDexMethodVisitor {
   }
 
   mirror::String* GetTargetString(const LinkerPatch& patch) SHARED_REQUIRES(Locks::mutator_lock_) {
-    mirror::String* string = dex_cache_->GetResolvedString(patch.TargetStringIndex());
+    const DexFile& dex_file = *patch.TargetStringDexFile();
+    StackHandleScope<1> hs(Thread::Current());
+    Handle<mirror::DexCache> dex_cache(hs.NewHandle((dex_file_ == &dex_file)
+        ? dex_cache_
+        : class_linker_->FindDexCache(Thread::Current(), dex_file)));
+    // The string may have been evicted from the hashed strings array of the dex cache,
+    // so fall back to the intern table where the resolved string is kept alive.
+    mirror::String* string =
+        class_linker_->LookupString(dex_file, patch.TargetStringIndex(), dex_cache);
     DCHECK(string != nullptr);
     DCHECK(writer_->HasBootImage() ||
            Runtime::Current()->GetHeap()->ObjectIsInBootImageSpace(string));
@@ -1332,41 +1354,65 @@ bool OatWriter::VisitDexMethods(DexMethodVisitor* visitor) {
   for (const DexFile* dex_file : *dex_files_) {
     const size_t class_def_count = dex_file->NumClassDefs();
     for (size_t class_def_index = 0; class_def_index != class_def_count; ++class_def_index) {
-      if (UNLIKELY(!visitor->StartClass(dex_file, class_def_index))) {
+      if (UNLIKELY(!VisitClassMethods(visitor, dex_file, class_def_index))) {
         return false;
       }
-      const DexFile::ClassDef& class_def = dex_file->GetClassDef(class_def_index);
-      const uint8_t* class_data = dex_file->GetClassData(class_def);
-      if (class_data != nullptr) {  // ie not an empty class, such as a marker interface
-        ClassDataItemIterator it(*dex_file, class_data);
-        while (it.HasNextStaticField()) {
-          it.Next();
-        }
-        while (it.HasNextInstanceField()) {
-          it.Next();
-        }
-        size_t class_def_method_index = 0u;
-        while (it.HasNextDirectMethod()) {
-          if (!visitor->VisitMethod(class_def_method_index, it)) {
-            return false;
-          }
-          ++class_def_method_index;
-          it.Next();
-        }
-        while (it.HasNextVirtualMethod()) {
-          if (UNLIKELY(!visitor->VisitMethod(class_def_method_index, it))) {
-            return false;
-          }
-          ++class_def_method_index;
-          it.Next();
-        }
+    }
+  }
+  return true;
+}
+
+bool OatWriter::VisitDexMethodsInCodeLayout(DexMethodVisitor* visitor) {
+  if (code_layout_.empty()) {
+    return VisitDexMethods(visitor);
+  }
+  for (const std::pair<const DexFile*, uint32_t>& class_ref : code_layout_) {
+    if (UNLIKELY(!VisitClassMethods(visitor, class_ref.first, class_ref.second))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool OatWriter::VisitClassMethods(DexMethodVisitor* visitor,
+                                  const DexFile* dex_file,
+                                  size_t class_def_index) {
+  if (UNLIKELY(!visitor->StartClass(dex_file, class_def_index))) {
+    return false;
+  }
+  const DexFile::ClassDef& class_def = dex_file->GetClassDef(class_def_index);
+  const uint8_t* class_data = dex_file->GetClassData(class_def);
+  if (class_data != nullptr) {  // ie not an empty class, such as a marker interface
+    ClassDataItemIterator it(*dex_file, class_data);
+    while (it.HasNextStaticField()) {
+      it.Next();
+    }
+    while (it.HasNextInstanceField()) {
+      it.Next();
+    }
+    size_t class_def_method_index = 0u;
+    while (it.HasNextDirectMethod()) {
+      if (!visitor->VisitMethod(class_def_method_index, it)) {
+        return false;
       }
-      if (UNLIKELY(!visitor->EndClass())) {
+      ++class_def_method_index;
+      it.Next();
+    }
+    while (it.HasNextVirtualMethod()) {
+      if (UNLIKELY(!visitor->VisitMethod(class_def_method_index, it))) {
         return false;
       }
+      ++class_def_method_index;
+      it.Next();
     }
   }
-  return true;
+  return visitor->EndClass();
+}
+
+size_t OatWriter::GetOatClassIndex(const DexFile* dex_file, size_t class_def_index) const {
+  auto it = oat_class_begin_indexes_.find(dex_file);
+  DCHECK(it != oat_class_begin_indexes_.end());
+  return it->second + class_def_index;
 }
 
 size_t OatWriter::InitOatHeader(InstructionSet instruction_set,
@@ -1401,6 +1447,12 @@ size_t OatWriter::InitOatClasses(size_t offset) {
   offset = visitor.GetOffset();
 
   // Update oat_dex_files_.
+  size_t oat_class_index = 0u;
+  for (const DexFile* dex_file : *dex_files_) {
+    oat_class_begin_indexes_.Put(dex_file, oat_class_index);
+    oat_class_index += dex_file->NumClassDefs();
+  }
+  DCHECK_EQ(oat_class_index, oat_classes_.size());
   auto oat_class_it = oat_classes_.begin();
   for (OatDexFile& oat_dex_file : oat_dex_files_) {
     for (uint32_t& class_offset : oat_dex_file.class_offsets_) {
@@ -1460,13 +1512,81 @@ size_t OatWriter::InitOatCode(size_t offset) {
   return offset;
 }
 
+static bool HasProfiledMethod(const ProfileCompilationInfo* profile,
+                              const DexFile* dex_file,
+                              uint32_t class_def_index) {
+  const uint8_t* class_data = dex_file->GetClassData(dex_file->GetClassDef(class_def_index));
+  if (class_data == nullptr) {
+    return false;
+  }
+  ClassDataItemIterator it(*dex_file, class_data);
+  while (it.HasNextStaticField()) {
+    it.Next();
+  }
+  while (it.HasNextInstanceField()) {
+    it.Next();
+  }
+  for (; it.HasNextDirectMethod() || it.HasNextVirtualMethod(); it.Next()) {
+    if (profile->ContainsMethod(MethodReference(dex_file, it.GetMemberIndex()))) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void OatWriter::InitCodeLayout() {
+  const ProfileCompilationInfo* profile = compiler_driver_->GetProfileCompilationInfo();
+  if (profile == nullptr) {
+    return;
+  }
+  // With a profile, mostly the profiled methods are compiled. Split their classes into those the
+  // profile records as loaded at startup and those that only have methods that got hot later, and
+  // lay out the startup classes first, then the other profiled classes, then the rest (mostly JNI
+  // stubs), each group in definition order.
+  dchecked_vector<std::pair<const DexFile*, uint32_t>> startup_classes;
+  dchecked_vector<std::pair<const DexFile*, uint32_t>> hot_classes;
+  dchecked_vector<std::pair<const DexFile*, uint32_t>> cold_classes;
+  for (const DexFile* dex_file : *dex_files_) {
+    for (uint32_t class_def_index = 0; class_def_index != dex_file->NumClassDefs();
+         ++class_def_index) {
+      if (profile->ContainsClass(*dex_file, class_def_index)) {
+        startup_classes.emplace_back(dex_file, class_def_index);
+      } else if (HasProfiledMethod(profile, dex_file, class_def_index)) {
+        hot_classes.emplace_back(dex_file, class_def_index);
+      } else {
+        cold_classes.emplace_back(dex_file, class_def_index);
+      }
+    }
+  }
+  if (startup_classes.empty()) {
+    // The profile does not record the classes loaded at startup, take the profiled ones.
+    startup_classes.swap(hot_classes);
+  }
+  if (hot_classes.empty() && cold_classes.empty()) {
+    // Nothing to reorder, but all the code is startup code.
+    num_hot_classes_ = startup_classes.size();
+    return;
+  }
+  if (startup_classes.empty()) {
+    // Nothing in the profile.
+    return;
+  }
+  VLOG(compiler) << "Laying out the code of " << startup_classes.size() << " startup classes and "
+                 << hot_classes.size() << " other profiled classes before "
+                 << cold_classes.size() << " other classes";
+  num_hot_classes_ = startup_classes.size();
+  code_layout_.swap(startup_classes);
+  code_layout_.insert(code_layout_.end(), hot_classes.begin(), hot_classes.end());
+  code_layout_.insert(code_layout_.end(), cold_classes.begin(), cold_classes.end());
+}
+
 size_t OatWriter::InitOatCodeDexFiles(size_t offset) {
-  #define VISIT(VisitorType)                          \
-    do {                                              \
-      VisitorType visitor(this, offset);              \
-      bool success = VisitDexMethods(&visitor);       \
-      DCHECK(success);                                \
-      offset = visitor.GetOffset();                   \
+  #define VISIT(VisitorType)                                \
+    do {                                                    \
+      VisitorType visitor(this, offset);                    \
+      bool success = VisitDexMethodsInCodeLayout(&visitor); \
+      DCHECK(success);                                      \
+      offset = visitor.GetOffset();                         \
     } while (false)
 
   VISIT(InitCodeMethodVisitor);
@@ -1741,7 +1861,7 @@ size_t OatWriter::WriteCodeDexFiles(OutputStream* out,
   #define VISIT(VisitorType)                                              \
     do {                                                                  \
       VisitorType visitor(this, out, file_offset, relative_offset);       \
-      if (UNLIKELY(!VisitDexMethods(&visitor))) {                         \
+      if (UNLIKELY(!VisitDexMethodsInCodeLayout(&visitor))) {             \
         return 0;                                                         \
       }                                                                   \
       relative_offset = visitor.GetOffset();                              \
@@ -236,6 +236,13 @@ class OatWriter {
   // Visit all the methods in all the compiled dex files in their definition order
   // with a given DexMethodVisitor.
   bool VisitDexMethods(DexMethodVisitor* visitor);
+  // Visit all the methods with a given DexMethodVisitor, in the order in which the code
+  // of their classes is laid out.
+  bool VisitDexMethodsInCodeLayout(DexMethodVisitor* visitor);
+  bool VisitClassMethods(DexMethodVisitor* visitor,
+                         const DexFile* dex_file,
+                         size_t class_def_index);
+  size_t GetOatClassIndex(const DexFile* dex_file, size_t class_def_index) const;
 
   size_t InitOatHeader(InstructionSet instruction_set,
                        const InstructionSetFeatures* instruction_set_features,
@@ -245,6 +252,7 @@ class OatWriter {
   size_t InitOatClasses(size_t offset);
   size_t InitOatMaps(size_t offset);
   size_t InitOatCode(size_t offset);
+  void InitCodeLayout();
   size_t InitOatCodeDexFiles(size_t offset);
 
   bool WriteClassOffsets(OutputStream* out);
@@ -319,6 +327,15 @@ class OatWriter {
   std::unique_ptr<OatHeader> oat_header_;
   dchecked_vector<OatDexFile> oat_dex_files_;
   dchecked_vector<OatClass> oat_classes_;
+  // Index in oat_classes_ of the first class of each dex file.
+  SafeMap<const DexFile*, size_t> oat_class_begin_indexes_;  // DexFiles not owned.
+  // Order in which the code of the classes is laid out. Classes loaded at startup according to
+  // the profile come first, then other classes with methods in the profile, so that the code run
+  // at startup is on as few pages as possible. Empty if the code is laid out in definition order.
+  dchecked_vector<std::pair<const DexFile*, uint32_t>> code_layout_;
+  // Number of classes at the start of the code layout that are loaded at startup, all of them
+  // if every class is, even though code_layout_ is then empty.
+  size_t num_hot_classes_;
   std::unique_ptr<const std::vector<uint8_t>> jni_dlsym_lookup_;
   std::unique_ptr<const std::vector<uint8_t>> quick_generic_jni_trampoline_;
   std::unique_ptr<const std::vector<uint8_t>> quick_imt_conflict_trampoline_;
@@ -557,8 +557,9 @@ class BCEVisitor : public HGraphVisitor {
     first_index_bounds_check_map_.clear();
     HGraphVisitor::VisitBasicBlock(block);
     // We should never deoptimize from an osr method, otherwise we might wrongly optimize
-    // code dominated by the deoptimization.
-    if (!GetGraph()->IsCompilingOsr()) {
+    // code dominated by the deoptimization. We also do not deoptimize when the JIT
+    // disabled speculation for this method.
+    if (GetGraph()->CanDeoptimize()) {
       AddComparesWithDeoptimization(block);
     }
   }
@@ -1371,8 +1372,9 @@ class BCEVisitor : public HGraphVisitor {
         return false;
       }
       // We should never deoptimize from an osr method, otherwise we might wrongly optimize
-      // code dominated by the deoptimization.
-      if (GetGraph()->IsCompilingOsr()) {
+      // code dominated by the deoptimization. We also do not deoptimize when the JIT
+      // disabled speculation for this method.
+      if (!GetGraph()->CanDeoptimize()) {
         return false;
       }
       // A try boundary preheader is hard to handle.
@@ -777,7 +777,11 @@ void CodeGenerator::RecordPcInfo(HInstruction* instruction,
   LocationSummary* locations = instruction->GetLocations();
 
   uint32_t register_mask = locations->GetRegisterMask();
-  if (locations->OnlyCallsOnSlowPath()) {
+  // An implicit suspend check records its pc without a slow path. The runtime then
+  // saves every register in a kSaveEverything frame, so caller-save registers holding
+  // objects stay visible to the GC.
+  bool is_implicit_suspend_check = instruction->IsSuspendCheck() && slow_path == nullptr;
+  if (locations->OnlyCallsOnSlowPath() && !is_implicit_suspend_check) {
     // In case of slow path, we currently set the location of caller-save registers
     // to register (instead of their stack location when pushed before the slow-path
     // call). Therefore register_mask contains both callee-save and caller-save
@@ -785,8 +789,9 @@ void CodeGenerator::RecordPcInfo(HInstruction* instruction,
     // they will be overwritten by the callee.
     register_mask &= core_callee_save_mask_;
   }
-  // The register mask must be a subset of callee-save registers.
-  DCHECK_EQ(register_mask & core_callee_save_mask_, register_mask);
+  // Otherwise the register mask must be a subset of callee-save registers.
+  DCHECK(is_implicit_suspend_check ||
+         (register_mask & core_callee_save_mask_) == register_mask);
   stack_map_stream_.BeginStackMapEntry(outer_dex_pc,
                                        native_pc,
                                        register_mask,
@@ -1100,6 +1105,27 @@ bool CodeGenerator::IsImplicitNullCheckAllowed(HNullCheck* null_check) const {
          !null_check->CanThrowIntoCatchBlock();
 }
 
+bool CodeGenerator::IsImplicitSuspendCheckAllowed(HSuspendCheck* suspend_check) const {
+  if (!compiler_options_.GetImplicitSuspendChecks() || graph_->IsCompilingOsr()) {
+    return false;
+  }
+  switch (GetInstructionSet()) {
+    case kArm:
+    case kThumb2:
+    case kArm64:
+    case kX86:
+    case kX86_64:
+      break;
+    default:
+      // The fault handler does not recognize suspend checks on other architectures.
+      return false;
+  }
+  // The check at method entry keeps testing the thread flags, so that it can
+  // still be removed from leaf methods.
+  HLoopInformation* info = suspend_check->GetBlock()->GetLoopInformation();
+  return (info != nullptr) && (info->GetSuspendCheck() == suspend_check) && !info->IsIrreducible();
+}
+
 bool CodeGenerator::CanMoveNullCheckToUser(HNullCheck* null_check) {
   HInstruction* first_next_not_move = null_check->GetNextDisregardingMoves();
 
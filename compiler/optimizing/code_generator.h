@@ -312,6 +312,14 @@ class CodeGenerator : public DeletableArenaObject<kArenaAllocCodeGenerator> {
   // save live registers, which may be needed by the runtime to set catch phis.
   bool IsImplicitNullCheckAllowed(HNullCheck* null_check) const;
 
+  // Returns true if implicit suspend checks are allowed in the compiler options
+  // and `suspend_check` is the suspend check of a reducible loop. Such a check is
+  // a load through the thread's suspend trigger at the top of the loop header,
+  // which faults when a suspension or checkpoint is requested. The fault handler
+  // then enters art_quick_implicit_suspend, which saves every register, so the
+  // check only needs a fixed temp and live registers stay where they are.
+  bool IsImplicitSuspendCheckAllowed(HSuspendCheck* suspend_check) const;
+
   // TODO: Avoid creating the `std::unique_ptr` here.
   void AddSlowPath(SlowPathCode* slow_path) {
     slow_paths_.push_back(std::unique_ptr<SlowPathCode>(slow_path));
@@ -1227,7 +1227,8 @@ void InstructionCodeGeneratorARM::HandleGoto(HInstruction* got, HBasicBlock* suc
   HInstruction* previous = got->GetPrevious();
 
   HLoopInformation* info = block->GetLoopInformation();
-  if (info != nullptr && info->IsBackEdge(*block) && info->HasSuspendCheck()) {
+  if (info != nullptr && info->IsBackEdge(*block) && info->HasSuspendCheck() &&
+      !codegen_->IsImplicitSuspendCheckAllowed(info->GetSuspendCheck())) {
     codegen_->ClearSpillSlotsFromLoopPhisInStackMap(info->GetSuspendCheck());
     GenerateSuspendCheck(info->GetSuspendCheck(), successor);
     return;
@@ -5124,14 +5125,22 @@ void InstructionCodeGeneratorARM::VisitParallelMove(HParallelMove* instruction)
 }
 
 void LocationsBuilderARM::VisitSuspendCheck(HSuspendCheck* instruction) {
-  new (GetGraph()->GetArena()) LocationSummary(instruction, LocationSummary::kCallOnSlowPath);
+  LocationSummary* locations =
+      new (GetGraph()->GetArena()) LocationSummary(instruction, LocationSummary::kCallOnSlowPath);
+  if (codegen_->IsImplicitSuspendCheckAllowed(instruction)) {
+    // The fault handler only recognizes polls through R0.
+    locations->AddTemp(Location::RegisterLocation(R0));
+  }
 }
 
 void InstructionCodeGeneratorARM::VisitSuspendCheck(HSuspendCheck* instruction) {
   HBasicBlock* block = instruction->GetBlock();
   if (block->GetLoopInformation() != nullptr) {
     DCHECK(block->GetLoopInformation()->GetSuspendCheck() == instruction);
-    // The back edge will generate the suspend check.
+    if (codegen_->IsImplicitSuspendCheckAllowed(instruction)) {
+      GenerateImplicitSuspendCheck(instruction);
+    }
+    // Otherwise the back edge will generate the suspend check.
     return;
   }
   if (block->IsEntryBlock() && instruction->GetNext()->IsGoto()) {
@@ -5168,6 +5177,18 @@ void InstructionCodeGeneratorARM::GenerateSuspendCheck(HSuspendCheck* instructio
   }
 }
 
+void InstructionCodeGeneratorARM::GenerateImplicitSuspendCheck(HSuspendCheck* instruction) {
+  DCHECK(instruction->GetBlock()->IsLoopHeader());
+  // The fault handler expects exactly this sequence: ldr.w r0, [r9, #trigger]; ldr r0, [r0].
+  // R0 is reserved as a temp by the locations builder. On a fault, art_quick_implicit_suspend
+  // saves every register, so nothing else needs to be spilled around the check.
+  DCHECK_EQ(instruction->GetLocations()->GetTemp(0).AsRegister<Register>(), R0);
+  __ LoadFromOffset(
+      kLoadWord, R0, TR, Thread::ThreadSuspendTriggerOffset<kArmWordSize>().Int32Value());
+  __ LoadFromOffset(kLoadWord, R0, R0, 0);
+  codegen_->RecordPcInfo(instruction, instruction->GetDexPc());
+}
+
 ArmAssembler* ParallelMoveResolverARM::GetAssembler() const {
   return codegen_->GetAssembler();
 }
@@ -5526,16 +5547,30 @@ HLoadString::LoadKind CodeGeneratorARM::GetSupportedLoadStringKind(
 }
 
 void LocationsBuilderARM::VisitLoadString(HLoadString* load) {
+  HLoadString::LoadKind load_kind = load->GetLoadKind();
+  const bool hashed_load =
+      kUseHashedDexCacheStrings && load_kind == HLoadString::LoadKind::kDexCacheViaMethod;
   LocationSummary::CallKind call_kind = (load->NeedsEnvironment() || kEmitCompilerReadBarrier)
       ? LocationSummary::kCallOnSlowPath
       : LocationSummary::kNoCall;
+  if (hashed_load && kEmitCompilerReadBarrier) {
+    // See InstructionCodeGeneratorARM::GenerateHashedDexCacheStringLoad().
+    call_kind = LocationSummary::kCall;
+  }
   LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(load, call_kind);
-  HLoadString::LoadKind load_kind = load->GetLoadKind();
   if (load_kind == HLoadString::LoadKind::kDexCacheViaMethod ||
       load_kind == HLoadString::LoadKind::kDexCachePcRelative) {
     locations->SetInAt(0, Location::RequiresRegister());
   }
-  locations->SetOut(Location::RequiresRegister());
+  if (hashed_load && kEmitCompilerReadBarrier) {
+    locations->SetOut(Location::RegisterLocation(R0));
+  } else {
+    locations->SetOut(Location::RequiresRegister());
+  }
+  if (hashed_load && !kEmitCompilerReadBarrier) {
+    // The index half of the StringDexCachePair.
+    locations->AddTemp(Location::RequiresRegister());
+  }
 }
 
 void InstructionCodeGeneratorARM::VisitLoadString(HLoadString* load) {
@@ -5593,6 +5628,10 @@ void InstructionCodeGeneratorARM::VisitLoadString(HLoadString* load) {
       break;
     }
     case HLoadString::LoadKind::kDexCacheViaMethod: {
+      if (kUseHashedDexCacheStrings) {
+        GenerateHashedDexCacheStringLoad(load);
+        return;
+      }
       Register current_method = locations->InAt(0).AsRegister<Register>();
 
       // /* GcRoot<mirror::Class> */ out = current_method->declaring_class_
@@ -5618,6 +5657,42 @@ void InstructionCodeGeneratorARM::VisitLoadString(HLoadString* load) {
   }
 }
 
+void InstructionCodeGeneratorARM::GenerateHashedDexCacheStringLoad(HLoadString* load) {
+  LocationSummary* locations = load->GetLocations();
+  Location out_loc = locations->Out();
+  Register out = out_loc.AsRegister<Register>();
+  if (kEmitCompilerReadBarrier) {
+    // The string of the pair would have to go through the read barrier after the index
+    // check, away from its GC root, so let the runtime look it up.
+    InvokeRuntimeCallingConvention calling_convention;
+    __ LoadImmediate(calling_convention.GetRegisterAt(0), load->GetStringIndex());
+    codegen_->InvokeRuntime(QUICK_ENTRY_POINT(pResolveString), load, load->GetDexPc(), nullptr);
+    CheckEntrypointTypes<kQuickResolveString, void*, uint32_t>();
+    return;
+  }
+
+  Register current_method = locations->InAt(0).AsRegister<Register>();
+  Register temp = locations->GetTemp(0).AsRegister<Register>();
+  const uint32_t string_index = load->GetStringIndex();
+  // /* GcRoot<mirror::Class> */ out = current_method->declaring_class_
+  GenerateGcRootFieldLoad(
+      load, out_loc, current_method, ArtMethod::DeclaringClassOffset().Int32Value());
+  // /* StringDexCacheType[] */ temp = out->dex_cache_strings_
+  __ LoadFromOffset(kLoadWord, temp, out, mirror::Class::DexCacheStringsOffset().Int32Value());
+  // The slot may hold another string index, so load the StringDexCachePair atomically and
+  // check its index. out = string_pointer, temp = string_index.
+  GenerateWideAtomicLoad(temp,
+                         mirror::DexCache::StringSlotIndex(string_index) *
+                             sizeof(mirror::StringDexCachePair),
+                         out,
+                         temp);
+  SlowPathCode* slow_path = new (GetGraph()->GetArena()) LoadStringSlowPathARM(load);
+  codegen_->AddSlowPath(slow_path);
+  __ CmpConstant(temp, string_index);
+  __ b(slow_path->GetEntryLabel(), NE);
+  __ Bind(slow_path->GetExitLabel());
+}
+
 static int32_t GetExceptionTlsOffset() {
   return Thread::ExceptionOffset<kArmWordSize>().Int32Value();
 }
@@ -222,6 +222,9 @@ class InstructionCodeGeneratorARM : public InstructionCodeGenerator {
   // is the block to branch to if the suspend check is not needed, and after
   // the suspend call.
   void GenerateSuspendCheck(HSuspendCheck* check, HBasicBlock* successor);
+  // Generate the faulting load of an implicit suspend check, see
+  // CodeGenerator::IsImplicitSuspendCheckAllowed().
+  void GenerateImplicitSuspendCheck(HSuspendCheck* check);
   void GenerateClassInitializationCheck(SlowPathCode* slow_path, Register class_reg);
   void GenerateAndConst(Register out, Register first, uint32_t value);
   void GenerateOrrConst(Register out, Register first, uint32_t value);
@@ -281,6 +284,9 @@ class InstructionCodeGeneratorARM : public InstructionCodeGenerator {
                                Location root,
                                Register obj,
                                uint32_t offset);
+  // Generate the kDexCacheViaMethod load of a string from a hashed strings array, see
+  // mirror::StringDexCachePair.
+  void GenerateHashedDexCacheStringLoad(HLoadString* load);
   void GenerateTestAndBranch(HInstruction* instruction,
                              size_t condition_input_index,
                              Label* true_target,
@@ -1588,6 +1588,18 @@ void InstructionCodeGeneratorARM64::GenerateSuspendCheck(HSuspendCheck* instruct
   }
 }
 
+void InstructionCodeGeneratorARM64::GenerateImplicitSuspendCheck(HSuspendCheck* instruction) {
+  DCHECK(instruction->GetBlock()->IsLoopHeader());
+  // The fault handler expects exactly this sequence: ldr x0, [tr, #trigger]; ldr x0, [x0].
+  // x0 is reserved as a temp by the locations builder. On a fault, art_quick_implicit_suspend
+  // saves every register, so nothing else needs to be spilled around the check.
+  DCHECK(XRegisterFrom(instruction->GetLocations()->GetTemp(0)).Is(x0));
+  BlockPoolsScope block_pools(GetVIXLAssembler());
+  __ Ldr(x0, MemOperand(tr, Thread::ThreadSuspendTriggerOffset<kArm64WordSize>().SizeValue()));
+  __ Ldr(x0, MemOperand(x0));
+  codegen_->RecordPcInfo(instruction, instruction->GetDexPc());
+}
+
 InstructionCodeGeneratorARM64::InstructionCodeGeneratorARM64(HGraph* graph,
                                                              CodeGeneratorARM64* codegen)
       : InstructionCodeGenerator(graph, codegen),
@@ -2878,7 +2890,8 @@ void InstructionCodeGeneratorARM64::HandleGoto(HInstruction* got, HBasicBlock* s
   HInstruction* previous = got->GetPrevious();
   HLoopInformation* info = block->GetLoopInformation();
 
-  if (info != nullptr && info->IsBackEdge(*block) && info->HasSuspendCheck()) {
+  if (info != nullptr && info->IsBackEdge(*block) && info->HasSuspendCheck() &&
+      !codegen_->IsImplicitSuspendCheckAllowed(info->GetSuspendCheck())) {
     codegen_->ClearSpillSlotsFromLoopPhisInStackMap(info->GetSuspendCheck());
     GenerateSuspendCheck(info->GetSuspendCheck(), successor);
     return;
@@ -4131,14 +4144,29 @@ HLoadString::LoadKind CodeGeneratorARM64::GetSupportedLoadStringKind(
 }
 
 void LocationsBuilderARM64::VisitLoadString(HLoadString* load) {
+  const bool hashed_load = kUseHashedDexCacheStrings &&
+      load->GetLoadKind() == HLoadString::LoadKind::kDexCacheViaMethod;
   LocationSummary::CallKind call_kind = (load->NeedsEnvironment() || kEmitCompilerReadBarrier)
       ? LocationSummary::kCallOnSlowPath
       : LocationSummary::kNoCall;
+  if (hashed_load && kEmitCompilerReadBarrier) {
+    // See InstructionCodeGeneratorARM64::GenerateHashedDexCacheStringLoad().
+    call_kind = LocationSummary::kCall;
+  }
   LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(load, call_kind);
   if (load->GetLoadKind() == HLoadString::LoadKind::kDexCacheViaMethod) {
     locations->SetInAt(0, Location::RequiresRegister());
   }
-  locations->SetOut(Location::RequiresRegister());
+  if (hashed_load && kEmitCompilerReadBarrier) {
+    InvokeRuntimeCallingConvention calling_convention;
+    locations->SetOut(calling_convention.GetReturnLocation(load->GetType()));
+  } else {
+    locations->SetOut(Location::RequiresRegister());
+  }
+  if (hashed_load && !kEmitCompilerReadBarrier) {
+    // The StringDexCachePair.
+    locations->AddTemp(Location::RequiresRegister());
+  }
 }
 
 void InstructionCodeGeneratorARM64::VisitLoadString(HLoadString* load) {
@@ -4210,6 +4238,10 @@ void InstructionCodeGeneratorARM64::VisitLoadString(HLoadString* load) {
       break;
     }
     case HLoadString::LoadKind::kDexCacheViaMethod: {
+      if (kUseHashedDexCacheStrings) {
+        GenerateHashedDexCacheStringLoad(load);
+        return;
+      }
       Register current_method = InputRegisterAt(load, 0);
       // /* GcRoot<mirror::Class> */ out = current_method->declaring_class_
       GenerateGcRootFieldLoad(
@@ -4234,6 +4266,41 @@ void InstructionCodeGeneratorARM64::VisitLoadString(HLoadString* load) {
   }
 }
 
+void InstructionCodeGeneratorARM64::GenerateHashedDexCacheStringLoad(HLoadString* load) {
+  Register out = OutputRegister(load);
+  if (kEmitCompilerReadBarrier) {
+    // The string of the pair would have to go through the read barrier after the index
+    // check, away from its GC root, so let the runtime look it up.
+    InvokeRuntimeCallingConvention calling_convention;
+    __ Mov(calling_convention.GetRegisterAt(0).W(), load->GetStringIndex());
+    codegen_->InvokeRuntime(QUICK_ENTRY_POINT(pResolveString), load, load->GetDexPc(), nullptr);
+    CheckEntrypointTypes<kQuickResolveString, void*, uint32_t>();
+    return;
+  }
+
+  Register current_method = InputRegisterAt(load, 0);
+  Register pair = XRegisterFrom(load->GetLocations()->GetTemp(0));
+  const uint32_t string_index = load->GetStringIndex();
+  // /* GcRoot<mirror::Class> */ out = current_method->declaring_class_
+  GenerateGcRootFieldLoad(load,
+                          load->GetLocations()->Out(),
+                          current_method,
+                          ArtMethod::DeclaringClassOffset().Int32Value());
+  // /* StringDexCacheType[] */ out = out->dex_cache_strings_
+  __ Ldr(out.X(), HeapOperand(out, mirror::Class::DexCacheStringsOffset().Uint32Value()));
+  // The slot may hold another string index, so load the StringDexCachePair atomically and
+  // check its index.
+  __ Ldr(pair, MemOperand(out.X(), mirror::DexCache::StringSlotIndex(string_index) *
+                                       sizeof(mirror::StringDexCachePair)));
+  __ Mov(out.W(), pair.W());
+  __ Lsr(pair, pair, 32);
+  SlowPathCodeARM64* slow_path = new (GetGraph()->GetArena()) LoadStringSlowPathARM64(load);
+  codegen_->AddSlowPath(slow_path);
+  __ Cmp(pair.W(), string_index);
+  __ B(ne, slow_path->GetEntryLabel());
+  __ Bind(slow_path->GetExitLabel());
+}
+
 void LocationsBuilderARM64::VisitLongConstant(HLongConstant* constant) {
   LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(constant);
   locations->SetOut(Location::ConstantLocation(constant));
@@ -4892,14 +4959,22 @@ void InstructionCodeGeneratorARM64::VisitUnresolvedStaticFieldSet(
 }
 
 void LocationsBuilderARM64::VisitSuspendCheck(HSuspendCheck* instruction) {
-  new (GetGraph()->GetArena()) LocationSummary(instruction, LocationSummary::kCallOnSlowPath);
+  LocationSummary* locations =
+      new (GetGraph()->GetArena()) LocationSummary(instruction, LocationSummary::kCallOnSlowPath);
+  if (codegen_->IsImplicitSuspendCheckAllowed(instruction)) {
+    // The fault handler only recognizes polls through x0.
+    locations->AddTemp(LocationFrom(x0));
+  }
 }
 
 void InstructionCodeGeneratorARM64::VisitSuspendCheck(HSuspendCheck* instruction) {
   HBasicBlock* block = instruction->GetBlock();
   if (block->GetLoopInformation() != nullptr) {
     DCHECK(block->GetLoopInformation()->GetSuspendCheck() == instruction);
-    // The back edge will generate the suspend check.
+    if (codegen_->IsImplicitSuspendCheckAllowed(instruction)) {
+      GenerateImplicitSuspendCheck(instruction);
+    }
+    // Otherwise the back edge will generate the suspend check.
     return;
   }
   if (block->IsEntryBlock() && instruction->GetNext()->IsGoto()) {
@@ -357,6 +357,7 @@ class InstructionCodeGeneratorARM64 : public InstructionCodeGenerator {
  private:
   void GenerateClassInitializationCheck(SlowPathCodeARM64* slow_path, vixl::Register class_reg);
   void GenerateSuspendCheck(HSuspendCheck* instruction, HBasicBlock* successor);
+  void GenerateImplicitSuspendCheck(HSuspendCheck* instruction);
   void HandleBinaryOp(HBinaryOperation* instr);
 
   void HandleFieldSet(HInstruction* instruction,
@@ -403,6 +404,9 @@ class InstructionCodeGeneratorARM64 : public InstructionCodeGenerator {
                                vixl::Register obj,
                                uint32_t offset,
                                vixl::Label* fixup_label = nullptr);
+  // Generate the kDexCacheViaMethod load of a string from a hashed strings array, see
+  // mirror::StringDexCachePair.
+  void GenerateHashedDexCacheStringLoad(HLoadString* load);
 
   // Generate a floating-point comparison.
   void GenerateFcmp(HInstruction* instruction);
@@ -4064,12 +4064,34 @@ void LocationsBuilderMIPS::VisitLoadString(HLoadString* load) {
   LocationSummary::CallKind call_kind = load->NeedsEnvironment()
       ? LocationSummary::kCallOnSlowPath
       : LocationSummary::kNoCall;
+  if (kUseHashedDexCacheStrings) {
+    // See InstructionCodeGeneratorMIPS::VisitLoadString().
+    call_kind = LocationSummary::kCall;
+  }
   LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(load, call_kind);
   locations->SetInAt(0, Location::RequiresRegister());
-  locations->SetOut(Location::RequiresRegister());
+  if (kUseHashedDexCacheStrings) {
+    locations->SetOut(Location::RegisterLocation(V0));
+  } else {
+    locations->SetOut(Location::RequiresRegister());
+  }
 }
 
 void InstructionCodeGeneratorMIPS::VisitLoadString(HLoadString* load) {
+  if (kUseHashedDexCacheStrings) {
+    // There is no single-copy atomic 64-bit load into core registers to read the
+    // StringDexCachePair of a hashed strings array inline, so let the runtime look up the
+    // string in the dex cache and resolve it if it is not present.
+    InvokeRuntimeCallingConvention calling_convention;
+    __ LoadConst32(calling_convention.GetRegisterAt(0), load->GetStringIndex());
+    codegen_->InvokeRuntime(QUICK_ENTRY_POINT(pResolveString),
+                            load,
+                            load->GetDexPc(),
+                            nullptr,
+                            IsDirectEntrypoint(kQuickResolveString));
+    CheckEntrypointTypes<kQuickResolveString, void*, uint32_t>();
+    return;
+  }
   LocationSummary* locations = load->GetLocations();
   Register out = locations->Out().AsRegister<Register>();
   Register current_method = locations->InAt(0).AsRegister<Register>();
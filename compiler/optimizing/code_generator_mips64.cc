@@ -3284,6 +3284,10 @@ void LocationsBuilderMIPS64::VisitLoadString(HLoadString* load) {
   LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(load, call_kind);
   locations->SetInAt(0, Location::RequiresRegister());
   locations->SetOut(Location::RequiresRegister());
+  if (kUseHashedDexCacheStrings) {
+    // The StringDexCachePair.
+    locations->AddTemp(Location::RequiresRegister());
+  }
 }
 
 void InstructionCodeGeneratorMIPS64::VisitLoadString(HLoadString* load) {
@@ -3293,6 +3297,27 @@ void InstructionCodeGeneratorMIPS64::VisitLoadString(HLoadString* load) {
   __ LoadFromOffset(kLoadUnsignedWord, out, current_method,
                     ArtMethod::DeclaringClassOffset().Int32Value());
   __ LoadFromOffset(kLoadDoubleword, out, out, mirror::Class::DexCacheStringsOffset().Int32Value());
+  if (kUseHashedDexCacheStrings) {
+    GpuRegister pair = locations->GetTemp(0).AsRegister<GpuRegister>();
+    const uint32_t string_index = load->GetStringIndex();
+    // The slot may hold another string index, so load the StringDexCachePair atomically and
+    // check its index.
+    __ LoadFromOffset(kLoadDoubleword,
+                      pair,
+                      out,
+                      mirror::DexCache::StringSlotIndex(string_index) *
+                          sizeof(mirror::StringDexCachePair));
+    __ Dext(out, pair, 0, 32);
+    __ Dsrl32(pair, pair, 0);
+    // TODO: We will need a read barrier here.
+    DCHECK(!load->IsInDexCache());
+    SlowPathCodeMIPS64* slow_path = new (GetGraph()->GetArena()) LoadStringSlowPathMIPS64(load);
+    codegen_->AddSlowPath(slow_path);
+    __ LoadConst32(TMP, string_index);
+    __ Bnec(pair, TMP, slow_path->GetEntryLabel());
+    __ Bind(slow_path->GetExitLabel());
+    return;
+  }
   __ LoadFromOffset(
       kLoadUnsignedWord, out, out, CodeGenerator::GetCacheOffset(load->GetStringIndex()));
   // TODO: We will need a read barrier here.
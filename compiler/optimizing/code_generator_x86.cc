@@ -1136,7 +1136,8 @@ void InstructionCodeGeneratorX86::HandleGoto(HInstruction* got, HBasicBlock* suc
   HInstruction* previous = got->GetPrevious();
 
   HLoopInformation* info = block->GetLoopInformation();
-  if (info != nullptr && info->IsBackEdge(*block) && info->HasSuspendCheck()) {
+  if (info != nullptr && info->IsBackEdge(*block) && info->HasSuspendCheck() &&
+      !codegen_->IsImplicitSuspendCheckAllowed(info->GetSuspendCheck())) {
     GenerateSuspendCheck(info->GetSuspendCheck(), successor);
     return;
   }
@@ -5585,14 +5586,22 @@ void InstructionCodeGeneratorX86::VisitParallelMove(HParallelMove* instruction)
 }
 
 void LocationsBuilderX86::VisitSuspendCheck(HSuspendCheck* instruction) {
-  new (GetGraph()->GetArena()) LocationSummary(instruction, LocationSummary::kCallOnSlowPath);
+  LocationSummary* locations =
+      new (GetGraph()->GetArena()) LocationSummary(instruction, LocationSummary::kCallOnSlowPath);
+  if (codegen_->IsImplicitSuspendCheckAllowed(instruction)) {
+    // The fault handler only recognizes polls through EAX.
+    locations->AddTemp(Location::RegisterLocation(EAX));
+  }
 }
 
 void InstructionCodeGeneratorX86::VisitSuspendCheck(HSuspendCheck* instruction) {
   HBasicBlock* block = instruction->GetBlock();
   if (block->GetLoopInformation() != nullptr) {
     DCHECK(block->GetLoopInformation()->GetSuspendCheck() == instruction);
-    // The back edge will generate the suspend check.
+    if (codegen_->IsImplicitSuspendCheckAllowed(instruction)) {
+      GenerateImplicitSuspendCheck(instruction);
+    }
+    // Otherwise the back edge will generate the suspend check.
     return;
   }
   if (block->IsEntryBlock() && instruction->GetNext()->IsGoto()) {
@@ -5629,6 +5638,18 @@ void InstructionCodeGeneratorX86::GenerateSuspendCheck(HSuspendCheck* instructio
   }
 }
 
+void InstructionCodeGeneratorX86::GenerateImplicitSuspendCheck(HSuspendCheck* instruction) {
+  DCHECK(instruction->GetBlock()->IsLoopHeader());
+  // The fault handler expects exactly this sequence: mov eax, fs:[trigger]; test eax, [eax].
+  // EAX is reserved as a temp by the locations builder. On a fault, art_quick_implicit_suspend
+  // saves every register, so nothing else needs to be spilled around the check.
+  DCHECK_EQ(instruction->GetLocations()->GetTemp(0).AsRegister<Register>(), EAX);
+  int32_t trigger_offset = Thread::ThreadSuspendTriggerOffset<kX86WordSize>().Int32Value();
+  __ fs()->movl(EAX, Address::Absolute(trigger_offset));
+  __ testl(EAX, Address(EAX, 0));
+  codegen_->RecordPcInfo(instruction, instruction->GetDexPc());
+}
+
 X86Assembler* ParallelMoveResolverX86::GetAssembler() const {
   return codegen_->GetAssembler();
 }
@@ -6023,17 +6044,33 @@ HLoadString::LoadKind CodeGeneratorX86::GetSupportedLoadStringKind(
 }
 
 void LocationsBuilderX86::VisitLoadString(HLoadString* load) {
+  HLoadString::LoadKind load_kind = load->GetLoadKind();
+  const bool hashed_load =
+      kUseHashedDexCacheStrings && load_kind == HLoadString::LoadKind::kDexCacheViaMethod;
   LocationSummary::CallKind call_kind = (load->NeedsEnvironment() || kEmitCompilerReadBarrier)
       ? LocationSummary::kCallOnSlowPath
       : LocationSummary::kNoCall;
+  if (hashed_load && kEmitCompilerReadBarrier) {
+    // See InstructionCodeGeneratorX86::GenerateHashedDexCacheStringLoad().
+    call_kind = LocationSummary::kCall;
+  }
   LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(load, call_kind);
-  HLoadString::LoadKind load_kind = load->GetLoadKind();
   if (load_kind == HLoadString::LoadKind::kDexCacheViaMethod ||
       load_kind == HLoadString::LoadKind::kBootImageLinkTimePcRelative ||
       load_kind == HLoadString::LoadKind::kDexCachePcRelative) {
     locations->SetInAt(0, Location::RequiresRegister());
   }
-  locations->SetOut(Location::RequiresRegister());
+  if (hashed_load && kEmitCompilerReadBarrier) {
+    locations->SetOut(Location::RegisterLocation(EAX));
+  } else {
+    locations->SetOut(Location::RequiresRegister());
+  }
+  if (hashed_load && !kEmitCompilerReadBarrier) {
+    // The StringDexCachePair is loaded with a single 64-bit SSE load, then its index half
+    // is moved to a core register for the compare.
+    locations->AddTemp(Location::RequiresFpuRegister());
+    locations->AddTemp(Location::RequiresRegister());
+  }
 }
 
 void InstructionCodeGeneratorX86::VisitLoadString(HLoadString* load) {
@@ -6078,6 +6115,10 @@ void InstructionCodeGeneratorX86::VisitLoadString(HLoadString* load) {
       break;
     }
     case HLoadString::LoadKind::kDexCacheViaMethod: {
+      if (kUseHashedDexCacheStrings) {
+        GenerateHashedDexCacheStringLoad(load);
+        return;
+      }
       Register current_method = locations->InAt(0).AsRegister<Register>();
 
       // /* GcRoot<mirror::Class> */ out = current_method->declaring_class_
@@ -6105,6 +6146,42 @@ void InstructionCodeGeneratorX86::VisitLoadString(HLoadString* load) {
   }
 }
 
+void InstructionCodeGeneratorX86::GenerateHashedDexCacheStringLoad(HLoadString* load) {
+  LocationSummary* locations = load->GetLocations();
+  Register out = locations->Out().AsRegister<Register>();
+  if (kEmitCompilerReadBarrier) {
+    // The string of the pair would have to go through the read barrier after the index
+    // check, away from its GC root, so let the runtime look it up.
+    InvokeRuntimeCallingConvention calling_convention;
+    __ movl(calling_convention.GetRegisterAt(0), Immediate(load->GetStringIndex()));
+    codegen_->InvokeRuntime(QUICK_ENTRY_POINT(pResolveString), load, load->GetDexPc(), nullptr);
+    CheckEntrypointTypes<kQuickResolveString, void*, uint32_t>();
+    return;
+  }
+
+  Register current_method = locations->InAt(0).AsRegister<Register>();
+  XmmRegister pair = locations->GetTemp(0).AsFpuRegister<XmmRegister>();
+  Register index = locations->GetTemp(1).AsRegister<Register>();
+  const uint32_t string_index = load->GetStringIndex();
+  // /* GcRoot<mirror::Class> */ out = current_method->declaring_class_
+  GenerateGcRootFieldLoad(
+      load, locations->Out(), Address(current_method, ArtMethod::DeclaringClassOffset()));
+  // /* StringDexCacheType[] */ out = out->dex_cache_strings_
+  __ movl(out, Address(out, mirror::Class::DexCacheStringsOffset()));
+  // The slot may hold another string index, so load the StringDexCachePair atomically and
+  // check its index.
+  __ movsd(pair, Address(out, mirror::DexCache::StringSlotIndex(string_index) *
+                                  sizeof(mirror::StringDexCachePair)));
+  __ movd(out, pair);
+  __ psrlq(pair, Immediate(32));
+  __ movd(index, pair);
+  SlowPathCode* slow_path = new (GetGraph()->GetArena()) LoadStringSlowPathX86(load);
+  codegen_->AddSlowPath(slow_path);
+  __ cmpl(index, Immediate(string_index));
+  __ j(kNotEqual, slow_path->GetEntryLabel());
+  __ Bind(slow_path->GetExitLabel());
+}
+
 static Address GetExceptionTlsAddress() {
   return Address::Absolute(Thread::ExceptionOffset<kX86WordSize>().Int32Value());
 }
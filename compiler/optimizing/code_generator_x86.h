@@ -207,6 +207,9 @@ class InstructionCodeGeneratorX86 : public InstructionCodeGenerator {
   // is the block to branch to if the suspend check is not needed, and after
   // the suspend call.
   void GenerateSuspendCheck(HSuspendCheck* check, HBasicBlock* successor);
+  // Generate the faulting load of an implicit suspend check, see
+  // CodeGenerator::IsImplicitSuspendCheckAllowed().
+  void GenerateImplicitSuspendCheck(HSuspendCheck* check);
   void GenerateClassInitializationCheck(SlowPathCode* slow_path, Register class_reg);
   void HandleBitwiseOperation(HBinaryOperation* instruction);
   void GenerateDivRemIntegral(HBinaryOperation* instruction);
@@ -265,6 +268,9 @@ class InstructionCodeGeneratorX86 : public InstructionCodeGenerator {
                                Location root,
                                const Address& address,
                                Label* fixup_label = nullptr);
+  // Generate the kDexCacheViaMethod load of a string from a hashed strings array, see
+  // mirror::StringDexCachePair.
+  void GenerateHashedDexCacheStringLoad(HLoadString* load);
 
   // Push value to FPU stack. `is_fp` specifies whether the value is floating point or not.
   // `is_wide` specifies whether it is long/double or not.
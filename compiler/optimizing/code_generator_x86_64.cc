@@ -1230,7 +1230,8 @@ void InstructionCodeGeneratorX86_64::HandleGoto(HInstruction* got, HBasicBlock*
   HInstruction* previous = got->GetPrevious();
 
   HLoopInformation* info = block->GetLoopInformation();
-  if (info != nullptr && info->IsBackEdge(*block) && info->HasSuspendCheck()) {
+  if (info != nullptr && info->IsBackEdge(*block) && info->HasSuspendCheck() &&
+      !codegen_->IsImplicitSuspendCheckAllowed(info->GetSuspendCheck())) {
     GenerateSuspendCheck(info->GetSuspendCheck(), successor);
     return;
   }
@@ -5080,14 +5081,22 @@ void InstructionCodeGeneratorX86_64::VisitParallelMove(HParallelMove* instructio
 }
 
 void LocationsBuilderX86_64::VisitSuspendCheck(HSuspendCheck* instruction) {
-  new (GetGraph()->GetArena()) LocationSummary(instruction, LocationSummary::kCallOnSlowPath);
+  LocationSummary* locations =
+      new (GetGraph()->GetArena()) LocationSummary(instruction, LocationSummary::kCallOnSlowPath);
+  if (codegen_->IsImplicitSuspendCheckAllowed(instruction)) {
+    // The fault handler only recognizes polls through RAX.
+    locations->AddTemp(Location::RegisterLocation(RAX));
+  }
 }
 
 void InstructionCodeGeneratorX86_64::VisitSuspendCheck(HSuspendCheck* instruction) {
   HBasicBlock* block = instruction->GetBlock();
   if (block->GetLoopInformation() != nullptr) {
     DCHECK(block->GetLoopInformation()->GetSuspendCheck() == instruction);
-    // The back edge will generate the suspend check.
+    if (codegen_->IsImplicitSuspendCheckAllowed(instruction)) {
+      GenerateImplicitSuspendCheck(instruction);
+    }
+    // Otherwise the back edge will generate the suspend check.
     return;
   }
   if (block->IsEntryBlock() && instruction->GetNext()->IsGoto()) {
@@ -5125,6 +5134,18 @@ void InstructionCodeGeneratorX86_64::GenerateSuspendCheck(HSuspendCheck* instruc
   }
 }
 
+void InstructionCodeGeneratorX86_64::GenerateImplicitSuspendCheck(HSuspendCheck* instruction) {
+  DCHECK(instruction->GetBlock()->IsLoopHeader());
+  // The fault handler expects exactly this sequence: movq rax, gs:[trigger]; test eax, [rax].
+  // RAX is reserved as a temp by the locations builder. On a fault, art_quick_implicit_suspend
+  // saves every register, so nothing else needs to be spilled around the check.
+  DCHECK_EQ(instruction->GetLocations()->GetTemp(0).AsRegister<Register>(), RAX);
+  int32_t trigger_offset = Thread::ThreadSuspendTriggerOffset<kX86_64WordSize>().Int32Value();
+  __ gs()->movq(CpuRegister(RAX), Address::Absolute(trigger_offset, /* no_rip */ true));
+  __ testl(CpuRegister(RAX), Address(CpuRegister(RAX), 0));
+  codegen_->RecordPcInfo(instruction, instruction->GetDexPc());
+}
+
 X86_64Assembler* ParallelMoveResolverX86_64::GetAssembler() const {
   return codegen_->GetAssembler();
 }
@@ -5450,14 +5471,28 @@ HLoadString::LoadKind CodeGeneratorX86_64::GetSupportedLoadStringKind(
 }
 
 void LocationsBuilderX86_64::VisitLoadString(HLoadString* load) {
+  const bool hashed_load = kUseHashedDexCacheStrings &&
+      load->GetLoadKind() == HLoadString::LoadKind::kDexCacheViaMethod;
   LocationSummary::CallKind call_kind = (load->NeedsEnvironment() || kEmitCompilerReadBarrier)
       ? LocationSummary::kCallOnSlowPath
       : LocationSummary::kNoCall;
+  if (hashed_load && kEmitCompilerReadBarrier) {
+    // See InstructionCodeGeneratorX86_64::GenerateHashedDexCacheStringLoad().
+    call_kind = LocationSummary::kCall;
+  }
   LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(load, call_kind);
   if (load->GetLoadKind() == HLoadString::LoadKind::kDexCacheViaMethod) {
     locations->SetInAt(0, Location::RequiresRegister());
   }
-  locations->SetOut(Location::RequiresRegister());
+  if (hashed_load && kEmitCompilerReadBarrier) {
+    locations->SetOut(Location::RegisterLocation(RAX));
+  } else {
+    locations->SetOut(Location::RequiresRegister());
+  }
+  if (hashed_load && !kEmitCompilerReadBarrier) {
+    // The StringDexCachePair.
+    locations->AddTemp(Location::RequiresRegister());
+  }
 }
 
 void InstructionCodeGeneratorX86_64::VisitLoadString(HLoadString* load) {
@@ -5501,6 +5536,10 @@ void InstructionCodeGeneratorX86_64::VisitLoadString(HLoadString* load) {
       break;
     }
     case HLoadString::LoadKind::kDexCacheViaMethod: {
+      if (kUseHashedDexCacheStrings) {
+        GenerateHashedDexCacheStringLoad(load);
+        return;
+      }
       CpuRegister current_method = locations->InAt(0).AsRegister<CpuRegister>();
 
       // /* GcRoot<mirror::Class> */ out = current_method->declaring_class_
@@ -5527,6 +5566,40 @@ void InstructionCodeGeneratorX86_64::VisitLoadString(HLoadString* load) {
   }
 }
 
+void InstructionCodeGeneratorX86_64::GenerateHashedDexCacheStringLoad(HLoadString* load) {
+  LocationSummary* locations = load->GetLocations();
+  CpuRegister out = locations->Out().AsRegister<CpuRegister>();
+  if (kEmitCompilerReadBarrier) {
+    // The string of the pair would have to go through the read barrier after the index
+    // check, away from its GC root, so let the runtime look it up.
+    InvokeRuntimeCallingConvention calling_convention;
+    __ movl(CpuRegister(calling_convention.GetRegisterAt(0)), Immediate(load->GetStringIndex()));
+    codegen_->InvokeRuntime(QUICK_ENTRY_POINT(pResolveString), load, load->GetDexPc(), nullptr);
+    CheckEntrypointTypes<kQuickResolveString, void*, uint32_t>();
+    return;
+  }
+
+  CpuRegister current_method = locations->InAt(0).AsRegister<CpuRegister>();
+  CpuRegister pair = locations->GetTemp(0).AsRegister<CpuRegister>();
+  const uint32_t string_index = load->GetStringIndex();
+  // /* GcRoot<mirror::Class> */ out = current_method->declaring_class_
+  GenerateGcRootFieldLoad(
+      load, locations->Out(), Address(current_method, ArtMethod::DeclaringClassOffset()));
+  // /* StringDexCacheType[] */ out = out->dex_cache_strings_
+  __ movq(out, Address(out, mirror::Class::DexCacheStringsOffset()));
+  // The slot may hold another string index, so load the StringDexCachePair atomically and
+  // check its index.
+  __ movq(pair, Address(out, mirror::DexCache::StringSlotIndex(string_index) *
+                                 sizeof(mirror::StringDexCachePair)));
+  __ movl(out, pair);  // Zero-extended.
+  __ shrq(pair, Immediate(32));
+  SlowPathCode* slow_path = new (GetGraph()->GetArena()) LoadStringSlowPathX86_64(load);
+  codegen_->AddSlowPath(slow_path);
+  __ cmpl(pair, Immediate(string_index));
+  __ j(kNotEqual, slow_path->GetEntryLabel());
+  __ Bind(slow_path->GetExitLabel());
+}
+
 static Address GetExceptionTlsAddress() {
   return Address::Absolute(Thread::ExceptionOffset<kX86_64WordSize>().Int32Value(),
                            /* no_rip */ true);
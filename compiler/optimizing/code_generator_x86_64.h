@@ -208,6 +208,9 @@ class InstructionCodeGeneratorX86_64 : public InstructionCodeGenerator {
   // is the block to branch to if the suspend check is not needed, and after
   // the suspend call.
   void GenerateSuspendCheck(HSuspendCheck* instruction, HBasicBlock* successor);
+  // Generate the faulting load of an implicit suspend check, see
+  // CodeGenerator::IsImplicitSuspendCheckAllowed().
+  void GenerateImplicitSuspendCheck(HSuspendCheck* instruction);
   void GenerateClassInitializationCheck(SlowPathCode* slow_path, CpuRegister class_reg);
   void HandleBitwiseOperation(HBinaryOperation* operation);
   void GenerateRemFP(HRem* rem);
@@ -260,6 +263,9 @@ class InstructionCodeGeneratorX86_64 : public InstructionCodeGenerator {
                                Location root,
                                const Address& address,
                                Label* fixup_label = nullptr);
+  // Generate the kDexCacheViaMethod load of a string from a hashed strings array, see
+  // mirror::StringDexCachePair.
+  void GenerateHashedDexCacheStringLoad(HLoadString* load);
 
   void PushOntoFPStack(Location source, uint32_t temp_offset,
                        uint32_t stack_adjustment, bool is_float);
@@ -261,6 +261,9 @@ void GraphChecker::VisitBoundsCheck(HBoundsCheck* check) {
 void GraphChecker::VisitDeoptimize(HDeoptimize* deopt) {
   if (GetGraph()->IsCompilingOsr()) {
     AddError(StringPrintf("A graph compiled OSR cannot have a HDeoptimize instruction"));
+  } else if (!GetGraph()->CanDeoptimize()) {
+    AddError(StringPrintf("A graph compiled without speculation cannot have a HDeoptimize "
+                          "instruction"));
   }
 
   // Perform the instruction base checks too.
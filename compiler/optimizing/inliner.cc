@@ -54,6 +54,23 @@ static constexpr size_t kMaximumNumberOfCumulatedDexRegisters = 64;
 // Avoid inlining within a huge method due to memory pressure.
 static constexpr size_t kMaximumCodeUnitSize = 4096;
 
+static bool IsInHotLoop(const HBasicBlock& block, const ArenaSet<uint32_t>& hot_loop_headers) {
+  for (HLoopInformationOutwardIterator it(block); !it.Done(); it.Advance()) {
+    uint32_t header_dex_pc = it.Current()->GetHeader()->GetDexPc();
+    if (hot_loop_headers.find(header_dex_pc) != hot_loop_headers.end()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Minimum number of receiver types of a megamorphic inline cache that must share
+// the same dispatch table entry for that entry to be guarded and inlined.
+static constexpr size_t kMinimumMegamorphicTargetShare = 2;
+
+// Maximum number of targets inlined at a megamorphic call site.
+static constexpr size_t kMaximumMegamorphicInlinedTargets = 3;
+
 void HInliner::Run() {
   const CompilerOptions& compiler_options = compiler_driver_->GetCompilerOptions();
   if ((compiler_options.GetInlineDepthLimit() == 0)
@@ -71,6 +88,13 @@ void HInliner::Run() {
 #ifdef MTK_ART_COMMON
   graph_->InitRecordStat(kMtkOptimizingOptStat3);
 #endif
+  // OSR compiled code is entered at a loop header: the code before the loops is never
+  // executed, and the code after them at most once. Only spend the inlining budget on
+  // the loop nests the interpreter found hot.
+  ArenaSet<uint32_t> hot_loop_headers(graph_->GetArena()->Adapter(kArenaAllocOptimization));
+  bool only_inline_in_hot_loops = (graph_ == outermost_graph_) &&
+      graph_->IsCompilingOsr() &&
+      CollectHotLoopHeaders(&hot_loop_headers);
   const ArenaVector<HBasicBlock*>& blocks = graph_->GetReversePostOrder();
   DCHECK(!blocks.empty());
   HBasicBlock* next_block = blocks[0];
@@ -82,6 +106,9 @@ void HInliner::Run() {
     }
     HBasicBlock* block = next_block;
     next_block = (i == blocks.size() - 1) ? nullptr : blocks[i + 1];
+    if (only_inline_in_hot_loops && !IsInHotLoop(*block, hot_loop_headers)) {
+      continue;
+    }
     for (HInstruction* instruction = block->GetFirstInstruction(); instruction != nullptr;) {
       HInstruction* next = instruction->GetNext();
       HInvoke* call = instruction->AsInvoke();
@@ -257,6 +284,24 @@ class ScopedProfilingInfoInlineUse {
   ProfilingInfo* const profiling_info_;
 };
 
+bool HInliner::CollectHotLoopHeaders(ArenaSet<uint32_t>* hot_loop_headers) {
+  if (!Runtime::Current()->UseJitCompilation()) {
+    return false;
+  }
+  ScopedObjectAccess soa(Thread::Current());
+  ScopedProfilingInfoInlineUse spiis(graph_->GetArtMethod(), soa.Self());
+  ProfilingInfo* profiling_info = spiis.GetProfilingInfo();
+  if (profiling_info == nullptr) {
+    return false;
+  }
+  for (HBasicBlock* block : graph_->GetReversePostOrder()) {
+    if (block->IsLoopHeader() && profiling_info->IsHotLoopHeader(block->GetDexPc())) {
+      hot_loop_headers->insert(block->GetDexPc());
+    }
+  }
+  return true;
+}
+
 bool HInliner::TryInline(HInvoke* invoke_instruction) {
   if (invoke_instruction->IsInvokeUnresolved()) {
     return false;  // Don't bother to move further if we know the method is unresolved.
@@ -326,9 +371,10 @@ bool HInliner::TryInline(HInvoke* invoke_instruction) {
         return false;
       } else if (ic.IsMonomorphic()) {
         MaybeRecordStat(kMonomorphicCall);
-        if (outermost_graph_->IsCompilingOsr()) {
+        if (!outermost_graph_->CanDeoptimize()) {
           // If we are compiling OSR, we pretend this call is polymorphic, as we may come from the
-          // interpreter and it may have seen different receiver types.
+          // interpreter and it may have seen different receiver types. We do the same when
+          // the JIT disabled speculation, so that the guard falls back to the invoke.
           return TryInlinePolymorphicCall(invoke_instruction, resolved_method, ic);
         } else {
           return TryInlineMonomorphicCall(invoke_instruction, resolved_method, ic);
@@ -338,10 +384,13 @@ bool HInliner::TryInline(HInvoke* invoke_instruction) {
         return TryInlinePolymorphicCall(invoke_instruction, resolved_method, ic);
       } else {
         DCHECK(ic.IsMegamorphic());
+        MaybeRecordStat(kMegamorphicCall);
+        if (TryInlineMegamorphicCall(invoke_instruction, resolved_method, ic)) {
+          return true;
+        }
         VLOG(compiler) << "Interface or virtual call to "
                        << PrettyMethod(method_index, caller_dex_file)
                        << " is megamorphic and not inlined";
-        MaybeRecordStat(kMegamorphicCall);
         return false;
       }
     }
@@ -521,8 +570,8 @@ bool HInliner::TryInlinePolymorphicCall(HInvoke* invoke_instruction,
           (i != InlineCache::kIndividualCacheSize - 1) &&
           (ic.GetTypeAt(i + 1) == nullptr);
 
-      if (outermost_graph_->IsCompilingOsr()) {
-        // We do not support HDeoptimize in OSR methods.
+      if (!outermost_graph_->CanDeoptimize()) {
+        // We do not support HDeoptimize in OSR methods, nor when speculation is disabled.
         deoptimize = false;
       }
       HInstruction* compare = AddTypeGuard(
@@ -683,16 +732,171 @@ bool HInliner::TryInlinePolymorphicCallToSameTarget(HInvoke* invoke_instruction,
     }
   }
 
+  if (!TryInlineWithDispatchTableGuard(invoke_instruction,
+                                       actual_method,
+                                       method_index,
+                                       /* with_deoptimization */ true)) {
+    return false;
+  }
+  MaybeRecordStat(kInlinedPolymorphicCall);
+  return true;
+}
+
+bool HInliner::TryInlineMegamorphicCall(HInvoke* invoke_instruction,
+                                        ArtMethod* resolved_method,
+                                        const InlineCache& ic) {
+  // This optimization only works under JIT for now.
+  DCHECK(Runtime::Current()->UseJitCompilation());
+  if (graph_->GetInstructionSet() == kMips64) {
+    // TODO: Support HClassTableGet for mips64.
+    return false;
+  }
+  ClassLinker* class_linker = caller_compilation_unit_.GetClassLinker();
+  size_t pointer_size = class_linker->GetImagePointerSize();
+  const DexFile& caller_dex_file = *caller_compilation_unit_.GetDexFile();
+
+  DCHECK(resolved_method != nullptr);
+  size_t method_index = invoke_instruction->IsInvokeVirtual()
+      ? invoke_instruction->AsInvokeVirtual()->GetVTableIndex()
+      : invoke_instruction->AsInvokeInterface()->GetImtIndex();
+
+  // The inline cache only holds the first receiver types seen, and more types flow
+  // through the call site. Guarding on the class would therefore miss most of the
+  // time, so instead we look for the dispatch table entries shared by several of the
+  // types seen: any other receiver type that shares one will also take the inlined path.
+  // Types whose IMT entry is a conflict trampoline are resolved through their interface
+  // table instead; the conflict trampoline does not identify the target, so those targets
+  // are guarded by the classes seen.
+  struct MegamorphicTarget {
+    ArtMethod* method;
+    bool through_imt_conflict;
+    size_t number_of_types;
+    // Classes to guard on if `through_imt_conflict`.
+    uint32_t class_indexes[InlineCache::kIndividualCacheSize];
+    bool is_referrer[InlineCache::kIndividualCacheSize];
+    size_t number_of_class_indexes;
+  };
+  MegamorphicTarget targets[InlineCache::kIndividualCacheSize];
+  size_t number_of_targets = 0;
+  for (size_t i = 0; i < InlineCache::kIndividualCacheSize; ++i) {
+    mirror::Class* type = ic.GetTypeAt(i);
+    if (type == nullptr) {
+      // The GC may have cleared the entry concurrently.
+      continue;
+    }
+    ArtMethod* new_method = nullptr;
+    bool through_imt_conflict = false;
+    if (invoke_instruction->IsInvokeInterface()) {
+      new_method = type->GetImt(pointer_size)->Get(method_index % ImTable::kSize, pointer_size);
+      if (new_method->IsRuntimeMethod()) {
+        new_method = type->FindVirtualMethodForInterface(resolved_method, pointer_size);
+        through_imt_conflict = true;
+        if (new_method == nullptr || new_method->IsAbstract() || new_method->IsRuntimeMethod()) {
+          // The call throws for this type.
+          continue;
+        }
+      }
+    } else {
+      DCHECK(invoke_instruction->IsInvokeVirtual());
+      new_method = type->GetEmbeddedVTableEntry(method_index, pointer_size);
+    }
+    DCHECK(new_method != nullptr);
+    size_t j = 0;
+    while (j < number_of_targets &&
+           (targets[j].method != new_method ||
+            targets[j].through_imt_conflict != through_imt_conflict)) {
+      ++j;
+    }
+    MegamorphicTarget& target = targets[j];
+    if (j == number_of_targets) {
+      target.method = new_method;
+      target.through_imt_conflict = through_imt_conflict;
+      target.number_of_types = 0;
+      target.number_of_class_indexes = 0;
+      ++number_of_targets;
+    }
+    ++target.number_of_types;
+    if (through_imt_conflict) {
+      uint32_t class_index =
+          FindClassIndexIn(type, caller_dex_file, caller_compilation_unit_.GetDexCache());
+      if (class_index != DexFile::kDexNoIndex) {
+        target.class_indexes[target.number_of_class_indexes] = class_index;
+        target.is_referrer[target.number_of_class_indexes] =
+            (type == outermost_graph_->GetArtMethod()->GetDeclaringClass());
+        ++target.number_of_class_indexes;
+      }
+    }
+  }
+
+  // Inline the most shared targets first, so that they are checked first.
+  std::stable_sort(targets,
+                   targets + number_of_targets,
+                   [](const MegamorphicTarget& lhs, const MegamorphicTarget& rhs) {
+                     return lhs.number_of_types > rhs.number_of_types;
+                   });
+
+  // Never deoptimize on a megamorphic call site: we know other types will flow
+  // through it, so keep the original invoke as the slow path of the last guard.
   HInstruction* receiver = invoke_instruction->InputAt(0);
-  HInstruction* cursor = invoke_instruction->GetPrevious();
-  HBasicBlock* bb_cursor = invoke_instruction->GetBlock();
+  size_t number_of_inlined_targets = 0;
+  for (size_t i = 0; i < number_of_targets; ++i) {
+    const MegamorphicTarget& target = targets[i];
+    if (target.number_of_types < kMinimumMegamorphicTargetShare ||
+        number_of_inlined_targets == kMaximumMegamorphicInlinedTargets) {
+      break;
+    }
+    if (target.through_imt_conflict && target.number_of_class_indexes == 0) {
+      // None of the classes can be loaded from the caller's dex file.
+      continue;
+    }
+    HInstruction* cursor = invoke_instruction->GetPrevious();
+    HBasicBlock* bb_cursor = invoke_instruction->GetBlock();
+    HInstruction* return_replacement = nullptr;
+    if (!TryBuildAndInline(invoke_instruction, target.method, &return_replacement)) {
+      continue;
+    }
+    HInstruction* compare = target.through_imt_conflict
+        ? AddClassSetGuard(receiver,
+                           cursor,
+                           bb_cursor,
+                           target.class_indexes,
+                           target.is_referrer,
+                           target.number_of_class_indexes,
+                           invoke_instruction)
+        : AddDispatchTableGuard(receiver,
+                                cursor,
+                                bb_cursor,
+                                target.method,
+                                method_index,
+                                invoke_instruction);
+    CreateDiamondPatternForPolymorphicInline(compare, return_replacement, invoke_instruction);
+    ++number_of_inlined_targets;
+  }
 
-  HInstruction* return_replacement = nullptr;
-  if (!TryBuildAndInline(invoke_instruction, actual_method, &return_replacement)) {
+  if (number_of_inlined_targets == 0) {
+    VLOG(compiler) << "Call to " << PrettyMethod(resolved_method)
+                   << " from megamorphic inline cache is not inlined because no"
+                   << " target is shared by enough receiver types";
     return false;
   }
+  MaybeRecordStat(kInlinedMegamorphicCall);
 
-  // We successfully inlined, now add a guard.
+  // Run type propagation to get the guards typed.
+  ReferenceTypePropagation rtp_fixup(graph_,
+                                     outer_compilation_unit_.GetDexCache(),
+                                     handles_,
+                                     /* is_first_run */ false);
+  rtp_fixup.Run();
+  return true;
+}
+
+HInstruction* HInliner::AddDispatchTableGuard(HInstruction* receiver,
+                                              HInstruction* cursor,
+                                              HBasicBlock* bb_cursor,
+                                              ArtMethod* actual_method,
+                                              size_t method_index,
+                                              HInvoke* invoke_instruction) {
+  ClassLinker* class_linker = caller_compilation_unit_.GetClassLinker();
   HInstanceFieldGet* receiver_class = BuildGetReceiverClass(
       class_linker, receiver, invoke_instruction->GetDexPc());
 
@@ -724,8 +928,74 @@ bool HInliner::TryInlinePolymorphicCallToSameTarget(HInvoke* invoke_instruction,
   }
   bb_cursor->InsertInstructionAfter(class_table_get, receiver_class);
   bb_cursor->InsertInstructionAfter(compare, class_table_get);
+  return compare;
+}
+
+HInstruction* HInliner::AddClassSetGuard(HInstruction* receiver,
+                                         HInstruction* cursor,
+                                         HBasicBlock* bb_cursor,
+                                         const uint32_t* class_indexes,
+                                         const bool* is_referrer,
+                                         size_t number_of_classes,
+                                         HInvoke* invoke_instruction) {
+  DCHECK_NE(number_of_classes, 0u);
+  ClassLinker* class_linker = caller_compilation_unit_.GetClassLinker();
+  uint32_t dex_pc = invoke_instruction->GetDexPc();
+  HInstanceFieldGet* receiver_class = BuildGetReceiverClass(class_linker, receiver, dex_pc);
+  if (cursor != nullptr) {
+    bb_cursor->InsertInstructionAfter(receiver_class, cursor);
+  } else {
+    bb_cursor->InsertInstructionBefore(receiver_class, bb_cursor->GetFirstInstruction());
+  }
 
-  if (outermost_graph_->IsCompilingOsr()) {
+  const DexFile& caller_dex_file = *caller_compilation_unit_.GetDexFile();
+  HInstruction* last = receiver_class;
+  HInstruction* compare = nullptr;
+  for (size_t i = 0; i != number_of_classes; ++i) {
+    // As in AddTypeGuard, the classes are in the dex cache since FindClassIndexIn found them.
+    HLoadClass* load_class = new (graph_->GetArena()) HLoadClass(graph_->GetCurrentMethod(),
+                                                                 class_indexes[i],
+                                                                 caller_dex_file,
+                                                                 is_referrer[i],
+                                                                 dex_pc,
+                                                                 /* needs_access_check */ false,
+                                                                 /* is_in_dex_cache */ true);
+    HNotEqual* not_equal = new (graph_->GetArena()) HNotEqual(load_class, receiver_class);
+    bb_cursor->InsertInstructionAfter(load_class, last);
+    bb_cursor->InsertInstructionAfter(not_equal, load_class);
+    last = not_equal;
+    if (compare == nullptr) {
+      compare = not_equal;
+    } else {
+      // The receiver is none of the classes.
+      HAnd* none = new (graph_->GetArena()) HAnd(Primitive::kPrimInt, compare, not_equal, dex_pc);
+      bb_cursor->InsertInstructionAfter(none, not_equal);
+      last = none;
+      compare = none;
+    }
+  }
+  return compare;
+}
+
+bool HInliner::TryInlineWithDispatchTableGuard(HInvoke* invoke_instruction,
+                                               ArtMethod* actual_method,
+                                               size_t method_index,
+                                               bool with_deoptimization) {
+  HInstruction* receiver = invoke_instruction->InputAt(0);
+  HInstruction* cursor = invoke_instruction->GetPrevious();
+  HBasicBlock* bb_cursor = invoke_instruction->GetBlock();
+
+  HInstruction* return_replacement = nullptr;
+  if (!TryBuildAndInline(invoke_instruction, actual_method, &return_replacement)) {
+    return false;
+  }
+
+  // We successfully inlined, now add a guard.
+  HInstruction* compare = AddDispatchTableGuard(
+      receiver, cursor, bb_cursor, actual_method, method_index, invoke_instruction);
+
+  if (!with_deoptimization || !outermost_graph_->CanDeoptimize()) {
+    // We do not support HDeoptimize in OSR methods, nor when speculation is disabled.
     CreateDiamondPatternForPolymorphicInline(compare, return_replacement, invoke_instruction);
   } else {
     // TODO: Extend reference type propagation to understand the guard.
@@ -745,9 +1015,6 @@ bool HInliner::TryInlinePolymorphicCallToSameTarget(HInvoke* invoke_instruction,
                                      handles_,
                                      /* is_first_run */ false);
   rtp_fixup.Run();
-
-  MaybeRecordStat(kInlinedPolymorphicCall);
-
   return true;
 }
 
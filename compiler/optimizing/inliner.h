@@ -60,6 +60,10 @@ class HInliner : public HOptimization {
  private:
   bool TryInline(HInvoke* invoke_instruction);
 
+  // Collect the dex pcs of the loop headers of the graph that the profiling info of
+  // the method reports as hot. Return false if there is no loop profiling information.
+  bool CollectHotLoopHeaders(ArenaSet<uint32_t>* hot_loop_headers);
+
   // Try to inline `resolved_method` in place of `invoke_instruction`. `do_rtp` is whether
   // reference type propagation can run after the inlining. If the inlining is successful, this
   // method will replace and remove the `invoke_instruction`.
@@ -118,6 +122,47 @@ class HInliner : public HOptimization {
                                             const InlineCache& ic)
     SHARED_REQUIRES(Locks::mutator_lock_);
 
+  // Try to inline the targets of a megamorphic call that are shared by several of the
+  // receiver types in the inline cache. If successful, the code in the graph will look like:
+  // if (receiver.getClass().dispatch_table[index] == target1) ... // inlined code
+  // else if (receiver.getClass() == class1 || receiver.getClass() == class2) ... // inlined code
+  // else receiver.method(...)
+  // where the second form is used for interface targets hidden behind IMT conflicts.
+  bool TryInlineMegamorphicCall(HInvoke* invoke_instruction,
+                                ArtMethod* resolved_method,
+                                const InlineCache& ic)
+    SHARED_REQUIRES(Locks::mutator_lock_);
+
+  // Add a check that the vtable or IMT entry at `method_index` of the receiver's class
+  // is `actual_method`. Returns the condition, which is true if it is not.
+  HInstruction* AddDispatchTableGuard(HInstruction* receiver,
+                                      HInstruction* cursor,
+                                      HBasicBlock* bb_cursor,
+                                      ArtMethod* actual_method,
+                                      size_t method_index,
+                                      HInvoke* invoke_instruction)
+    SHARED_REQUIRES(Locks::mutator_lock_);
+
+  // Add a check that the receiver's class is one of the given classes of the caller's
+  // dex file. Returns the condition, which is true if it is none of them.
+  HInstruction* AddClassSetGuard(HInstruction* receiver,
+                                 HInstruction* cursor,
+                                 HBasicBlock* bb_cursor,
+                                 const uint32_t* class_indexes,
+                                 const bool* is_referrer,
+                                 size_t number_of_classes,
+                                 HInvoke* invoke_instruction)
+    SHARED_REQUIRES(Locks::mutator_lock_);
+
+  // Inline `actual_method` guarded by a check that the vtable or IMT entry at
+  // `method_index` of the receiver's class is `actual_method`. If `with_deoptimization`
+  // is false, or when compiling OSR, the original invoke is kept as the slow path.
+  bool TryInlineWithDispatchTableGuard(HInvoke* invoke_instruction,
+                                       ArtMethod* actual_method,
+                                       size_t method_index,
+                                       bool with_deoptimization)
+    SHARED_REQUIRES(Locks::mutator_lock_);
+
 
   HInstanceFieldGet* BuildGetReceiverClass(ClassLinker* class_linker,
                                            HInstruction* receiver,
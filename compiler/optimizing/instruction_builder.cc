@@ -19,6 +19,7 @@
 #include "bytecode_utils.h"
 #include "class_linker.h"
 #include "driver/compiler_options.h"
+#include "jit/profiling_info.h"
 #include "scoped_thread_state_change.h"
 
 namespace art {
@@ -475,8 +476,7 @@ void HInstructionBuilder::If_22t(const Instruction& instruction, uint32_t dex_pc
   HInstruction* second = LoadLocal(instruction.VRegB(), Primitive::kPrimInt);
   T* comparison = new (arena_) T(first, second, dex_pc);
   AppendInstruction(comparison);
-  AppendInstruction(new (arena_) HIf(comparison, dex_pc));
-  current_block_ = nullptr;
+  BuildIf(comparison, instruction, dex_pc);
 }
 
 template<typename T>
@@ -484,10 +484,42 @@ void HInstructionBuilder::If_21t(const Instruction& instruction, uint32_t dex_pc
   HInstruction* value = LoadLocal(instruction.VRegA(), Primitive::kPrimInt);
   T* comparison = new (arena_) T(value, graph_->GetIntConstant(0, dex_pc), dex_pc);
   AppendInstruction(comparison);
-  AppendInstruction(new (arena_) HIf(comparison, dex_pc));
+  BuildIf(comparison, instruction, dex_pc);
+}
+
+void HInstructionBuilder::BuildIf(HCondition* comparison,
+                                  const Instruction& instruction,
+                                  uint32_t dex_pc) {
+  if (CanSpeculateBranchNotTaken(instruction, dex_pc)) {
+    // The interpreter resumes at the branch when deoptimizing, and takes it.
+    AppendInstruction(new (arena_) HDeoptimize(comparison, dex_pc));
+    AppendInstruction(new (arena_) HIf(graph_->GetIntConstant(0, dex_pc), dex_pc));
+    MaybeRecordStat(kSpeculatedBranchNotTaken);
+  } else {
+    AppendInstruction(new (arena_) HIf(comparison, dex_pc));
+  }
   current_block_ = nullptr;
 }
 
+bool HInstructionBuilder::CanSpeculateBranchNotTaken(const Instruction& instruction,
+                                                     uint32_t dex_pc) const {
+  if (!Runtime::Current()->UseJitCompilation() ||
+      !graph_->CanDeoptimize() ||
+      // The deoptimization count is kept for the compiled method, not for inlinees.
+      dex_compilation_unit_ != outer_compilation_unit_ ||
+      current_block_->IsTryBlock() ||
+      instruction.GetTargetOffset() <= 0) {
+    return false;
+  }
+  ArtMethod* method = graph_->GetArtMethod();
+  if (method == nullptr) {
+    return false;
+  }
+  // The ProfilingInfo is not collected while the method is being compiled.
+  ProfilingInfo* info = method->GetProfilingInfo(sizeof(void*));
+  return info != nullptr && info->IsBranchNeverTaken(dex_pc);
+}
+
 template<typename T>
 void HInstructionBuilder::Unop_12x(const Instruction& instruction,
                                    Primitive::Type type,
@@ -133,6 +133,15 @@ class HInstructionBuilder : public ValueObject {
   template<typename T> void If_21t(const Instruction& instruction, uint32_t dex_pc);
   template<typename T> void If_22t(const Instruction& instruction, uint32_t dex_pc);
 
+  // Builds the HIf for the conditional branch `instruction`. When the JIT may speculate,
+  // and the interpreter never took the forward branch, the branch is compiled as not
+  // taken, behind an HDeoptimize on `comparison`.
+  void BuildIf(HCondition* comparison, const Instruction& instruction, uint32_t dex_pc);
+
+  // Returns whether the compiled code may assume the conditional branch at `dex_pc`
+  // is not taken, and deoptimize otherwise.
+  bool CanSpeculateBranchNotTaken(const Instruction& instruction, uint32_t dex_pc) const;
+
   void Conversion_12x(const Instruction& instruction,
                       Primitive::Type input_type,
                       Primitive::Type result_type,
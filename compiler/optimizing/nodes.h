@@ -322,7 +322,8 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
         cached_double_constants_(std::less<int64_t>(), arena->Adapter(kArenaAllocConstantsMap)),
         cached_current_method_(nullptr),
         inexact_object_rti_(ReferenceTypeInfo::CreateInvalid()),
-        osr_(osr) {
+        osr_(osr),
+        speculation_allowed_(true) {
     blocks_.reserve(kDefaultNumberOfBlocks);
   }
 
@@ -537,6 +538,12 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
 
   bool IsCompilingOsr() const { return osr_; }
 
+  // Whether optimizations may speculate and emit HDeoptimize for when the speculation
+  // fails. We never deoptimize from an osr method, and the JIT disables speculation
+  // for methods which deoptimized too often.
+  bool CanDeoptimize() const { return !osr_ && speculation_allowed_; }
+  void DisableSpeculation() { speculation_allowed_ = false; }
+
   bool HasTryCatch() const { return has_try_catch_; }
   void SetHasTryCatch(bool value) { has_try_catch_ = value; }
 
@@ -683,6 +690,10 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
   // compiled code entries which the interpreter can directly jump to.
   const bool osr_;
 
+  // Whether the compiled code may speculate and deoptimize. Cleared when the
+  // previously compiled code of the method deoptimized too often.
+  bool speculation_allowed_;
+
   friend class SsaBuilder;           // For caching constants.
   friend class SsaLivenessAnalysis;  // For the linear order.
   friend class HInliner;             // For the reverse post order.
@@ -5695,7 +5706,9 @@ class HLoadString : public HExpression<1> {
 
     // Load from resolved strings array accessed through the class loaded from
     // the compiled method's own ArtMethod*. This is the default access type when
-    // all other types are unavailable.
+    // all other types are unavailable. With kUseHashedDexCacheStrings, the index
+    // stored with the string in its slot is checked (see mirror::StringDexCachePair)
+    // and this is the only load kind from the dex cache.
     kDexCacheViaMethod,
 
     kLast = kDexCacheViaMethod
@@ -65,6 +65,7 @@
 #include "jit/debugger_interface.h"
 #include "jit/jit.h"
 #include "jit/jit_code_cache.h"
+#include "jit/profiling_info.h"
 #include "jni/quick/jni_compiler.h"
 #include "licm.h"
 #include "load_store_elimination.h"
@@ -731,6 +732,15 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* arena,
     if (dex_cache->GetResolvedType(type_index) == nullptr) {
       dex_cache->SetResolvedType(type_index, method->GetDeclaringClass());
     }
+
+    // If previously JIT compiled code of this method kept deoptimizing, compile
+    // it without speculative optimizations this time.
+    if (Runtime::Current()->UseJitCompilation()) {
+      ProfilingInfo* info = method->GetProfilingInfo(sizeof(void*));
+      if (info != nullptr && !info->IsSpeculationAllowed()) {
+        graph->DisableSpeculation();
+      }
+    }
   }
 
   std::unique_ptr<CodeGenerator> codegen(
@@ -54,6 +54,7 @@ enum MethodCompilationStat {
   kNotCompiledVerifyAtRuntime,
   kInlinedMonomorphicCall,
   kInlinedPolymorphicCall,
+  kInlinedMegamorphicCall,
   kMonomorphicCall,
   kPolymorphicCall,
   kMegamorphicCall,
@@ -65,6 +66,7 @@ enum MethodCompilationStat {
   kInlinedInvokeVirtualOrInterface,
   kImplicitNullCheckGenerated,
   kExplicitNullCheckGenerated,
+  kSpeculatedBranchNotTaken,
 #if MTK_ART_COMMON
   kMtkFirstStat,
   kMtkOptimizingOptStat1,
@@ -163,6 +165,7 @@ class OptimizingCompilerStats {
       case kNotCompiledVerifyAtRuntime : name = "NotCompiledVerifyAtRuntime"; break;
       case kInlinedMonomorphicCall: name = "InlinedMonomorphicCall"; break;
       case kInlinedPolymorphicCall: name = "InlinedPolymorphicCall"; break;
+      case kInlinedMegamorphicCall: name = "InlinedMegamorphicCall"; break;
       case kMonomorphicCall: name = "MonomorphicCall"; break;
       case kPolymorphicCall: name = "PolymorphicCall"; break;
       case kMegamorphicCall: name = "MegamorphicCall"; break;
@@ -174,6 +177,7 @@ class OptimizingCompilerStats {
       case kInlinedInvokeVirtualOrInterface: name = "InlinedInvokeVirtualOrInterface"; break;
       case kImplicitNullCheckGenerated: name = "ImplicitNullCheckGenerated"; break;
       case kExplicitNullCheckGenerated: name = "ExplicitNullCheckGenerated"; break;
+      case kSpeculatedBranchNotTaken: name = "SpeculatedBranchNotTaken"; break;
 
       #ifdef MTK_ART_COMMON
       default:
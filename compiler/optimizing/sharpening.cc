@@ -195,6 +195,10 @@ void HSharpening::ProcessLoadString(HLoadString* load_string) {
       if (string != nullptr && runtime->GetHeap()->ObjectIsInBootImageSpace(string)) {
         desired_load_kind = HLoadString::LoadKind::kBootImageAddress;
         address = reinterpret_cast64<uint64_t>(string);
+      } else if (kUseHashedDexCacheStrings) {
+        // The slot of the string in the hashed strings array may hold another string by the
+        // time the code runs, so the slot can only be loaded through the declaring class.
+        desired_load_kind = HLoadString::LoadKind::kDexCacheViaMethod;
       } else {
         // Note: If the string is not in the dex cache, the instruction needs environment
         // and will not be inlined across dex files. Within a dex file, the slow-path helper
@@ -210,8 +214,11 @@ void HSharpening::ProcessLoadString(HLoadString* load_string) {
       if (string != nullptr && runtime->GetHeap()->ObjectIsInBootImageSpace(string)) {
         if (codegen_->GetCompilerOptions().GetCompilePic()) {
           // Use PC-relative load from the dex cache if the dex file belongs
-          // to the oat file that we're currently compiling.
-          desired_load_kind = ContainsElement(compiler_driver_->GetDexFilesForOatFile(), &dex_file)
+          // to the oat file that we're currently compiling. A hashed strings
+          // array has no fixed slot for the string.
+          bool in_oat_file =
+              ContainsElement(compiler_driver_->GetDexFilesForOatFile(), &dex_file);
+          desired_load_kind = (in_oat_file && !kUseHashedDexCacheStrings)
               ? HLoadString::LoadKind::kDexCachePcRelative
               : HLoadString::LoadKind::kDexCacheViaMethod;
         } else {
@@ -220,15 +227,20 @@ void HSharpening::ProcessLoadString(HLoadString* load_string) {
         }
       } else {
         // Not JIT and the string is not in boot image.
-        desired_load_kind = HLoadString::LoadKind::kDexCachePcRelative;
+        desired_load_kind = kUseHashedDexCacheStrings
+            ? HLoadString::LoadKind::kDexCacheViaMethod
+            : HLoadString::LoadKind::kDexCachePcRelative;
       }
     }
   }
-  if (is_in_dex_cache) {
+
+  HLoadString::LoadKind load_kind = codegen_->GetSupportedLoadStringKind(desired_load_kind);
+  // A string in the hashed strings array may be evicted before kDexCacheViaMethod code loads it.
+  if (is_in_dex_cache &&
+      !(kUseHashedDexCacheStrings && load_kind == HLoadString::LoadKind::kDexCacheViaMethod)) {
     load_string->MarkInDexCache();
   }
 
-  HLoadString::LoadKind load_kind = codegen_->GetSupportedLoadStringKind(desired_load_kind);
   switch (load_kind) {
     case HLoadString::LoadKind::kBootImageLinkTimeAddress:
     case HLoadString::LoadKind::kBootImageLinkTimePcRelative:
@@ -369,6 +369,14 @@ NO_RETURN static void Usage(const char* fmt, ...) {
   UsageError("");
   UsageError("  --debuggable: Produce code debuggable with Java debugger.");
   UsageError("");
+  UsageError("  --implicit-suspend-checks: Poll for thread suspension at loop back edges with a");
+  UsageError("      load through the thread's suspend trigger, which faults when a suspension or");
+  UsageError("      checkpoint is requested, instead of testing the thread flags.");
+  UsageError("      Only supported on arm, arm64, x86 and x86_64. The code must run on a");
+  UsageError("      runtime started with -Ximplicit-suspend-checks. (disabled by default)");
+  UsageError("");
+  UsageError("  --no-implicit-suspend-checks: Test the thread flags at suspend checks.");
+  UsageError("");
   UsageError("  --runtime-arg <argument>: used to specify various arguments for the runtime,");
   UsageError("      such as initial heap size, maximum heap size, and verbose output.");
   UsageError("      Use a separate --runtime-arg switch for each argument.");
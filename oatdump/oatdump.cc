@@ -75,6 +75,7 @@ const char* image_methods_descriptions_[] = {
   "kCalleeSaveMethod",
   "kRefsOnlySaveMethod",
   "kRefsAndArgsSaveMethod",
+  "kSaveEverythingMethod",
 };
 
 const char* image_roots_descriptions_[] = {
@@ -403,6 +404,11 @@ class OatDumper {
                            GetQuickToInterpreterBridgeOffset);
 #undef DUMP_OAT_HEADER_OFFSET
 
+    os << "HOT CODE SIZE:\n";
+    os << StringPrintf("%u (0x%08x)\n\n",
+                       oat_header.GetHotCodeSize(),
+                       oat_header.GetHotCodeSize());
+
     os << "IMAGE PATCH DELTA:\n";
     os << StringPrintf("%d (0x%08x)\n\n",
                        oat_header.GetImagePatchDelta(),
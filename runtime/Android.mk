@@ -36,6 +36,7 @@ LIBART_COMMON_SRC_FILES := \
   base/hex_dump.cc \
   base/logging.cc \
   base/mutex.cc \
+  base/published_hash_sets.cc \
   base/scoped_arena_allocator.cc \
   base/scoped_flock.cc \
   base/stringpiece.cc \
@@ -46,6 +47,7 @@ LIBART_COMMON_SRC_FILES := \
   base/unix_file/random_access_file_utils.cc \
   check_jni.cc \
   class_linker.cc \
+  class_path_index.cc \
   class_table.cc \
   code_simulator_container.cc \
   common_throws.cc \
@@ -95,6 +97,7 @@ LIBART_COMMON_SRC_FILES := \
   instrumentation.cc \
   intern_table.cc \
   interpreter/interpreter.cc \
+  interpreter/interpreter_cache.cc \
   interpreter/interpreter_common.cc \
   interpreter/interpreter_goto_table_impl.cc \
   interpreter/interpreter_switch_impl.cc \
@@ -196,6 +199,7 @@ LIBART_COMMON_SRC_FILES := \
   verifier/method_verifier.cc \
   verifier/reg_type.cc \
   verifier/reg_type_cache.cc \
+  verifier/verification_cache.cc \
   verifier/register_line.cc \
   well_known_classes.cc \
   zip_archive.cc
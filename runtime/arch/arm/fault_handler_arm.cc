@@ -127,14 +127,14 @@ bool NullPointerHandler::Action(int sig ATTRIBUTE_UNUSED, siginfo_t* info ATTRIB
   return true;
 }
 
-// A suspend check is done using the following instruction sequence:
+// An implicit suspend check is done using the following instruction sequence:
 // 0xf723c0b2: f8d902c0  ldr.w   r0, [r9, #704]  ; suspend_trigger_
-// .. some intervening instruction
 // 0xf723c0b6: 6800      ldr     r0, [r0, #0]
 
 // The offset from r9 is Thread::ThreadSuspendTriggerOffset().
 // To check for a suspend check, we examine the instructions that caused
-// the fault (at PC-4 and PC).
+// the fault (at PC-4 and PC). The compiler emits them back to back, so that a
+// null check on `ldr r0, [r0, #0]` is never mistaken for a suspend check.
 bool SuspensionHandler::Action(int sig ATTRIBUTE_UNUSED, siginfo_t* info ATTRIBUTE_UNUSED,
                                void* context) {
   // These are the instructions to check for.  The first one is the ldr r0,[r9,#xxx]
@@ -155,20 +155,9 @@ bool SuspensionHandler::Action(int sig ATTRIBUTE_UNUSED, siginfo_t* info ATTRIBU
     return false;
   }
 
-  // The first instruction can a little bit up the stream due to load hoisting
-  // in the compiler.
-  uint8_t* limit = ptr1 - 40;   // Compiler will hoist to a max of 20 instructions.
-  bool found = false;
-  while (ptr1 > limit) {
-    uint32_t inst1 = ((ptr1[0] | ptr1[1] << 8) << 16) | (ptr1[2] | ptr1[3] << 8);
-    VLOG(signals) << "inst1: " << std::hex << inst1 << " checkinst1: " << checkinst1;
-    if (inst1 == checkinst1) {
-      found = true;
-      break;
-    }
-    ptr1 -= 2;      // Min instruction size is 2 bytes.
-  }
-  if (found) {
+  uint32_t inst1 = ((ptr1[0] | ptr1[1] << 8) << 16) | (ptr1[2] | ptr1[3] << 8);
+  VLOG(signals) << "inst1: " << std::hex << inst1 << " checkinst1: " << checkinst1;
+  if (inst1 == checkinst1) {
     VLOG(signals) << "suspend check match";
     // This is a suspend check.  Arrange for the signal handler to return to
     // art_quick_implicit_suspend.  Also set LR so that after the suspend check it
@@ -182,9 +171,9 @@ bool SuspensionHandler::Action(int sig ATTRIBUTE_UNUSED, siginfo_t* info ATTRIBU
     sc->arm_lr = sc->arm_pc + 3;      // +2 + 1 (for thumb)
     sc->arm_pc = reinterpret_cast<uintptr_t>(art_quick_implicit_suspend);
 
-    // Now remove the suspend trigger that caused this fault.
-    Thread::Current()->RemoveSuspendTrigger();
-    VLOG(signals) << "removed suspend trigger invoking test suspend";
+    // The trigger stays armed until the pending request has been handled, see
+    // Thread::ModifySuspendCount() and Thread::RunCheckpointFunction().
+    VLOG(signals) << "invoking implicit suspend";
     return true;
   }
   return false;
@@ -110,9 +110,9 @@ bool NullPointerHandler::Action(int sig ATTRIBUTE_UNUSED, siginfo_t* info ATTRIB
 // the fault (at PC-4 and PC).
 bool SuspensionHandler::Action(int sig ATTRIBUTE_UNUSED, siginfo_t* info ATTRIBUTE_UNUSED,
                                void* context) {
-  // These are the instructions to check for.  The first one is the ldr x0,[r18,#xxx]
+  // These are the instructions to check for.  The first one is the ldr x0,[x19,#xxx]
   // where xxx is the offset of the suspend trigger.
-  uint32_t checkinst1 = 0xf9400240 | (Thread::ThreadSuspendTriggerOffset<8>().Int32Value() << 7);
+  uint32_t checkinst1 = 0xf9400260 | (Thread::ThreadSuspendTriggerOffset<8>().Int32Value() << 7);
   uint32_t checkinst2 = 0xf9400000;
 
   struct ucontext *uc = reinterpret_cast<struct ucontext *>(context);
@@ -128,20 +128,11 @@ bool SuspensionHandler::Action(int sig ATTRIBUTE_UNUSED, siginfo_t* info ATTRIBU
     return false;
   }
 
-  // The first instruction can a little bit up the stream due to load hoisting
-  // in the compiler.
-  uint8_t* limit = ptr1 - 80;   // Compiler will hoist to a max of 20 instructions.
-  bool found = false;
-  while (ptr1 > limit) {
-    uint32_t inst1 = *reinterpret_cast<uint32_t*>(ptr1);
-    VLOG(signals) << "inst1: " << std::hex << inst1 << " checkinst1: " << checkinst1;
-    if (inst1 == checkinst1) {
-      found = true;
-      break;
-    }
-    ptr1 -= 4;
-  }
-  if (found) {
+  // The compiler emits both loads back to back, so that a null check on
+  // ldr x0,[x0,#0] is never mistaken for a suspend check.
+  uint32_t inst1 = *reinterpret_cast<uint32_t*>(ptr1);
+  VLOG(signals) << "inst1: " << std::hex << inst1 << " checkinst1: " << checkinst1;
+  if (inst1 == checkinst1) {
     VLOG(signals) << "suspend check match";
     // This is a suspend check.  Arrange for the signal handler to return to
     // art_quick_implicit_suspend.  Also set LR so that after the suspend check it
@@ -151,9 +142,9 @@ bool SuspensionHandler::Action(int sig ATTRIBUTE_UNUSED, siginfo_t* info ATTRIBU
     sc->regs[30] = sc->pc + 4;
     sc->pc = reinterpret_cast<uintptr_t>(art_quick_implicit_suspend);
 
-    // Now remove the suspend trigger that caused this fault.
-    Thread::Current()->RemoveSuspendTrigger();
-    VLOG(signals) << "removed suspend trigger invoking test suspend";
+    // The trigger stays armed until the pending request has been handled, see
+    // Thread::ModifySuspendCount() and Thread::RunCheckpointFunction().
+    VLOG(signals) << "invoking implicit suspend";
     return true;
   }
   return false;
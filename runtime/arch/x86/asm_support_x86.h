@@ -25,4 +25,7 @@
 // 32 bytes for GPRs and 32 bytes for FPRs.
 #define FRAME_SIZE_REFS_AND_ARGS_CALLEE_SAVE (32 + 32)
 
+// 32 bytes for GPRs, 64 bytes for FPRs and 16 bytes for the Method* and padding.
+#define FRAME_SIZE_SAVE_EVERYTHING_CALLEE_SAVE 112
+
 #endif  // ART_RUNTIME_ARCH_X86_ASM_SUPPORT_X86_H_
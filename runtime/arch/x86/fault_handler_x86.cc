@@ -73,12 +73,12 @@ namespace art {
 // mac symbols have a prefix of _ on x86_64
 extern "C" void _art_quick_throw_null_pointer_exception();
 extern "C" void _art_quick_throw_stack_overflow();
-extern "C" void _art_quick_test_suspend();
+extern "C" void _art_quick_implicit_suspend();
 #define EXT_SYM(sym) _ ## sym
 #else
 extern "C" void art_quick_throw_null_pointer_exception();
 extern "C" void art_quick_throw_stack_overflow();
-extern "C" void art_quick_test_suspend();
+extern "C" void art_quick_implicit_suspend();
 #define EXT_SYM(sym) sym
 #endif
 
@@ -319,19 +319,17 @@ bool NullPointerHandler::Action(int, siginfo_t*, void* context) {
   return true;
 }
 
-// A suspend check is done using the following instruction sequence:
+// An implicit suspend check is done using the following instruction sequence:
 // (x86)
 // 0xf720f1df:         648B058C000000      mov     eax, fs:[0x8c]  ; suspend_trigger
-// .. some intervening instructions.
 // 0xf720f1e6:                   8500      test    eax, [eax]
 // (x86_64)
 // 0x7f579de45d9e: 65488B0425A8000000      movq    rax, gs:[0xa8]  ; suspend_trigger
-// .. some intervening instructions.
 // 0x7f579de45da7:               8500      test    eax, [eax]
 
 // The offset from fs is Thread::ThreadSuspendTriggerOffset().
 // To check for a suspend check, we examine the instructions that caused
-// the fault.
+// the fault. The compiler emits them back to back.
 bool SuspensionHandler::Action(int, siginfo_t*, void* context) {
   // These are the instructions to check for.  The first one is the mov eax, fs:[xxx]
   // where xxx is the offset of the suspend trigger.
@@ -361,24 +359,12 @@ bool SuspensionHandler::Action(int, siginfo_t*, void* context) {
     return false;
   }
 
-  // The first instruction can a little bit up the stream due to load hoisting
-  // in the compiler.
-  uint8_t* limit = pc - 100;   // Compiler will hoist to a max of 20 instructions.
   uint8_t* ptr = pc - sizeof(checkinst1);
-  bool found = false;
-  while (ptr > limit) {
-    if (memcmp(ptr, checkinst1, sizeof(checkinst1)) == 0) {
-      found = true;
-      break;
-    }
-    ptr -= 1;
-  }
-
-  if (found) {
+  if (memcmp(ptr, checkinst1, sizeof(checkinst1)) == 0) {
     VLOG(signals) << "suspend check match";
 
-    // We need to arrange for the signal handler to return to the null pointer
-    // exception generator.  The return address must be the address of the
+    // We need to arrange for the signal handler to return to
+    // art_quick_implicit_suspend.  The return address must be the address of the
     // next instruction (this instruction + 2).  The return address
     // is on the stack at the top address of the current frame.
 
@@ -388,11 +374,11 @@ bool SuspensionHandler::Action(int, siginfo_t*, void* context) {
     *next_sp = retaddr;
     uc->CTX_ESP = reinterpret_cast<uintptr_t>(next_sp);
 
-    uc->CTX_EIP = reinterpret_cast<uintptr_t>(EXT_SYM(art_quick_test_suspend));
+    uc->CTX_EIP = reinterpret_cast<uintptr_t>(EXT_SYM(art_quick_implicit_suspend));
 
-    // Now remove the suspend trigger that caused this fault.
-    Thread::Current()->RemoveSuspendTrigger();
-    VLOG(signals) << "removed suspend trigger invoking test suspend";
+    // The trigger stays armed until the pending request has been handled, see
+    // Thread::ModifySuspendCount() and Thread::RunCheckpointFunction().
+    VLOG(signals) << "invoking implicit suspend";
     return true;
   }
   VLOG(signals) << "Not a suspend check match, first instruction mismatch";
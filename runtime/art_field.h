@@ -53,6 +53,10 @@ class ArtField FINAL {
     access_flags_ = new_access_flags;
   }
 
+  static MemberOffset AccessFlagsOffset() {
+    return MemberOffset(OFFSETOF_MEMBER(ArtField, access_flags_));
+  }
+
   bool IsPublic() SHARED_REQUIRES(Locks::mutator_lock_) {
     return (GetAccessFlags() & kAccPublic) != 0;
   }
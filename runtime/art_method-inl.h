@@ -319,6 +319,8 @@ inline const char* ArtMethod::GetName() {
     return "<runtime internal callee-save reference registers method>";
   } else if (this == runtime->GetCalleeSaveMethod(Runtime::kRefsAndArgs)) {
     return "<runtime internal callee-save reference and argument registers method>";
+  } else if (this == runtime->GetCalleeSaveMethod(Runtime::kSaveEverything)) {
+    return "<runtime internal callee-save everything method>";
   } else {
     return "<unknown runtime internal method>";
   }
@@ -348,6 +348,12 @@ class ArtMethod FINAL {
     return (GetAccessFlags() & mask) == mask;
   }
 
+  // A critical native is always also a fast native, see ClassLinker::LoadMethod.
+  bool IsCriticalNative() {
+    constexpr uint32_t mask = kAccCriticalNative | kAccNative;
+    return (GetAccessFlags() & mask) == mask;
+  }
+
   bool IsAbstract() {
     return (GetAccessFlags() & kAccAbstract) != 0;
   }
@@ -18,6 +18,7 @@
 #define ART_RUNTIME_ASM_SUPPORT_H_
 
 #if defined(__cplusplus)
+#include "art_field.h"
 #include "art_method.h"
 #include "gc/allocator/rosalloc.h"
 #include "jit/jit.h"
@@ -92,6 +93,11 @@ ADD_TEST_EQ(static_cast<size_t>(RUNTIME_REFS_ONLY_CALLEE_SAVE_FRAME_OFFSET),
 ADD_TEST_EQ(static_cast<size_t>(RUNTIME_REFS_AND_ARGS_CALLEE_SAVE_FRAME_OFFSET),
             art::Runtime::GetCalleeSaveMethodOffset(art::Runtime::kRefsAndArgs))
 
+// Offset of field Runtime::callee_save_methods_[kSaveEverything]
+#define RUNTIME_SAVE_EVERYTHING_CALLEE_SAVE_FRAME_OFFSET (3 * 8)
+ADD_TEST_EQ(static_cast<size_t>(RUNTIME_SAVE_EVERYTHING_CALLEE_SAVE_FRAME_OFFSET),
+            art::Runtime::GetCalleeSaveMethodOffset(art::Runtime::kSaveEverything))
+
 // Offset of field Thread::tls32_.state_and_flags.
 #define THREAD_FLAGS_OFFSET 0
 ADD_TEST_EQ(THREAD_FLAGS_OFFSET,
@@ -107,8 +113,13 @@ ADD_TEST_EQ(THREAD_ID_OFFSET,
 ADD_TEST_EQ(THREAD_IS_GC_MARKING_OFFSET,
             art::Thread::IsGcMarkingOffset<__SIZEOF_POINTER__>().Int32Value())
 
+// Offset of field Thread::tls32_.bias_locks.
+#define THREAD_BIAS_LOCKS_OFFSET 64
+ADD_TEST_EQ(THREAD_BIAS_LOCKS_OFFSET,
+            art::Thread::BiasLocksOffset<__SIZEOF_POINTER__>().Int32Value())
+
 // Offset of field Thread::tlsPtr_.card_table.
-#define THREAD_CARD_TABLE_OFFSET 128
+#define THREAD_CARD_TABLE_OFFSET 136
 ADD_TEST_EQ(THREAD_CARD_TABLE_OFFSET,
             art::Thread::CardTableOffset<__SIZEOF_POINTER__>().Int32Value())
 
@@ -167,6 +178,16 @@ ADD_TEST_EQ(THREAD_LOCAL_ALLOC_STACK_TOP_OFFSET,
 #define THREAD_LOCAL_ALLOC_STACK_END_OFFSET (THREAD_ROSALLOC_RUNS_OFFSET + 17 * __SIZEOF_POINTER__)
 ADD_TEST_EQ(THREAD_LOCAL_ALLOC_STACK_END_OFFSET,
             art::Thread::ThreadLocalAllocStackEndOffset<__SIZEOF_POINTER__>().Int32Value())
+// Offset of field Thread::tlsPtr_.interpreter_cache.
+#define THREAD_INTERPRETER_CACHE_OFFSET (THREAD_ROSALLOC_RUNS_OFFSET + 18 * __SIZEOF_POINTER__)
+ADD_TEST_EQ(THREAD_INTERPRETER_CACHE_OFFSET,
+            art::Thread::InterpreterCacheOffset<__SIZEOF_POINTER__>().Int32Value())
+
+// Number of entries in the interpreter cache. An entry holds two pointers, the address of the
+// dex instruction and its value, and is at index (dex_pc_ptr >> 1) & (size - 1).
+#define INTERPRETER_CACHE_SIZE_LOG2 8
+ADD_TEST_EQ(static_cast<size_t>(1U << INTERPRETER_CACHE_SIZE_LOG2),
+            art::InterpreterCache::kSize)
 
 // Offsets within ShadowFrame.
 #define SHADOWFRAME_LINK_OFFSET 0
@@ -245,6 +266,10 @@ ADD_TEST_EQ(static_cast<uint32_t>(ACCESS_FLAGS_CLASS_IS_FINALIZABLE),
 ADD_TEST_EQ(static_cast<uint32_t>(ACCESS_FLAGS_CLASS_IS_FINALIZABLE),
             static_cast<uint32_t>(1U << ACCESS_FLAGS_CLASS_IS_FINALIZABLE_BIT))
 
+#define ACCESS_FLAGS_CLASS_BIASED_LOCKING_REVOKED 0x10000000
+ADD_TEST_EQ(static_cast<uint32_t>(ACCESS_FLAGS_CLASS_BIASED_LOCKING_REVOKED),
+            static_cast<uint32_t>(art::kAccBiasedLockingRevoked))
+
 // Array offsets.
 #define MIRROR_ARRAY_LENGTH_OFFSET      MIRROR_OBJECT_HEADER_SIZE
 ADD_TEST_EQ(MIRROR_ARRAY_LENGTH_OFFSET, art::mirror::Array::LengthOffset().Int32Value())
@@ -326,6 +351,16 @@ ADD_TEST_EQ(ART_METHOD_QUICK_CODE_OFFSET_32,
 ADD_TEST_EQ(ART_METHOD_QUICK_CODE_OFFSET_64,
             art::ArtMethod::EntryPointFromQuickCompiledCodeOffset(8).Int32Value())
 
+// Offsets within art::ArtField.
+#define ART_FIELD_ACCESS_FLAGS_OFFSET 4
+ADD_TEST_EQ(ART_FIELD_ACCESS_FLAGS_OFFSET, art::ArtField::AccessFlagsOffset().Int32Value())
+
+#define ART_FIELD_OFFSET_OFFSET 12
+ADD_TEST_EQ(ART_FIELD_OFFSET_OFFSET, art::ArtField::OffsetOffset().Int32Value())
+
+#define ACCESS_FLAGS_VOLATILE 0x0040
+ADD_TEST_EQ(static_cast<uint32_t>(ACCESS_FLAGS_VOLATILE), static_cast<uint32_t>(art::kAccVolatile))
+
 #define LOCK_WORD_STATE_SHIFT 30
 ADD_TEST_EQ(LOCK_WORD_STATE_SHIFT, static_cast<int32_t>(art::LockWord::kStateShift))
 
@@ -347,6 +382,20 @@ ADD_TEST_EQ(LOCK_WORD_READ_BARRIER_STATE_MASK_TOGGLED,
 #define LOCK_WORD_THIN_LOCK_COUNT_ONE 65536
 ADD_TEST_EQ(LOCK_WORD_THIN_LOCK_COUNT_ONE, static_cast<int32_t>(art::LockWord::kThinLockCountOne))
 
+#define LOCK_WORD_THIN_LOCK_COUNT_SHIFT 16
+ADD_TEST_EQ(LOCK_WORD_THIN_LOCK_COUNT_SHIFT,
+            static_cast<int32_t>(art::LockWord::kThinLockCountShift))
+
+#define LOCK_WORD_THIN_LOCK_COUNT_SIZE 11
+ADD_TEST_EQ(LOCK_WORD_THIN_LOCK_COUNT_SIZE, static_cast<int32_t>(art::LockWord::kThinLockCountSize))
+
+#define LOCK_WORD_THIN_LOCK_COUNT_MASK_SHIFTED 0x07FF0000
+ADD_TEST_EQ(LOCK_WORD_THIN_LOCK_COUNT_MASK_SHIFTED,
+            static_cast<int32_t>(art::LockWord::kThinLockCountMaskShifted))
+
+#define LOCK_WORD_BIASED_FLAG 0x08000000
+ADD_TEST_EQ(LOCK_WORD_BIASED_FLAG, static_cast<int32_t>(art::LockWord::kBiasedFlag))
+
 #define OBJECT_ALIGNMENT_MASK 7
 ADD_TEST_EQ(static_cast<size_t>(OBJECT_ALIGNMENT_MASK), art::kObjectAlignment - 1)
 
@@ -0,0 +1,30 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "published_hash_sets.h"
+
+#include "runtime.h"
+#include "thread_list.h"
+
+namespace art {
+
+uint64_t PublishedHashSetsBase::GetSuspendAllEpoch() {
+  Runtime* const runtime = Runtime::Current();
+  ThreadList* const thread_list = runtime != nullptr ? runtime->GetThreadList() : nullptr;
+  return thread_list != nullptr ? thread_list->GetSuspendAllEpoch() : 0u;
+}
+
+}  // namespace art
@@ -0,0 +1,193 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_BASE_PUBLISHED_HASH_SETS_H_
+#define ART_RUNTIME_BASE_PUBLISHED_HASH_SETS_H_
+
+#include <stdint.h>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "atomic.h"
+#include "base/logging.h"
+#include "base/macros.h"
+
+namespace art {
+
+class PublishedHashSetsBase {
+ protected:
+  // Returns the number of completed suspend alls, or 0 without a thread list, in which case
+  // nothing is freed before the sets are deleted.
+  static uint64_t GetSuspendAllEpoch();
+};
+
+// A list of hash sets that lookups may search without holding the lock that guards the list.
+//
+// The sets are never resized in place: a full set is replaced with a larger copy, and an array of
+// the sets is republished whenever the list changes. Replaced sets and arrays are freed once all
+// threads have been suspended after their replacement, since lookups run with the mutator lock
+// held and cannot span a suspension. Erasing may move other elements within their set, so a lookup
+// that misses while an erase is in progress has to search again with the lock held.
+//
+// All functions but FindWithoutLock must be called with the owner's lock held.
+template <class Set>
+class PublishedHashSets : private PublishedHashSetsBase {
+ public:
+  typedef typename Set::value_type ValueType;
+  typedef std::vector<std::unique_ptr<Set>> SetVector;
+
+  explicit PublishedHashSets(Set* initial_set)
+      : published_sets_(nullptr), erase_sequence_(0u) {
+    sets_.emplace_back(initial_set);
+    published_sets_.StoreRelaxed(new SetArray(1u, initial_set));
+  }
+
+  ~PublishedHashSets() {
+    delete published_sets_.LoadRelaxed();
+  }
+
+  // The sets, in lookup order.
+  const SetVector& GetSets() const {
+    return sets_;
+  }
+
+  void AddFront(Set* set) {
+    sets_.emplace(sets_.begin(), set);
+    Publish();
+  }
+
+  void AddBack(Set* set) {
+    sets_.emplace_back(set);
+    Publish();
+  }
+
+  // Insert into the last set.
+  void Insert(const ValueType& element) {
+    Set* const last = GetLastSetWithRoom();
+    // Make the element visible to lookups that find it without the lock.
+    QuasiAtomic::ThreadFenceRelease();
+    last->Insert(element);
+  }
+
+  void InsertWithHash(const ValueType& element, size_t hash) {
+    Set* const last = GetLastSetWithRoom();
+    QuasiAtomic::ThreadFenceRelease();
+    last->InsertWithHash(element, hash);
+  }
+
+  // Call around erasing elements from the sets.
+  void StartErase() {
+    erase_sequence_.FetchAndAddSequentiallyConsistent(1u);
+  }
+
+  void FinishErase() {
+    erase_sequence_.FetchAndAddSequentiallyConsistent(1u);
+  }
+
+  // Sets `result` to the first element matching `key` in the published sets, or to an empty
+  // element if there is none. Returns false if an erase may have moved the element while
+  // searching, in which case the caller searches again with the lock held.
+  template <typename Key>
+  bool FindWithoutLock(const Key& key, size_t hash, /*out*/ ValueType* result) const {
+    const uint32_t erase_sequence = erase_sequence_.LoadAcquire();
+    if (UNLIKELY((erase_sequence & 1u) != 0u)) {
+      return false;
+    }
+    for (Set* set : *published_sets_.LoadAcquire()) {
+      auto it = set->FindWithHash(key, hash);
+      if (it != set->end()) {
+        *result = *it;
+        return true;
+      }
+    }
+    *result = ValueType();
+    QuasiAtomic::ThreadFenceAcquire();
+    return erase_sequence_.LoadRelaxed() == erase_sequence;
+  }
+
+  // Returns the number of replaced sets that are not freed yet.
+  size_t NumRetiredSets() const {
+    return retired_sets_.size();
+  }
+
+ private:
+  typedef std::vector<Set*> SetArray;
+
+  // Returns the last set, after replacing it with a larger copy if inserting would resize it.
+  Set* GetLastSetWithRoom() {
+    std::unique_ptr<Set>& last = sets_.back();
+    if (last->Size() < last->ElementsUntilExpand()) {
+      return last.get();
+    }
+    // Grow like HashSet::Expand, but into a new set so that lookups can keep reading the old one.
+    std::unique_ptr<Set> grown(new Set(last->GetMinLoadFactor(), last->GetMaxLoadFactor()));
+    grown->Reserve(
+        static_cast<size_t>(last->Size() * last->GetMaxLoadFactor() / last->GetMinLoadFactor()));
+    for (const ValueType& element : *last) {
+      grown->Insert(element);
+    }
+    last.swap(grown);
+    retired_sets_.emplace_back(GetSuspendAllEpoch(), std::move(grown));
+    Publish();
+    FreeRetired();
+    DCHECK_LT(last->Size(), last->ElementsUntilExpand());
+    return last.get();
+  }
+
+  void Publish() {
+    SetArray* const sets = new SetArray();
+    for (const std::unique_ptr<Set>& set : sets_) {
+      sets->push_back(set.get());
+    }
+    const SetArray* const old_sets = published_sets_.LoadRelaxed();
+    published_sets_.StoreRelease(sets);
+    retired_arrays_.emplace_back(GetSuspendAllEpoch(), std::unique_ptr<const SetArray>(old_sets));
+  }
+
+  // Free the sets and arrays that no lookup can still be reading.
+  void FreeRetired() {
+    // Nothing retired before the latest suspend all can still be read. Entries are in retirement
+    // order.
+    const uint64_t epoch = GetSuspendAllEpoch();
+    auto retired_sets_end = retired_sets_.begin();
+    while (retired_sets_end != retired_sets_.end() && retired_sets_end->first < epoch) {
+      ++retired_sets_end;
+    }
+    retired_sets_.erase(retired_sets_.begin(), retired_sets_end);
+    auto retired_arrays_end = retired_arrays_.begin();
+    while (retired_arrays_end != retired_arrays_.end() && retired_arrays_end->first < epoch) {
+      ++retired_arrays_end;
+    }
+    retired_arrays_.erase(retired_arrays_.begin(), retired_arrays_end);
+  }
+
+  SetVector sets_;
+  // The sets of sets_, for lookups without the lock.
+  Atomic<const SetArray*> published_sets_;
+  // Odd while elements are being erased.
+  Atomic<uint32_t> erase_sequence_;
+  // Sets and arrays that lookups may still be reading, with the suspend all epoch at which they
+  // were replaced.
+  std::vector<std::pair<uint64_t, std::unique_ptr<Set>>> retired_sets_;
+  std::vector<std::pair<uint64_t, std::unique_ptr<const SetArray>>> retired_arrays_;
+
+  DISALLOW_COPY_AND_ASSIGN(PublishedHashSets);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_BASE_PUBLISHED_HASH_SETS_H_
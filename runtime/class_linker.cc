@@ -41,6 +41,7 @@
 #include "base/unix_file/fd_file.h"
 #include "base/value_object.h"
 #include "class_linker-inl.h"
+#include "class_path_index.h"
 #include "class_table-inl.h"
 #include "compiler_callbacks.h"
 #include "debugger.h"
@@ -58,6 +59,7 @@
 #include "image-inl.h"
 #include "intern_table.h"
 #include "interpreter/interpreter.h"
+#include "interpreter/interpreter_cache.h"
 #include "jit/jit.h"
 #include "jit/jit_code_cache.h"
 #include "jit/offline_profiling_info.h"
@@ -76,6 +78,7 @@
 #include "mirror/reference-inl.h"
 #include "mirror/stack_trace_element.h"
 #include "mirror/string-inl.h"
+#include "monitor.h"
 #include "native/dalvik_system_DexFile.h"
 #include "oat.h"
 #include "oat_file.h"
@@ -88,10 +91,12 @@
 #include "ScopedLocalRef.h"
 #include "scoped_thread_state_change.h"
 #include "thread-inl.h"
+#include "thread_list.h"
 #include "trace.h"
 #include "utils.h"
 #include "utils/dex_cache_arrays_layout-inl.h"
 #include "verifier/method_verifier.h"
+#include "verifier/verification_cache.h"
 #include "well_known_classes.h"
 
 namespace art {
@@ -741,6 +746,10 @@ void ClassLinker::FinishInit(Thread* self) {
 
   CHECK(!array_iftable_.IsNull());
 
+  // Class objects are locked by any thread initializing or linking them, never bias their locks.
+  // The art_quick_lock_object fast paths only check the access flags of the class.
+  GetClassRoot(kJavaLangClass)->SetBiasedLockingRevoked();
+
   // disable the slow paths in FindClass and CreatePrimitiveClass now
   // that Object, Class, and Object[] are setup
   init_done_ = true;
@@ -1274,7 +1283,7 @@ bool ClassLinker::UpdateAppImageClassLoadersAndDexCaches(
       // If the oat file expects the dex cache arrays to be in the BSS, then allocate there and
         // copy over the arrays.
         DCHECK(dex_file != nullptr);
-        const size_t num_strings = dex_file->NumStringIds();
+        const size_t num_strings = mirror::DexCache::StringsArraySize(dex_file->NumStringIds());
         const size_t num_types = dex_file->NumTypeIds();
         const size_t num_methods = dex_file->NumMethodIds();
         const size_t num_fields = dex_file->NumFieldIds();
@@ -1287,13 +1296,14 @@ bool ClassLinker::UpdateAppImageClassLoadersAndDexCaches(
         // The space is not yet visible to the GC, we can avoid the read barriers and use
         // std::copy_n.
         if (num_strings != 0u) {
-          GcRoot<mirror::String>* const image_resolved_strings = dex_cache->GetStrings();
-          GcRoot<mirror::String>* const strings =
-              reinterpret_cast<GcRoot<mirror::String>*>(raw_arrays + layout.StringsOffset());
+          mirror::StringDexCacheType* const image_resolved_strings = dex_cache->GetStrings();
+          mirror::StringDexCacheType* const strings =
+              reinterpret_cast<mirror::StringDexCacheType*>(raw_arrays + layout.StringsOffset());
           for (size_t j = 0; kIsDebugBuild && j < num_strings; ++j) {
-            DCHECK(strings[j].IsNull());
+            DCHECK(mirror::StringDexCachePair::ReadSlot<kWithoutReadBarrier>(strings, j) ==
+                   nullptr);
           }
-          std::copy_n(image_resolved_strings, num_strings, strings);
+          mirror::StringDexCachePair::CopySlots(image_resolved_strings, strings, num_strings);
           dex_cache->SetStrings(strings);
         }
         if (num_types != 0u) {
@@ -1476,14 +1486,14 @@ class UpdateClassLoaderAndResolvedStringsVisitor {
 
   bool operator()(mirror::Class* klass) const SHARED_REQUIRES(Locks::mutator_lock_) {
     if (forward_strings_) {
-      GcRoot<mirror::String>* strings = klass->GetDexCacheStrings();
+      mirror::StringDexCacheType* strings = klass->GetDexCacheStrings();
       if (strings != nullptr) {
         DCHECK(
             space_->GetImageHeader().GetImageSection(ImageHeader::kSectionDexCacheArrays).Contains(
                 reinterpret_cast<uint8_t*>(strings) - space_->Begin()))
             << "String dex cache array for " << PrettyClass(klass) << " is not in app image";
         // Dex caches have already been updated, so take the strings pointer from there.
-        GcRoot<mirror::String>* new_strings = klass->GetDexCache()->GetStrings();
+        mirror::StringDexCacheType* new_strings = klass->GetDexCache()->GetStrings();
         DCHECK_NE(strings, new_strings);
         klass->SetDexCacheStrings(new_strings);
       }
@@ -2049,6 +2059,8 @@ void ClassLinker::DeleteClassLoader(Thread* self, const ClassLoaderData& data) {
       code_cache->RemoveMethodsIn(self, *data.allocator);
     }
   }
+  Monitor::RemoveContentionSitesIn(self, *data.allocator);
+  Runtime::Current()->GetThreadList()->RemoveSafepointSitesIn(self, *data.allocator);
   delete data.allocator;
   delete data.class_table;
 }
@@ -2086,8 +2098,9 @@ mirror::DexCache* ClassLinker::AllocDexCache(Thread* self,
     // Zero-initialized.
     raw_arrays = reinterpret_cast<uint8_t*>(linear_alloc->Alloc(self, layout.Size()));
   }
-  GcRoot<mirror::String>* strings = (dex_file.NumStringIds() == 0u) ? nullptr :
-      reinterpret_cast<GcRoot<mirror::String>*>(raw_arrays + layout.StringsOffset());
+  const size_t num_strings = mirror::DexCache::StringsArraySize(dex_file.NumStringIds());
+  mirror::StringDexCacheType* strings = (num_strings == 0u) ? nullptr :
+      reinterpret_cast<mirror::StringDexCacheType*>(raw_arrays + layout.StringsOffset());
   GcRoot<mirror::Class>* types = (dex_file.NumTypeIds() == 0u) ? nullptr :
       reinterpret_cast<GcRoot<mirror::Class>*>(raw_arrays + layout.TypesOffset());
   ArtMethod** methods = (dex_file.NumMethodIds() == 0u) ? nullptr :
@@ -2096,8 +2109,8 @@ mirror::DexCache* ClassLinker::AllocDexCache(Thread* self,
       reinterpret_cast<ArtField**>(raw_arrays + layout.FieldsOffset());
   if (kIsDebugBuild) {
     // Sanity check to make sure all the dex cache arrays are empty. b/28992179
-    for (size_t i = 0; i < dex_file.NumStringIds(); ++i) {
-      CHECK(strings[i].Read<kWithoutReadBarrier>() == nullptr);
+    for (size_t i = 0; i < num_strings; ++i) {
+      CHECK(mirror::StringDexCachePair::ReadSlot<kWithoutReadBarrier>(strings, i) == nullptr);
     }
     for (size_t i = 0; i < dex_file.NumTypeIds(); ++i) {
       CHECK(types[i].Read<kWithoutReadBarrier>() == nullptr);
@@ -2112,7 +2125,7 @@ mirror::DexCache* ClassLinker::AllocDexCache(Thread* self,
   dex_cache->Init(&dex_file,
                   location.Get(),
                   strings,
-                  dex_file.NumStringIds(),
+                  num_strings,
                   types,
                   dex_file.NumTypeIds(),
                   methods,
@@ -2224,6 +2237,9 @@ mirror::Class* ClassLinker::EnsureResolved(Thread* self,
 
 typedef std::pair<const DexFile*, const DexFile::ClassDef*> ClassPathEntry;
 
+// Class paths with fewer dex files are searched one dex file at a time.
+static constexpr size_t kMinDexFilesForClassPathIndex = 4;
+
 // Search a collection of DexFiles for a descriptor
 ClassPathEntry FindInClassPath(const char* descriptor,
                                size_t hash, const std::vector<const DexFile*>& class_path) {
@@ -2236,6 +2252,67 @@ ClassPathEntry FindInClassPath(const char* descriptor,
   return ClassPathEntry(nullptr, nullptr);
 }
 
+void ClassLinker::FindInDexElements(ScopedObjectAccessAlreadyRunnable& soa,
+                                    Thread* self,
+                                    Handle<mirror::ClassLoader> class_loader,
+                                    Handle<mirror::ObjectArray<mirror::Object>> dex_elements,
+                                    const char* descriptor,
+                                    size_t hash,
+                                    /*out*/ const DexFile** dex_file,
+                                    /*out*/ const DexFile::ClassDef** class_def) {
+  ClassTable* class_table = ClassTableForClassLoader(class_loader.Get());
+  if (class_table != nullptr &&
+      class_table->FindInClassPath(dex_elements.Get(), descriptor, hash, dex_file, class_def)) {
+    return;
+  }
+  // Loop through each dalvik.system.DexPathList$Element's dalvik.system.DexFile and look
+  // at the mCookie which is a DexFile vector.
+  ArtField* const cookie_field = soa.DecodeField(WellKnownClasses::dalvik_system_DexFile_cookie);
+  ArtField* const dex_file_field =
+      soa.DecodeField(WellKnownClasses::dalvik_system_DexPathList__Element_dexFile);
+  std::vector<const DexFile*> dex_files;
+  for (int32_t i = 0; i < dex_elements->GetLength(); ++i) {
+    mirror::Object* element = dex_elements->GetWithoutChecks(i);
+    if (element == nullptr) {
+      // Should never happen, fall back to java code to throw a NPE.
+      break;
+    }
+    mirror::Object* java_dex_file = dex_file_field->GetObject(element);
+    if (java_dex_file != nullptr) {
+      mirror::LongArray* long_array = cookie_field->GetObject(java_dex_file)->AsLongArray();
+      if (long_array == nullptr) {
+        // This should never happen so log a warning.
+        LOG(WARNING) << "Null DexFile::mCookie for " << descriptor;
+        break;
+      }
+      int32_t long_array_size = long_array->GetLength();
+      // First element is the oat file.
+      for (int32_t j = kDexFileIndexStart; j < long_array_size; ++j) {
+        dex_files.push_back(reinterpret_cast<const DexFile*>(static_cast<uintptr_t>(
+            long_array->GetWithoutChecks(j))));
+      }
+    }
+  }
+  if (dex_files.size() < kMinDexFilesForClassPathIndex) {
+    ClassPathEntry pair = FindInClassPath(descriptor, hash, dex_files);
+    *dex_file = pair.first;
+    *class_def = pair.second;
+    return;
+  }
+  // Index the class path so that the next lookups, which often fail at this level of the class
+  // loader chain, take a single hash lookup instead of one per dex file.
+  std::unique_ptr<ClassPathIndex> index(new ClassPathIndex(dex_files));
+  if (!index->Find(descriptor, hash, dex_file, class_def)) {
+    *dex_file = nullptr;
+    *class_def = nullptr;
+  }
+  if (class_table == nullptr) {
+    WriterMutexLock mu(self, *Locks::classlinker_classes_lock_);
+    class_table = InsertClassTableForClassLoader(class_loader.Get());
+  }
+  class_table->SetClassPathIndex(dex_elements.Get(), std::move(index));
+}
+
 bool ClassLinker::FindClassInPathClassLoader(ScopedObjectAccessAlreadyRunnable& soa,
                                              Thread* self,
                                              const char* descriptor,
@@ -2276,7 +2353,7 @@ bool ClassLinker::FindClassInPathClassLoader(ScopedObjectAccessAlreadyRunnable&
   }
 
   // Handles as RegisterDexFile may allocate dex caches (and cause thread suspension).
-  StackHandleScope<4> hs(self);
+  StackHandleScope<2> hs(self);
   Handle<mirror::ClassLoader> h_parent(hs.NewHandle(class_loader->GetParent()));
   bool recursive_result = FindClassInPathClassLoader(soa, self, descriptor, hash, h_parent, result);
 
@@ -2305,49 +2382,34 @@ bool ClassLinker::FindClassInPathClassLoader(ScopedObjectAccessAlreadyRunnable&
     mirror::Object* dex_elements_obj =
         soa.DecodeField(WellKnownClasses::dalvik_system_DexPathList_dexElements)->
         GetObject(dex_path_list);
-    // Loop through each dalvik.system.DexPathList$Element's dalvik.system.DexFile and look
-    // at the mCookie which is a DexFile vector.
     if (dex_elements_obj != nullptr) {
       Handle<mirror::ObjectArray<mirror::Object>> dex_elements =
           hs.NewHandle(dex_elements_obj->AsObjectArray<mirror::Object>());
-      for (int32_t i = 0; i < dex_elements->GetLength(); ++i) {
-        mirror::Object* element = dex_elements->GetWithoutChecks(i);
-        if (element == nullptr) {
-          // Should never happen, fall back to java code to throw a NPE.
-          break;
-        }
-        mirror::Object* dex_file = dex_file_field->GetObject(element);
-        if (dex_file != nullptr) {
-          mirror::LongArray* long_array = cookie_field->GetObject(dex_file)->AsLongArray();
-          if (long_array == nullptr) {
-            // This should never happen so log a warning.
-            LOG(WARNING) << "Null DexFile::mCookie for " << descriptor;
-            break;
-          }
-          int32_t long_array_size = long_array->GetLength();
-          // First element is the oat file.
-          for (int32_t j = kDexFileIndexStart; j < long_array_size; ++j) {
-            const DexFile* cp_dex_file = reinterpret_cast<const DexFile*>(static_cast<uintptr_t>(
-                long_array->GetWithoutChecks(j)));
-            const DexFile::ClassDef* dex_class_def = cp_dex_file->FindClassDef(descriptor, hash);
-            if (dex_class_def != nullptr) {
-              mirror::Class* klass = DefineClass(self,
-                                                 descriptor,
-                                                 hash,
-                                                 class_loader,
-                                                 *cp_dex_file,
-                                                 *dex_class_def);
-              if (klass == nullptr) {
-                CHECK(self->IsExceptionPending()) << descriptor;
-                self->ClearException();
-                // TODO: Is it really right to break here, and not check the other dex files?
-                return true;
-              }
-              *result = klass;
-              return true;
-            }
-          }
+      const DexFile* cp_dex_file = nullptr;
+      const DexFile::ClassDef* dex_class_def = nullptr;
+      FindInDexElements(soa,
+                        self,
+                        class_loader,
+                        dex_elements,
+                        descriptor,
+                        hash,
+                        &cp_dex_file,
+                        &dex_class_def);
+      if (dex_class_def != nullptr) {
+        mirror::Class* klass = DefineClass(self,
+                                           descriptor,
+                                           hash,
+                                           class_loader,
+                                           *cp_dex_file,
+                                           *dex_class_def);
+        if (klass == nullptr) {
+          CHECK(self->IsExceptionPending()) << descriptor;
+          self->ClearException();
+          // TODO: Is it really right to break here, and not check the other dex files?
+          return true;
         }
+        *result = klass;
+        return true;
       }
     }
     self->AssertNoPendingException();
@@ -2583,6 +2645,10 @@ mirror::Class* ClassLinker::DefineClass(Thread* self,
   // Notify native debugger of the new class and its layout.
   jit::Jit::NewTypeLoadedIfUsingJit(h_new_class.Get());
 
+  // The class loader can now find the classes of the dex file, let their background
+  // verification go on.
+  Runtime::Current()->GetOatFileManager().OnClassDefined(self, h_new_class);
+
   return h_new_class.Get();
 }
 
@@ -3184,6 +3250,12 @@ void ClassLinker::LoadMethod(Thread* self,
       }
     }
   }
+  if (UNLIKELY((access_flags & kAccNative) != 0u)) {
+    // Pick up @FastNative and @CriticalNative so that neither the JNI stubs nor the generic JNI
+    // trampoline transition out of Runnable for these methods.
+    access_flags |= dex_file.GetNativeMethodAnnotationAccessFlags(
+        dex_file.GetClassDef(klass->GetDexClassDefIndex()), dex_method_idx, access_flags);
+  }
   dst->SetAccessFlags(access_flags);
 }
 
@@ -3617,18 +3689,16 @@ bool ClassLinker::RemoveClass(const char* descriptor, mirror::ClassLoader* class
   return class_table != nullptr && class_table->Remove(descriptor);
 }
 
-mirror::Class* ClassLinker::LookupClass(Thread* self,
+mirror::Class* ClassLinker::LookupClass(Thread* self ATTRIBUTE_UNUSED,
                                         const char* descriptor,
                                         size_t hash,
                                         mirror::ClassLoader* class_loader) {
-  {
-    ReaderMutexLock mu(self, *Locks::classlinker_classes_lock_);
-    ClassTable* const class_table = ClassTableForClassLoader(class_loader);
-    if (class_table != nullptr) {
-      mirror::Class* result = class_table->Lookup(descriptor, hash);
-      if (result != nullptr) {
-        return result;
-      }
+  // Class tables are only deleted with their class loader, and do their own synchronization.
+  ClassTable* const class_table = ClassTableForClassLoader(class_loader);
+  if (class_table != nullptr) {
+    mirror::Class* result = class_table->Lookup(descriptor, hash);
+    if (result != nullptr) {
+      return result;
     }
   }
   if (class_loader != nullptr || !dex_cache_boot_image_class_lookup_required_) {
@@ -3937,6 +4007,13 @@ void ClassLinker::VerifyClass(Thread* self, Handle<mirror::Class> klass, LogSeve
   // precise error message. To ensure a rerun, test:
   //     oat_file_class_status == mirror::Class::kStatusError => !preverified
   DCHECK(!(oat_file_class_status == mirror::Class::kStatusError) || !preverified);
+  // Otherwise try the results of verifying the class in a previous run.
+  verifier::VerificationCache* verification_cache = nullptr;
+  if (!preverified && oat_file_class_status != mirror::Class::kStatusError) {
+    verification_cache = GetVerificationCache(dex_file, klass.Get());
+    preverified = verification_cache != nullptr &&
+        verification_cache->IsVerified(klass->GetDexClassDefIndex());
+  }
 
   verifier::MethodVerifier::FailureKind verifier_failure = verifier::MethodVerifier::kNoFailure;
   std::string error_msg;
@@ -3973,6 +4050,11 @@ void ClassLinker::VerifyClass(Thread* self, Handle<mirror::Class> klass, LogSeve
         // Pretend a soft failure occurred so that we don't consider the class verified below.
         verifier_failure = verifier::MethodVerifier::kSoftFailure;
       }
+      if (!preverified &&
+          verifier_failure == verifier::MethodVerifier::kNoFailure &&
+          verification_cache != nullptr) {
+        verification_cache->RecordVerified(klass->GetDexClassDefIndex());
+      }
     } else {
       CHECK_EQ(verifier_failure, verifier::MethodVerifier::kSoftFailure);
       // Soft failures at compile time should be retried at runtime. Soft
@@ -4020,6 +4102,29 @@ void ClassLinker::EnsureSkipAccessChecksMethods(Handle<mirror::Class> klass) {
   }
 }
 
+verifier::VerificationCache* ClassLinker::GetVerificationCache(const DexFile& dex_file,
+                                                               mirror::Class* klass) {
+  verifier::VerificationCache* const cache = dex_file.GetVerificationCache();
+  // Like for oat files without an image, re-verify the classes to initialize the dex caches.
+  if (cache == nullptr ||
+      Runtime::Current()->IsAotCompiler() ||
+      !Runtime::Current()->GetHeap()->HasBootImageSpace() ||
+      klass->GetClassLoader() == nullptr) {
+    return nullptr;
+  }
+  if (cache->NeedsClassPathChecksum()) {
+    // Computed on first use, once the class loader has been fully constructed.
+    uint32_t class_path_checksum;
+    if (Runtime::Current()->GetOatFileManager().ComputeClassPathChecksum(
+            klass->GetClassLoader(), &class_path_checksum)) {
+      cache->SetClassPathChecksum(class_path_checksum);
+    } else {
+      cache->SetClassPathUnsupported();
+    }
+  }
+  return cache;
+}
+
 bool ClassLinker::VerifyClassUsingOatFile(const DexFile& dex_file,
                                           mirror::Class* klass,
                                           mirror::Class::Status& oat_file_class_status) {
@@ -5057,6 +5162,8 @@ void ClassLinker::RegisterClassLoader(mirror::ClassLoader* class_loader) {
   data.weak_root = self->GetJniEnv()->vm->AddWeakGlobalRef(self, class_loader);
   // Create and set the class table.
   data.class_table = new ClassTable;
+  // Lookups may read the class table without holding the class linker classes lock.
+  QuasiAtomic::ThreadFenceRelease();
   class_loader->SetClassTable(data.class_table);
   // Create and set the linear allocator.
   data.allocator = Runtime::Current()->CreateLinearAlloc();
@@ -8262,6 +8369,10 @@ void ClassLinker::CleanupClassLoaders() {
       }
     }
   }
+  if (!to_delete.empty()) {
+    // Interpreter caches may hold fields and methods of the unloaded classes.
+    InterpreterCache::InvalidateAll();
+  }
   for (ClassLoaderData& data : to_delete) {
     DeleteClassLoader(self, data);
   }
@@ -48,10 +48,14 @@ namespace mirror {
   class DexCache;
   class DexCachePointerArray;
   class DexCacheTest_Open_Test;
+  class DexCacheTest_StringCacheEviction_Test;
   class IfTable;
   template<class T> class ObjectArray;
   class StackTraceElement;
 }  // namespace mirror
+namespace verifier {
+  class VerificationCache;
+}  // namespace verifier
 
 class ImtConflictTable;
 template<class T> class Handle;
@@ -467,6 +471,9 @@ class ClassLinker {
                                mirror::Class::Status& oat_file_class_status)
       SHARED_REQUIRES(Locks::mutator_lock_)
       REQUIRES(!dex_lock_);
+  // Returns the verification cache of `dex_file` if it can be used for `klass`, null otherwise.
+  verifier::VerificationCache* GetVerificationCache(const DexFile& dex_file, mirror::Class* klass)
+      SHARED_REQUIRES(Locks::mutator_lock_);
   void ResolveClassExceptionHandlerTypes(Handle<mirror::Class> klass)
       SHARED_REQUIRES(Locks::mutator_lock_)
       REQUIRES(!dex_lock_);
@@ -1043,6 +1050,19 @@ class ClassLinker {
   ClassTable* ClassTableForClassLoader(mirror::ClassLoader* class_loader)
       SHARED_REQUIRES(Locks::mutator_lock_);
 
+  // Finds the first definition of a class in the dex files of `dex_elements`, the dex path of
+  // `class_loader`. Sets `class_def` to null if none of the dex files defines the class.
+  void FindInDexElements(ScopedObjectAccessAlreadyRunnable& soa,
+                         Thread* self,
+                         Handle<mirror::ClassLoader> class_loader,
+                         Handle<mirror::ObjectArray<mirror::Object>> dex_elements,
+                         const char* descriptor,
+                         size_t hash,
+                         /*out*/ const DexFile** dex_file,
+                         /*out*/ const DexFile::ClassDef** class_def)
+      SHARED_REQUIRES(Locks::mutator_lock_)
+      REQUIRES(!Locks::classlinker_classes_lock_);
+
   // Insert a new class table if not found.
   ClassTable* InsertClassTableForClassLoader(mirror::ClassLoader* class_loader)
       SHARED_REQUIRES(Locks::mutator_lock_)
@@ -1178,6 +1198,7 @@ class ClassLinker {
   friend class JniInternalTest;  // for GetRuntimeQuickGenericJniStub
   ART_FRIEND_TEST(ClassLinkerTest, RegisterDexFileName);  // for DexLock, and RegisterDexFileLocked
   ART_FRIEND_TEST(mirror::DexCacheTest, Open);  // for AllocDexCache
+  ART_FRIEND_TEST(mirror::DexCacheTest, StringCacheEviction);  // for AllocDexCache
   DISALLOW_COPY_AND_ASSIGN(ClassLinker);
 };
 
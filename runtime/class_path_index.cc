@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "class_path_index.h"
+
+#include <string.h>
+
+#include "dex_file-inl.h"
+#include "utf.h"
+
+namespace art {
+
+bool ClassPathIndex::HashEqualsFn::operator()(const Entry& a, const Entry& b) const {
+  if (a.hash != b.hash) {
+    return false;
+  }
+  const char* descriptor = a.dex_file->GetClassDescriptor(a.dex_file->GetClassDef(a.class_def_idx));
+  return (*this)(b, Key { descriptor, a.hash });
+}
+
+bool ClassPathIndex::HashEqualsFn::operator()(const Entry& entry, const Key& key) const {
+  if (entry.hash != key.hash) {
+    return false;
+  }
+  const DexFile::ClassDef& class_def = entry.dex_file->GetClassDef(entry.class_def_idx);
+  return strcmp(entry.dex_file->GetClassDescriptor(class_def), key.descriptor) == 0;
+}
+
+ClassPathIndex::ClassPathIndex(const std::vector<const DexFile*>& dex_files)
+    : num_dex_files_(dex_files.size()) {
+  size_t num_class_defs = 0;
+  for (const DexFile* dex_file : dex_files) {
+    num_class_defs += dex_file->NumClassDefs();
+  }
+  entries_.Reserve(num_class_defs);
+  for (const DexFile* dex_file : dex_files) {
+    for (uint32_t i = 0; i < dex_file->NumClassDefs(); ++i) {
+      const char* descriptor = dex_file->GetClassDescriptor(dex_file->GetClassDef(i));
+      const uint32_t hash = static_cast<uint32_t>(ComputeModifiedUtf8Hash(descriptor));
+      // Only the first definition is visible through the class path.
+      if (entries_.FindWithHash(Key { descriptor, hash }, hash) == entries_.end()) {
+        entries_.InsertWithHash(Entry { dex_file, i, hash }, hash);
+      }
+    }
+  }
+}
+
+bool ClassPathIndex::Find(const char* descriptor,
+                          size_t hash,
+                          const DexFile** dex_file,
+                          const DexFile::ClassDef** class_def) const {
+  const uint32_t key_hash = static_cast<uint32_t>(hash);
+  auto it = entries_.FindWithHash(Key { descriptor, key_hash }, key_hash);
+  if (it == entries_.end()) {
+    return false;
+  }
+  *dex_file = it->dex_file;
+  *class_def = &it->dex_file->GetClassDef(it->class_def_idx);
+  return true;
+}
+
+}  // namespace art
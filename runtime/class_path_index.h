@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_CLASS_PATH_INDEX_H_
+#define ART_RUNTIME_CLASS_PATH_INDEX_H_
+
+#include <stdint.h>
+#include <vector>
+
+#include "base/allocator.h"
+#include "base/hash_set.h"
+#include "base/macros.h"
+#include "dex_file.h"
+
+namespace art {
+
+// Index of the class definitions of a class path, mapping each descriptor to its first definition
+// in the dex files of the class path. Finding a class, or finding that the class path does not
+// define it, takes a single lookup instead of one lookup per dex file.
+class ClassPathIndex {
+ public:
+  explicit ClassPathIndex(const std::vector<const DexFile*>& dex_files);
+
+  // Returns true and the first definition of the class if the class path defines it.
+  bool Find(const char* descriptor,
+            size_t hash,
+            /*out*/ const DexFile** dex_file,
+            /*out*/ const DexFile::ClassDef** class_def) const;
+
+  size_t NumDexFiles() const {
+    return num_dex_files_;
+  }
+
+  size_t NumClasses() const {
+    return entries_.Size();
+  }
+
+ private:
+  struct Entry {
+    const DexFile* dex_file;
+    uint32_t class_def_idx;
+    uint32_t hash;
+  };
+
+  struct Key {
+    const char* descriptor;
+    uint32_t hash;
+  };
+
+  class EmptyFn {
+   public:
+    void MakeEmpty(Entry& item) const {
+      item.dex_file = nullptr;
+    }
+    bool IsEmpty(const Entry& item) const {
+      return item.dex_file == nullptr;
+    }
+  };
+
+  class HashEqualsFn {
+   public:
+    size_t operator()(const Entry& entry) const {
+      return entry.hash;
+    }
+    size_t operator()(const Key& key) const {
+      return key.hash;
+    }
+    bool operator()(const Entry& a, const Entry& b) const;
+    bool operator()(const Entry& entry, const Key& key) const;
+  };
+
+  typedef HashSet<Entry, EmptyFn, HashEqualsFn, HashEqualsFn,
+                  TrackingAllocator<Entry, kAllocatorTagClassTable>> EntrySet;
+
+  const size_t num_dex_files_;
+  EntrySet entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(ClassPathIndex);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_CLASS_PATH_INDEX_H_
@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "class_path_index.h"
+
+#include <memory>
+
+#include "common_runtime_test.h"
+#include "dex_file-inl.h"
+#include "utf.h"
+
+namespace art {
+
+class ClassPathIndexTest : public CommonRuntimeTest {};
+
+TEST_F(ClassPathIndexTest, Find) {
+  std::unique_ptr<const DexFile> nested(OpenTestDexFile("Nested"));
+  std::unique_ptr<const DexFile> main1(OpenTestDexFile("Main"));
+  std::unique_ptr<const DexFile> main2(OpenTestDexFile("Main"));
+  ClassPathIndex index({ nested.get(), main1.get(), main2.get() });
+  EXPECT_EQ(3u, index.NumDexFiles());
+  EXPECT_EQ(nested->NumClassDefs() + main1->NumClassDefs(), index.NumClasses());
+
+  const DexFile* dex_file = nullptr;
+  const DexFile::ClassDef* class_def = nullptr;
+  for (const DexFile* expected : { nested.get(), main1.get() }) {
+    for (size_t i = 0; i < expected->NumClassDefs(); ++i) {
+      const char* descriptor = expected->GetClassDescriptor(expected->GetClassDef(i));
+      const size_t hash = ComputeModifiedUtf8Hash(descriptor);
+      ASSERT_TRUE(index.Find(descriptor, hash, &dex_file, &class_def)) << descriptor;
+      // The first definition in the class path is found.
+      EXPECT_EQ(expected, dex_file);
+      EXPECT_EQ(&expected->GetClassDef(i), class_def);
+    }
+  }
+
+  const char* missing = "LMissing;";
+  EXPECT_FALSE(index.Find(missing, ComputeModifiedUtf8Hash(missing), &dex_file, &class_def));
+}
+
+}  // namespace art
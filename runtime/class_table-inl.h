@@ -24,34 +24,40 @@ namespace art {
 template<class Visitor>
 void ClassTable::VisitRoots(Visitor& visitor) {
   ReaderMutexLock mu(Thread::Current(), lock_);
-  for (ClassSet& class_set : classes_) {
-    for (GcRoot<mirror::Class>& root : class_set) {
+  for (const std::unique_ptr<ClassSet>& class_set : classes_.GetSets()) {
+    for (GcRoot<mirror::Class>& root : *class_set) {
       visitor.VisitRoot(root.AddressWithoutBarrier());
     }
   }
   for (GcRoot<mirror::Object>& root : strong_roots_) {
     visitor.VisitRoot(root.AddressWithoutBarrier());
   }
+  if (!class_path_dex_elements_.IsNull()) {
+    visitor.VisitRoot(class_path_dex_elements_.AddressWithoutBarrier());
+  }
 }
 
 template<class Visitor>
 void ClassTable::VisitRoots(const Visitor& visitor) {
   ReaderMutexLock mu(Thread::Current(), lock_);
-  for (ClassSet& class_set : classes_) {
-    for (GcRoot<mirror::Class>& root : class_set) {
+  for (const std::unique_ptr<ClassSet>& class_set : classes_.GetSets()) {
+    for (GcRoot<mirror::Class>& root : *class_set) {
       visitor.VisitRoot(root.AddressWithoutBarrier());
     }
   }
   for (GcRoot<mirror::Object>& root : strong_roots_) {
     visitor.VisitRoot(root.AddressWithoutBarrier());
   }
+  if (!class_path_dex_elements_.IsNull()) {
+    visitor.VisitRoot(class_path_dex_elements_.AddressWithoutBarrier());
+  }
 }
 
 template <typename Visitor>
 bool ClassTable::Visit(Visitor& visitor) {
   ReaderMutexLock mu(Thread::Current(), lock_);
-  for (ClassSet& class_set : classes_) {
-    for (GcRoot<mirror::Class>& root : class_set) {
+  for (const std::unique_ptr<ClassSet>& class_set : classes_.GetSets()) {
+    for (GcRoot<mirror::Class>& root : *class_set) {
       if (!visitor(root.Read())) {
         return false;
       }
@@ -16,26 +16,29 @@
 
 #include "class_table.h"
 
+#include "class_path_index.h"
 #include "mirror/class-inl.h"
+#include "mirror/object_array.h"
 
 namespace art {
 
-ClassTable::ClassTable() : lock_("Class loader classes", kClassLoaderClassesLock) {
-  Runtime* const runtime = Runtime::Current();
-  classes_.push_back(ClassSet(runtime->GetHashTableMinLoadFactor(),
-                              runtime->GetHashTableMaxLoadFactor()));
-}
+ClassTable::ClassTable()
+    : lock_("Class loader classes", kClassLoaderClassesLock),
+      classes_(new ClassSet(Runtime::Current()->GetHashTableMinLoadFactor(),
+                            Runtime::Current()->GetHashTableMaxLoadFactor())) {}
+
+ClassTable::~ClassTable() {}
 
 void ClassTable::FreezeSnapshot() {
   WriterMutexLock mu(Thread::Current(), lock_);
-  classes_.push_back(ClassSet());
+  classes_.AddBack(new ClassSet());
 }
 
 bool ClassTable::Contains(mirror::Class* klass) {
   ReaderMutexLock mu(Thread::Current(), lock_);
-  for (ClassSet& class_set : classes_) {
-    auto it = class_set.Find(GcRoot<mirror::Class>(klass));
-    if (it != class_set.end()) {
+  for (const std::unique_ptr<ClassSet>& class_set : classes_.GetSets()) {
+    auto it = class_set->Find(GcRoot<mirror::Class>(klass));
+    if (it != class_set->end()) {
       return it->Read() == klass;
     }
   }
@@ -44,9 +47,9 @@ bool ClassTable::Contains(mirror::Class* klass) {
 
 mirror::Class* ClassTable::LookupByDescriptor(mirror::Class* klass) {
   ReaderMutexLock mu(Thread::Current(), lock_);
-  for (ClassSet& class_set : classes_) {
-    auto it = class_set.Find(GcRoot<mirror::Class>(klass));
-    if (it != class_set.end()) {
+  for (const std::unique_ptr<ClassSet>& class_set : classes_.GetSets()) {
+    auto it = class_set->Find(GcRoot<mirror::Class>(klass));
+    if (it != class_set->end()) {
       return it->Read();
     }
   }
@@ -56,10 +59,11 @@ mirror::Class* ClassTable::LookupByDescriptor(mirror::Class* klass) {
 mirror::Class* ClassTable::UpdateClass(const char* descriptor, mirror::Class* klass, size_t hash) {
   WriterMutexLock mu(Thread::Current(), lock_);
   // Should only be updating latest table.
-  auto existing_it = classes_.back().FindWithHash(descriptor, hash);
-  if (kIsDebugBuild && existing_it == classes_.back().end()) {
-    for (const ClassSet& class_set : classes_) {
-      if (class_set.FindWithHash(descriptor, hash) != class_set.end()) {
+  ClassSet* const latest = classes_.GetSets().back().get();
+  auto existing_it = latest->FindWithHash(descriptor, hash);
+  if (kIsDebugBuild && existing_it == latest->end()) {
+    for (const std::unique_ptr<ClassSet>& class_set : classes_.GetSets()) {
+      if (class_set->FindWithHash(descriptor, hash) != class_set->end()) {
         LOG(FATAL) << "Updating class found in frozen table " << descriptor;
       }
     }
@@ -72,7 +76,8 @@ mirror::Class* ClassTable::UpdateClass(const char* descriptor, mirror::Class* kl
   CHECK(!klass->IsTemp()) << descriptor;
   VerifyObject(klass);
   // Update the element in the hash set with the new class. This is safe to do since the descriptor
-  // doesn't change.
+  // doesn't change, and lookups find either class.
+  QuasiAtomic::ThreadFenceRelease();
   *existing_it = GcRoot<mirror::Class>(klass);
   return existing;
 }
@@ -80,23 +85,38 @@ mirror::Class* ClassTable::UpdateClass(const char* descriptor, mirror::Class* kl
 size_t ClassTable::NumZygoteClasses() const {
   ReaderMutexLock mu(Thread::Current(), lock_);
   size_t sum = 0;
-  for (size_t i = 0; i < classes_.size() - 1; ++i) {
-    sum += classes_[i].Size();
+  const PublishedHashSets<ClassSet>::SetVector& class_sets = classes_.GetSets();
+  for (size_t i = 0; i < class_sets.size() - 1; ++i) {
+    sum += class_sets[i]->Size();
   }
   return sum;
 }
 
 size_t ClassTable::NumNonZygoteClasses() const {
   ReaderMutexLock mu(Thread::Current(), lock_);
-  return classes_.back().Size();
+  return classes_.GetSets().back()->Size();
+}
+
+size_t ClassTable::NumRetiredClassSets() const {
+  ReaderMutexLock mu(Thread::Current(), lock_);
+  return classes_.NumRetiredSets();
 }
 
 mirror::Class* ClassTable::Lookup(const char* descriptor, size_t hash) {
+  GcRoot<mirror::Class> root;
+  if (LIKELY(classes_.FindWithoutLock(descriptor, hash, &root))) {
+    return root.Read();
+  }
+  // A removal may have moved the class we are looking for while we were searching.
   ReaderMutexLock mu(Thread::Current(), lock_);
-  for (ClassSet& class_set : classes_) {
-    auto it = class_set.FindWithHash(descriptor, hash);
-    if (it != class_set.end()) {
-     return it->Read();
+  return LookupLocked(descriptor, hash);
+}
+
+mirror::Class* ClassTable::LookupLocked(const char* descriptor, size_t hash) {
+  for (const std::unique_ptr<ClassSet>& class_set : classes_.GetSets()) {
+    auto it = class_set->FindWithHash(descriptor, hash);
+    if (it != class_set->end()) {
+      return it->Read();
     }
   }
   return nullptr;
@@ -104,24 +124,30 @@ mirror::Class* ClassTable::Lookup(const char* descriptor, size_t hash) {
 
 void ClassTable::Insert(mirror::Class* klass) {
   WriterMutexLock mu(Thread::Current(), lock_);
-  classes_.back().Insert(GcRoot<mirror::Class>(klass));
+  InsertLocked(klass, ClassDescriptorHashEquals()(GcRoot<mirror::Class>(klass)));
 }
 
 void ClassTable::InsertWithoutLocks(mirror::Class* klass) {
-  classes_.back().Insert(GcRoot<mirror::Class>(klass));
+  InsertLocked(klass, ClassDescriptorHashEquals()(GcRoot<mirror::Class>(klass)));
 }
 
 void ClassTable::InsertWithHash(mirror::Class* klass, size_t hash) {
   WriterMutexLock mu(Thread::Current(), lock_);
-  classes_.back().InsertWithHash(GcRoot<mirror::Class>(klass), hash);
+  InsertLocked(klass, hash);
+}
+
+void ClassTable::InsertLocked(mirror::Class* klass, size_t hash) {
+  classes_.InsertWithHash(GcRoot<mirror::Class>(klass), hash);
 }
 
 bool ClassTable::Remove(const char* descriptor) {
   WriterMutexLock mu(Thread::Current(), lock_);
-  for (ClassSet& class_set : classes_) {
-    auto it = class_set.Find(descriptor);
-    if (it != class_set.end()) {
-      class_set.Erase(it);
+  for (const std::unique_ptr<ClassSet>& class_set : classes_.GetSets()) {
+    auto it = class_set->Find(descriptor);
+    if (it != class_set->end()) {
+      classes_.StartErase();
+      class_set->Erase(it);
+      classes_.FinishErase();
       return true;
     }
   }
@@ -167,8 +193,8 @@ size_t ClassTable::WriteToMemory(uint8_t* ptr) const {
   ClassSet combined;
   // Combine all the class sets in case there are multiple, also adjusts load factor back to
   // default in case classes were pruned.
-  for (const ClassSet& class_set : classes_) {
-    for (const GcRoot<mirror::Class>& root : class_set) {
+  for (const std::unique_ptr<ClassSet>& class_set : classes_.GetSets()) {
+    for (const GcRoot<mirror::Class>& root : *class_set) {
       combined.Insert(root);
     }
   }
@@ -190,11 +216,36 @@ size_t ClassTable::ReadFromMemory(uint8_t* ptr) {
 
 void ClassTable::AddClassSet(ClassSet&& set) {
   WriterMutexLock mu(Thread::Current(), lock_);
-  classes_.insert(classes_.begin(), std::move(set));
+  classes_.AddFront(new ClassSet(std::move(set)));
 }
 
 void ClassTable::ClearStrongRoots() {
   WriterMutexLock mu(Thread::Current(), lock_);
   strong_roots_.clear();
+  class_path_dex_elements_ = GcRoot<mirror::Object>();
+  class_path_index_.reset();
+}
+
+bool ClassTable::FindInClassPath(mirror::ObjectArray<mirror::Object>* dex_elements,
+                                 const char* descriptor,
+                                 size_t hash,
+                                 const DexFile** dex_file,
+                                 const DexFile::ClassDef** class_def) {
+  ReaderMutexLock mu(Thread::Current(), lock_);
+  if (class_path_index_ == nullptr || class_path_dex_elements_.Read() != dex_elements) {
+    return false;
+  }
+  if (!class_path_index_->Find(descriptor, hash, dex_file, class_def)) {
+    *dex_file = nullptr;
+    *class_def = nullptr;
+  }
+  return true;
+}
+
+void ClassTable::SetClassPathIndex(mirror::ObjectArray<mirror::Object>* dex_elements,
+                                   std::unique_ptr<ClassPathIndex> index) {
+  WriterMutexLock mu(Thread::Current(), lock_);
+  class_path_dex_elements_ = GcRoot<mirror::Object>(dex_elements);
+  class_path_index_ = std::move(index);
 }
 }  // namespace art
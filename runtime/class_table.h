@@ -17,6 +17,7 @@
 #ifndef ART_RUNTIME_CLASS_TABLE_H_
 #define ART_RUNTIME_CLASS_TABLE_H_
 
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -25,6 +26,7 @@
 #include "base/hash_set.h"
 #include "base/macros.h"
 #include "base/mutex.h"
+#include "base/published_hash_sets.h"
 #include "dex_file.h"
 #include "gc_root.h"
 #include "object_callbacks.h"
@@ -32,11 +34,15 @@
 
 namespace art {
 
+class ClassPathIndex;
+
 namespace mirror {
   class ClassLoader;
+  class Object;
+  template<class T> class ObjectArray;
 }  // namespace mirror
 
-// Each loader has a ClassTable
+// Each loader has a ClassTable. Lookups do not take the table's lock, see PublishedHashSets.
 class ClassTable {
  public:
   class ClassDescriptorHashEquals {
@@ -68,6 +74,7 @@ class ClassTable {
       ClassSet;
 
   ClassTable();
+  ~ClassTable();
 
   // Used by image writer for checking.
   bool Contains(mirror::Class* klass)
@@ -86,6 +93,9 @@ class ClassTable {
   // Returns all off the classes in the lastest snapshot.
   size_t NumNonZygoteClasses() const REQUIRES(!lock_);
 
+  // Returns the number of replaced class sets that are not freed yet. Used by tests.
+  size_t NumRetiredClassSets() const REQUIRES(!lock_);
+
   // Update a class in the table with the new class. Returns the existing class which was replaced.
   mirror::Class* UpdateClass(const char* descriptor, mirror::Class* new_klass, size_t hash)
       REQUIRES(!lock_)
@@ -110,7 +120,8 @@ class ClassTable {
       REQUIRES(!lock_)
       SHARED_REQUIRES(Locks::mutator_lock_);
 
-  // Return the first class that matches the descriptor. Returns null if there are none.
+  // Return the first class that matches the descriptor. Returns null if there are none. Does not
+  // take the lock unless a class is being removed concurrently.
   mirror::Class* Lookup(const char* descriptor, size_t hash)
       REQUIRES(!lock_)
       SHARED_REQUIRES(Locks::mutator_lock_);
@@ -158,6 +169,23 @@ class ClassTable {
       REQUIRES(!lock_)
       SHARED_REQUIRES(Locks::mutator_lock_);
 
+  // Find the first definition of a class in the dex files of `dex_elements`, the dex path of the
+  // class loader. Returns false if there is no class path index for `dex_elements`, true otherwise
+  // with a null `dex_file` if the class path does not define the class.
+  bool FindInClassPath(mirror::ObjectArray<mirror::Object>* dex_elements,
+                       const char* descriptor,
+                       size_t hash,
+                       /*out*/ const DexFile** dex_file,
+                       /*out*/ const DexFile::ClassDef** class_def)
+      REQUIRES(!lock_)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
+  // Replace the class path index with `index`, the index of the dex files of `dex_elements`.
+  void SetClassPathIndex(mirror::ObjectArray<mirror::Object>* dex_elements,
+                         std::unique_ptr<ClassPathIndex> index)
+      REQUIRES(!lock_)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
   ReaderWriterMutex& GetLock() {
     return lock_;
   }
@@ -165,14 +193,27 @@ class ClassTable {
  private:
   void InsertWithoutLocks(mirror::Class* klass) NO_THREAD_SAFETY_ANALYSIS;
 
+  void InsertLocked(mirror::Class* klass, size_t hash)
+      REQUIRES(lock_)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
+  mirror::Class* LookupLocked(const char* descriptor, size_t hash)
+      REQUIRES(lock_)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
   // Lock to guard inserting and removing.
   mutable ReaderWriterMutex lock_;
-  // We have a vector to help prevent dirty pages after the zygote forks by calling FreezeSnapshot.
-  std::vector<ClassSet> classes_ GUARDED_BY(lock_);
+  // We have several sets to help prevent dirty pages after the zygote forks by calling
+  // FreezeSnapshot. Modified with the lock held, searched by lookups without it.
+  PublishedHashSets<ClassSet> classes_;
   // Extra strong roots that can be either dex files or dex caches. Dex files used by the class
   // loader which may not be owned by the class loader must be held strongly live. Also dex caches
   // are held live to prevent them being unloading once they have classes in them.
   std::vector<GcRoot<mirror::Object>> strong_roots_ GUARDED_BY(lock_);
+  // Index of the dex path of the class loader, and the dex elements array it was built from. The
+  // index is rebuilt when the class loader's dex path list replaces the array.
+  GcRoot<mirror::Object> class_path_dex_elements_ GUARDED_BY(lock_);
+  std::unique_ptr<ClassPathIndex> class_path_index_ GUARDED_BY(lock_);
 
   friend class ImageWriter;  // for InsertWithoutLocks.
 };
@@ -0,0 +1,204 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "class_table.h"
+
+#include <string>
+#include <vector>
+
+#include "atomic.h"
+#include "class_linker.h"
+#include "common_runtime_test.h"
+#include "mirror/class-inl.h"
+#include "scoped_thread_state_change.h"
+#include "thread_list.h"
+#include "thread_pool.h"
+#include "utf.h"
+
+namespace art {
+
+// With the runtime's load factors, the latest class set is replaced when inserting the classes at
+// indices 0, 700, 1227 and 2149.
+static constexpr size_t kNumClasses = 2200;
+
+class ClassTableTest : public CommonRuntimeTest {
+ protected:
+  // Collects kNumClasses classes of the boot class loader, which are never unloaded, with their
+  // descriptors and hashes.
+  void CollectBootClasses() SHARED_REQUIRES(Locks::mutator_lock_) {
+    class Collector : public ClassVisitor {
+     public:
+      explicit Collector(std::vector<mirror::Class*>* classes) : classes_(classes) {}
+
+      bool operator()(mirror::Class* klass) OVERRIDE {
+        classes_->push_back(klass);
+        return classes_->size() != kNumClasses;
+      }
+
+     private:
+      std::vector<mirror::Class*>* const classes_;
+    };
+    Collector collector(&classes_);
+    class_linker_->VisitClasses(&collector);
+    ASSERT_EQ(kNumClasses, classes_.size());
+    for (mirror::Class* klass : classes_) {
+      std::string temp;
+      descriptors_.push_back(klass->GetDescriptor(&temp));
+      hashes_.push_back(ComputeModifiedUtf8Hash(descriptors_.back().c_str()));
+    }
+  }
+
+  void InsertClasses(ClassTable* table, size_t begin, size_t end)
+      SHARED_REQUIRES(Locks::mutator_lock_) {
+    for (size_t i = begin; i != end; ++i) {
+      table->InsertWithHash(classes_[i], hashes_[i]);
+    }
+  }
+
+  std::vector<mirror::Class*> classes_;
+  std::vector<std::string> descriptors_;
+  std::vector<size_t> hashes_;
+};
+
+TEST_F(ClassTableTest, LookupAfterReplacements) {
+  ScopedObjectAccess soa(Thread::Current());
+  CollectBootClasses();
+  ClassTable table;
+  for (size_t i = 0; i != kNumClasses; ++i) {
+    table.InsertWithHash(classes_[i], hashes_[i]);
+    // Classes inserted in earlier sets are still found.
+    if (i % 100u == 0u) {
+      for (size_t j = 0; j <= i; ++j) {
+        ASSERT_EQ(classes_[j], table.Lookup(descriptors_[j].c_str(), hashes_[j])) << j;
+      }
+    }
+  }
+  // Nothing allocates, so there was no suspend all to free the replaced sets.
+  EXPECT_EQ(4u, table.NumRetiredClassSets());
+  for (size_t i = 0; i != kNumClasses; ++i) {
+    EXPECT_EQ(classes_[i], table.Lookup(descriptors_[i].c_str(), hashes_[i])) << i;
+    EXPECT_TRUE(table.Contains(classes_[i])) << i;
+  }
+  EXPECT_EQ(kNumClasses, table.NumNonZygoteClasses());
+}
+
+TEST_F(ClassTableTest, RetiredSetsFreedAfterSuspendAll) {
+  Thread* const self = Thread::Current();
+  ClassTable table;
+  {
+    ScopedObjectAccess soa(self);
+    CollectBootClasses();
+    InsertClasses(&table, 0u, 1300u);
+  }
+  // Lookups may still be reading the replaced sets.
+  EXPECT_EQ(3u, table.NumRetiredClassSets());
+  {
+    ScopedSuspendAll ssa(__FUNCTION__);
+  }
+  // No lookup started before the suspend all can still be running. The sets are freed by the next
+  // replacement, which retires the set it replaces.
+  EXPECT_EQ(3u, table.NumRetiredClassSets());
+  {
+    ScopedObjectAccess soa(self);
+    InsertClasses(&table, 1300u, kNumClasses);
+  }
+  EXPECT_EQ(1u, table.NumRetiredClassSets());
+}
+
+// Looks up the classes at odd indices until told to stop.
+class LookupTask : public Task {
+ public:
+  LookupTask(ClassTable* table,
+             const std::vector<mirror::Class*>* classes,
+             const std::vector<std::string>* descriptors,
+             const std::vector<size_t>* hashes,
+             AtomicInteger* started,
+             Atomic<bool>* stop,
+             AtomicInteger* failures)
+      : table_(table),
+        classes_(classes),
+        descriptors_(descriptors),
+        hashes_(hashes),
+        started_(started),
+        stop_(stop),
+        failures_(failures) {}
+
+  void Run(Thread* self) OVERRIDE {
+    ScopedObjectAccess soa(self);
+    ++*started_;
+    do {
+      for (size_t i = 1; i < classes_->size(); i += 2) {
+        if (table_->Lookup((*descriptors_)[i].c_str(), (*hashes_)[i]) != (*classes_)[i]) {
+          ++*failures_;
+        }
+      }
+    } while (!stop_->LoadSequentiallyConsistent());
+  }
+
+  void Finalize() OVERRIDE {
+    delete this;
+  }
+
+ private:
+  ClassTable* const table_;
+  const std::vector<mirror::Class*>* const classes_;
+  const std::vector<std::string>* const descriptors_;
+  const std::vector<size_t>* const hashes_;
+  AtomicInteger* const started_;
+  Atomic<bool>* const stop_;
+  AtomicInteger* const failures_;
+};
+
+TEST_F(ClassTableTest, RemoveWhileLookingUp) {
+  static constexpr int32_t kNumThreads = 4;
+  Thread* const self = Thread::Current();
+  ClassTable table;
+  {
+    ScopedObjectAccess soa(self);
+    CollectBootClasses();
+    InsertClasses(&table, 0u, kNumClasses);
+  }
+  ThreadPool thread_pool("Class table test thread pool", kNumThreads);
+  AtomicInteger started(0);
+  Atomic<bool> stop(false);
+  AtomicInteger failures(0);
+  for (int32_t i = 0; i < kNumThreads; ++i) {
+    thread_pool.AddTask(
+        self,
+        new LookupTask(&table, &classes_, &descriptors_, &hashes_, &started, &stop, &failures));
+  }
+  thread_pool.StartWorkers(self);
+  while (started.LoadSequentiallyConsistent() != kNumThreads) {
+    sched_yield();
+  }
+  {
+    ScopedObjectAccess soa(self);
+    // Removing the classes at even indices moves the others within the set.
+    for (size_t i = 0; i < kNumClasses; i += 2) {
+      EXPECT_TRUE(table.Remove(descriptors_[i].c_str())) << i;
+    }
+  }
+  stop.StoreSequentiallyConsistent(true);
+  thread_pool.Wait(self, /* do_work */ false, /* may_hold_locks */ false);
+  EXPECT_EQ(0, failures.LoadSequentiallyConsistent());
+  ScopedObjectAccess soa(self);
+  for (size_t i = 0; i < kNumClasses; ++i) {
+    mirror::Class* const expected = (i % 2u == 0u) ? nullptr : classes_[i];
+    EXPECT_EQ(expected, table.Lookup(descriptors_[i].c_str(), hashes_[i])) << i;
+  }
+}
+
+}  // namespace art
@@ -51,6 +51,7 @@
 #include "type_lookup_table.h"
 #include "utf-inl.h"
 #include "utils.h"
+#include "verifier/verification_cache.h"
 #include "well_known_classes.h"
 #include "zip_archive.h"
 
@@ -732,6 +733,10 @@ void DexFile::CreateTypeLookupTable(uint8_t* storage) const {
   lookup_table_.reset(TypeLookupTable::Create(*this, storage));
 }
 
+void DexFile::SetVerificationCache(std::shared_ptr<verifier::VerificationCache> cache) const {
+  verification_cache_ = std::move(cache);
+}
+
 // Given a signature place the type ids into the given vector
 bool DexFile::CreateTypeList(const StringPiece& signature, uint16_t* return_type_idx,
                              std::vector<uint16_t>* param_type_idxs) const {
@@ -1387,6 +1392,58 @@ bool DexFile::IsMethodAnnotationPresent(ArtMethod* method, Handle<mirror::Class>
   return annotation_item != nullptr;
 }
 
+uint32_t DexFile::GetNativeMethodAnnotationAccessFlags(const ClassDef& class_def,
+                                                      uint32_t method_idx,
+                                                      uint32_t access_flags) const {
+  DCHECK_NE(access_flags & kAccNative, 0u);
+  const AnnotationsDirectoryItem* annotations_dir = GetAnnotationsDirectory(class_def);
+  if (annotations_dir == nullptr) {
+    return 0u;
+  }
+  const MethodAnnotationsItem* method_annotations = GetMethodAnnotations(annotations_dir);
+  if (method_annotations == nullptr) {
+    return 0u;
+  }
+  const AnnotationSetItem* annotation_set = nullptr;
+  for (uint32_t i = 0; i < annotations_dir->methods_size_; ++i) {
+    if (method_annotations[i].method_idx_ == method_idx) {
+      annotation_set = GetMethodAnnotationSetItem(method_annotations[i]);
+      break;
+    }
+  }
+  if (annotation_set == nullptr) {
+    return 0u;
+  }
+  uint32_t flags = 0u;
+  for (uint32_t i = 0; i < annotation_set->size_; ++i) {
+    const AnnotationItem* annotation_item = GetAnnotationItem(annotation_set, i);
+    if (annotation_item == nullptr) {
+      continue;
+    }
+    const uint8_t* annotation = annotation_item->annotation_;
+    const char* descriptor = StringByTypeIdx(DecodeUnsignedLeb128(&annotation));
+    if (strcmp(descriptor, "Ldalvik/annotation/optimization/FastNative;") == 0) {
+      flags |= kAccFastNative;
+    } else if (strcmp(descriptor, "Ldalvik/annotation/optimization/CriticalNative;") == 0) {
+      flags |= kAccFastNative | kAccCriticalNative;
+    }
+  }
+  if ((flags & kAccCriticalNative) != 0u) {
+    // The native code of a critical native gets neither a JNIEnv* nor a jclass, so there is no
+    // way to pass or return references, or to release a lock.
+    const char* shorty = GetMethodShorty(GetMethodId(method_idx));
+    bool primitive_only = (strchr(shorty, 'L') == nullptr);
+    if ((access_flags & kAccStatic) == 0 || (access_flags & kAccSynchronized) != 0 ||
+        !primitive_only) {
+      LOG(WARNING) << "Ignoring @CriticalNative on " << PrettyMethod(method_idx, *this)
+                   << ": only static, non-synchronized methods with primitive arguments and"
+                   << " return type can be critical";
+      flags &= ~kAccCriticalNative;
+    }
+  }
+  return flags;
+}
+
 const DexFile::AnnotationSetItem* DexFile::FindAnnotationSetForClass(Handle<mirror::Class> klass)
     const {
   const AnnotationsDirectoryItem* annotations_dir = GetAnnotationsDirectory(*klass->GetClassDef());
@@ -54,6 +54,10 @@ class StringPiece;
 class TypeLookupTable;
 class ZipArchive;
 
+namespace verifier {
+class VerificationCache;
+}  // namespace verifier
+
 // TODO: move all of the macro functionality into the DexCache class.
 class DexFile {
  public:
@@ -1000,6 +1004,14 @@ class DexFile {
       SHARED_REQUIRES(Locks::mutator_lock_);
   bool IsMethodAnnotationPresent(ArtMethod* method, Handle<mirror::Class> annotation_class) const
       SHARED_REQUIRES(Locks::mutator_lock_);
+  // Returns the kAccFastNative and kAccCriticalNative flags implied by the
+  // dalvik.annotation.optimization annotations of a native method. Annotations are matched by
+  // descriptor, so no class is resolved and this is safe to use while loading the declaring class
+  // or from the compiler. @CriticalNative is only honored for static, non-synchronized methods
+  // with primitive arguments and return type; it implies @FastNative.
+  uint32_t GetNativeMethodAnnotationAccessFlags(const ClassDef& class_def,
+                                                uint32_t method_idx,
+                                                uint32_t access_flags) const;
 
   const AnnotationSetItem* FindAnnotationSetForClass(Handle<mirror::Class> klass) const
       SHARED_REQUIRES(Locks::mutator_lock_);
@@ -1175,6 +1187,14 @@ class DexFile {
 
   void CreateTypeLookupTable(uint8_t* storage = nullptr) const;
 
+  // Persisted runtime verification results, or null if this dex file does not keep any.
+  verifier::VerificationCache* GetVerificationCache() const {
+    return verification_cache_.get();
+  }
+
+  // The cache is shared with the OatFileManager, which writes it out.
+  void SetVerificationCache(std::shared_ptr<verifier::VerificationCache> cache) const;
+
  private:
   // Opens a .dex file
   static std::unique_ptr<const DexFile> OpenFile(int fd, const char* location,
@@ -1274,6 +1294,7 @@ class DexFile {
   // null.
   const OatDexFile* oat_dex_file_;
   mutable std::unique_ptr<TypeLookupTable> lookup_table_;
+  mutable std::shared_ptr<verifier::VerificationCache> verification_cache_;
 
   friend class DexFileVerifierTest;
   ART_FRIEND_TEST(ClassLinkerTest, RegisterDexFileName);  // for constructor
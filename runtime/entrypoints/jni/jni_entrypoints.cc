@@ -31,7 +31,8 @@ extern "C" void* artFindNativeMethod() {
 extern "C" void* artFindNativeMethod(Thread* self) {
   DCHECK_EQ(self, Thread::Current());
 #endif
-  Locks::mutator_lock_->AssertNotHeld(self);  // We come here as Native.
+  // We come here as Native, or as Runnable for @FastNative and @CriticalNative methods, which
+  // do not transition out of Runnable. The ScopedObjectAccess is a no-op in the latter case.
   ScopedObjectAccess soa(self);
 
   ArtMethod* method = self->GetCurrentMethod(nullptr);
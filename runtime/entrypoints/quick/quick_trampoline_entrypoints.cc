@@ -1619,7 +1619,8 @@ class ComputeNativeCallFrameSize {
 
 class ComputeGenericJniFrameSize FINAL : public ComputeNativeCallFrameSize {
  public:
-  ComputeGenericJniFrameSize() : num_handle_scope_references_(0) {}
+  explicit ComputeGenericJniFrameSize(bool critical_native)
+      : num_handle_scope_references_(0), critical_native_(critical_native) {}
 
   // Lays out the callee-save frame. Assumes that the incorrect frame corresponding to RefsAndArgs
   // is at *m = sp. Will update to point to the bottom of the save frame.
@@ -1660,7 +1661,8 @@ class ComputeGenericJniFrameSize FINAL : public ComputeNativeCallFrameSize {
 
   // Adds space for the cookie. Note: may leave stack unaligned.
   void LayoutCookie(uint8_t** sp) const {
-    // Reference cookie and padding
+    // Reference cookie and padding. MIPS32 keeps a flag in the padding, see
+    // artQuickGenericJniTrampoline().
     *sp -= 8;
   }
 
@@ -1705,6 +1707,8 @@ class ComputeGenericJniFrameSize FINAL : public ComputeNativeCallFrameSize {
 
  private:
   uint32_t num_handle_scope_references_;
+  // @CriticalNative methods take neither JNIEnv* nor jclass.
+  const bool critical_native_;
 };
 
 uintptr_t ComputeGenericJniFrameSize::PushHandle(mirror::Object* /* ptr */) {
@@ -1714,6 +1718,10 @@ uintptr_t ComputeGenericJniFrameSize::PushHandle(mirror::Object* /* ptr */) {
 
 void ComputeGenericJniFrameSize::WalkHeader(
     BuildNativeCallFrameStateMachine<ComputeNativeCallFrameSize>* sm) {
+  if (critical_native_) {
+    return;
+  }
+
   // JNIEnv
   sm->AdvancePointer(nullptr);
 
@@ -1772,11 +1780,11 @@ class FillNativeCall {
 // of transitioning into native code.
 class BuildGenericJniFrameVisitor FINAL : public QuickArgumentVisitor {
  public:
-  BuildGenericJniFrameVisitor(Thread* self, bool is_static, const char* shorty, uint32_t shorty_len,
-                              ArtMethod*** sp)
+  BuildGenericJniFrameVisitor(Thread* self, bool is_static, bool critical_native,
+                              const char* shorty, uint32_t shorty_len, ArtMethod*** sp)
      : QuickArgumentVisitor(*sp, is_static, shorty, shorty_len),
        jni_call_(nullptr, nullptr, nullptr, nullptr), sm_(&jni_call_) {
-    ComputeGenericJniFrameSize fsc;
+    ComputeGenericJniFrameSize fsc(critical_native);
     uintptr_t* start_gpr_reg;
     uint32_t* start_fpr_reg;
     uintptr_t* start_stack_arg;
@@ -1787,6 +1795,11 @@ class BuildGenericJniFrameVisitor FINAL : public QuickArgumentVisitor {
 
     jni_call_.Reset(start_gpr_reg, start_fpr_reg, start_stack_arg, handle_scope_);
 
+    // @CriticalNative methods only get the arguments from the shorty.
+    if (critical_native) {
+      return;
+    }
+
     // jni environment is always first argument
     sm_.AdvancePointer(self->GetJniEnv());
 
@@ -1833,7 +1846,8 @@ class BuildGenericJniFrameVisitor FINAL : public QuickArgumentVisitor {
       while (cur_entry_ < expected_slots) {
         handle_scope_->GetMutableHandle(cur_entry_++).Assign(nullptr);
       }
-      DCHECK_NE(cur_entry_, 0U);
+      // Only @CriticalNative methods have an empty handle scope.
+      DCHECK(cur_entry_ != 0U || expected_slots == 0U);
     }
 
    private:
@@ -1957,7 +1971,8 @@ extern "C" TwoWordReturn artQuickGenericJniTrampoline(Thread* self, ArtMethod**
   const char* shorty = called->GetShorty(&shorty_len);
 
   // Run the visitor and update sp.
-  BuildGenericJniFrameVisitor visitor(self, called->IsStatic(), shorty, shorty_len, &sp);
+  BuildGenericJniFrameVisitor visitor(self, called->IsStatic(), called->IsCriticalNative(),
+                                      shorty, shorty_len, &sp);
   visitor.VisitArguments();
   visitor.FinalizeHandleScope(self);
 
@@ -1980,6 +1995,17 @@ extern "C" TwoWordReturn artQuickGenericJniTrampoline(Thread* self, ArtMethod**
   }
   uint32_t* sp32 = reinterpret_cast<uint32_t*>(sp);
   *(sp32 - 1) = cookie;
+#if defined(__mips__) && !defined(__LP64__)
+  // o32 passes leading floating point arguments of a @CriticalNative method in $f12 and $f14.
+  // art_quick_generic_jni_trampoline loads both from the GPR slots, which only leaves two
+  // leading floats ambiguous: they share the first register pair instead of taking one each.
+  // Flag them in the padding word below the cookie, see ComputeGenericJniFrameSize::LayoutCookie.
+  // The native code pointer cannot carry the flag, its bit 0 selects the ISA mode.
+  *(sp32 - 2) =
+      (called->IsCriticalNative() && shorty_len >= 3 && shorty[1] == 'F' && shorty[2] == 'F')
+          ? 1u
+          : 0u;
+#endif
 
   // Retrieve the stored native code.
   void* nativeCode = called->GetEntryPointFromJni();
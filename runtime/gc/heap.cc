@@ -72,6 +72,7 @@
 #include "scoped_thread_state_change.h"
 #include "handle_scope-inl.h"
 #include "thread_list.h"
+#include "thread_pool.h"
 #include "well_known_classes.h"
 #ifdef MTK_ART_RUNTIME_CLAMP_GROWTH_LIMIT_GC_LOCK
 #include "scoped_gc_critical_section.h"
@@ -294,6 +295,7 @@ Heap::Heap(size_t initial_size,
           image_name.c_str(),
           image_instruction_set,
           index > 0,
+          index > 0 ? boot_image_spaces_.front()->GetInPlaceRelocationDelta() : 0,
           &error_msg);
       if (boot_image_space != nullptr) {
         AddSpace(boot_image_space);
@@ -337,6 +339,9 @@ Heap::Heap(size_t initial_size,
         break;
       }
     }
+    if (!boot_image_spaces_.empty()) {
+      space::ImageSpace::RelocateBootImagesInPlace(boot_image_spaces_);
+    }
   }
   /*
   requested_alloc_space_begin ->     +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-
@@ -966,7 +971,7 @@ void Heap::UpdateProcessState(ProcessState old_process_state, ProcessState new_p
 void Heap::CreateThreadPool() {
   const size_t num_threads = std::max(parallel_gc_threads_, conc_gc_threads_);
   if (num_threads != 0) {
-    thread_pool_.reset(new ThreadPool("Heap thread pool", num_threads));
+    thread_pool_.reset(new WorkStealingThreadPool("Heap thread pool", num_threads));
   }
 }
 
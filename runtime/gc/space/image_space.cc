@@ -28,9 +28,12 @@
 #include "base/scoped_flock.h"
 #include "base/systrace.h"
 #include "base/time_utils.h"
+#include "class_linker.h"
 #include "gc/accounting/space_bitmap-inl.h"
 #include "image-inl.h"
 #include "image_space_fs.h"
+#include "intern_table.h"
+#include "mirror/abstract_method.h"
 #include "mirror/class-inl.h"
 #include "mirror/object-inl.h"
 #include "oat_file.h"
@@ -56,7 +59,8 @@ ImageSpace::ImageSpace(const std::string& image_filename,
                   end,
                   kGcRetentionPolicyNeverCollect),
       oat_file_non_owned_(nullptr),
-      image_location_(image_location) {
+      image_location_(image_location),
+      in_place_relocation_delta_(0) {
   DCHECK(live_bitmap != nullptr);
   live_bitmap_.reset(live_bitmap);
 }
@@ -189,6 +193,13 @@ static bool ReadSpecificImageHeader(const char* filename, ImageHeader* image_hea
     return true;
 }
 
+// Boot images compiled with position independent oat files can be relocated when they are mapped
+// instead of running patchoat, see ImageSpace::RelocateBootImagesInPlace.
+static bool CanRelocateInPlace(const char* filename) {
+  ImageHeader image_header;
+  return ReadSpecificImageHeader(filename, &image_header) && image_header.CompilePic();
+}
+
 // Relocate the image at image_location to dest_filename and relocate it by a random amount.
 static bool RelocateImage(const char* image_location, const char* dest_filename,
                                InstructionSet isa, std::string* error_msg) {
@@ -371,6 +382,7 @@ static bool CheckSpace(const std::string& cache_filename, std::string* error_msg
 ImageSpace* ImageSpace::CreateBootImage(const char* image_location,
                                         const InstructionSet image_isa,
                                         bool secondary_image,
+                                        int32_t boot_image_delta,
                                         std::string* error_msg) {
   ScopedTrace trace(__FUNCTION__);
   std::string system_filename;
@@ -395,6 +407,7 @@ ImageSpace* ImageSpace::CreateBootImage(const char* image_location,
     const std::string* image_filename;
     bool is_system = false;
     bool relocated_version_used = false;
+    int32_t in_place_relocation_delta = 0;
     if (relocate) {
       if (!dalvik_cache_exists) {
         *error_msg = StringPrintf("Requiring relocation for image '%s' at '%s' but we do not have "
@@ -403,10 +416,22 @@ ImageSpace* ImageSpace::CreateBootImage(const char* image_location,
         return nullptr;
       }
       if (has_system) {
-        if (has_cache && ChecksumsMatch(system_filename.c_str(), cache_filename.c_str())) {
+        if (secondary_image && boot_image_delta != 0) {
+          // The primary image was relocated in place, map the system image by the same delta.
+          image_filename = &system_filename;
+          is_system = true;
+          in_place_relocation_delta = boot_image_delta;
+        } else if (has_cache && ChecksumsMatch(system_filename.c_str(), cache_filename.c_str())) {
           // We already have a relocated version
           image_filename = &cache_filename;
           relocated_version_used = true;
+        } else if (!secondary_image && CanRelocateInPlace(system_filename.c_str())) {
+          // The oat files are position independent, only the image needs fixing up. Do that when
+          // mapping the image rather than writing a patched copy to the dalvik-cache.
+          image_filename = &system_filename;
+          is_system = true;
+          in_place_relocation_delta = ChooseRelocationOffsetDelta(ART_BASE_ADDRESS_MIN_DELTA,
+                                                                  ART_BASE_ADDRESS_MAX_DELTA);
         } else {
           // We cannot have a relocated version, Relocate the system one and use it.
 
@@ -502,6 +527,7 @@ ImageSpace* ImageSpace::CreateBootImage(const char* image_location,
                                image_location,
                                !(is_system || relocated_version_used),
                                /* oat_file */nullptr,
+                               in_place_relocation_delta,
                                error_msg);
     }
     if (space != nullptr) {
@@ -574,7 +600,12 @@ ImageSpace* ImageSpace::CreateBootImage(const char* image_location,
     // we leave Create.
     ScopedFlock image_lock;
     image_lock.Init(cache_filename.c_str(), error_msg);
-    space = ImageSpace::Init(cache_filename.c_str(), image_location, true, nullptr, error_msg);
+    space = ImageSpace::Init(cache_filename.c_str(),
+                             image_location,
+                             true,
+                             nullptr,
+                             /* in_place_relocation_delta */ 0,
+                             error_msg);
     if (space == nullptr) {
       *error_msg = StringPrintf("Failed to load generated image '%s': %s",
                                 cache_filename.c_str(), error_msg->c_str());
@@ -743,10 +774,14 @@ class FixupObjectVisitor : public FixupVisitor {
   template<typename... Args>
   explicit FixupObjectVisitor(gc::accounting::ContinuousSpaceBitmap* visited,
                               const size_t pointer_size,
+                              mirror::Class* method_class,
+                              mirror::Class* constructor_class,
                               Args... args)
       : FixupVisitor(args...),
         pointer_size_(pointer_size),
-        visited_(visited) {}
+        visited_(visited),
+        method_class_(method_class),
+        constructor_class_(constructor_class) {}
 
   // Fix up separately since we also need to fix up method entrypoints.
   ALWAYS_INLINE void VisitRootIfNonNull(
@@ -765,9 +800,13 @@ class FixupObjectVisitor : public FixupVisitor {
       // Space is not yet added to the heap, don't do a read barrier.
       mirror::Object* ref = obj->GetFieldObject<mirror::Object, kVerifyNone, kWithoutReadBarrier>(
           offset);
-      // Use SetFieldObjectWithoutWriteBarrier to avoid card marking since we are writing to the
-      // image.
-      obj->SetFieldObjectWithoutWriteBarrier<false, true, kVerifyNone>(offset, ForwardObject(ref));
+      mirror::Object* new_ref = ForwardObject(ref);
+      // Only write references that change, pages that only reference unmoved images stay clean.
+      if (ref != new_ref) {
+        // Use SetFieldObjectWithoutWriteBarrier to avoid card marking since we are writing to the
+        // image.
+        obj->SetFieldObjectWithoutWriteBarrier<false, true, kVerifyNone>(offset, new_ref);
+      }
     }
   }
 
@@ -795,9 +834,12 @@ class FixupObjectVisitor : public FixupVisitor {
   void operator()(mirror::Class* klass ATTRIBUTE_UNUSED, mirror::Reference* ref) const
       SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(Locks::heap_bitmap_lock_) {
     mirror::Object* obj = ref->GetReferent<kWithoutReadBarrier>();
-    ref->SetFieldObjectWithoutWriteBarrier<false, true, kVerifyNone>(
-        mirror::Reference::ReferentOffset(),
-        ForwardObject(obj));
+    mirror::Object* new_obj = ForwardObject(obj);
+    if (obj != new_obj) {
+      ref->SetFieldObjectWithoutWriteBarrier<false, true, kVerifyNone>(
+          mirror::Reference::ReferentOffset(),
+          new_obj);
+    }
   }
 
   void operator()(mirror::Object* obj) const NO_THREAD_SAFETY_ANALYSIS {
@@ -826,6 +868,16 @@ class FixupObjectVisitor : public FixupVisitor {
     obj->VisitReferences</*visit native roots*/false, kVerifyNone, kWithoutReadBarrier>(
         *this,
         *this);
+    mirror::Class* const klass = obj->GetClass<kVerifyNone, kWithoutReadBarrier>();
+    if (klass == method_class_ || klass == constructor_class_) {
+      // Forward the ArtMethod of java.lang.reflect.Method and Constructor objects.
+      mirror::AbstractMethod* const abstract_method = down_cast<mirror::AbstractMethod*>(obj);
+      ArtMethod* method = abstract_method->GetArtMethod();
+      ArtMethod* new_method = ForwardObject(method);
+      if (method != new_method) {
+        abstract_method->SetArtMethod(new_method);
+      }
+    }
     // Note that this code relies on no circular dependencies.
     // We want to use our own class loader and not the one in the image.
     if (obj->IsClass<kVerifyNone, kWithoutReadBarrier>()) {
@@ -864,6 +916,9 @@ class FixupObjectVisitor : public FixupVisitor {
  private:
   const size_t pointer_size_;
   gc::accounting::ContinuousSpaceBitmap* const visited_;
+  // Null if the images can not contain Method and Constructor objects with relocated ArtMethods.
+  mirror::Class* const method_class_;
+  mirror::Class* const constructor_class_;
 };
 
 class ForwardObjectAdapter {
@@ -939,6 +994,90 @@ class FixupArtFieldVisitor : public FixupVisitor, public ArtFieldVisitor {
   }
 };
 
+// Adapt for InternTable::VisitRoots.
+class FixupInternTableVisitor : public FixupVisitor, public RootVisitor {
+ public:
+  template<typename... Args>
+  explicit FixupInternTableVisitor(Args... args) : FixupVisitor(args...) {}
+
+  void VisitRoots(mirror::Object*** roots, size_t count, const RootInfo& info ATTRIBUTE_UNUSED)
+      OVERRIDE SHARED_REQUIRES(Locks::mutator_lock_) {
+    for (size_t i = 0; i < count; ++i) {
+      *roots[i] = ForwardObject(*roots[i]);
+    }
+  }
+
+  void VisitRoots(mirror::CompressedReference<mirror::Object>** roots,
+                  size_t count,
+                  const RootInfo& info ATTRIBUTE_UNUSED)
+      OVERRIDE SHARED_REQUIRES(Locks::mutator_lock_) {
+    for (size_t i = 0; i < count; ++i) {
+      mirror::Object* ref = roots[i]->AsMirrorPtr();
+      mirror::Object* new_ref = ForwardObject(ref);
+      if (ref != new_ref) {
+        roots[i]->Assign(new_ref);
+      }
+    }
+  }
+};
+
+// Fix up the native arrays of the dex caches in the image roots. The image roots must already be
+// relocated.
+static void FixupDexCaches(const ImageHeader& image_header,
+                           const FixupObjectAdapter& fixup_adapter,
+                           size_t pointer_size) NO_THREAD_SAFETY_ANALYSIS {
+  auto* dex_caches = image_header.GetImageRoot<kWithoutReadBarrier>(ImageHeader::kDexCaches)->
+      AsObjectArray<mirror::DexCache, kVerifyNone, kWithoutReadBarrier>();
+  for (int32_t i = 0, count = dex_caches->GetLength(); i < count; ++i) {
+    mirror::DexCache* dex_cache = dex_caches->Get<kVerifyNone, kWithoutReadBarrier>(i);
+    // Fix up dex cache pointers.
+    mirror::StringDexCacheType* strings = dex_cache->GetStrings();
+    if (strings != nullptr) {
+      mirror::StringDexCacheType* new_strings = fixup_adapter.ForwardObject(strings);
+      if (strings != new_strings) {
+        dex_cache->SetStrings(new_strings);
+      }
+      dex_cache->FixupStrings<kWithoutReadBarrier>(new_strings, fixup_adapter);
+    }
+    GcRoot<mirror::Class>* types = dex_cache->GetResolvedTypes();
+    if (types != nullptr) {
+      GcRoot<mirror::Class>* new_types = fixup_adapter.ForwardObject(types);
+      if (types != new_types) {
+        dex_cache->SetResolvedTypes(new_types);
+      }
+      dex_cache->FixupResolvedTypes<kWithoutReadBarrier>(new_types, fixup_adapter);
+    }
+    ArtMethod** methods = dex_cache->GetResolvedMethods();
+    if (methods != nullptr) {
+      ArtMethod** new_methods = fixup_adapter.ForwardObject(methods);
+      if (methods != new_methods) {
+        dex_cache->SetResolvedMethods(new_methods);
+      }
+      for (size_t j = 0, num = dex_cache->NumResolvedMethods(); j != num; ++j) {
+        ArtMethod* orig = mirror::DexCache::GetElementPtrSize(new_methods, j, pointer_size);
+        ArtMethod* copy = fixup_adapter.ForwardObject(orig);
+        if (orig != copy) {
+          mirror::DexCache::SetElementPtrSize(new_methods, j, copy, pointer_size);
+        }
+      }
+    }
+    ArtField** fields = dex_cache->GetResolvedFields();
+    if (fields != nullptr) {
+      ArtField** new_fields = fixup_adapter.ForwardObject(fields);
+      if (fields != new_fields) {
+        dex_cache->SetResolvedFields(new_fields);
+      }
+      for (size_t j = 0, num = dex_cache->NumResolvedFields(); j != num; ++j) {
+        ArtField* orig = mirror::DexCache::GetElementPtrSize(new_fields, j, pointer_size);
+        ArtField* copy = fixup_adapter.ForwardObject(orig);
+        if (orig != copy) {
+          mirror::DexCache::SetElementPtrSize(new_fields, j, copy, pointer_size);
+        }
+      }
+    }
+  }
+}
+
 // Relocate an image space mapped at target_base which possibly used to be at a different base
 // address. Only needs a single image space, not one for both source and destination.
 // In place means modifying a single ImageSpace in place rather than relocating from one ImageSpace
@@ -1032,6 +1171,8 @@ static bool RelocateInPlace(ImageHeader& image_header,
                                                       image_header.GetImageSize()));
     FixupObjectVisitor fixup_object_visitor(visited_bitmap.get(),
                                             pointer_size,
+                                            /*method_class*/nullptr,
+                                            /*constructor_class*/nullptr,
                                             boot_image,
                                             boot_oat,
                                             app_image,
@@ -1048,56 +1189,7 @@ static bool RelocateInPlace(ImageHeader& image_header,
     image_header.RelocateImageObjects(app_image.Delta());
     CHECK_EQ(image_header.GetImageBegin(), target_base);
     // Fix up dex cache DexFile pointers.
-    auto* dex_caches = image_header.GetImageRoot<kWithoutReadBarrier>(ImageHeader::kDexCaches)->
-        AsObjectArray<mirror::DexCache, kVerifyNone, kWithoutReadBarrier>();
-    for (int32_t i = 0, count = dex_caches->GetLength(); i < count; ++i) {
-      mirror::DexCache* dex_cache = dex_caches->Get<kVerifyNone, kWithoutReadBarrier>(i);
-      // Fix up dex cache pointers.
-      GcRoot<mirror::String>* strings = dex_cache->GetStrings();
-      if (strings != nullptr) {
-        GcRoot<mirror::String>* new_strings = fixup_adapter.ForwardObject(strings);
-        if (strings != new_strings) {
-          dex_cache->SetStrings(new_strings);
-        }
-        dex_cache->FixupStrings<kWithoutReadBarrier>(new_strings, fixup_adapter);
-      }
-      GcRoot<mirror::Class>* types = dex_cache->GetResolvedTypes();
-      if (types != nullptr) {
-        GcRoot<mirror::Class>* new_types = fixup_adapter.ForwardObject(types);
-        if (types != new_types) {
-          dex_cache->SetResolvedTypes(new_types);
-        }
-        dex_cache->FixupResolvedTypes<kWithoutReadBarrier>(new_types, fixup_adapter);
-      }
-      ArtMethod** methods = dex_cache->GetResolvedMethods();
-      if (methods != nullptr) {
-        ArtMethod** new_methods = fixup_adapter.ForwardObject(methods);
-        if (methods != new_methods) {
-          dex_cache->SetResolvedMethods(new_methods);
-        }
-        for (size_t j = 0, num = dex_cache->NumResolvedMethods(); j != num; ++j) {
-          ArtMethod* orig = mirror::DexCache::GetElementPtrSize(new_methods, j, pointer_size);
-          ArtMethod* copy = fixup_adapter.ForwardObject(orig);
-          if (orig != copy) {
-            mirror::DexCache::SetElementPtrSize(new_methods, j, copy, pointer_size);
-          }
-        }
-      }
-      ArtField** fields = dex_cache->GetResolvedFields();
-      if (fields != nullptr) {
-        ArtField** new_fields = fixup_adapter.ForwardObject(fields);
-        if (fields != new_fields) {
-          dex_cache->SetResolvedFields(new_fields);
-        }
-        for (size_t j = 0, num = dex_cache->NumResolvedFields(); j != num; ++j) {
-          ArtField* orig = mirror::DexCache::GetElementPtrSize(new_fields, j, pointer_size);
-          ArtField* copy = fixup_adapter.ForwardObject(orig);
-          if (orig != copy) {
-            mirror::DexCache::SetElementPtrSize(new_fields, j, copy, pointer_size);
-          }
-        }
-      }
-    }
+    FixupDexCaches(image_header, fixup_adapter, pointer_size);
   }
   {
     // Only touches objects in the app image, no need for mutator lock.
@@ -1146,10 +1238,133 @@ static bool RelocateInPlace(ImageHeader& image_header,
   return true;
 }
 
+// Fix up the boot images mapped at in_place_relocation_delta_ by Init. The headers and the oat
+// files already moved, this reuses the app image visitors treating all the boot images and oat
+// files as one range since the images reference each other. Runs before any thread is attached.
+void ImageSpace::RelocateBootImagesInPlace(const std::vector<ImageSpace*>& boot_image_spaces) {
+  DCHECK(!boot_image_spaces.empty());
+  const int32_t delta = boot_image_spaces.front()->in_place_relocation_delta_;
+  if (delta == 0) {
+    return;
+  }
+  TimingLogger logger(__FUNCTION__, true, false);
+  uintptr_t image_begin = std::numeric_limits<uintptr_t>::max();
+  uintptr_t image_end = 0u;
+  uintptr_t oat_begin = std::numeric_limits<uintptr_t>::max();
+  uintptr_t oat_end = 0u;
+  for (ImageSpace* space : boot_image_spaces) {
+    CHECK_EQ(space->in_place_relocation_delta_, delta) << space->GetName();
+    const uintptr_t begin = reinterpret_cast<uintptr_t>(space->Begin());
+    image_begin = std::min(image_begin, begin);
+    image_end = std::max(image_end, begin + space->GetImageHeader().GetImageSize());
+    const OatFile* oat_file = space->GetOatFile();
+    oat_begin = std::min(oat_begin, reinterpret_cast<uintptr_t>(oat_file->Begin()));
+    oat_end = std::max(oat_end, reinterpret_cast<uintptr_t>(oat_file->End()));
+  }
+  const RelocationRange boot_image(image_begin - delta, image_begin, image_end - image_begin);
+  const RelocationRange boot_oat(oat_begin - delta, oat_begin, oat_end - oat_begin);
+  VLOG(image) << "Boot image " << boot_image;
+  VLOG(image) << "Boot oat " << boot_oat;
+  const ImageHeader& primary_header = boot_image_spaces.front()->GetImageHeader();
+  const size_t pointer_size = primary_header.GetPointerSize();
+  FixupObjectAdapter fixup_adapter(boot_image, boot_oat, boot_image, boot_oat);
+  {
+    TimingLogger::ScopedTiming timing("Fixup objects", &logger);
+    // Look up the reflection classes before the class roots are fixed up.
+    auto* class_roots = down_cast<mirror::ObjectArray<mirror::Class>*>(
+        fixup_adapter.ForwardObject(
+            primary_header.GetImageRoot<kWithoutReadBarrier>(ImageHeader::kClassRoots)));
+    mirror::Class* method_class = fixup_adapter.ForwardObject(
+        class_roots->Get<kVerifyNone, kWithoutReadBarrier>(ClassLinker::kJavaLangReflectMethod));
+    mirror::Class* constructor_class = fixup_adapter.ForwardObject(
+        class_roots->Get<kVerifyNone, kWithoutReadBarrier>(
+            ClassLinker::kJavaLangReflectConstructor));
+    // The visited bitmap spans all the boot images since classes and pointer arrays may be shared
+    // across them.
+    std::unique_ptr<gc::accounting::ContinuousSpaceBitmap> visited_bitmap(
+        gc::accounting::ContinuousSpaceBitmap::Create("Relocate bitmap",
+                                                      reinterpret_cast<uint8_t*>(image_begin),
+                                                      image_end - image_begin));
+    FixupObjectVisitor fixup_object_visitor(visited_bitmap.get(),
+                                            pointer_size,
+                                            method_class,
+                                            constructor_class,
+                                            boot_image,
+                                            boot_oat,
+                                            boot_image,
+                                            boot_oat);
+    for (ImageSpace* space : boot_image_spaces) {
+      const ImageSection& objects_section =
+          space->GetImageHeader().GetImageSection(ImageHeader::kSectionObjects);
+      space->GetLiveBitmap()->VisitMarkedRange(
+          reinterpret_cast<uintptr_t>(space->Begin() + objects_section.Offset()),
+          reinterpret_cast<uintptr_t>(space->Begin() + objects_section.End()),
+          fixup_object_visitor);
+    }
+  }
+  for (ImageSpace* space : boot_image_spaces) {
+    const ImageHeader& image_header = space->GetImageHeader();
+    uint8_t* const target_base = space->Begin();
+    {
+      TimingLogger::ScopedTiming timing("Fixup dex caches", &logger);
+      FixupDexCaches(image_header, fixup_adapter, pointer_size);
+    }
+    {
+      TimingLogger::ScopedTiming timing("Fixup methods", &logger);
+      FixupArtMethodVisitor method_visitor(/*fixup_heap_objects*/true,
+                                           pointer_size,
+                                           boot_image,
+                                           boot_oat,
+                                           boot_image,
+                                           boot_oat);
+      image_header.VisitPackedArtMethods(&method_visitor, target_base, pointer_size);
+    }
+    {
+      TimingLogger::ScopedTiming timing("Fixup fields", &logger);
+      FixupArtFieldVisitor field_visitor(boot_image, boot_oat, boot_image, boot_oat);
+      image_header.VisitPackedArtFields(&field_visitor, target_base);
+    }
+    {
+      TimingLogger::ScopedTiming timing("Fixup imt", &logger);
+      image_header.VisitPackedImTables(fixup_adapter, target_base, pointer_size);
+    }
+    {
+      TimingLogger::ScopedTiming timing("Fixup conflict tables", &logger);
+      image_header.VisitPackedImtConflictTables(fixup_adapter, target_base, pointer_size);
+    }
+    // Note that we require that AddTableFromMemory and ReadFromMemory do not make an internal copy
+    // of the elements. This also relies on visit roots not doing any verification which could fail
+    // after we update the roots to be the image addresses.
+    const ImageSection& interned_strings_section =
+        image_header.GetImageSection(ImageHeader::kSectionInternedStrings);
+    if (interned_strings_section.Size() > 0u) {
+      TimingLogger::ScopedTiming timing("Fixup interned strings", &logger);
+      InternTable temp_table;
+      temp_table.AddTableFromMemory(target_base + interned_strings_section.Offset());
+      FixupInternTableVisitor root_visitor(boot_image, boot_oat, boot_image, boot_oat);
+      temp_table.VisitRoots(&root_visitor, kVisitRootFlagAllRoots);
+    }
+    const ImageSection& class_table_section =
+        image_header.GetImageSection(ImageHeader::kSectionClassTable);
+    if (class_table_section.Size() > 0u) {
+      TimingLogger::ScopedTiming timing("Fixup class table", &logger);
+      WriterMutexLock mu(Thread::Current(), *Locks::classlinker_classes_lock_);
+      ClassTable temp_table;
+      temp_table.ReadFromMemory(target_base + class_table_section.Offset());
+      FixupRootVisitor root_visitor(boot_image, boot_oat, boot_image, boot_oat);
+      temp_table.VisitRoots(root_visitor);
+    }
+  }
+  if (VLOG_IS_ON(image)) {
+    logger.Dump(LOG(INFO));
+  }
+}
+
 ImageSpace* ImageSpace::Init(const char* image_filename,
                              const char* image_location,
                              bool validate_oat_file,
                              const OatFile* oat_file,
+                             int32_t in_place_relocation_delta,
                              std::string* error_msg) {
   CHECK(image_filename != nullptr);
   CHECK(image_location != nullptr);
@@ -1225,7 +1440,12 @@ ImageSpace* ImageSpace::Init(const char* image_filename,
 
   // The preferred address to map the image, null specifies any address. If we manage to map the
   // image at the image begin, the amount of fixup work required is minimized.
-  std::vector<uint8_t*> addresses(1, image_header->GetImageBegin());
+  std::vector<uint8_t*> addresses(1, image_header->GetImageBegin() + in_place_relocation_delta);
+  if (in_place_relocation_delta != 0 && !image_header->CompilePic()) {
+    *error_msg = StringPrintf("Cannot relocate image '%s' in place without position independent "
+                              "oat files", image_filename);
+    return nullptr;
+  }
   if (image_header->IsPic()) {
     // Can also map at a random low_4gb address since we can relocate in-place.
     addresses.push_back(nullptr);
@@ -1328,6 +1548,12 @@ ImageSpace* ImageSpace::Init(const char* image_filename,
   // Loaded the map, use the image header from the file now in case we patch it with
   // RelocateInPlace.
   image_header = reinterpret_cast<ImageHeader*>(map->Begin());
+  if (in_place_relocation_delta != 0) {
+    // Move the header along with the boot image so that the oat file gets mapped by the same delta
+    // and the runtime methods point at the new location. The objects and native structures are
+    // fixed up by RelocateBootImagesInPlace once all the boot images are mapped.
+    image_header->RelocateImage(in_place_relocation_delta);
+  }
   const uint32_t bitmap_index = bitmap_index_.FetchAndAddSequentiallyConsistent(1);
   std::string bitmap_name(StringPrintf("imagespace %s live-bitmap %u",
                                        image_filename,
@@ -1366,6 +1592,7 @@ ImageSpace* ImageSpace::Init(const char* image_filename,
                                                    map.release(),
                                                    bitmap.release(),
                                                    image_end));
+  space->in_place_relocation_delta_ = in_place_relocation_delta;
 
   // VerifyImageAllocations() will be called later in Runtime::Init()
   // as some class roots like ArtMethod::java_lang_reflect_ArtMethod_
@@ -1410,6 +1637,8 @@ ImageSpace* ImageSpace::Init(const char* image_filename,
              image_header->GetImageMethod(ImageHeader::kRefsOnlySaveMethod));
     CHECK_EQ(runtime->GetCalleeSaveMethod(Runtime::kRefsAndArgs),
              image_header->GetImageMethod(ImageHeader::kRefsAndArgsSaveMethod));
+    CHECK_EQ(runtime->GetCalleeSaveMethod(Runtime::kSaveEverything),
+             image_header->GetImageMethod(ImageHeader::kSaveEverythingMethod));
   } else if (!runtime->HasResolutionMethod()) {
     runtime->SetInstructionSet(space->oat_file_non_owned_->GetOatHeader().GetInstructionSet());
     runtime->SetResolutionMethod(image_header->GetImageMethod(ImageHeader::kResolutionMethod));
@@ -1422,6 +1651,9 @@ ImageSpace* ImageSpace::Init(const char* image_filename,
         image_header->GetImageMethod(ImageHeader::kRefsOnlySaveMethod), Runtime::kRefsOnly);
     runtime->SetCalleeSaveMethod(
         image_header->GetImageMethod(ImageHeader::kRefsAndArgsSaveMethod), Runtime::kRefsAndArgs);
+    runtime->SetCalleeSaveMethod(
+        image_header->GetImageMethod(ImageHeader::kSaveEverythingMethod),
+        Runtime::kSaveEverything);
   }
 
   VLOG(image) << "ImageSpace::Init exiting " << *space.get();
@@ -1602,6 +1834,7 @@ ImageSpace* ImageSpace::CreateFromAppImage(const char* image,
                                      image,
                                      /*validate_oat_file*/false,
                                      oat_file,
+                                     /*in_place_relocation_delta*/0,
                                      /*out*/error_msg);
 }
 
@@ -43,12 +43,22 @@ class ImageSpace : public MemMapSpace {
   // creation of the alloc space. The ReleaseOatFile will later be
   // used to transfer ownership of the OatFile to the ClassLinker when
   // it is initialized.
+  //
+  // PIC boot images that need relocation are mapped at a random delta instead of being patched
+  // by patchoat. All the boot images must move by the same delta, so secondary images are passed
+  // the delta the primary image was mapped at in boot_image_delta.
   static ImageSpace* CreateBootImage(const char* image,
                                      InstructionSet image_isa,
                                      bool secondary_image,
+                                     int32_t boot_image_delta,
                                      std::string* error_msg)
       SHARED_REQUIRES(Locks::mutator_lock_);
 
+  // Fix up the contents of boot images that CreateBootImage mapped at a delta. Must be called
+  // once all the boot images are loaded since they reference each other.
+  static void RelocateBootImagesInPlace(const std::vector<ImageSpace*>& boot_image_spaces)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
   // Try to open an existing app image space.
   static ImageSpace* CreateFromAppImage(const char* image,
                                         const OatFile* oat_file,
@@ -153,6 +163,12 @@ class ImageSpace : public MemMapSpace {
     return GetImageHeader().GetOatFileEnd();
   }
 
+  // Return the delta the image was mapped at away from the address in the image file, zero if the
+  // image did not need relocating in place.
+  int32_t GetInPlaceRelocationDelta() const {
+    return in_place_relocation_delta_;
+  }
+
   void DumpSections(std::ostream& os) const;
 
  protected:
@@ -161,11 +177,13 @@ class ImageSpace : public MemMapSpace {
   // If validate_oat_file is false (for /system), do not verify that image's OatFile is up-to-date
   // relative to its DexFile inputs. Otherwise (for /data), validate the inputs and generate the
   // OatFile in /data/dalvik-cache if necessary. If the oat_file is null, it uses the oat file from
-  // the image.
+  // the image. A non-zero in_place_relocation_delta maps a boot image at that delta from the
+  // address it was compiled for, see RelocateBootImagesInPlace.
   static ImageSpace* Init(const char* image_filename,
                           const char* image_location,
                           bool validate_oat_file,
                           const OatFile* oat_file,
+                          int32_t in_place_relocation_delta,
                           std::string* error_msg)
       SHARED_REQUIRES(Locks::mutator_lock_);
 
@@ -198,6 +216,10 @@ class ImageSpace : public MemMapSpace {
 
   const std::string image_location_;
 
+  // Delta the image header was relocated by when mapping a boot image. The rest of the image is
+  // fixed up by RelocateBootImagesInPlace.
+  int32_t in_place_relocation_delta_;
+
  private:
   DISALLOW_COPY_AND_ASSIGN(ImageSpace);
 };
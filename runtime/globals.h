@@ -107,6 +107,14 @@ static constexpr bool kPoisonHeapReferences = true;
 static constexpr bool kPoisonHeapReferences = false;
 #endif
 
+// If true, the strings array of a DexCache is a fixed-size hashed cache instead of having one
+// slot per string id (see mirror::StringDexCachePair).
+#ifdef ART_USE_HASHED_DEX_CACHE_STRINGS
+static constexpr bool kUseHashedDexCacheStrings = true;
+#else
+static constexpr bool kUseHashedDexCacheStrings = false;
+#endif
+
 // If true, enable the tlab allocator by default.
 #ifdef ART_USE_TLAB
 static constexpr bool kUseTlab = true;
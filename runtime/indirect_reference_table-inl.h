@@ -53,7 +53,7 @@ inline bool IndirectReferenceTable::GetChecked(IndirectRef iref) const {
     AbortIfNoCheckJNI(msg);
     return false;
   }
-  if (UNLIKELY(table_[idx].GetReference()->IsNull())) {
+  if (UNLIKELY(GetEntry(idx)->GetReference()->IsNull())) {
     AbortIfNoCheckJNI(StringPrintf("JNI ERROR (app bug): accessed deleted %s %p",
                                    GetIndirectRefKindString(kind_),
                                    iref));
@@ -87,7 +87,7 @@ inline mirror::Object* IndirectReferenceTable::Get(IndirectRef iref) const {
     return nullptr;
   }
   uint32_t idx = ExtractIndex(iref);
-  mirror::Object* obj = table_[idx].GetReference()->Read<kReadBarrierOption>();
+  mirror::Object* obj = GetEntry(idx)->GetReference()->Read<kReadBarrierOption>();
   VerifyObject(obj);
   return obj;
 }
@@ -98,7 +98,7 @@ inline void IndirectReferenceTable::Update(IndirectRef iref, mirror::Object* obj
     return;
   }
   uint32_t idx = ExtractIndex(iref);
-  table_[idx].SetReference(obj);
+  GetEntry(idx)->SetReference(obj);
 }
 
 }  // namespace art
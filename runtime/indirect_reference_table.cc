@@ -16,8 +16,11 @@
 
 #include "indirect_reference_table-inl.h"
 
+#include <algorithm>
+
 #include "base/systrace.h"
 #include "jni_internal.h"
+#include "mem_map.h"
 #include "nth_caller_visitor.h"
 #include "reference_table.h"
 #include "runtime.h"
@@ -86,36 +89,57 @@ void IndirectReferenceTable::AbortIfNoCheckJNI(const std::string& msg) {
 IndirectReferenceTable::IndirectReferenceTable(size_t initialCount,
                                                size_t maxCount, IndirectRefKind desiredKind,
                                                bool abort_on_error)
-    : kind_(desiredKind),
+    : first_segment_shift_(WhichPowerOf2(RoundUpToPowerOfTwo(initialCount))),
+      kind_(desiredKind),
       max_entries_(maxCount) {
   CHECK_GT(initialCount, 0U);
   CHECK_LE(initialCount, maxCount);
+  CHECK_LE(maxCount, kIRTMaxEntries);
   CHECK_NE(desiredKind, kHandleScopeOrInvalid);
+  DCHECK_LT(StorageSegmentOf(maxCount - 1), kMaxStorageSegments);
 
+  std::fill_n(storage_segments_, kMaxStorageSegments, nullptr);
+  segment_state_.all = IRT_FIRST_SEGMENT;
+  // Only the first storage segment is mapped up front, the others are mapped as the table grows.
   std::string error_str;
-  const size_t table_bytes = maxCount * sizeof(IrtEntry);
-  table_mem_map_.reset(MemMap::MapAnonymous("indirect ref table", nullptr, table_bytes,
-                                            PROT_READ | PROT_WRITE, false, false, &error_str));
-  if (abort_on_error) {
-    CHECK(table_mem_map_.get() != nullptr) << error_str;
-    CHECK_EQ(table_mem_map_->Size(), table_bytes);
-    CHECK(table_mem_map_->Begin() != nullptr);
-  } else if (table_mem_map_.get() == nullptr ||
-             table_mem_map_->Size() != table_bytes ||
-             table_mem_map_->Begin() == nullptr) {
-    table_mem_map_.reset();
+  if (!EnsureStorageFor(0, &error_str)) {
+    if (abort_on_error) {
+      LOG(FATAL) << error_str;
+    }
     LOG(ERROR) << error_str;
-    return;
   }
-  table_ = reinterpret_cast<IrtEntry*>(table_mem_map_->Begin());
-  segment_state_.all = IRT_FIRST_SEGMENT;
 }
 
 IndirectReferenceTable::~IndirectReferenceTable() {
 }
 
 bool IndirectReferenceTable::IsValid() const {
-  return table_mem_map_.get() != nullptr;
+  return storage_mem_maps_[0].get() != nullptr;
+}
+
+bool IndirectReferenceTable::EnsureStorageFor(size_t index, std::string* error_msg) {
+  size_t segment = StorageSegmentOf(index);
+  if (storage_segments_[segment] != nullptr) {
+    return true;
+  }
+  // Don't map entries past max_entries_.
+  size_t num_entries = std::min(StorageSegmentSize(segment),
+                                max_entries_ - StorageSegmentStart(segment));
+  const size_t segment_bytes = num_entries * sizeof(IrtEntry);
+  std::unique_ptr<MemMap> mem_map(MemMap::MapAnonymous("indirect ref table",
+                                                       nullptr,
+                                                       segment_bytes,
+                                                       PROT_READ | PROT_WRITE,
+                                                       false,
+                                                       false,
+                                                       error_msg));
+  if (mem_map.get() == nullptr) {
+    return false;
+  }
+  CHECK_GE(mem_map->Size(), segment_bytes);
+  storage_segments_[segment] = reinterpret_cast<IrtEntry*>(mem_map->Begin());
+  storage_mem_maps_[segment] = std::move(mem_map);
+  return true;
 }
 
 IndirectRef IndirectReferenceTable::Add(uint32_t cookie, mirror::Object* obj) {
@@ -125,7 +149,7 @@ IndirectRef IndirectReferenceTable::Add(uint32_t cookie, mirror::Object* obj) {
 
   CHECK(obj != nullptr);
   VerifyObject(obj);
-  DCHECK(table_ != nullptr);
+  DCHECK(IsValid());
   DCHECK_GE(segment_state_.parts.numHoles, prevState.parts.numHoles);
 
   if (topIndex == max_entries_) {
@@ -140,24 +164,40 @@ IndirectRef IndirectReferenceTable::Add(uint32_t cookie, mirror::Object* obj) {
   IndirectRef result;
   int numHoles = segment_state_.parts.numHoles - prevState.parts.numHoles;
   size_t index;
-  if (numHoles > 0) {
+  if (numHoles > 0 && kind_ != kLocal) {
+    // Take a hole from the free list, skipping stale indices.
+    DCHECK_EQ(cookie, IRT_FIRST_SEGMENT);
+    do {
+      DCHECK(!free_indices_.empty());
+      index = free_indices_.back();
+      free_indices_.pop_back();
+    } while (index >= topIndex || !GetEntry(index)->GetReference()->IsNull());
+    segment_state_.parts.numHoles--;
+    if (segment_state_.parts.numHoles == 0) {
+      free_indices_.clear();
+    }
+  } else if (numHoles > 0) {
     DCHECK_GT(topIndex, 1U);
     // Find the first hole; likely to be near the end of the list.
-    IrtEntry* pScan = &table_[topIndex - 1];
-    DCHECK(!pScan->GetReference()->IsNull());
-    --pScan;
-    while (!pScan->GetReference()->IsNull()) {
-      DCHECK_GE(pScan, table_ + prevState.parts.topIndex);
-      --pScan;
+    index = topIndex - 1;
+    DCHECK(!GetEntry(index)->GetReference()->IsNull());
+    --index;
+    while (!GetEntry(index)->GetReference()->IsNull()) {
+      DCHECK_GE(index, prevState.parts.topIndex);
+      --index;
     }
-    index = pScan - table_;
     segment_state_.parts.numHoles--;
   } else {
-    // Add to the end.
+    // Add to the end, mapping more storage if needed.
+    std::string error_msg;
+    if (UNLIKELY(!EnsureStorageFor(topIndex, &error_msg))) {
+      LOG(FATAL) << "JNI ERROR: failed to grow " << kind_ << " table to " << topIndex + 1
+                 << " entries: " << error_msg;
+    }
     index = topIndex++;
     segment_state_.parts.topIndex = topIndex;
   }
-  table_[index].Add(obj);
+  GetEntry(index)->Add(obj);
   result = ToIndirectRef(index);
   if ((false)) {
     LOG(INFO) << "+++ added at " << ExtractIndex(result) << " top=" << segment_state_.parts.topIndex
@@ -170,7 +210,7 @@ IndirectRef IndirectReferenceTable::Add(uint32_t cookie, mirror::Object* obj) {
 
 void IndirectReferenceTable::AssertEmpty() {
   for (size_t i = 0; i < Capacity(); ++i) {
-    if (!table_[i].GetReference()->IsNull()) {
+    if (!GetEntry(i)->GetReference()->IsNull()) {
       ScopedObjectAccess soa(Thread::Current());
       LOG(FATAL) << "Internal Error: non-empty local reference table\n"
                  << MutatorLockedDumpable<IndirectReferenceTable>(*this);
@@ -192,7 +232,7 @@ bool IndirectReferenceTable::Remove(uint32_t cookie, IndirectRef iref) {
   int topIndex = segment_state_.parts.topIndex;
   int bottomIndex = prevState.parts.topIndex;
 
-  DCHECK(table_ != nullptr);
+  DCHECK(IsValid());
   DCHECK_GE(segment_state_.parts.numHoles, prevState.parts.numHoles);
 
   if (GetIndirectRefKind(iref) == kHandleScopeOrInvalid) {
@@ -231,16 +271,16 @@ bool IndirectReferenceTable::Remove(uint32_t cookie, IndirectRef iref) {
       return false;
     }
 
-    *table_[idx].GetReference() = GcRoot<mirror::Object>(nullptr);
+    *GetEntry(idx)->GetReference() = GcRoot<mirror::Object>(nullptr);
     int numHoles = segment_state_.parts.numHoles - prevState.parts.numHoles;
     if (numHoles != 0) {
       while (--topIndex > bottomIndex && numHoles != 0) {
         if ((false)) {
           LOG(INFO) << "+++ checking for hole at " << topIndex - 1
                     << " (cookie=" << cookie << ") val="
-                    << table_[topIndex - 1].GetReference()->Read<kWithoutReadBarrier>();
+                    << GetEntry(topIndex - 1)->GetReference()->Read<kWithoutReadBarrier>();
         }
-        if (!table_[topIndex - 1].GetReference()->IsNull()) {
+        if (!GetEntry(topIndex - 1)->GetReference()->IsNull()) {
           break;
         }
         if ((false)) {
@@ -250,6 +290,10 @@ bool IndirectReferenceTable::Remove(uint32_t cookie, IndirectRef iref) {
       }
       segment_state_.parts.numHoles = numHoles + prevState.parts.numHoles;
       segment_state_.parts.topIndex = topIndex;
+      if (segment_state_.parts.numHoles == 0) {
+        // Only stale indices are left in the free list.
+        free_indices_.clear();
+      }
     } else {
       segment_state_.parts.topIndex = topIndex-1;
       if ((false)) {
@@ -259,7 +303,7 @@ bool IndirectReferenceTable::Remove(uint32_t cookie, IndirectRef iref) {
   } else {
     // Not the top-most entry.  This creates a hole.  We null out the entry to prevent somebody
     // from deleting it twice and screwing up the hole count.
-    if (table_[idx].GetReference()->IsNull()) {
+    if (GetEntry(idx)->GetReference()->IsNull()) {
       LOG(INFO) << "--- WEIRD: removing null entry " << idx;
       return false;
     }
@@ -267,8 +311,11 @@ bool IndirectReferenceTable::Remove(uint32_t cookie, IndirectRef iref) {
       return false;
     }
 
-    *table_[idx].GetReference() = GcRoot<mirror::Object>(nullptr);
+    *GetEntry(idx)->GetReference() = GcRoot<mirror::Object>(nullptr);
     segment_state_.parts.numHoles++;
+    if (kind_ != kLocal) {
+      free_indices_.push_back(idx);
+    }
     if ((false)) {
       LOG(INFO) << "+++ left hole at " << idx << ", holes=" << segment_state_.parts.numHoles;
     }
@@ -280,9 +327,24 @@ bool IndirectReferenceTable::Remove(uint32_t cookie, IndirectRef iref) {
 void IndirectReferenceTable::Trim() {
   ScopedTrace trace(__PRETTY_FUNCTION__);
   const size_t top_index = Capacity();
-  auto* release_start = AlignUp(reinterpret_cast<uint8_t*>(&table_[top_index]), kPageSize);
-  uint8_t* release_end = table_mem_map_->End();
-  madvise(release_start, release_end - release_start, MADV_DONTNEED);
+  // Unmap the storage segments past the one holding the top index, which is only released
+  // past the top index. The first storage segment is always kept.
+  size_t top_segment = StorageSegmentOf(top_index);
+  for (size_t segment = std::max(top_segment + 1, static_cast<size_t>(1));
+       segment != kMaxStorageSegments;
+       ++segment) {
+    storage_segments_[segment] = nullptr;
+    storage_mem_maps_[segment].reset();
+  }
+  if (top_segment < kMaxStorageSegments && storage_segments_[top_segment] != nullptr) {
+    IrtEntry* top_entry =
+        &storage_segments_[top_segment][top_index - StorageSegmentStart(top_segment)];
+    uint8_t* release_start = AlignUp(reinterpret_cast<uint8_t*>(top_entry), kPageSize);
+    uint8_t* release_end = storage_mem_maps_[top_segment]->End();
+    if (release_start < release_end) {
+      madvise(release_start, release_end - release_start, MADV_DONTNEED);
+    }
+  }
 }
 
 void IndirectReferenceTable::VisitRoots(RootVisitor* visitor, const RootInfo& root_info) {
@@ -299,9 +361,9 @@ void IndirectReferenceTable::Dump(std::ostream& os) const {
   os << kind_ << " table dump:\n";
   ReferenceTable::Table entries;
   for (size_t i = 0; i < Capacity(); ++i) {
-    mirror::Object* obj = table_[i].GetReference()->Read<kWithoutReadBarrier>();
+    mirror::Object* obj = GetEntry(i)->GetReference()->Read<kWithoutReadBarrier>();
     if (obj != nullptr) {
-      obj = table_[i].GetReference()->Read();
+      obj = GetEntry(i)->GetReference()->Read();
       entries.push_back(GcRoot<mirror::Object>(obj));
     }
   }
@@ -20,8 +20,11 @@
 #include <stdint.h>
 
 #include <iosfwd>
+#include <memory>
 #include <string>
+#include <vector>
 
+#include "base/bit_utils.h"
 #include "base/logging.h"
 #include "base/mutex.h"
 #include "gc_root.h"
@@ -131,6 +134,10 @@ static inline IndirectRefKind GetIndirectRefKind(IndirectRef iref) {
 /* use as initial value for "cookie", and when table has only one segment */
 static const uint32_t IRT_FIRST_SEGMENT = 0;
 
+// Largest number of entries of a table, as indices are stored in 16 bits in IndirectRef and
+// IRTSegmentState.
+static constexpr size_t kIRTMaxEntries = 0xffff;
+
 /*
  * Table definition.
  *
@@ -139,10 +146,12 @@ static const uint32_t IRT_FIRST_SEGMENT = 0;
  * most-recently-added entry).  For JNI local references, the common
  * operations are adding a new entry and removing an entire table segment.
  *
- * If "alloc_entries_" is not equal to "max_entries_", the table may expand
- * when entries are added, which means the memory may move.  If you want
- * to keep pointers into "table" rather than offsets, you must use a
- * fixed-size table.
+ * Entries are stored in storage segments allocated as the table grows, up to
+ * "max_entries_".  The first storage segment holds the initial count rounded up
+ * to a power of two, and each following one twice as many entries as the
+ * previous one.  Storage segments never move, so entries can be read without
+ * holding the lock serializing additions, and storage segments past the top
+ * index are released when the table is trimmed.
  *
  * If we delete entries from the middle of the list, we will be left with
  * "holes".  We track the number of holes so that, when adding new elements,
@@ -176,10 +185,10 @@ static const uint32_t IRT_FIRST_SEGMENT = 0;
  * stale references aren't possible (though we may be able to get similar
  * benefits with other approaches).
  *
- * TODO: consider a "lastDeleteIndex" for quick hole-filling when an
- * add immediately follows a delete; must invalidate after segment pop
- * (which could increase the cost/complexity of method call/return).
- * Might be worth only using it for JNI globals.
+ * Global and weak global tables don't use segments: they keep the indices of
+ * their holes in a free list so that adding an entry to a table with holes
+ * doesn't scan the table.  Local tables still hunt for holes in the current
+ * segment, which is usually small.
  *
  * TODO: may want completely different add/remove algorithms for global
  * and local refs to improve performance.  A large circular buffer might
@@ -226,9 +235,12 @@ class IrtEntry {
 static_assert(sizeof(IrtEntry) == (1 + kIRTPrevCount) * sizeof(uint32_t),
               "Unexpected sizeof(IrtEntry)");
 
+class IndirectReferenceTable;
+
 class IrtIterator {
  public:
-  IrtIterator(IrtEntry* table, size_t i, size_t capacity) SHARED_REQUIRES(Locks::mutator_lock_)
+  IrtIterator(const IndirectReferenceTable* table, size_t i, size_t capacity)
+      SHARED_REQUIRES(Locks::mutator_lock_)
       : table_(table), i_(i), capacity_(capacity) {
   }
 
@@ -237,17 +249,14 @@ class IrtIterator {
     return *this;
   }
 
-  GcRoot<mirror::Object>* operator*() {
-    // This does not have a read barrier as this is used to visit roots.
-    return table_[i_].GetReference();
-  }
+  GcRoot<mirror::Object>* operator*();
 
   bool equals(const IrtIterator& rhs) const {
     return (i_ == rhs.i_ && table_ == rhs.table_);
   }
 
  private:
-  IrtEntry* const table_;
+  const IndirectReferenceTable* const table_;
   size_t i_;
   const size_t capacity_;
 };
@@ -327,11 +336,11 @@ class IndirectReferenceTable {
 
   // Note IrtIterator does not have a read barrier as it's used to visit roots.
   IrtIterator begin() {
-    return IrtIterator(table_, 0, Capacity());
+    return IrtIterator(this, 0, Capacity());
   }
 
   IrtIterator end() {
-    return IrtIterator(table_, Capacity(), Capacity());
+    return IrtIterator(this, Capacity(), Capacity());
   }
 
   void VisitRoots(RootVisitor* visitor, const RootInfo& root_info)
@@ -352,10 +361,36 @@ class IndirectReferenceTable {
     return Offset(0);
   }
 
-  // Release pages past the end of the table that may have previously held references.
+  // Release storage segments and pages past the end of the table that may have previously held
+  // references.
   void Trim() SHARED_REQUIRES(Locks::mutator_lock_);
 
  private:
+  // Enough storage segments to reach kIRTMaxEntries from a first segment of a single entry.
+  static constexpr size_t kMaxStorageSegments = 17;
+
+  // Return the entry at "index", whose storage segment must be allocated.
+  IrtEntry* GetEntry(size_t index) const {
+    size_t segment = StorageSegmentOf(index);
+    DCHECK(storage_segments_[segment] != nullptr) << index;
+    return &storage_segments_[segment][index - StorageSegmentStart(segment)];
+  }
+
+  size_t StorageSegmentOf(size_t index) const {
+    return static_cast<size_t>(MostSignificantBit((index >> first_segment_shift_) + 1));
+  }
+
+  size_t StorageSegmentStart(size_t segment) const {
+    return ((static_cast<size_t>(1) << segment) - 1) << first_segment_shift_;
+  }
+
+  size_t StorageSegmentSize(size_t segment) const {
+    return static_cast<size_t>(1) << (first_segment_shift_ + segment);
+  }
+
+  // Map the storage segment holding the entry at "index" if it is not mapped yet.
+  bool EnsureStorageFor(size_t index, std::string* error_msg);
+
   // Extract the table index from an indirect reference.
   static uint32_t ExtractIndex(IndirectRef iref) {
     uintptr_t uref = reinterpret_cast<uintptr_t>(iref);
@@ -368,7 +403,7 @@ class IndirectReferenceTable {
    */
   IndirectRef ToIndirectRef(uint32_t tableIndex) const {
     DCHECK_LT(tableIndex, 65536U);
-    uint32_t serialChunk = table_[tableIndex].GetSerial();
+    uint32_t serialChunk = GetEntry(tableIndex)->GetSerial();
     uintptr_t uref = (serialChunk << 20) | (tableIndex << 2) | kind_;
     return reinterpret_cast<IndirectRef>(uref);
   }
@@ -383,17 +418,29 @@ class IndirectReferenceTable {
   /* semi-public - read/write by jni down calls */
   IRTSegmentState segment_state_;
 
-  // Mem map where we store the indirect refs.
-  std::unique_ptr<MemMap> table_mem_map_;
-  // bottom of the stack. Do not directly access the object references
-  // in this as they are roots. Use Get() that has a read barrier.
-  IrtEntry* table_;
+  // Mem maps where we store the indirect refs, null past the last storage segment in use.
+  std::unique_ptr<MemMap> storage_mem_maps_[kMaxStorageSegments];
+  // Beginning of the storage segments. Do not directly access the object references
+  // in these as they are roots. Use Get() that has a read barrier.
+  IrtEntry* storage_segments_[kMaxStorageSegments];
+  // Log2 of the number of entries of the first storage segment.
+  const size_t first_segment_shift_;
   /* bit mask, ORed into all irefs */
   const IndirectRefKind kind_;
   /* max #of entries allowed */
   const size_t max_entries_;
+  // Indices of the holes of a global or weak global table. May also contain stale indices of
+  // entries which were reused or are now past the top index.
+  std::vector<uint32_t> free_indices_;
+
+  friend class IrtIterator;
 };
 
+inline GcRoot<mirror::Object>* IrtIterator::operator*() {
+  // This does not have a read barrier as this is used to visit roots.
+  return table_->GetEntry(i_)->GetReference();
+}
+
 }  // namespace art
 
 #endif  // ART_RUNTIME_INDIRECT_REFERENCE_TABLE_H_
@@ -254,4 +254,89 @@ TEST_F(IndirectReferenceTableTest, BasicTest) {
   CheckDump(&irt, 0, 0);
 }
 
+TEST_F(IndirectReferenceTableTest, GrowAndTrim) {
+  ScopedObjectAccess soa(Thread::Current());
+  static const size_t kTableInitial = 4;
+  static const size_t kTableMax = 1000;
+  IndirectReferenceTable irt(kTableInitial, kTableMax, kLocal);
+
+  mirror::Class* c = class_linker_->FindSystemClass(soa.Self(), "Ljava/lang/Object;");
+  ASSERT_TRUE(c != nullptr);
+  mirror::Object* obj0 = c->AllocObject(soa.Self());
+  ASSERT_TRUE(obj0 != nullptr);
+
+  const uint32_t cookie = IRT_FIRST_SEGMENT;
+
+  // Fill the table, which grows from its initial size to its maximum.
+  std::vector<IndirectRef> refs;
+  for (size_t i = 0; i < kTableMax; ++i) {
+    IndirectRef iref = irt.Add(cookie, obj0);
+    ASSERT_TRUE(iref != nullptr) << "Failed adding " << i;
+    refs.push_back(iref);
+  }
+  ASSERT_EQ(kTableMax, irt.Capacity());
+  for (IndirectRef iref : refs) {
+    EXPECT_EQ(obj0, irt.Get(iref));
+  }
+
+  // Drop all the entries as when popping a local frame, then release the unused storage.
+  irt.SetSegmentState(cookie);
+  irt.Trim();
+  ASSERT_EQ(0U, irt.Capacity());
+
+  // The table grows again once trimmed.
+  refs.clear();
+  for (size_t i = 0; i < kTableMax; ++i) {
+    IndirectRef iref = irt.Add(cookie, obj0);
+    ASSERT_TRUE(iref != nullptr) << "Failed adding " << i;
+    refs.push_back(iref);
+  }
+  for (IndirectRef iref : refs) {
+    EXPECT_EQ(obj0, irt.Get(iref));
+  }
+  CheckDump(&irt, kTableMax, 1);
+}
+
+TEST_F(IndirectReferenceTableTest, GlobalHoleReuse) {
+  ScopedObjectAccess soa(Thread::Current());
+  static const size_t kTableInitial = 16;
+  static const size_t kTableMax = 64;
+  IndirectReferenceTable irt(kTableInitial, kTableMax, kGlobal);
+
+  mirror::Class* c = class_linker_->FindSystemClass(soa.Self(), "Ljava/lang/Object;");
+  ASSERT_TRUE(c != nullptr);
+  mirror::Object* obj0 = c->AllocObject(soa.Self());
+  ASSERT_TRUE(obj0 != nullptr);
+
+  const uint32_t cookie = IRT_FIRST_SEGMENT;
+
+  IndirectRef refs[kTableMax];
+  for (size_t i = 0; i < kTableMax; ++i) {
+    refs[i] = irt.Add(cookie, obj0);
+    ASSERT_TRUE(refs[i] != nullptr);
+  }
+  // Punch holes and fill them again without growing the table.
+  for (size_t i = 0; i < kTableMax - 1; i += 2) {
+    ASSERT_TRUE(irt.Remove(cookie, refs[i]));
+  }
+  for (size_t i = 0; i < kTableMax - 1; i += 2) {
+    refs[i] = irt.Add(cookie, obj0);
+    ASSERT_TRUE(refs[i] != nullptr);
+  }
+  ASSERT_EQ(kTableMax, irt.Capacity()) << "holes not filled";
+  for (size_t i = 0; i < kTableMax; ++i) {
+    EXPECT_EQ(obj0, irt.Get(refs[i]));
+  }
+
+  // Holes consumed by removing the top entry are not reused.
+  ASSERT_TRUE(irt.Remove(cookie, refs[kTableMax - 3]));
+  ASSERT_TRUE(irt.Remove(cookie, refs[kTableMax - 2]));
+  ASSERT_TRUE(irt.Remove(cookie, refs[kTableMax - 1]));
+  ASSERT_EQ(kTableMax - 3, irt.Capacity());
+  IndirectRef iref = irt.Add(cookie, obj0);
+  ASSERT_TRUE(iref != nullptr);
+  ASSERT_EQ(kTableMax - 2, irt.Capacity());
+  EXPECT_EQ(obj0, irt.Get(iref));
+}
+
 }  // namespace art
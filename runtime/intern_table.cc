@@ -92,20 +92,18 @@ mirror::String* InternTable::LookupWeak(Thread* self, mirror::String* s) {
   return LookupWeakLocked(s);
 }
 
-mirror::String* InternTable::LookupStrong(Thread* self, mirror::String* s) {
-  MutexLock mu(self, *Locks::intern_table_lock_);
-  return LookupStrongLocked(s);
+mirror::String* InternTable::LookupStrong(Thread* self ATTRIBUTE_UNUSED, mirror::String* s) {
+  return strong_interns_.FindWithoutLock(s);
 }
 
-mirror::String* InternTable::LookupStrong(Thread* self,
+mirror::String* InternTable::LookupStrong(Thread* self ATTRIBUTE_UNUSED,
                                           uint32_t utf16_length,
                                           const char* utf8_data) {
   DCHECK_EQ(utf16_length, CountModifiedUtf8Chars(utf8_data));
   Utf8String string(utf16_length,
                     utf8_data,
                     ComputeUtf16HashFromModifiedUtf8(utf8_data, utf16_length));
-  MutexLock mu(self, *Locks::intern_table_lock_);
-  return strong_interns_.Find(string);
+  return strong_interns_.FindWithoutLock(string);
 }
 
 mirror::String* InternTable::LookupWeakLocked(mirror::String* s) {
@@ -187,9 +185,10 @@ void InternTable::AddImagesStringsToTable(const std::vector<gc::space::ImageSpac
       mirror::ObjectArray<mirror::DexCache>* dex_caches = root->AsObjectArray<mirror::DexCache>();
       for (int32_t i = 0; i < dex_caches->GetLength(); ++i) {
         mirror::DexCache* dex_cache = dex_caches->Get(i);
+        mirror::StringDexCacheType* const strings = dex_cache->GetStrings();
         const size_t num_strings = dex_cache->NumStrings();
         for (size_t j = 0; j < num_strings; ++j) {
-          mirror::String* image_string = dex_cache->GetResolvedString(j);
+          mirror::String* image_string = mirror::StringDexCachePair::ReadSlot(strings, j);
           if (image_string != nullptr) {
             mirror::String* found = LookupStrongLocked(image_string);
             if (found == nullptr) {
@@ -257,6 +256,12 @@ mirror::String* InternTable::Insert(mirror::String* s, bool is_strong, bool hold
   if (s == nullptr) {
     return nullptr;
   }
+  // Most strings interned are already strongly interned, e.g. when resolving string constants.
+  // Find them without serializing on the intern table lock.
+  mirror::String* const strong = strong_interns_.FindWithoutLock(s);
+  if (strong != nullptr) {
+    return strong;
+  }
   Thread* const self = Thread::Current();
   MutexLock mu(self, *Locks::intern_table_lock_);
   if (kDebugLocking && !holding_locks) {
@@ -316,6 +321,11 @@ mirror::String* InternTable::Insert(mirror::String* s, bool is_strong, bool hold
 
 mirror::String* InternTable::InternStrong(int32_t utf16_length, const char* utf8_data) {
   DCHECK(utf8_data != nullptr);
+  // Avoid allocating a string if it is already interned.
+  mirror::String* const strong = LookupStrong(Thread::Current(), utf16_length, utf8_data);
+  if (strong != nullptr) {
+    return strong;
+  }
   return InternStrong(mirror::String::AllocFromModifiedUtf8(
       Thread::Current(), utf16_length, utf8_data));
 }
@@ -405,87 +415,108 @@ size_t InternTable::Table::AddTableFromMemory(const uint8_t* ptr) {
     }
   }
   // Insert at the front since we add new interns into the back.
-  tables_.insert(tables_.begin(), std::move(set));
+  tables_.AddFront(new UnorderedSet(std::move(set)));
   return read_count;
 }
 
 size_t InternTable::Table::WriteToMemory(uint8_t* ptr) {
-  if (tables_.empty()) {
+  const PublishedHashSets<UnorderedSet>::SetVector& tables = tables_.GetSets();
+  if (tables.empty()) {
     return 0;
   }
   UnorderedSet* table_to_write;
   UnorderedSet combined;
-  if (tables_.size() > 1) {
+  if (tables.size() > 1) {
     table_to_write = &combined;
-    for (UnorderedSet& table : tables_) {
-      for (GcRoot<mirror::String>& string : table) {
+    for (const std::unique_ptr<UnorderedSet>& table : tables) {
+      for (GcRoot<mirror::String>& string : *table) {
         combined.Insert(string);
       }
     }
   } else {
-    table_to_write = &tables_.back();
+    table_to_write = tables.back().get();
   }
   return table_to_write->WriteToMemory(ptr);
 }
 
 void InternTable::Table::Remove(mirror::String* s) {
-  for (UnorderedSet& table : tables_) {
-    auto it = table.Find(GcRoot<mirror::String>(s));
-    if (it != table.end()) {
-      table.Erase(it);
+  for (const std::unique_ptr<UnorderedSet>& table : tables_.GetSets()) {
+    auto it = table->Find(GcRoot<mirror::String>(s));
+    if (it != table->end()) {
+      tables_.StartErase();
+      table->Erase(it);
+      tables_.FinishErase();
       return;
     }
   }
   LOG(FATAL) << "Attempting to remove non-interned string " << s->ToModifiedUtf8();
 }
 
-mirror::String* InternTable::Table::Find(mirror::String* s) {
+template <typename Key>
+mirror::String* InternTable::Table::FindLocked(const Key& key) {
   Locks::intern_table_lock_->AssertHeld(Thread::Current());
-  for (UnorderedSet& table : tables_) {
-    auto it = table.Find(GcRoot<mirror::String>(s));
-    if (it != table.end()) {
+  for (const std::unique_ptr<UnorderedSet>& table : tables_.GetSets()) {
+    auto it = table->Find(key);
+    if (it != table->end()) {
       return it->Read();
     }
   }
   return nullptr;
 }
 
-mirror::String* InternTable::Table::Find(const Utf8String& string) {
-  Locks::intern_table_lock_->AssertHeld(Thread::Current());
-  for (UnorderedSet& table : tables_) {
-    auto it = table.Find(string);
-    if (it != table.end()) {
-      return it->Read();
-    }
+template <typename Key>
+mirror::String* InternTable::Table::FindUnlocked(const Key& key) {
+  GcRoot<mirror::String> string;
+  if (LIKELY(tables_.FindWithoutLock(key, StringHashEquals()(key), &string))) {
+    return string.Read();
   }
-  return nullptr;
+  // A removal may have moved the string we are looking for while we were searching.
+  MutexLock mu(Thread::Current(), *Locks::intern_table_lock_);
+  return FindLocked(key);
+}
+
+mirror::String* InternTable::Table::Find(mirror::String* s) {
+  return FindLocked(GcRoot<mirror::String>(s));
+}
+
+mirror::String* InternTable::Table::Find(const Utf8String& string) {
+  return FindLocked(string);
+}
+
+mirror::String* InternTable::Table::FindWithoutLock(mirror::String* s) {
+  return FindUnlocked(GcRoot<mirror::String>(s));
+}
+
+mirror::String* InternTable::Table::FindWithoutLock(const Utf8String& string) {
+  return FindUnlocked(string);
 }
 
 void InternTable::Table::AddNewTable() {
-  tables_.push_back(UnorderedSet());
+  tables_.AddBack(new UnorderedSet());
 }
 
 void InternTable::Table::Insert(mirror::String* s) {
   // Always insert the last table, the image tables are before and we avoid inserting into these
   // to prevent dirty pages.
-  DCHECK(!tables_.empty());
-  tables_.back().Insert(GcRoot<mirror::String>(s));
+  tables_.Insert(GcRoot<mirror::String>(s));
 }
 
 void InternTable::Table::VisitRoots(RootVisitor* visitor) {
   BufferedRootVisitor<kDefaultBufferedRootCount> buffered_visitor(
       visitor, RootInfo(kRootInternedString));
-  for (UnorderedSet& table : tables_) {
-    for (auto& intern : table) {
+  for (const std::unique_ptr<UnorderedSet>& table : tables_.GetSets()) {
+    for (auto& intern : *table) {
       buffered_visitor.VisitRoot(intern);
     }
   }
 }
 
 void InternTable::Table::SweepWeaks(IsMarkedVisitor* visitor) {
-  for (UnorderedSet& table : tables_) {
-    SweepWeaks(&table, visitor);
+  tables_.StartErase();
+  for (const std::unique_ptr<UnorderedSet>& table : tables_.GetSets()) {
+    SweepWeaks(table.get(), visitor);
   }
+  tables_.FinishErase();
 }
 
 void InternTable::Table::SweepWeaks(UnorderedSet* set, IsMarkedVisitor* visitor) {
@@ -503,11 +534,11 @@ void InternTable::Table::SweepWeaks(UnorderedSet* set, IsMarkedVisitor* visitor)
 }
 
 size_t InternTable::Table::Size() const {
-  return std::accumulate(tables_.begin(),
-                         tables_.end(),
+  return std::accumulate(tables_.GetSets().begin(),
+                         tables_.GetSets().end(),
                          0U,
-                         [](size_t sum, const UnorderedSet& set) {
-                           return sum + set.Size();
+                         [](size_t sum, const std::unique_ptr<UnorderedSet>& set) {
+                           return sum + set->Size();
                          });
 }
 
@@ -524,12 +555,8 @@ void InternTable::ChangeWeakRootStateLocked(gc::WeakRootState new_state) {
   }
 }
 
-InternTable::Table::Table() {
-  Runtime* const runtime = Runtime::Current();
-  // Initial table.
-  tables_.push_back(UnorderedSet());
-  tables_.back().SetLoadFactor(runtime->GetHashTableMinLoadFactor(),
-                               runtime->GetHashTableMaxLoadFactor());
-}
+InternTable::Table::Table()
+    : tables_(new UnorderedSet(Runtime::Current()->GetHashTableMinLoadFactor(),
+                               Runtime::Current()->GetHashTableMaxLoadFactor())) {}
 
 }  // namespace art
@@ -23,6 +23,7 @@
 #include "base/allocator.h"
 #include "base/hash_set.h"
 #include "base/mutex.h"
+#include "base/published_hash_sets.h"
 #include "gc_root.h"
 #include "gc/weak_root_state.h"
 #include "object_callbacks.h"
@@ -178,6 +179,9 @@ class InternTable {
 
   // Table which holds pre zygote and post zygote interned strings. There is one instance for
   // weak interns and strong interns.
+  //
+  // Lookups may also be done without the intern table lock, with FindWithoutLock, see
+  // PublishedHashSets.
   class Table {
    public:
     Table();
@@ -185,6 +189,10 @@ class InternTable {
         REQUIRES(Locks::intern_table_lock_);
     mirror::String* Find(const Utf8String& string) SHARED_REQUIRES(Locks::mutator_lock_)
         REQUIRES(Locks::intern_table_lock_);
+    mirror::String* FindWithoutLock(mirror::String* s) SHARED_REQUIRES(Locks::mutator_lock_)
+        REQUIRES(!Locks::intern_table_lock_);
+    mirror::String* FindWithoutLock(const Utf8String& string)
+        SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(!Locks::intern_table_lock_);
     void Insert(mirror::String* s) SHARED_REQUIRES(Locks::mutator_lock_)
         REQUIRES(Locks::intern_table_lock_);
     void Remove(mirror::String* s)
@@ -210,12 +218,19 @@ class InternTable {
     typedef HashSet<GcRoot<mirror::String>, GcRootEmptyFn, StringHashEquals, StringHashEquals,
         TrackingAllocator<GcRoot<mirror::String>, kAllocatorTagInternTable>> UnorderedSet;
 
+    template <typename Key>
+    mirror::String* FindLocked(const Key& key)
+        SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
+    template <typename Key>
+    mirror::String* FindUnlocked(const Key& key)
+        SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(!Locks::intern_table_lock_);
+
     void SweepWeaks(UnorderedSet* set, IsMarkedVisitor* visitor)
         SHARED_REQUIRES(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
 
     // We call AddNewTable when we create the zygote to reduce private dirty pages caused by
     // modifying the zygote intern table. The back of table is modified when strings are interned.
-    std::vector<UnorderedSet> tables_;
+    PublishedHashSets<UnorderedSet> tables_;
   };
 
   // Insert if non null, otherwise return null. Must be called holding the mutator lock.
@@ -266,8 +281,9 @@ class InternTable {
   // Since this contains (strong) roots, they need a read barrier to
   // enable concurrent intern table (strong) root scan. Do not
   // directly access the strings in it. Use functions that contain
-  // read barriers.
-  Table strong_interns_ GUARDED_BY(Locks::intern_table_lock_);
+  // read barriers. Not GUARDED_BY the intern table lock since it can be searched without it,
+  // the Table functions that need the lock require it.
+  Table strong_interns_;
   std::vector<GcRoot<mirror::String>> new_strong_intern_roots_
       GUARDED_BY(Locks::intern_table_lock_);
   // Since this contains (weak) roots, they need a read barrier. Do
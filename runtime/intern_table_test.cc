@@ -16,9 +16,12 @@
 
 #include "intern_table.h"
 
+#include "base/stringprintf.h"
+#include "class_linker-inl.h"
 #include "common_runtime_test.h"
 #include "mirror/object.h"
 #include "handle_scope-inl.h"
+#include "mirror/object_array-inl.h"
 #include "mirror/string.h"
 #include "scoped_thread_state_change.h"
 
@@ -212,4 +215,28 @@ TEST_F(InternTableTest, LookupStrong) {
   EXPECT_TRUE(lookup_foobbS == nullptr);
 }
 
+TEST_F(InternTableTest, LookupStrongAfterGrowth) {
+  ScopedObjectAccess soa(Thread::Current());
+  InternTable intern_table;
+  // Enough strings to replace the table with larger copies a few times.
+  static constexpr size_t kNumStrings = 5000;
+  StackHandleScope<1> hs(soa.Self());
+  Handle<mirror::ObjectArray<mirror::String>> interned(
+      hs.NewHandle(class_linker_->AllocStringArray(soa.Self(), kNumStrings)));
+  ASSERT_TRUE(interned.Get() != nullptr);
+  for (size_t i = 0; i < kNumStrings; ++i) {
+    const std::string name = StringPrintf("string%zu", i);
+    mirror::String* string = intern_table.InternStrong(name.length(), name.c_str());
+    ASSERT_TRUE(string != nullptr);
+    interned->Set<false>(i, string);
+  }
+  EXPECT_EQ(kNumStrings, intern_table.StrongSize());
+  for (size_t i = 0; i < kNumStrings; ++i) {
+    const std::string name = StringPrintf("string%zu", i);
+    EXPECT_EQ(interned->Get(i), intern_table.LookupStrong(soa.Self(), name.length(), name.c_str()));
+    EXPECT_EQ(interned->Get(i), intern_table.InternStrong(name.length(), name.c_str()));
+  }
+  EXPECT_TRUE(intern_table.LookupStrong(soa.Self(), 6, "string") == nullptr);
+}
+
 }  // namespace art
@@ -272,6 +272,8 @@ static inline JValue Execute(
     bool stay_in_interpreter = false) SHARED_REQUIRES(Locks::mutator_lock_) {
   DCHECK(!shadow_frame.GetMethod()->IsAbstract());
   DCHECK(!shadow_frame.GetMethod()->IsNative());
+  // Code of unloaded dex files is only reached again through a new method entry.
+  self->GetInterpreterCache()->Revalidate();
   if (LIKELY(shadow_frame.GetDexPC() == 0)) {  // Entering the method, but not via deoptimization.
     if (kIsDebugBuild) {
       self->AssertNoPendingException();
@@ -0,0 +1,34 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "interpreter_cache.h"
+
+namespace art {
+
+Atomic<size_t> InterpreterCache::global_generation_(0u);
+
+void InterpreterCache::Clear() {
+  static_assert(offsetof(InterpreterCache, entries_) == 0u,
+                "The mterp handlers expect the entries at the start of the cache");
+  static_assert(sizeof(Entry) == 2 * sizeof(void*), "Unexpected interpreter cache entry size");
+  generation_ = global_generation_.LoadRelaxed();
+  for (Entry& entry : entries_) {
+    entry.key = nullptr;
+    entry.value = 0u;
+  }
+}
+
+}  // namespace art
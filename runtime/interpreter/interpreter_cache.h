@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_INTERPRETER_INTERPRETER_CACHE_H_
+#define ART_RUNTIME_INTERPRETER_INTERPRETER_CACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "atomic.h"
+#include "base/bit_utils.h"
+#include "base/macros.h"
+
+namespace art {
+
+// Small direct-mapped cache of per-instruction interpreter state, such as the ArtField*
+// of a field access or the resolved ArtMethod* of an invoke. Entries are keyed by the
+// address of the dex instruction, which is unique among the code that is currently loaded.
+//
+// Each thread owns its cache, so lookups need no synchronization. The cache lives in the
+// thread's pointer-sized TLS values, where the mterp field access handlers probe it directly.
+//
+// Unloading class loaders frees the cached fields and methods and may let the dex code be
+// remapped at the same address. Entries of code that is still loaded stay valid, and new code
+// can only be reached by entering a method in the interpreter, so the caches of all threads are
+// invalidated through a global generation that is only checked on method entry.
+class InterpreterCache {
+ public:
+  // Number of entries. Must be a power of two.
+  static constexpr size_t kSize = 256;
+
+  InterpreterCache() {
+    Clear();
+  }
+
+  ALWAYS_INLINE bool Get(const void* key, size_t* value) {
+    const Entry& entry = entries_[IndexOf(key)];
+    if (LIKELY(entry.key == key)) {
+      *value = entry.value;
+      return true;
+    }
+    return false;
+  }
+
+  ALWAYS_INLINE void Set(const void* key, size_t value) {
+    Entry& entry = entries_[IndexOf(key)];
+    entry.key = key;
+    entry.value = value;
+  }
+
+  // Clear the cache if InvalidateAll() was called since it was last cleared.
+  ALWAYS_INLINE void Revalidate() {
+    if (UNLIKELY(generation_ != global_generation_.LoadRelaxed())) {
+      Clear();
+    }
+  }
+
+  void Clear();
+
+  // Invalidate the caches of all threads. Each cache is cleared by its owner on its next
+  // call to Revalidate().
+  static void InvalidateAll() {
+    global_generation_.FetchAndAddSequentiallyConsistent(1);
+  }
+
+ private:
+  // Laid out for the mterp handlers, see INTERPRETER_CACHE_SIZE_LOG2 in asm_support.h.
+  struct Entry {
+    const void* key;
+    size_t value;
+  };
+
+  static size_t IndexOf(const void* key) {
+    static_assert(IsPowerOfTwo(kSize), "Interpreter cache size must be a power of two");
+    // Dex instructions are 2-byte aligned and most of them are 4 or 6 bytes long.
+    return (reinterpret_cast<uintptr_t>(key) >> 1) & (kSize - 1);
+  }
+
+  static Atomic<size_t> global_generation_;
+
+  // The entries come first so that the mterp handlers can index them from the thread.
+  Entry entries_[kSize];
+  size_t generation_;
+
+  DISALLOW_COPY_AND_ASSIGN(InterpreterCache);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_INTERPRETER_INTERPRETER_CACHE_H_
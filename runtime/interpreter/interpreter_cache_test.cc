@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "interpreter_cache.h"
+
+#include <memory>
+
+#include "gtest/gtest.h"
+
+namespace art {
+
+TEST(InterpreterCache, GetSet) {
+  std::unique_ptr<InterpreterCache> cache(new InterpreterCache());
+  uint16_t code[2 * InterpreterCache::kSize];
+  size_t value = 0u;
+
+  EXPECT_FALSE(cache->Get(&code[0], &value));
+  cache->Set(&code[0], 42u);
+  EXPECT_TRUE(cache->Get(&code[0], &value));
+  EXPECT_EQ(42u, value);
+  EXPECT_FALSE(cache->Get(&code[1], &value));
+
+  // An instruction mapping to the same entry evicts the previous one.
+  cache->Set(&code[InterpreterCache::kSize], 43u);
+  EXPECT_FALSE(cache->Get(&code[0], &value));
+  EXPECT_TRUE(cache->Get(&code[InterpreterCache::kSize], &value));
+  EXPECT_EQ(43u, value);
+
+  cache->Clear();
+  EXPECT_FALSE(cache->Get(&code[InterpreterCache::kSize], &value));
+}
+
+TEST(InterpreterCache, InvalidateAll) {
+  std::unique_ptr<InterpreterCache> cache1(new InterpreterCache());
+  std::unique_ptr<InterpreterCache> cache2(new InterpreterCache());
+  uint16_t code[4];
+  size_t value = 0u;
+
+  cache1->Set(&code[0], 1u);
+  cache2->Set(&code[2], 2u);
+  InterpreterCache::InvalidateAll();
+  // Lookups do not check the generation, only Revalidate() does.
+  EXPECT_TRUE(cache1->Get(&code[0], &value));
+  cache1->Revalidate();
+  cache2->Revalidate();
+  EXPECT_FALSE(cache1->Get(&code[0], &value));
+  EXPECT_FALSE(cache2->Get(&code[2], &value));
+
+  // Entries added after the invalidation are kept.
+  cache1->Set(&code[0], 3u);
+  cache1->Revalidate();
+  EXPECT_TRUE(cache1->Get(&code[0], &value));
+  EXPECT_EQ(3u, value);
+}
+
+}  // namespace art
@@ -34,6 +34,7 @@
 #include "dex_instruction-inl.h"
 #include "entrypoints/entrypoint_utils-inl.h"
 #include "handle_scope-inl.h"
+#include "interpreter/interpreter_cache.h"
 #include "jit/jit.h"
 #include "lambda/art_lambda_method.h"
 #include "lambda/box_table.h"
@@ -348,7 +349,7 @@ static inline const char* GetStringDataByDexStringIndexOrThrow(ShadowFrame& shad
   mirror::Class* declaring_class = method->GetDeclaringClass();
   if (!do_access_check) {
     // MethodVerifier refuses methods with string_idx out of bounds.
-    DCHECK_LT(string_idx, declaring_class->GetDexCache()->NumStrings());
+    DCHECK_LT(string_idx, dex_file->NumStringIds());
   } else {
     // Access checks enabled: perform string index bounds ourselves.
     if (string_idx >= dex_file->GetHeader().string_ids_size_) {
@@ -631,8 +632,36 @@ static inline bool DoInvoke(Thread* self, ShadowFrame& shadow_frame, const Instr
   const uint32_t vregC = (is_range) ? inst->VRegC_3rc() : inst->VRegC_35c();
   Object* receiver = (type == kStatic) ? nullptr : shadow_frame.GetVRegReference(vregC);
   ArtMethod* sf_method = shadow_frame.GetMethod();
-  ArtMethod* const called_method = FindMethodFromCode<type, do_access_check>(
-      method_idx, &receiver, sf_method, self);
+  ArtMethod* called_method = nullptr;
+  // Verified static, direct and virtual invokes cache the resolved method of the instruction,
+  // which saves the dex cache lookup and the access checks on the next execution.
+  constexpr bool kUseCache = !do_access_check &&
+      (type == kStatic || type == kDirect || type == kVirtual);
+  InterpreterCache* const cache = self->GetInterpreterCache();
+  size_t cached_method = 0u;
+  if (kUseCache &&
+      (type == kStatic || receiver != nullptr) &&
+      cache->Get(inst, &cached_method)) {
+    ArtMethod* const resolved_method = reinterpret_cast<ArtMethod*>(cached_method);
+    if (type == kVirtual) {
+      called_method = receiver->GetClass()->GetVTableEntry(
+          resolved_method->GetMethodIndex(),
+          Runtime::Current()->GetClassLinker()->GetImagePointerSize());
+    } else {
+      called_method = resolved_method;
+    }
+  } else {
+    called_method = FindMethodFromCode<type, do_access_check>(
+        method_idx, &receiver, sf_method, self);
+    if (kUseCache && called_method != nullptr) {
+      ArtMethod* const resolved_method = (type == kVirtual)
+          ? Runtime::Current()->GetClassLinker()->GetResolvedMethod(method_idx, sf_method)
+          : called_method;
+      if (resolved_method != nullptr) {
+        cache->Set(inst, reinterpret_cast<size_t>(resolved_method));
+      }
+    }
+  }
   // The shadow frame should already be pushed, so we don't need to update it.
   if (UNLIKELY(called_method == nullptr)) {
     CHECK(self->IsExceptionPending());
@@ -751,8 +780,8 @@ static inline String* ResolveString(Thread* self, ShadowFrame& shadow_frame, uin
   ArtMethod* method = shadow_frame.GetMethod();
   mirror::Class* declaring_class = method->GetDeclaringClass();
   // MethodVerifier refuses methods with string_idx out of bounds.
-  DCHECK_LT(string_idx, declaring_class->GetDexCache()->NumStrings());
-  mirror::String* s = declaring_class->GetDexCacheStrings()[string_idx].Read();
+  DCHECK_LT(string_idx, declaring_class->GetDexFile().NumStringIds());
+  mirror::String* s = declaring_class->GetDexCache()->GetResolvedString(string_idx);
   if (UNLIKELY(s == nullptr)) {
     StackHandleScope<1> hs(self);
     Handle<mirror::DexCache> dex_cache(hs.NewHandle(declaring_class->GetDexCache()));
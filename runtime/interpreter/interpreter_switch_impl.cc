@@ -84,10 +84,20 @@ namespace interpreter {
     }                                                                                          \
   } while (false)
 
-#define HOTNESS_UPDATE()                                                                       \
+#define HOTNESS_UPDATE(offset)                                                                 \
   do {                                                                                         \
     if (jit != nullptr) {                                                                      \
       jit->AddSamples(self, method, 1, /*with_backedges*/ true);                               \
+      jit->AddLoopSamples(method, dex_pc + (offset), 1);                                       \
+    }                                                                                          \
+  } while (false)
+
+// Record a taken forward conditional branch, which the compiler may otherwise
+// speculate is never taken.
+#define TAKEN_BRANCH_UPDATE()                                                                  \
+  do {                                                                                         \
+    if (jit != nullptr) {                                                                      \
+      jit->AddTakenBranch(method, dex_pc);                                                     \
     }                                                                                          \
   } while (false)
 
@@ -582,7 +592,7 @@ JValue ExecuteSwitchImpl(Thread* self, const DexFile::CodeItem* code_item,
         int8_t offset = inst->VRegA_10t(inst_data);
         BRANCH_INSTRUMENTATION(offset);
         if (IsBackwardBranch(offset)) {
-          HOTNESS_UPDATE();
+          HOTNESS_UPDATE(offset);
           self->AllowThreadSuspension();
         }
         inst = inst->RelativeAt(offset);
@@ -593,7 +603,7 @@ JValue ExecuteSwitchImpl(Thread* self, const DexFile::CodeItem* code_item,
         int16_t offset = inst->VRegA_20t();
         BRANCH_INSTRUMENTATION(offset);
         if (IsBackwardBranch(offset)) {
-          HOTNESS_UPDATE();
+          HOTNESS_UPDATE(offset);
           self->AllowThreadSuspension();
         }
         inst = inst->RelativeAt(offset);
@@ -604,7 +614,7 @@ JValue ExecuteSwitchImpl(Thread* self, const DexFile::CodeItem* code_item,
         int32_t offset = inst->VRegA_30t();
         BRANCH_INSTRUMENTATION(offset);
         if (IsBackwardBranch(offset)) {
-          HOTNESS_UPDATE();
+          HOTNESS_UPDATE(offset);
           self->AllowThreadSuspension();
         }
         inst = inst->RelativeAt(offset);
@@ -615,7 +625,7 @@ JValue ExecuteSwitchImpl(Thread* self, const DexFile::CodeItem* code_item,
         int32_t offset = DoPackedSwitch(inst, shadow_frame, inst_data);
         BRANCH_INSTRUMENTATION(offset);
         if (IsBackwardBranch(offset)) {
-          HOTNESS_UPDATE();
+          HOTNESS_UPDATE(offset);
           self->AllowThreadSuspension();
         }
         inst = inst->RelativeAt(offset);
@@ -626,7 +636,7 @@ JValue ExecuteSwitchImpl(Thread* self, const DexFile::CodeItem* code_item,
         int32_t offset = DoSparseSwitch(inst, shadow_frame, inst_data);
         BRANCH_INSTRUMENTATION(offset);
         if (IsBackwardBranch(offset)) {
-          HOTNESS_UPDATE();
+          HOTNESS_UPDATE(offset);
           self->AllowThreadSuspension();
         }
         inst = inst->RelativeAt(offset);
@@ -731,8 +741,10 @@ JValue ExecuteSwitchImpl(Thread* self, const DexFile::CodeItem* code_item,
           int16_t offset = inst->VRegC_22t();
           BRANCH_INSTRUMENTATION(offset);
           if (IsBackwardBranch(offset)) {
-            HOTNESS_UPDATE();
+            HOTNESS_UPDATE(offset);
             self->AllowThreadSuspension();
+          } else {
+            TAKEN_BRANCH_UPDATE();
           }
           inst = inst->RelativeAt(offset);
         } else {
@@ -748,8 +760,10 @@ JValue ExecuteSwitchImpl(Thread* self, const DexFile::CodeItem* code_item,
           int16_t offset = inst->VRegC_22t();
           BRANCH_INSTRUMENTATION(offset);
           if (IsBackwardBranch(offset)) {
-            HOTNESS_UPDATE();
+            HOTNESS_UPDATE(offset);
             self->AllowThreadSuspension();
+          } else {
+            TAKEN_BRANCH_UPDATE();
           }
           inst = inst->RelativeAt(offset);
         } else {
@@ -765,8 +779,10 @@ JValue ExecuteSwitchImpl(Thread* self, const DexFile::CodeItem* code_item,
           int16_t offset = inst->VRegC_22t();
           BRANCH_INSTRUMENTATION(offset);
           if (IsBackwardBranch(offset)) {
-            HOTNESS_UPDATE();
+            HOTNESS_UPDATE(offset);
             self->AllowThreadSuspension();
+          } else {
+            TAKEN_BRANCH_UPDATE();
           }
           inst = inst->RelativeAt(offset);
         } else {
@@ -782,8 +798,10 @@ JValue ExecuteSwitchImpl(Thread* self, const DexFile::CodeItem* code_item,
           int16_t offset = inst->VRegC_22t();
           BRANCH_INSTRUMENTATION(offset);
           if (IsBackwardBranch(offset)) {
-            HOTNESS_UPDATE();
+            HOTNESS_UPDATE(offset);
             self->AllowThreadSuspension();
+          } else {
+            TAKEN_BRANCH_UPDATE();
           }
           inst = inst->RelativeAt(offset);
         } else {
@@ -799,8 +817,10 @@ JValue ExecuteSwitchImpl(Thread* self, const DexFile::CodeItem* code_item,
           int16_t offset = inst->VRegC_22t();
           BRANCH_INSTRUMENTATION(offset);
           if (IsBackwardBranch(offset)) {
-            HOTNESS_UPDATE();
+            HOTNESS_UPDATE(offset);
             self->AllowThreadSuspension();
+          } else {
+            TAKEN_BRANCH_UPDATE();
           }
           inst = inst->RelativeAt(offset);
         } else {
@@ -816,8 +836,10 @@ JValue ExecuteSwitchImpl(Thread* self, const DexFile::CodeItem* code_item,
           int16_t offset = inst->VRegC_22t();
           BRANCH_INSTRUMENTATION(offset);
           if (IsBackwardBranch(offset)) {
-            HOTNESS_UPDATE();
+            HOTNESS_UPDATE(offset);
             self->AllowThreadSuspension();
+          } else {
+            TAKEN_BRANCH_UPDATE();
           }
           inst = inst->RelativeAt(offset);
         } else {
@@ -832,8 +854,10 @@ JValue ExecuteSwitchImpl(Thread* self, const DexFile::CodeItem* code_item,
           int16_t offset = inst->VRegB_21t();
           BRANCH_INSTRUMENTATION(offset);
           if (IsBackwardBranch(offset)) {
-            HOTNESS_UPDATE();
+            HOTNESS_UPDATE(offset);
             self->AllowThreadSuspension();
+          } else {
+            TAKEN_BRANCH_UPDATE();
           }
           inst = inst->RelativeAt(offset);
         } else {
@@ -848,8 +872,10 @@ JValue ExecuteSwitchImpl(Thread* self, const DexFile::CodeItem* code_item,
           int16_t offset = inst->VRegB_21t();
           BRANCH_INSTRUMENTATION(offset);
           if (IsBackwardBranch(offset)) {
-            HOTNESS_UPDATE();
+            HOTNESS_UPDATE(offset);
             self->AllowThreadSuspension();
+          } else {
+            TAKEN_BRANCH_UPDATE();
           }
           inst = inst->RelativeAt(offset);
         } else {
@@ -864,8 +890,10 @@ JValue ExecuteSwitchImpl(Thread* self, const DexFile::CodeItem* code_item,
           int16_t offset = inst->VRegB_21t();
           BRANCH_INSTRUMENTATION(offset);
           if (IsBackwardBranch(offset)) {
-            HOTNESS_UPDATE();
+            HOTNESS_UPDATE(offset);
             self->AllowThreadSuspension();
+          } else {
+            TAKEN_BRANCH_UPDATE();
           }
           inst = inst->RelativeAt(offset);
         } else {
@@ -880,8 +908,10 @@ JValue ExecuteSwitchImpl(Thread* self, const DexFile::CodeItem* code_item,
           int16_t offset = inst->VRegB_21t();
           BRANCH_INSTRUMENTATION(offset);
           if (IsBackwardBranch(offset)) {
-            HOTNESS_UPDATE();
+            HOTNESS_UPDATE(offset);
             self->AllowThreadSuspension();
+          } else {
+            TAKEN_BRANCH_UPDATE();
           }
           inst = inst->RelativeAt(offset);
         } else {
@@ -896,8 +926,10 @@ JValue ExecuteSwitchImpl(Thread* self, const DexFile::CodeItem* code_item,
           int16_t offset = inst->VRegB_21t();
           BRANCH_INSTRUMENTATION(offset);
           if (IsBackwardBranch(offset)) {
-            HOTNESS_UPDATE();
+            HOTNESS_UPDATE(offset);
             self->AllowThreadSuspension();
+          } else {
+            TAKEN_BRANCH_UPDATE();
           }
           inst = inst->RelativeAt(offset);
         } else {
@@ -912,8 +944,10 @@ JValue ExecuteSwitchImpl(Thread* self, const DexFile::CodeItem* code_item,
           int16_t offset = inst->VRegB_21t();
           BRANCH_INSTRUMENTATION(offset);
           if (IsBackwardBranch(offset)) {
-            HOTNESS_UPDATE();
+            HOTNESS_UPDATE(offset);
             self->AllowThreadSuspension();
+          } else {
+            TAKEN_BRANCH_UPDATE();
           }
           inst = inst->RelativeAt(offset);
         } else {
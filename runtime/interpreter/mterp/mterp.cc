@@ -19,11 +19,17 @@
  */
 #include "interpreter/interpreter_common.h"
 #include "entrypoints/entrypoint_utils-inl.h"
+#include "jit/profiling_info.h"
 #include "mterp.h"
 #include "debugger.h"
 
 namespace art {
 namespace interpreter {
+
+// Maximum number of back edges counted down by mterp between two hotness reports, for methods
+// with several loops and a ProfilingInfo.
+static constexpr int32_t kLoopHotnessBatchSize = 64;
+
 /*
  * Verify some constants used by the mterp interpreter.
  */
@@ -544,10 +550,120 @@ extern "C" int artSet64IndirectStaticFromMterp(uint32_t field_idx, ArtMethod* re
   return -1;  // failure
 }
 
-extern "C" int artSet8InstanceFromMterp(uint32_t field_idx, mirror::Object* obj, uint8_t new_value,
-                                        ArtMethod* referrer)
+// Returns the instance field accessed by the iget/iput at `dex_pc_ptr`, or null if it cannot
+// be found without resolution or access checks. Found fields are remembered in the thread's
+// interpreter cache, which skips the dex cache lookup and checks on later executions.
+template<FindFieldType kAccessType, size_t kFieldSize>
+ALWAYS_INLINE static ArtField* FindInstanceFieldFastFromMterp(uint16_t* dex_pc_ptr,
+                                                              ArtMethod* referrer,
+                                                              Thread* self)
+    SHARED_REQUIRES(Locks::mutator_lock_) {
+  InterpreterCache* const cache = self->GetInterpreterCache();
+  size_t cached_field;
+  if (LIKELY(cache->Get(dex_pc_ptr, &cached_field))) {
+    return reinterpret_cast<ArtField*>(cached_field);
+  }
+  const uint32_t field_idx = Instruction::At(dex_pc_ptr)->VRegC_22c();
+  ArtField* field = FindFieldFast(field_idx, referrer, kAccessType, kFieldSize);
+  if (LIKELY(field != nullptr)) {
+    cache->Set(dex_pc_ptr, reinterpret_cast<size_t>(field));
+  }
+  return field;
+}
+
+// Like FindInstanceFieldFastFromMterp(), but resolves the field if needed. Returns null with
+// a pending exception if the field cannot be resolved or accessed, or if `*obj` is null.
+template<FindFieldType kAccessType, size_t kFieldSize>
+ALWAYS_INLINE static ArtField* FindInstanceFieldFromMterp(uint16_t* dex_pc_ptr,
+                                                          mirror::Object** obj,
+                                                          ArtMethod* referrer,
+                                                          Thread* self)
+    SHARED_REQUIRES(Locks::mutator_lock_) {
+  ArtField* field = FindInstanceFieldFastFromMterp<kAccessType, kFieldSize>(dex_pc_ptr,
+                                                                            referrer,
+                                                                            self);
+  if (UNLIKELY(field == nullptr)) {
+    const uint32_t field_idx = Instruction::At(dex_pc_ptr)->VRegC_22c();
+    StackHandleScope<1> hs(self);
+    HandleWrapper<mirror::Object> h_obj(hs.NewHandleWrapper(obj));
+    field = FindFieldFromCode<kAccessType, true>(field_idx, referrer, self, kFieldSize);
+    if (UNLIKELY(field == nullptr)) {
+      DCHECK(self->IsExceptionPending());
+      return nullptr;
+    }
+    self->GetInterpreterCache()->Set(dex_pc_ptr, reinterpret_cast<size_t>(field));
+  }
+  if (UNLIKELY(*obj == nullptr)) {
+    constexpr bool is_read =
+        (kAccessType == InstancePrimitiveRead) || (kAccessType == InstanceObjectRead);
+    ThrowNullPointerExceptionForFieldAccess(field, is_read);
+    return nullptr;
+  }
+  return field;
+}
+
+extern "C" uint8_t artGetBooleanInstanceFromMterp(uint16_t* dex_pc_ptr, mirror::Object* obj,
+                                                  ArtMethod* referrer, Thread* self)
+    SHARED_REQUIRES(Locks::mutator_lock_) {
+  ArtField* field = FindInstanceFieldFromMterp<InstancePrimitiveRead, sizeof(int8_t)>(
+      dex_pc_ptr, &obj, referrer, self);
+  return LIKELY(field != nullptr) ? field->GetBoolean(obj) : 0;
+}
+
+extern "C" int8_t artGetByteInstanceFromMterp(uint16_t* dex_pc_ptr, mirror::Object* obj,
+                                              ArtMethod* referrer, Thread* self)
+    SHARED_REQUIRES(Locks::mutator_lock_) {
+  ArtField* field = FindInstanceFieldFromMterp<InstancePrimitiveRead, sizeof(int8_t)>(
+      dex_pc_ptr, &obj, referrer, self);
+  return LIKELY(field != nullptr) ? field->GetByte(obj) : 0;
+}
+
+extern "C" uint16_t artGetCharInstanceFromMterp(uint16_t* dex_pc_ptr, mirror::Object* obj,
+                                                ArtMethod* referrer, Thread* self)
+    SHARED_REQUIRES(Locks::mutator_lock_) {
+  ArtField* field = FindInstanceFieldFromMterp<InstancePrimitiveRead, sizeof(int16_t)>(
+      dex_pc_ptr, &obj, referrer, self);
+  return LIKELY(field != nullptr) ? field->GetChar(obj) : 0;
+}
+
+extern "C" int16_t artGetShortInstanceFromMterp(uint16_t* dex_pc_ptr, mirror::Object* obj,
+                                                ArtMethod* referrer, Thread* self)
+    SHARED_REQUIRES(Locks::mutator_lock_) {
+  ArtField* field = FindInstanceFieldFromMterp<InstancePrimitiveRead, sizeof(int16_t)>(
+      dex_pc_ptr, &obj, referrer, self);
+  return LIKELY(field != nullptr) ? field->GetShort(obj) : 0;
+}
+
+extern "C" uint32_t artGet32InstanceFromMterp(uint16_t* dex_pc_ptr, mirror::Object* obj,
+                                              ArtMethod* referrer, Thread* self)
+    SHARED_REQUIRES(Locks::mutator_lock_) {
+  ArtField* field = FindInstanceFieldFromMterp<InstancePrimitiveRead, sizeof(int32_t)>(
+      dex_pc_ptr, &obj, referrer, self);
+  return LIKELY(field != nullptr) ? field->Get32(obj) : 0;
+}
+
+extern "C" uint64_t artGet64InstanceFromMterp(uint16_t* dex_pc_ptr, mirror::Object* obj,
+                                              ArtMethod* referrer, Thread* self)
     SHARED_REQUIRES(Locks::mutator_lock_) {
-  ArtField* field = FindFieldFast(field_idx, referrer, InstancePrimitiveWrite, sizeof(int8_t));
+  ArtField* field = FindInstanceFieldFromMterp<InstancePrimitiveRead, sizeof(int64_t)>(
+      dex_pc_ptr, &obj, referrer, self);
+  return LIKELY(field != nullptr) ? field->Get64(obj) : 0;
+}
+
+extern "C" mirror::Object* artGetObjInstanceFromMterp(uint16_t* dex_pc_ptr, mirror::Object* obj,
+                                                      ArtMethod* referrer, Thread* self)
+    SHARED_REQUIRES(Locks::mutator_lock_) {
+  ArtField* field = FindInstanceFieldFromMterp<InstanceObjectRead,
+                                               sizeof(mirror::HeapReference<mirror::Object>)>(
+      dex_pc_ptr, &obj, referrer, self);
+  return LIKELY(field != nullptr) ? field->GetObj(obj) : nullptr;
+}
+
+extern "C" int artSet8InstanceFromMterp(uint16_t* dex_pc_ptr, mirror::Object* obj,
+                                        uint8_t new_value, ArtMethod* referrer)
+    SHARED_REQUIRES(Locks::mutator_lock_) {
+  ArtField* field = FindInstanceFieldFastFromMterp<InstancePrimitiveWrite, sizeof(int8_t)>(
+      dex_pc_ptr, referrer, Thread::Current());
   if (LIKELY(field != nullptr && obj != nullptr)) {
     Primitive::Type type = field->GetTypeAsPrimitiveType();
     if (type == Primitive::kPrimBoolean) {
@@ -561,11 +677,11 @@ extern "C" int artSet8InstanceFromMterp(uint32_t field_idx, mirror::Object* obj,
   return -1;  // failure
 }
 
-extern "C" int artSet16InstanceFromMterp(uint32_t field_idx, mirror::Object* obj, uint16_t new_value,
-                                        ArtMethod* referrer)
+extern "C" int artSet16InstanceFromMterp(uint16_t* dex_pc_ptr, mirror::Object* obj,
+                                         uint16_t new_value, ArtMethod* referrer)
     SHARED_REQUIRES(Locks::mutator_lock_) {
-  ArtField* field = FindFieldFast(field_idx, referrer, InstancePrimitiveWrite,
-                                          sizeof(int16_t));
+  ArtField* field = FindInstanceFieldFastFromMterp<InstancePrimitiveWrite, sizeof(int16_t)>(
+      dex_pc_ptr, referrer, Thread::Current());
   if (LIKELY(field != nullptr && obj != nullptr)) {
     Primitive::Type type = field->GetTypeAsPrimitiveType();
     if (type == Primitive::kPrimChar) {
@@ -579,11 +695,11 @@ extern "C" int artSet16InstanceFromMterp(uint32_t field_idx, mirror::Object* obj
   return -1;  // failure
 }
 
-extern "C" int artSet32InstanceFromMterp(uint32_t field_idx, mirror::Object* obj,
+extern "C" int artSet32InstanceFromMterp(uint16_t* dex_pc_ptr, mirror::Object* obj,
                                          uint32_t new_value, ArtMethod* referrer)
     SHARED_REQUIRES(Locks::mutator_lock_) {
-  ArtField* field = FindFieldFast(field_idx, referrer, InstancePrimitiveWrite,
-                                          sizeof(int32_t));
+  ArtField* field = FindInstanceFieldFastFromMterp<InstancePrimitiveWrite, sizeof(int32_t)>(
+      dex_pc_ptr, referrer, Thread::Current());
   if (LIKELY(field != nullptr && obj != nullptr)) {
     field->Set32<false>(obj, new_value);
     return 0;  // success
@@ -591,11 +707,11 @@ extern "C" int artSet32InstanceFromMterp(uint32_t field_idx, mirror::Object* obj
   return -1;  // failure
 }
 
-extern "C" int artSet64InstanceFromMterp(uint32_t field_idx, mirror::Object* obj,
+extern "C" int artSet64InstanceFromMterp(uint16_t* dex_pc_ptr, mirror::Object* obj,
                                          uint64_t* new_value, ArtMethod* referrer)
     SHARED_REQUIRES(Locks::mutator_lock_) {
-  ArtField* field = FindFieldFast(field_idx, referrer, InstancePrimitiveWrite,
-                                          sizeof(int64_t));
+  ArtField* field = FindInstanceFieldFastFromMterp<InstancePrimitiveWrite, sizeof(int64_t)>(
+      dex_pc_ptr, referrer, Thread::Current());
   if (LIKELY(field != nullptr  && obj != nullptr)) {
     field->Set64<false>(obj, *new_value);
     return 0;  // success
@@ -603,11 +719,12 @@ extern "C" int artSet64InstanceFromMterp(uint32_t field_idx, mirror::Object* obj
   return -1;  // failure
 }
 
-extern "C" int artSetObjInstanceFromMterp(uint32_t field_idx, mirror::Object* obj,
+extern "C" int artSetObjInstanceFromMterp(uint16_t* dex_pc_ptr, mirror::Object* obj,
                                           mirror::Object* new_value, ArtMethod* referrer)
     SHARED_REQUIRES(Locks::mutator_lock_) {
-  ArtField* field = FindFieldFast(field_idx, referrer, InstanceObjectWrite,
-                                          sizeof(mirror::HeapReference<mirror::Object>));
+  ArtField* field = FindInstanceFieldFastFromMterp<InstanceObjectWrite,
+                                                   sizeof(mirror::HeapReference<mirror::Object>)>(
+      dex_pc_ptr, referrer, Thread::Current());
   if (LIKELY(field != nullptr && obj != nullptr)) {
     field->SetObj<false>(obj, new_value);
     return 0;  // success
@@ -673,6 +790,14 @@ extern "C" int MterpSetUpHotnessCountdown(ArtMethod* method, ShadowFrame* shadow
    */
   countdown_value = std::min(countdown_value,
                              static_cast<int32_t>(std::numeric_limits<int16_t>::max()));
+  if (countdown_value > kLoopHotnessBatchSize) {
+    // A batch of back edges is attributed to the loop whose back edge ends it. Once the
+    // method is profiled, keep the batches small so that this sampling tells its loops apart.
+    ProfilingInfo* info = method->GetProfilingInfo(sizeof(void*));
+    if (info != nullptr && info->GetNumberOfLoops() > 1) {
+      countdown_value = kLoopHotnessBatchSize;
+    }
+  }
   shadow_frame->SetCachedHotnessCountdown(countdown_value);
   shadow_frame->SetHotnessCountdown(countdown_value);
   return countdown_value;
@@ -694,6 +819,36 @@ extern "C" int16_t MterpAddHotnessBatch(ArtMethod* method,
   return MterpSetUpHotnessCountdown(method, shadow_frame);
 }
 
+/*
+ * Same as MterpAddHotnessBatch, for a batch which ended on the taken back edge of `offset`.
+ * The batch is also counted for the loop header this back edge branches to.
+ */
+extern "C" int16_t MterpAddBackEdgeHotnessBatch(ArtMethod* method,
+                                                ShadowFrame* shadow_frame,
+                                                Thread* self,
+                                                int32_t offset)
+    SHARED_REQUIRES(Locks::mutator_lock_) {
+  jit::Jit* jit = Runtime::Current()->GetJit();
+  if (jit != nullptr) {
+    int16_t count = shadow_frame->GetCachedHotnessCountdown() - shadow_frame->GetHotnessCountdown();
+    jit->AddSamples(self, method, count, /*with_backedges*/ true);
+    jit->AddLoopSamples(method, shadow_frame->GetDexPC() + offset, count);
+  }
+  return MterpSetUpHotnessCountdown(method, shadow_frame);
+}
+
+/*
+ * Record a taken forward branch of a method which has a ProfilingInfo, for the
+ * compiler not to speculate that the branch is never taken.
+ */
+extern "C" void MterpProfileTakenBranch(ShadowFrame* shadow_frame)
+    SHARED_REQUIRES(Locks::mutator_lock_) {
+  jit::Jit* jit = Runtime::Current()->GetJit();
+  if (jit != nullptr) {
+    jit->AddTakenBranch(shadow_frame->GetMethod(), shadow_frame->GetDexPC());
+  }
+}
+
 // TUNING: Unused by arm/arm64/x86/x86_64.  Remove when mips/mips64 mterps support batch updates.
 extern "C" bool  MterpProfileBranch(Thread* self, ShadowFrame* shadow_frame, int32_t offset)
     SHARED_REQUIRES(Locks::mutator_lock_) {
@@ -703,6 +858,10 @@ extern "C" bool  MterpProfileBranch(Thread* self, ShadowFrame* shadow_frame, int
   jit::Jit* jit = Runtime::Current()->GetJit();
   if ((jit != nullptr) && (offset <= 0)) {
     jit->AddSamples(self, method, 1, /*with_backedges*/ true);
+    jit->AddLoopSamples(method, dex_pc + offset, 1);
+  } else if ((jit != nullptr) && (offset > 2)) {
+    // Not taken branches report an offset of 2, which no profiled branch has.
+    jit->AddTakenBranch(method, dex_pc);
   }
   int16_t countdown_value = MterpSetUpHotnessCountdown(method, shadow_frame);
   if (countdown_value == jit::kJitCheckForOSR) {
@@ -723,6 +882,7 @@ extern "C" bool MterpMaybeDoOnStackReplacement(Thread* self,
   if (offset <= 0) {
     // Keep updating hotness in case a compilation request was dropped.  Eventually it will retry.
     jit->AddSamples(self, method, 1, /*with_backedges*/ true);
+    jit->AddLoopSamples(method, dex_pc + offset, 1);
   }
   // Assumes caller has already determined that an OSR check is appropriate.
   return jit::Jit::MaybeDoOnStackReplacement(self, method, dex_pc, offset, result);
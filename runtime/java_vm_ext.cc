@@ -46,10 +46,10 @@
 namespace art {
 
 static size_t gGlobalsInitial = 512;  // Arbitrary.
-static size_t gGlobalsMax = 51200;  // Arbitrary sanity check. (Must fit in 16 bits.)
+static size_t gGlobalsMax = kIRTMaxEntries;  // The tables grow on demand up to the 16 bit limit.
 
 static const size_t kWeakGlobalsInitial = 16;  // Arbitrary.
-static const size_t kWeakGlobalsMax = 51200;  // Arbitrary sanity check. (Must fit in 16 bits.)
+static const size_t kWeakGlobalsMax = kIRTMaxEntries;
 
 static bool IsBadJniVersion(int version) {
   // We don't support JNI_VERSION_1_1. These are the only other valid versions.
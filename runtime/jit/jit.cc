@@ -17,10 +17,16 @@
 #include "jit.h"
 
 #include <dlfcn.h>
+#include <fcntl.h>
 
 #include "art_method-inl.h"
+#include "base/scoped_flock.h"
+#include "base/time_utils.h"
+#include "base/unix_file/fd_file.h"
 #include "debugger.h"
 #include "entrypoints/runtime_asm_entrypoints.h"
+#include "gc/heap.h"
+#include "gc/task_processor.h"
 #include "interpreter/interpreter.h"
 #include "jit_code_cache.h"
 #include "oat_file_manager.h"
@@ -43,6 +49,13 @@ namespace jit {
 static constexpr bool kEnableOnStackReplacement = true;
 // At what priority to schedule jit threads. 9 is the lowest foreground priority on device.
 static constexpr int kJitPoolThreadPthreadPriority = 9;
+// Number of startup profile methods compiled before yielding the JIT thread to other tasks.
+static constexpr size_t kPrecompileBatchSize = 8;
+// Pause between two batches of startup profile methods, to leave CPU to the application.
+static constexpr uint64_t kPrecompileBatchPauseMs = 10;
+// Number of batches a profile method waits for its class to be initialized before being
+// left to the hotness counters.
+static constexpr size_t kPrecompileMaxRetries = 200;
 
 // JIT compiler
 void* Jit::jit_library_handle_= nullptr;
@@ -65,6 +78,8 @@ JitOptions* JitOptions::CreateFromRuntimeArguments(const RuntimeArgumentMap& opt
       options.Exists(RuntimeArgumentMap::DumpJITInfoOnShutdown);
   jit_options->save_profiling_info_ =
       options.GetOrDefault(RuntimeArgumentMap::JITSaveProfilingInfo);
+  jit_options->precompile_profile_ =
+      options.GetOrDefault(RuntimeArgumentMap::JITPrecompileProfile);
 
   jit_options->compile_threshold_ = options.GetOrDefault(RuntimeArgumentMap::JITCompileThreshold);
 #ifdef __ANDROID__
@@ -141,6 +156,17 @@ void Jit::DumpInfo(std::ostream& os) {
   memory_use_.PrintMemoryUse(os);
 }
 
+void Jit::DumpStatsAsJson(std::ostream& os) {
+  os << "{\"hot_method_threshold\":" << hot_method_threshold_
+     << ",\"warm_method_threshold\":" << warm_method_threshold_
+     << ",\"osr_method_threshold\":" << osr_method_threshold_
+     << ",\"priority_thread_weight\":" << priority_thread_weight_
+     << ",\"invoke_transition_weight\":" << invoke_transition_weight_
+     << ",\"code_cache_stats\":";
+  code_cache_->DumpStatsAsJson(os);
+  os << "}";
+}
+
 void Jit::DumpForSigQuit(std::ostream& os) {
   DumpInfo(os);
   ProfileSaver::DumpInstanceInfo(os);
@@ -155,7 +181,10 @@ Jit::Jit() : dump_info_on_shutdown_(false),
              memory_use_("Memory used for compilation", 16),
              lock_("JIT memory use lock"),
              use_jit_compilation_(true),
-             save_profiling_info_(false) {}
+             save_profiling_info_(false),
+             precompile_profile_(false),
+             precompile_lock_("JIT precompile lock"),
+             precompile_batch_scheduled_(false) {}
 
 Jit* Jit::Create(JitOptions* options, std::string* error_msg) {
   DCHECK(options->UseJitCompilation() || options->GetSaveProfilingInfo());
@@ -174,6 +203,7 @@ Jit* Jit::Create(JitOptions* options, std::string* error_msg) {
   }
   jit->use_jit_compilation_ = options->UseJitCompilation();
   jit->save_profiling_info_ = options->GetSaveProfilingInfo();
+  jit->precompile_profile_ = options->GetPrecompileProfile();
   VLOG(jit) << "JIT created with initial_capacity="
       << PrettySize(options->GetCodeCacheInitialCapacity())
       << ", max_capacity=" << PrettySize(options->GetCodeCacheMaxCapacity())
@@ -277,9 +307,12 @@ bool Jit::CompileMethod(ArtMethod* method, Thread* self, bool osr) {
   VLOG(jit) << "Compiling method "
             << PrettyMethod(method_to_compile)
             << " osr=" << std::boolalpha << osr;
+  uint64_t start_ns = NanoTime();
   bool success = jit_compile_method_(jit_compiler_handle_, method_to_compile, self, osr);
   code_cache_->DoneCompiling(method_to_compile, self, osr);
-  if (!success) {
+  if (success) {
+    code_cache_->AddCompilationTime(method_to_compile, NanoTime() - start_ns);
+  } else {
     VLOG(jit) << "Failed to compile method "
               << PrettyMethod(method_to_compile)
               << " osr=" << std::boolalpha << osr;
@@ -314,6 +347,7 @@ void Jit::DeleteThreadPool() {
     cache->Wait(self, false, false);
     delete cache;
   }
+  DeletePrecompileTasks(self);
 }
 
 void Jit::StartProfileSaver(const std::string& filename,
@@ -365,6 +399,9 @@ void Jit::NewTypeLoadedIfUsingJit(mirror::Class* type) {
     DCHECK(jit->jit_types_loaded_ != nullptr);
     jit->jit_types_loaded_(jit->jit_compiler_handle_, &type, 1);
   }
+  if (jit->precompile_profile_) {
+    jit->MaybePrecompileMethodsOf(Thread::Current(), type);
+  }
 }
 
 void Jit::DumpTypeInfoForLoadedTypes(ClassLinker* linker) {
@@ -555,10 +592,11 @@ class JitCompileTask FINAL : public Task {
   enum TaskKind {
     kAllocateProfile,
     kCompile,
-    kCompileOsr
+    kCompileOsr,
+    kPrecompile
   };
 
-  JitCompileTask(ArtMethod* method, TaskKind kind) : method_(method), kind_(kind) {
+  JitCompileTask(ArtMethod* method, TaskKind kind) : method_(method), kind_(kind), retries_(0) {
     ScopedObjectAccess soa(Thread::Current());
     // Add a global ref to the class to prevent class unloading until compilation is done.
     klass_ = soa.Vm()->AddGlobalRef(soa.Self(), method_->GetDeclaringClass());
@@ -576,6 +614,13 @@ class JitCompileTask FINAL : public Task {
       Runtime::Current()->GetJit()->CompileMethod(method_, self, /* osr */ false);
     } else if (kind_ == kCompileOsr) {
       Runtime::Current()->GetJit()->CompileMethod(method_, self, /* osr */ true);
+    } else if (kind_ == kPrecompile) {
+      // The compiler requires a ProfilingInfo object. Its inline caches are still empty, so
+      // the code we get is not as good as the one compiled for a hot method.
+      if (method_->GetProfilingInfo(sizeof(void*)) != nullptr ||
+          ProfilingInfo::Create(self, method_, /* retry_allocation */ true)) {
+        Runtime::Current()->GetJit()->CompileMethod(method_, self, /* osr */ false);
+      }
     } else {
       DCHECK(kind_ == kAllocateProfile);
       if (ProfilingInfo::Create(self, method_, /* retry_allocation */ true)) {
@@ -589,14 +634,250 @@ class JitCompileTask FINAL : public Task {
     delete this;
   }
 
+  // Whether the method of a precompile task can be compiled. Compiled code is installed
+  // as the entry point of the method, which would bypass the class initialization check
+  // for static methods, so we wait for the declaring class to be initialized.
+  bool IsReadyToPrecompile() SHARED_REQUIRES(Locks::mutator_lock_) {
+    DCHECK_EQ(kind_, kPrecompile);
+    return method_->GetDeclaringClass()->IsInitialized();
+  }
+
+  size_t IncrementRetries() {
+    return ++retries_;
+  }
+
  private:
   ArtMethod* const method_;
   const TaskKind kind_;
   jobject klass_;
+  size_t retries_;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(JitCompileTask);
 };
 
+class JitLoadProfileTask FINAL : public Task {
+ public:
+  explicit JitLoadProfileTask(const std::string& profile_filename)
+      : profile_filename_(profile_filename) {}
+
+  void Run(Thread* self) OVERRIDE {
+    ScopedFlock flock;
+    std::string error;
+    if (!flock.Init(profile_filename_.c_str(),
+                    O_RDONLY | O_NOFOLLOW | O_CLOEXEC,
+                    /* block */ false,
+                    &error)) {
+      LOG(WARNING) << "Couldn't lock the profile file " << profile_filename_ << ": " << error;
+      return;
+    }
+    std::unique_ptr<ProfileCompilationInfo> profile(new ProfileCompilationInfo());
+    if (!profile->Load(flock.GetFile()->Fd())) {
+      LOG(WARNING) << "Could not load profile data from file " << profile_filename_;
+      return;
+    }
+    VLOG(jit) << "Precompiling " << profile->GetNumberOfMethods()
+              << " methods from profile " << profile_filename_;
+    ScopedObjectAccess soa(self);
+    Runtime::Current()->GetJit()->SetStartupProfile(self, std::move(profile));
+  }
+
+  void Finalize() OVERRIDE {
+    delete this;
+  }
+
+ private:
+  const std::string profile_filename_;
+
+  DISALLOW_IMPLICIT_CONSTRUCTORS(JitLoadProfileTask);
+};
+
+class JitPrecompileBatchTask FINAL : public Task {
+ public:
+  JitPrecompileBatchTask() {}
+
+  void Run(Thread* self) OVERRIDE {
+    Runtime::Current()->GetJit()->RunPrecompileBatch(self);
+  }
+
+  void Finalize() OVERRIDE {
+    delete this;
+  }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(JitPrecompileBatchTask);
+};
+
+// Adds the next batch of startup profile methods to the JIT thread pool once the pause
+// between batches has elapsed. Runs on the heap task daemon, which supports delayed tasks.
+class JitSchedulePrecompileBatchTask FINAL : public gc::HeapTask {
+ public:
+  explicit JitSchedulePrecompileBatchTask(uint64_t target_run_time)
+      : gc::HeapTask(target_run_time) {}
+
+  void Run(Thread* self) OVERRIDE {
+    Jit* jit = Runtime::Current()->GetJit();
+    if (jit != nullptr) {
+      jit->AddPrecompileBatchTask(self);
+    }
+  }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(JitSchedulePrecompileBatchTask);
+};
+
+void Jit::PrecompileMethodsFromProfile(const std::string& profile_filename) {
+  if (!precompile_profile_ || !use_jit_compilation_ || thread_pool_ == nullptr) {
+    return;
+  }
+  thread_pool_->AddTask(Thread::Current(), new JitLoadProfileTask(profile_filename));
+}
+
+void Jit::SetStartupProfile(Thread* self, std::unique_ptr<ProfileCompilationInfo> profile) {
+  class CollectProfileMethods : public ClassVisitor {
+   public:
+    CollectProfileMethods(Jit* jit, Thread* self) : jit_(jit), self_(self) {}
+
+    bool operator()(mirror::Class* klass) OVERRIDE SHARED_REQUIRES(Locks::mutator_lock_) {
+      MutexLock mu(self_, jit_->precompile_lock_);
+      jit_->CollectStartupProfileMethods(klass, &methods_);
+      return true;
+    }
+
+    Jit* const jit_;
+    Thread* const self_;
+    std::vector<ArtMethod*> methods_;
+  };
+
+  {
+    MutexLock mu(self, precompile_lock_);
+    startup_profile_ = std::move(profile);
+  }
+  // Classes loaded from now on find the startup profile in MaybePrecompileMethodsOf, and
+  // the ones already loaded are in the class tables. A class may be seen twice, which is
+  // harmless as the JIT code cache ignores requests for already compiled methods.
+  CollectProfileMethods visitor(this, self);
+  Runtime::Current()->GetClassLinker()->VisitClasses(&visitor);
+  AddPrecompileTasks(self, visitor.methods_);
+}
+
+void Jit::MaybePrecompileMethodsOf(Thread* self, mirror::Class* klass) {
+  std::vector<ArtMethod*> methods;
+  {
+    MutexLock mu(self, precompile_lock_);
+    CollectStartupProfileMethods(klass, &methods);
+  }
+  AddPrecompileTasks(self, methods);
+}
+
+void Jit::CollectStartupProfileMethods(mirror::Class* klass, std::vector<ArtMethod*>* methods) {
+  if (startup_profile_ == nullptr ||
+      klass->IsArrayClass() ||
+      klass->IsPrimitive() ||
+      klass->IsProxyClass()) {
+    return;
+  }
+  for (ArtMethod& method : klass->GetDeclaredMethods(sizeof(void*))) {
+    if (method.IsNative() ||
+        method.IsAbstract() ||
+        method.IsClassInitializer() ||
+        !method.IsCompilable()) {
+      continue;
+    }
+    if (startup_profile_->ContainsMethod(
+            MethodReference(method.GetDexFile(), method.GetDexMethodIndex()))) {
+      methods->push_back(&method);
+    }
+  }
+}
+
+void Jit::AddPrecompileTasks(Thread* self, const std::vector<ArtMethod*>& methods) {
+  if (methods.empty() || thread_pool_ == nullptr) {
+    return;
+  }
+  // Create the tasks without holding the lock: they take a global reference to the
+  // declaring class of the method, to prevent class unloading until they are done.
+  std::vector<JitCompileTask*> tasks;
+  for (ArtMethod* method : methods) {
+    tasks.push_back(new JitCompileTask(method, JitCompileTask::kPrecompile));
+  }
+  bool schedule_batch = false;
+  {
+    MutexLock mu(self, precompile_lock_);
+    precompile_tasks_.insert(precompile_tasks_.end(), tasks.begin(), tasks.end());
+    if (!precompile_batch_scheduled_) {
+      precompile_batch_scheduled_ = true;
+      schedule_batch = true;
+    }
+  }
+  if (schedule_batch) {
+    thread_pool_->AddTask(self, new JitPrecompileBatchTask());
+  }
+}
+
+void Jit::DeletePrecompileTasks(Thread* self) {
+  std::deque<JitCompileTask*> precompile_tasks;
+  {
+    MutexLock mu(self, precompile_lock_);
+    precompile_tasks.swap(precompile_tasks_);
+  }
+  for (JitCompileTask* task : precompile_tasks) {
+    task->Finalize();
+  }
+}
+
+void Jit::RunPrecompileBatch(Thread* self) {
+  std::vector<JitCompileTask*> batch;
+  {
+    MutexLock mu(self, precompile_lock_);
+    while (batch.size() < kPrecompileBatchSize && !precompile_tasks_.empty()) {
+      batch.push_back(precompile_tasks_.front());
+      precompile_tasks_.pop_front();
+    }
+  }
+
+  std::vector<JitCompileTask*> deferred;
+  for (JitCompileTask* task : batch) {
+    bool ready;
+    {
+      ScopedObjectAccess soa(self);
+      ready = task->IsReadyToPrecompile();
+    }
+    if (ready) {
+      task->Run(self);
+      task->Finalize();
+    } else if (task->IncrementRetries() < kPrecompileMaxRetries) {
+      deferred.push_back(task);
+    } else {
+      // The class is still not initialized. The method will be compiled if it gets hot.
+      task->Finalize();
+    }
+  }
+
+  bool schedule_batch;
+  {
+    MutexLock mu(self, precompile_lock_);
+    precompile_tasks_.insert(precompile_tasks_.end(), deferred.begin(), deferred.end());
+    precompile_batch_scheduled_ = !precompile_tasks_.empty();
+    schedule_batch = precompile_batch_scheduled_;
+  }
+  if (schedule_batch) {
+    // Pause through a delayed heap task rather than sleeping here, so that the JIT thread
+    // keeps compiling the methods which get hot in the meantime.
+    Runtime::Current()->GetHeap()->GetTaskProcessor()->AddTask(
+        self, new JitSchedulePrecompileBatchTask(NanoTime() + MsToNs(kPrecompileBatchPauseMs)));
+  }
+}
+
+void Jit::AddPrecompileBatchTask(Thread* self) {
+  // Add the next batch at the end of the queue, so that methods which got hot during the
+  // pause are compiled first. The thread pool is only deleted with all threads suspended,
+  // so it is safe to check it while runnable.
+  ScopedObjectAccess soa(self);
+  if (thread_pool_ != nullptr) {
+    thread_pool_->AddTask(self, new JitPrecompileBatchTask());
+  }
+}
+
 void Jit::AddSamples(Thread* self, ArtMethod* method, uint16_t count, bool with_backedges) {
   if (thread_pool_ == nullptr) {
     // Should only see this when shutting down.
@@ -688,6 +969,20 @@ void Jit::MethodEntered(Thread* thread, ArtMethod* method) {
   }
 }
 
+void Jit::AddLoopSamples(ArtMethod* method, uint32_t header_dex_pc, uint16_t count) {
+  ProfilingInfo* info = method->GetProfilingInfo(sizeof(void*));
+  if (info != nullptr) {
+    info->AddBackEdges(header_dex_pc, count);
+  }
+}
+
+void Jit::AddTakenBranch(ArtMethod* method, uint32_t dex_pc) {
+  ProfilingInfo* info = method->GetProfilingInfo(sizeof(void*));
+  if (info != nullptr) {
+    info->AddTakenBranch(dex_pc);
+  }
+}
+
 void Jit::InvokeVirtualOrInterface(Thread* thread,
                                    mirror::Object* this_object,
                                    ArtMethod* caller,
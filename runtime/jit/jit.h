@@ -34,6 +34,7 @@ struct RuntimeArgumentMap;
 namespace jit {
 
 class JitCodeCache;
+class JitCompileTask;
 class JitOptions;
 
 static constexpr int16_t kJitCheckForOSR = -1;
@@ -64,6 +65,9 @@ class Jit {
   // Dump interesting info: #methods compiled, code vs data size, compile / verify cumulative
   // loggers.
   void DumpInfo(std::ostream& os) REQUIRES(!lock_);
+  // Dump the JIT thresholds and the code cache statistics, including per-method compilation
+  // statistics, as a JSON object.
+  void DumpStatsAsJson(std::ostream& os) SHARED_REQUIRES(Locks::mutator_lock_);
   // Add a timing logger to cumulative_timings_.
   void AddTimingLogger(const TimingLogger& logger);
 
@@ -106,6 +110,16 @@ class Jit {
   void AddSamples(Thread* self, ArtMethod* method, uint16_t samples, bool with_backedges)
       SHARED_REQUIRES(Locks::mutator_lock_);
 
+  // Record `count` back edges to the loop header at `header_dex_pc`, to drive which loops
+  // an OSR compilation of `method` should optimize.
+  void AddLoopSamples(ArtMethod* method, uint32_t header_dex_pc, uint16_t count)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
+  // Record that the interpreter took the forward conditional branch at `dex_pc`, so that
+  // the compiler does not speculate the branch is never taken.
+  void AddTakenBranch(ArtMethod* method, uint32_t dex_pc)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
   void InvokeVirtualOrInterface(Thread* thread,
                                 mirror::Object* this_object,
                                 ArtMethod* caller,
@@ -136,6 +150,11 @@ class Jit {
                          const std::string& app_dir);
   void StopProfileSaver();
 
+  // If the config options allow it, load the profile stored in `profile_filename` on the JIT
+  // thread pool and compile the methods it lists in the background, without waiting for them
+  // to become hot. Methods of classes loaded later are queued when their class is loaded.
+  void PrecompileMethodsFromProfile(const std::string& profile_filename);
+
   void DumpForSigQuit(std::ostream& os) REQUIRES(!lock_);
 
   static void NewTypeLoadedIfUsingJit(mirror::Class* type)
@@ -172,6 +191,33 @@ class Jit {
 
   static bool LoadCompiler(std::string* error_msg);
 
+  // Install `profile` as the startup profile and queue the profiled methods of the classes
+  // already loaded.
+  void SetStartupProfile(Thread* self, std::unique_ptr<ProfileCompilationInfo> profile)
+      REQUIRES(!precompile_lock_)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
+  // Queue the methods of `klass` listed in the startup profile for background compilation.
+  void MaybePrecompileMethodsOf(Thread* self, mirror::Class* klass)
+      REQUIRES(!precompile_lock_)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
+  // Add the methods of `klass` listed in the startup profile to `methods`.
+  void CollectStartupProfileMethods(mirror::Class* klass, std::vector<ArtMethod*>* methods)
+      REQUIRES(precompile_lock_)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
+  void AddPrecompileTasks(Thread* self, const std::vector<ArtMethod*>& methods)
+      REQUIRES(!precompile_lock_)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
+  // Run a batch of pending precompile tasks, and schedule the next batch if there are more.
+  void RunPrecompileBatch(Thread* self) REQUIRES(!precompile_lock_);
+  // Add a task running the next batch of precompile tasks to the thread pool.
+  void AddPrecompileBatchTask(Thread* self) REQUIRES(!Locks::mutator_lock_);
+
+  void DeletePrecompileTasks(Thread* self) REQUIRES(!precompile_lock_);
+
   // JIT compiler
   static void* jit_library_handle_;
   static void* jit_compiler_handle_;
@@ -198,6 +244,17 @@ class Jit {
   uint16_t invoke_transition_weight_;
   std::unique_ptr<ThreadPool> thread_pool_;
 
+  // Background compilation of the methods listed in the startup profile.
+  bool precompile_profile_;
+  Mutex precompile_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  std::unique_ptr<ProfileCompilationInfo> startup_profile_ GUARDED_BY(precompile_lock_);
+  std::deque<JitCompileTask*> precompile_tasks_ GUARDED_BY(precompile_lock_);
+  bool precompile_batch_scheduled_ GUARDED_BY(precompile_lock_);
+
+  friend class JitLoadProfileTask;
+  friend class JitPrecompileBatchTask;
+  friend class JitSchedulePrecompileBatchTask;
+
   DISALLOW_COPY_AND_ASSIGN(Jit);
 };
 
@@ -231,6 +288,9 @@ class JitOptions {
   bool GetSaveProfilingInfo() const {
     return save_profiling_info_;
   }
+  bool GetPrecompileProfile() const {
+    return precompile_profile_;
+  }
   bool UseJitCompilation() const {
     return use_jit_compilation_;
   }
@@ -256,6 +316,7 @@ class JitOptions {
   size_t invoke_transition_weight_;
   bool dump_info_on_shutdown_;
   bool save_profiling_info_;
+  bool precompile_profile_;
 
   JitOptions()
       : use_jit_compilation_(false),
@@ -263,7 +324,8 @@ class JitOptions {
         code_cache_max_capacity_(0),
         compile_threshold_(0),
         dump_info_on_shutdown_(false),
-        save_profiling_info_(false) { }
+        save_profiling_info_(false),
+        precompile_profile_(false) { }
 
   DISALLOW_COPY_AND_ASSIGN(JitOptions);
 };
@@ -20,6 +20,7 @@
 
 #include "art_method-inl.h"
 #include "base/stl_util.h"
+#include "base/stringprintf.h"
 #include "base/systrace.h"
 #include "base/time_utils.h"
 #include "debugger_interface.h"
@@ -44,6 +45,9 @@ static constexpr int kProtCode = PROT_READ | PROT_EXEC;
 static constexpr size_t kCodeSizeLogThreshold = 50 * KB;
 static constexpr size_t kStackMapSizeLogThreshold = 50 * KB;
 
+// Number of code cache collections we keep a record of.
+static constexpr size_t kCollectionHistorySize = 16;
+
 #define CHECKED_MPROTECT(memory, size, prot)                \
   do {                                                      \
     int rc = mprotect(memory, size, prot);                  \
@@ -294,6 +298,13 @@ void JitCodeCache::RemoveMethodsIn(Thread* self, const LinearAlloc& alloc) {
       ++it;
     }
   }
+  for (auto it = method_stats_.begin(); it != method_stats_.end();) {
+    if (alloc.ContainsUnsafe(it->first)) {
+      it = method_stats_.erase(it);
+    } else {
+      ++it;
+    }
+  }
 }
 
 void JitCodeCache::ClearGcRootsInInlineCaches(Thread* self) {
@@ -352,8 +363,12 @@ uint8_t* JitCodeCache::CommitCodeInternal(Thread* self,
   {
     MutexLock mu(self, lock_);
     method_code_map_.Put(code_ptr, method);
+    JitMethodStats* stats = GetMethodStats(method);
+    stats->compilations++;
+    stats->code_size = code_size;
     if (osr) {
       number_of_osr_compilations_++;
+      stats->osr_compilations++;
       osr_code_map_.Put(method, code_ptr);
     } else {
       Runtime::Current()->GetInstrumentation()->UpdateMethodsCode(
@@ -598,9 +613,14 @@ void JitCodeCache::GarbageCollectCache(Thread* self) {
     TimingLogger::ScopedTiming st("Code cache collection", &logger);
 
     bool do_full_collection = false;
+    JitCollectionRecord record;
+    record.start_time_ns = NanoTime();
     {
       MutexLock mu(self, lock_);
       do_full_collection = ShouldDoFullCollection();
+      record.full = do_full_collection;
+      record.code_size_before = CodeCacheSizeLocked();
+      record.data_size_before = DataCacheSizeLocked();
     }
 
     if (!kIsDebugBuild || VLOG_IS_ON(jit)) {
@@ -631,6 +651,15 @@ void JitCodeCache::GarbageCollectCache(Thread* self) {
         IncreaseCodeCacheCapacity();
       }
 
+      record.duration_ns = NanoTime() - record.start_time_ns;
+      record.code_size_after = CodeCacheSizeLocked();
+      record.data_size_after = DataCacheSizeLocked();
+      record.capacity_after = current_capacity_;
+      if (collection_history_.size() == kCollectionHistorySize) {
+        collection_history_.pop_front();
+      }
+      collection_history_.push_back(record);
+
       bool next_collection_will_be_full = ShouldDoFullCollection();
 
       // Start polling the liveness of compiled code to prepare for the next full collection.
@@ -821,6 +850,8 @@ OatQuickMethodHeader* JitCodeCache::LookupOsrMethodHeader(ArtMethod* method) {
 ProfilingInfo* JitCodeCache::AddProfilingInfo(Thread* self,
                                               ArtMethod* method,
                                               const std::vector<uint32_t>& entries,
+                                              const std::vector<uint32_t>& loop_headers,
+                                              const std::vector<uint32_t>& branches,
                                               bool retry_allocation)
     // No thread safety analysis as we are using TryLock/Unlock explicitly.
     NO_THREAD_SAFETY_ANALYSIS {
@@ -829,19 +860,19 @@ ProfilingInfo* JitCodeCache::AddProfilingInfo(Thread* self,
     // If we are allocating for the interpreter, just try to lock, to avoid
     // lock contention with the JIT.
     if (lock_.ExclusiveTryLock(self)) {
-      info = AddProfilingInfoInternal(self, method, entries);
+      info = AddProfilingInfoInternal(self, method, entries, loop_headers, branches);
       lock_.ExclusiveUnlock(self);
     }
   } else {
     {
       MutexLock mu(self, lock_);
-      info = AddProfilingInfoInternal(self, method, entries);
+      info = AddProfilingInfoInternal(self, method, entries, loop_headers, branches);
     }
 
     if (info == nullptr) {
       GarbageCollectCache(self);
       MutexLock mu(self, lock_);
-      info = AddProfilingInfoInternal(self, method, entries);
+      info = AddProfilingInfoInternal(self, method, entries, loop_headers, branches);
     }
   }
   return info;
@@ -849,9 +880,11 @@ ProfilingInfo* JitCodeCache::AddProfilingInfo(Thread* self,
 
 ProfilingInfo* JitCodeCache::AddProfilingInfoInternal(Thread* self ATTRIBUTE_UNUSED,
                                                       ArtMethod* method,
-                                                      const std::vector<uint32_t>& entries) {
+                                                      const std::vector<uint32_t>& entries,
+                                                      const std::vector<uint32_t>& loop_headers,
+                                                      const std::vector<uint32_t>& branches) {
   size_t profile_info_size = RoundUp(
-      sizeof(ProfilingInfo) + sizeof(InlineCache) * entries.size(),
+      ProfilingInfo::ComputeSize(entries.size(), loop_headers.size(), branches.size()),
       sizeof(void*));
 
   // Check whether some other thread has concurrently created it.
@@ -864,7 +897,7 @@ ProfilingInfo* JitCodeCache::AddProfilingInfoInternal(Thread* self ATTRIBUTE_UNU
   if (data == nullptr) {
     return nullptr;
   }
-  info = new (data) ProfilingInfo(method, entries);
+  info = new (data) ProfilingInfo(method, entries, loop_headers, branches);
 
   // Make sure other threads see the data in the profiling info object before the
   // store in the ArtMethod's ProfilingInfo pointer.
@@ -977,6 +1010,17 @@ void JitCodeCache::InvalidateCompiledCodeFor(ArtMethod* method,
     profiling_info->SetSavedEntryPoint(nullptr);
   }
 
+  if (profiling_info != nullptr) {
+    // Count the failed speculation, so that the compiler stops speculating
+    // on methods which keep deoptimizing.
+    bool was_speculation_allowed = profiling_info->IsSpeculationAllowed();
+    profiling_info->IncrementDeoptimizationCount();
+    if (was_speculation_allowed && !profiling_info->IsSpeculationAllowed()) {
+      VLOG(jit) << "Disabling speculative optimizations for " << PrettyMethod(method)
+                << " after " << profiling_info->GetDeoptimizationCount() << " deoptimizations";
+    }
+  }
+
   if (method->GetEntryPointFromQuickCompiledCode() == header->GetEntryPoint()) {
     // The entrypoint is the one to invalidate, so we just update
     // it to the interpreter entry point and clear the counter to get the method
@@ -994,6 +1038,7 @@ void JitCodeCache::InvalidateCompiledCodeFor(ArtMethod* method,
   }
   MutexLock mu(Thread::Current(), lock_);
   number_of_deoptimizations_++;
+  GetMethodStats(method)->deoptimizations++;
 }
 
 uint8_t* JitCodeCache::AllocateCode(size_t code_size) {
@@ -1039,5 +1084,82 @@ void JitCodeCache::Dump(std::ostream& os) {
   histogram_profiling_info_memory_use_.PrintMemoryUse(os);
 }
 
+JitMethodStats* JitCodeCache::GetMethodStats(ArtMethod* method) {
+  auto it = method_stats_.find(method);
+  if (it == method_stats_.end()) {
+    it = method_stats_.Put(method, JitMethodStats());
+  }
+  return &it->second;
+}
+
+void JitCodeCache::AddCompilationTime(ArtMethod* method, uint64_t time_ns) {
+  MutexLock mu(Thread::Current(), lock_);
+  GetMethodStats(method)->compile_time_ns += time_ns;
+}
+
+// Write `str` as a JSON string literal.
+static void DumpJsonString(std::ostream& os, const std::string& str) {
+  os << '"';
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      os << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      os << StringPrintf("\\u%04x", c);
+    } else {
+      os << c;
+    }
+  }
+  os << '"';
+}
+
+void JitCodeCache::DumpStatsAsJson(std::ostream& os) {
+  MutexLock mu(Thread::Current(), lock_);
+  os << "{\"code_cache\":{"
+     << "\"code_size\":" << used_memory_for_code_
+     << ",\"data_size\":" << used_memory_for_data_
+     << ",\"capacity\":" << current_capacity_
+     << ",\"max_capacity\":" << max_capacity_
+     << ",\"entries\":" << method_code_map_.size()
+     << ",\"osr_entries\":" << osr_code_map_.size()
+     << ",\"profiling_infos\":" << profiling_infos_.size()
+     << ",\"compilations\":" << number_of_compilations_
+     << ",\"osr_compilations\":" << number_of_osr_compilations_
+     << ",\"deoptimizations\":" << number_of_deoptimizations_
+     << ",\"collections\":" << number_of_collections_
+     << "},\"collection_history\":[";
+  bool first = true;
+  for (const JitCollectionRecord& record : collection_history_) {
+    os << (first ? "" : ",")
+       << "{\"start_time_ns\":" << record.start_time_ns
+       << ",\"duration_ns\":" << record.duration_ns
+       << ",\"full\":" << std::boolalpha << record.full << std::noboolalpha
+       << ",\"code_size_before\":" << record.code_size_before
+       << ",\"code_size_after\":" << record.code_size_after
+       << ",\"data_size_before\":" << record.data_size_before
+       << ",\"data_size_after\":" << record.data_size_after
+       << ",\"capacity_after\":" << record.capacity_after
+       << "}";
+    first = false;
+  }
+  os << "],\"methods\":[";
+  first = true;
+  for (const auto& entry : method_stats_) {
+    const JitMethodStats& stats = entry.second;
+    os << (first ? "" : ",") << "{\"method\":";
+    DumpJsonString(os, PrettyMethod(entry.first));
+    os << ",\"compilations\":" << stats.compilations
+       << ",\"recompilations\":" << (stats.compilations == 0 ? 0 : stats.compilations - 1)
+       << ",\"osr_compilations\":" << stats.osr_compilations
+       << ",\"deoptimizations\":" << stats.deoptimizations
+       << ",\"code_size\":" << stats.code_size
+       << ",\"compile_time_ns\":" << stats.compile_time_ns
+       << ",\"in_code_cache\":" << std::boolalpha
+       << ContainsPc(entry.first->GetEntryPointFromQuickCompiledCode()) << std::noboolalpha
+       << "}";
+    first = false;
+  }
+  os << "]}";
+}
+
 }  // namespace jit
 }  // namespace art
@@ -19,6 +19,8 @@
 
 #include "instrumentation.h"
 
+#include <deque>
+
 #include "atomic.h"
 #include "base/histogram-inl.h"
 #include "base/macros.h"
@@ -46,6 +48,39 @@ class JitInstrumentationCache;
 static constexpr int kJitCodeAlignment = 16;
 using CodeCacheBitmap = gc::accounting::MemoryRangeBitmap<kJitCodeAlignment>;
 
+// Compilation statistics the code cache keeps for a method.
+struct JitMethodStats {
+  JitMethodStats()
+      : compilations(0),
+        osr_compilations(0),
+        deoptimizations(0),
+        code_size(0),
+        compile_time_ns(0) {}
+
+  // Number of times compiled code was committed for the method, including OSR code.
+  uint32_t compilations;
+  // Number of times OSR code was committed for the method.
+  uint32_t osr_compilations;
+  // Number of times compiled code of the method deoptimized.
+  uint32_t deoptimizations;
+  // Size in bytes of the last compiled code of the method.
+  size_t code_size;
+  // Total time spent compiling the method.
+  uint64_t compile_time_ns;
+};
+
+// Summary of a code cache collection.
+struct JitCollectionRecord {
+  uint64_t start_time_ns;
+  uint64_t duration_ns;
+  bool full;
+  size_t code_size_before;
+  size_t code_size_after;
+  size_t data_size_before;
+  size_t data_size_after;
+  size_t capacity_after;
+};
+
 class JitCodeCache {
  public:
   static constexpr size_t kMaxCapacity = 64 * MB;
@@ -155,6 +190,8 @@ class JitCodeCache {
   ProfilingInfo* AddProfilingInfo(Thread* self,
                                   ArtMethod* method,
                                   const std::vector<uint32_t>& entries,
+                                  const std::vector<uint32_t>& loop_headers,
+                                  const std::vector<uint32_t>& branches,
                                   bool retry_allocation)
       REQUIRES(!lock_)
       SHARED_REQUIRES(Locks::mutator_lock_);
@@ -186,6 +223,15 @@ class JitCodeCache {
 
   void Dump(std::ostream& os) REQUIRES(!lock_);
 
+  // Record the time the compiler spent compiling `method`.
+  void AddCompilationTime(ArtMethod* method, uint64_t time_ns) REQUIRES(!lock_);
+
+  // Dump the code cache occupancy, the history of the last code cache collections and
+  // the compilation statistics of each method as a JSON object.
+  void DumpStatsAsJson(std::ostream& os)
+      REQUIRES(!lock_)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
   bool IsOsrCompiled(ArtMethod* method) REQUIRES(!lock_);
 
  private:
@@ -213,7 +259,9 @@ class JitCodeCache {
 
   ProfilingInfo* AddProfilingInfoInternal(Thread* self,
                                           ArtMethod* method,
-                                          const std::vector<uint32_t>& entries)
+                                          const std::vector<uint32_t>& entries,
+                                          const std::vector<uint32_t>& loop_headers,
+                                          const std::vector<uint32_t>& branches)
       REQUIRES(lock_)
       SHARED_REQUIRES(Locks::mutator_lock_);
 
@@ -256,6 +304,9 @@ class JitCodeCache {
   bool CheckLiveCompiledCodeHasProfilingInfo()
       REQUIRES(lock_);
 
+  // Return the compilation statistics of `method`, creating them if needed.
+  JitMethodStats* GetMethodStats(ArtMethod* method) REQUIRES(lock_);
+
   void FreeCode(uint8_t* code) REQUIRES(lock_);
   uint8_t* AllocateCode(size_t code_size) REQUIRES(lock_);
   void FreeData(uint8_t* data) REQUIRES(lock_);
@@ -324,6 +375,12 @@ class JitCodeCache {
   // Number of code cache collections done throughout the lifetime of the JIT.
   size_t number_of_collections_ GUARDED_BY(lock_);
 
+  // Compilation statistics of the methods compiled throughout the lifetime of the JIT.
+  SafeMap<ArtMethod*, JitMethodStats> method_stats_ GUARDED_BY(lock_);
+
+  // The last code cache collections, oldest first.
+  std::deque<JitCollectionRecord> collection_history_ GUARDED_BY(lock_);
+
   // Histograms for keeping track of stack map size statistics.
   Histogram<uint64_t> histogram_stack_map_memory_use_ GUARDED_BY(lock_);
 
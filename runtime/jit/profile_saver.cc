@@ -139,6 +139,8 @@ void ProfileSaver::Run() {
     uint16_t new_methods = 0;
     uint64_t start_work = NanoTime();
     bool profile_saved_to_disk = ProcessProfilingInfo(&new_methods);
+    // Also keep the classes verified since the last wake up for the next run.
+    Runtime::Current()->GetOatFileManager().WriteVerificationCaches(self);
     // Update the notification counter based on result. Note that there might be contention on this
     // but we don't care about to be 100% precise.
     if (!profile_saved_to_disk) {
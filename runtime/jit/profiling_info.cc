@@ -25,17 +25,37 @@
 
 namespace art {
 
-ProfilingInfo::ProfilingInfo(ArtMethod* method, const std::vector<uint32_t>& entries)
+// A loop is considered hot if it has seen at least 1/kHotLoopRatio of the back edges
+// of the hottest loop of the method.
+static constexpr uint32_t kHotLoopRatio = 16;
+
+ProfilingInfo::ProfilingInfo(ArtMethod* method,
+                             const std::vector<uint32_t>& entries,
+                             const std::vector<uint32_t>& loop_headers,
+                             const std::vector<uint32_t>& branches)
       : number_of_inline_caches_(entries.size()),
+        number_of_loops_(loop_headers.size()),
+        number_of_branches_(branches.size()),
         method_(method),
         is_method_being_compiled_(false),
         is_osr_method_being_compiled_(false),
         current_inline_uses_(0),
+        number_of_deoptimizations_(0),
         saved_entry_point_(nullptr) {
   memset(&cache_, 0, number_of_inline_caches_ * sizeof(InlineCache));
   for (size_t i = 0; i < number_of_inline_caches_; ++i) {
     cache_[i].dex_pc_ = entries[i];
   }
+  LoopHotness* loops = GetLoops();
+  for (size_t i = 0; i < number_of_loops_; ++i) {
+    loops[i].dex_pc_ = loop_headers[i];
+    loops[i].count_ = 0;
+  }
+  BranchProfile* branch_profiles = GetBranches();
+  for (size_t i = 0; i < number_of_branches_; ++i) {
+    branch_profiles[i].dex_pc_ = branches[i];
+    branch_profiles[i].taken_ = false;
+  }
   if (method->IsCopied()) {
     // GetHoldingClassOfCopiedMethod is expensive, but creating a profiling info for a copied method
     // appears to happen very rarely in practice.
@@ -58,8 +78,21 @@ bool ProfilingInfo::Create(Thread* self, ArtMethod* method, bool retry_allocatio
 
   uint32_t dex_pc = 0;
   std::vector<uint32_t> entries;
+  std::vector<uint32_t> loop_headers;
+  std::vector<uint32_t> branches;
   while (code_ptr < code_end) {
     const Instruction& instruction = *Instruction::At(code_ptr);
+    if (instruction.IsBranch()) {
+      int32_t offset = instruction.GetTargetOffset();
+      if (offset <= 0) {
+        loop_headers.push_back(dex_pc + offset);
+      } else if (!instruction.IsUnconditional() &&
+                 offset > static_cast<int32_t>(instruction.SizeInCodeUnits())) {
+        // A conditional branch to the next instruction has the same target when not
+        // taken, there is nothing to profile.
+        branches.push_back(dex_pc);
+      }
+    }
     switch (instruction.Opcode()) {
       case Instruction::INVOKE_VIRTUAL:
       case Instruction::INVOKE_VIRTUAL_RANGE:
@@ -77,12 +110,51 @@ bool ProfilingInfo::Create(Thread* self, ArtMethod* method, bool retry_allocatio
     code_ptr += instruction.SizeInCodeUnits();
   }
 
+  // Several back edges may branch to the same loop header.
+  std::sort(loop_headers.begin(), loop_headers.end());
+  loop_headers.erase(std::unique(loop_headers.begin(), loop_headers.end()), loop_headers.end());
+
   // We always create a `ProfilingInfo` object, even if there is no instruction we are
   // interested in. The JIT code cache internally uses it.
 
   // Allocate the `ProfilingInfo` object int the JIT's data space.
   jit::JitCodeCache* code_cache = Runtime::Current()->GetJit()->GetCodeCache();
-  return code_cache->AddProfilingInfo(self, method, entries, retry_allocation) != nullptr;
+  return code_cache->AddProfilingInfo(
+      self, method, entries, loop_headers, branches, retry_allocation) != nullptr;
+}
+
+LoopHotness* ProfilingInfo::GetLoopHotness(uint32_t header_dex_pc) {
+  LoopHotness* begin = GetLoops();
+  LoopHotness* end = begin + number_of_loops_;
+  LoopHotness* it = std::lower_bound(
+      begin, end, header_dex_pc, [](const LoopHotness& loop, uint32_t dex_pc) {
+        return loop.dex_pc_ < dex_pc;
+      });
+  return (it != end && it->dex_pc_ == header_dex_pc) ? it : nullptr;
+}
+
+bool ProfilingInfo::IsHotLoopHeader(uint32_t header_dex_pc) {
+  LoopHotness* loop = GetLoopHotness(header_dex_pc);
+  if (loop == nullptr) {
+    return false;
+  }
+  uint32_t max_count = 0;
+  LoopHotness* loops = GetLoops();
+  for (size_t i = 0; i < number_of_loops_; ++i) {
+    max_count = std::max(max_count, loops[i].count_);
+  }
+  // Without any information, consider all loops hot.
+  return max_count == 0 || loop->count_ >= max_count / kHotLoopRatio;
+}
+
+BranchProfile* ProfilingInfo::GetBranchProfile(uint32_t dex_pc) {
+  BranchProfile* begin = GetBranches();
+  BranchProfile* end = begin + number_of_branches_;
+  BranchProfile* it = std::lower_bound(
+      begin, end, dex_pc, [](const BranchProfile& branch, uint32_t branch_dex_pc) {
+        return branch.dex_pc_ < branch_dex_pc;
+      });
+  return (it != end && it->dex_pc_ == dex_pc) ? it : nullptr;
 }
 
 InlineCache* ProfilingInfo::GetInlineCache(uint32_t dex_pc) {
@@ -84,6 +84,45 @@ class InlineCache {
   DISALLOW_COPY_AND_ASSIGN(InlineCache);
 };
 
+// Number of back edges taken to a loop header, as seen by the interpreter.
+class LoopHotness {
+ public:
+  uint32_t GetDexPc() const {
+    return dex_pc_;
+  }
+
+  uint32_t GetCount() const {
+    return count_;
+  }
+
+ private:
+  uint32_t dex_pc_;
+  // Updated without synchronization: like the method hotness counter, this is
+  // only a heuristic and lost updates are fine.
+  uint32_t count_;
+
+  friend class ProfilingInfo;
+};
+
+// Whether a forward conditional branch was taken, as seen by the interpreter.
+class BranchProfile {
+ public:
+  uint32_t GetDexPc() const {
+    return dex_pc_;
+  }
+
+  bool IsTaken() const {
+    return taken_;
+  }
+
+ private:
+  uint32_t dex_pc_;
+  // Only ever set to true, so updates need no synchronization.
+  bool taken_;
+
+  friend class ProfilingInfo;
+};
+
 /**
  * Profiling info for a method, created and filled by the interpreter once the
  * method is warm, and used by the compiler to drive optimizations.
@@ -95,6 +134,45 @@ class ProfilingInfo {
   static bool Create(Thread* self, ArtMethod* method, bool retry_allocation)
       SHARED_REQUIRES(Locks::mutator_lock_);
 
+  // Record that back edges to the loop header at `header_dex_pc` were taken `count` times.
+  void AddBackEdges(uint32_t header_dex_pc, uint32_t count) {
+    LoopHotness* loop = GetLoopHotness(header_dex_pc);
+    if (loop != nullptr) {
+      loop->count_ += std::min(count, std::numeric_limits<uint32_t>::max() - loop->count_);
+    }
+  }
+
+  size_t GetNumberOfLoops() const {
+    return number_of_loops_;
+  }
+
+  // Return the loop counter for the loop header at `header_dex_pc`, or null if
+  // there is no back edge to that dex pc.
+  LoopHotness* GetLoopHotness(uint32_t header_dex_pc);
+
+  // Return whether the loop at `header_dex_pc` is part of the hot loops of the method,
+  // that is whether it has seen at least a fraction of the back edges of the hottest loop.
+  bool IsHotLoopHeader(uint32_t header_dex_pc);
+
+  // Record that the interpreter took the forward conditional branch at `dex_pc`.
+  void AddTakenBranch(uint32_t dex_pc) {
+    BranchProfile* branch = GetBranchProfile(dex_pc);
+    if (branch != nullptr && !branch->taken_) {
+      branch->taken_ = true;
+    }
+  }
+
+  // Return the profile of the forward conditional branch at `dex_pc`, or null if
+  // there is no such branch.
+  BranchProfile* GetBranchProfile(uint32_t dex_pc);
+
+  // Return whether the forward conditional branch at `dex_pc` was never taken since
+  // the method is profiled, in which case the compiler may speculate it is not taken.
+  bool IsBranchNeverTaken(uint32_t dex_pc) {
+    BranchProfile* branch = GetBranchProfile(dex_pc);
+    return branch != nullptr && !branch->IsTaken();
+  }
+
   // Add information from an executed INVOKE instruction to the profile.
   void AddInvokeInfo(uint32_t dex_pc, mirror::Class* cls)
       // Method should not be interruptible, as it manipulates the ProfilingInfo
@@ -161,17 +239,67 @@ class ProfilingInfo {
     current_inline_uses_--;
   }
 
+  // Record that compiled code of the method deoptimized, because one of the
+  // speculations the compiler made did not hold.
+  void IncrementDeoptimizationCount() {
+    if (number_of_deoptimizations_ != std::numeric_limits<uint16_t>::max()) {
+      number_of_deoptimizations_++;
+    }
+  }
+
+  uint16_t GetDeoptimizationCount() const {
+    return number_of_deoptimizations_;
+  }
+
+  // Whether the compiler may speculate (and emit deoptimization points) when
+  // compiling the method. Once the compiled code of the method has deoptimized
+  // `kMaxSpeculativeDeoptimizations` times, it gets recompiled without speculation.
+  bool IsSpeculationAllowed() const {
+    return number_of_deoptimizations_ < kMaxSpeculativeDeoptimizations;
+  }
+
+  static constexpr uint16_t kMaxSpeculativeDeoptimizations = 3;
+
   bool IsInUseByCompiler() const {
     return IsMethodBeingCompiled(/*osr*/ true) || IsMethodBeingCompiled(/*osr*/ false) ||
         (current_inline_uses_ > 0);
   }
 
+  // Size of a ProfilingInfo with the given number of inline caches, loops and branches.
+  static size_t ComputeSize(size_t number_of_inline_caches,
+                            size_t number_of_loops,
+                            size_t number_of_branches) {
+    return sizeof(ProfilingInfo) +
+        sizeof(InlineCache) * number_of_inline_caches +
+        sizeof(LoopHotness) * number_of_loops +
+        sizeof(BranchProfile) * number_of_branches;
+  }
+
  private:
-  ProfilingInfo(ArtMethod* method, const std::vector<uint32_t>& entries);
+  ProfilingInfo(ArtMethod* method,
+                const std::vector<uint32_t>& entries,
+                const std::vector<uint32_t>& loop_headers,
+                const std::vector<uint32_t>& branches);
+
+  // The loop counters are allocated right after the inline caches, sorted by dex pc.
+  LoopHotness* GetLoops() {
+    return reinterpret_cast<LoopHotness*>(&cache_[number_of_inline_caches_]);
+  }
+
+  // The branch profiles are allocated right after the loop counters, sorted by dex pc.
+  BranchProfile* GetBranches() {
+    return reinterpret_cast<BranchProfile*>(GetLoops() + number_of_loops_);
+  }
 
   // Number of instructions we are profiling in the ArtMethod.
   const uint32_t number_of_inline_caches_;
 
+  // Number of loop headers we are profiling in the ArtMethod.
+  const uint32_t number_of_loops_;
+
+  // Number of forward conditional branches we are profiling in the ArtMethod.
+  const uint32_t number_of_branches_;
+
   // Method this profiling info is for.
   ArtMethod* const method_;
 
@@ -188,11 +316,16 @@ class ProfilingInfo {
   // it updates this counter so that the GC does not try to clear the inline caches.
   uint16_t current_inline_uses_;
 
+  // Number of times compiled code of the method deoptimized. Like the hotness
+  // counter, this is a heuristic and is reset if the ProfilingInfo is collected.
+  uint16_t number_of_deoptimizations_;
+
   // Entry point of the corresponding ArtMethod, while the JIT code cache
   // is poking for the liveness of compiled code.
   const void* saved_entry_point_;
 
-  // Dynamically allocated array of size `number_of_inline_caches_`.
+  // Dynamically allocated array of size `number_of_inline_caches_`, followed by
+  // an array of `number_of_loops_` LoopHotness and `number_of_branches_` BranchProfile.
   InlineCache cache_[0];
 
   friend class jit::JitCodeCache;
@@ -163,7 +163,8 @@ void JNIEnvExt::RecordMonitorEnter(jobject obj) {
 static std::string ComputeMonitorDescription(Thread* self,
                                              jobject obj) SHARED_REQUIRES(Locks::mutator_lock_) {
   mirror::Object* o = self->DecodeJObject(obj);
-  if ((o->GetLockWord(false).GetState() == LockWord::kThinLocked) &&
+  LockWord::LockState state = o->GetLockWord(false).GetState();
+  if ((state == LockWord::kThinLocked || state == LockWord::kBiased) &&
       Locks::mutator_lock_->IsExclusiveHeld(self)) {
     // Getting the identity hashcode here would result in lock inflation and suspension of the
     // current thread, which isn't safe if this is the only runnable thread.
@@ -29,9 +29,10 @@ namespace art {
 
 class JavaVMExt;
 
-// Maximum number of local references in the indirect reference table. The value is arbitrary but
-// low enough that it forces sanity checks.
-static constexpr size_t kLocalsMax = 512;
+// Maximum number of local references in the indirect reference table. The table only grows to
+// this size when that many references are live, which is limited by the encoding of indirect
+// references.
+static constexpr size_t kLocalsMax = kIRTMaxEntries;
 
 struct JNIEnvExt : public JNIEnv {
   static JNIEnvExt* Create(Thread* self, JavaVMExt* vm);
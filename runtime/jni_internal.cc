@@ -2329,7 +2329,7 @@ class JNI {
   static jint EnsureLocalCapacityInternal(ScopedObjectAccess& soa, jint desired_capacity,
                                           const char* caller)
       SHARED_REQUIRES(Locks::mutator_lock_) {
-    // TODO: we should try to expand the table if necessary.
+    // The table grows on demand, only check against its maximum size.
     if (desired_capacity < 0 || desired_capacity > static_cast<jint>(kLocalsMax)) {
       LOG(ERROR) << "Invalid capacity given to " << caller << ": " << desired_capacity;
       return JNI_ERR;
@@ -27,6 +27,9 @@
 
 namespace art {
 
+// Calls that leaked a local reference each would overflow the old fixed size local reference table.
+static constexpr size_t kLeakCheckIterations = 512;
+
 // TODO: Convert to CommonRuntimeTest. Currently MakeExecutable is used.
 class JniInternalTest : public CommonCompilerTest {
  protected:
@@ -85,6 +88,12 @@ class JniInternalTest : public CommonCompilerTest {
     CommonCompilerTest::TearDown();
   }
 
+  // Index past the last local reference of env_, holes included.
+  size_t GetLocalsTop() {
+    ScopedObjectAccess soa(env_);
+    return down_cast<JNIEnvExt*>(env_)->locals.Capacity();
+  }
+
   jclass GetPrimitiveClass(char descriptor) {
     ScopedObjectAccess soa(env_);
     mirror::Class* c = class_linker_->FindPrimitiveClass(descriptor);
@@ -868,11 +877,13 @@ TEST_F(JniInternalTest, FromReflectedField_ToReflectedField) {
   ASSERT_NE(fid, nullptr);
   // Turn the fid into a java.lang.reflect.Field...
   jobject field = env_->ToReflectedField(c, fid, JNI_FALSE);
-  for (size_t i = 0; i <= kLocalsMax; ++i) {
-    // Regression test for b/18396311, ToReflectedField leaking local refs causing a local
-    // reference table overflows with 512 references to ArtField
+  // Regression test for b/18396311, ToReflectedField leaking local refs to ArtField. The local
+  // reference table grows instead of overflowing, so check that its top stays put.
+  size_t locals_top = GetLocalsTop();
+  for (size_t i = 0; i != kLeakCheckIterations; ++i) {
     env_->DeleteLocalRef(env_->ToReflectedField(c, fid, JNI_FALSE));
   }
+  EXPECT_EQ(locals_top, GetLocalsTop());
   ASSERT_NE(c, nullptr);
   ASSERT_TRUE(env_->IsInstanceOf(field, jlrField));
   // ...and back again.
@@ -899,11 +910,12 @@ TEST_F(JniInternalTest, FromReflectedMethod_ToReflectedMethod) {
   ASSERT_NE(mid, nullptr);
   // Turn the mid into a java.lang.reflect.Constructor...
   jobject method = env_->ToReflectedMethod(c, mid, JNI_FALSE);
-  for (size_t i = 0; i <= kLocalsMax; ++i) {
-    // Regression test for b/18396311, ToReflectedMethod leaking local refs causing a local
-    // reference table overflows with 512 references to ArtMethod
+  // Regression test for b/18396311, ToReflectedMethod leaking local refs to ArtMethod.
+  size_t locals_top = GetLocalsTop();
+  for (size_t i = 0; i != kLeakCheckIterations; ++i) {
     env_->DeleteLocalRef(env_->ToReflectedMethod(c, mid, JNI_FALSE));
   }
+  EXPECT_EQ(locals_top, GetLocalsTop());
   ASSERT_NE(method, nullptr);
   ASSERT_TRUE(env_->IsInstanceOf(method, jlrConstructor));
   // ...and back again.
@@ -1868,8 +1880,8 @@ TEST_F(JniInternalTest, PushLocalFrame_10395422) {
   // Negative capacities are not allowed.
   ASSERT_EQ(JNI_ERR, env_->PushLocalFrame(-1));
 
-  // And it's okay to have an upper limit. Ours is currently 512.
-  ASSERT_EQ(JNI_ERR, env_->PushLocalFrame(8192));
+  // And it's okay to have an upper limit. Ours is kLocalsMax.
+  ASSERT_EQ(JNI_ERR, env_->PushLocalFrame(static_cast<jint>(kLocalsMax) + 1));
 }
 
 TEST_F(JniInternalTest, PushLocalFrame_PopLocalFrame) {
@@ -34,6 +34,18 @@ inline uint32_t LockWord::ThinLockCount() const {
   return (value_ >> kThinLockCountShift) & kThinLockCountMask;
 }
 
+inline uint32_t LockWord::BiasedLockOwner() const {
+  DCHECK_EQ(GetState(), kBiased);
+  CheckReadBarrierState();
+  return (value_ >> kThinLockOwnerShift) & kThinLockOwnerMask;
+}
+
+inline uint32_t LockWord::BiasedLockCount() const {
+  DCHECK_EQ(GetState(), kBiased);
+  CheckReadBarrierState();
+  return (value_ >> kThinLockCountShift) & kThinLockCountMask;
+}
+
 inline Monitor* LockWord::FatLockMonitor() const {
   DCHECK_EQ(GetState(), kFatLocked);
   CheckReadBarrierState();
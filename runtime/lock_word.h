@@ -35,9 +35,18 @@ class Monitor;
  * the state. The four possible states are fat locked, thin/unlocked, hash code, and forwarding
  * address. When the lock word is in the "thin" state and its bits are formatted as follows:
  *
- *  |33|22|222222221111|1111110000000000|
- *  |10|98|765432109876|5432109876543210|
- *  |00|rb| lock count |thread id owner |
+ *  |33|22|2|22222221111|1111110000000000|
+ *  |10|98|7|65432109876|5432109876543210|
+ *  |00|rb|0| lock count|thread id owner |
+ *
+ * When the lock word is in the "biased" state, it is reserved for the thread whose id it holds,
+ * which may lock and unlock it without atomic operations. The count is the number of times the
+ * owner currently holds the lock, 0 meaning the lock is not held. Its bits are formatted as
+ * follows:
+ *
+ *  |33|22|2|22222221111|1111110000000000|
+ *  |10|98|7|65432109876|5432109876543210|
+ *  |00|rb|1| hold count|thread id owner |
  *
  * When the lock word is in the "fat" state and its bits are formatted as follows:
  *
@@ -67,8 +76,10 @@ class LockWord {
     kReadBarrierStateSize = 2,
     // Number of bits to encode the thin lock owner.
     kThinLockOwnerSize = 16,
+    // One bit to tell biased locks apart from thin locks.
+    kBiasedSize = 1,
     // Remaining bits are the recursive lock count.
-    kThinLockCountSize = 32 - kThinLockOwnerSize - kStateSize - kReadBarrierStateSize,
+    kThinLockCountSize = 32 - kThinLockOwnerSize - kBiasedSize - kStateSize - kReadBarrierStateSize,
     // Thin lock bits. Owner in lowest bits.
 
     kThinLockOwnerShift = 0,
@@ -79,16 +90,21 @@ class LockWord {
     kThinLockCountMask = (1 << kThinLockCountSize) - 1,
     kThinLockMaxCount = kThinLockCountMask,
     kThinLockCountOne = 1 << kThinLockCountShift,  // == 65536 (0x10000)
+    kThinLockCountMaskShifted = kThinLockCountMask << kThinLockCountShift,
+
+    // Biased flag right above the count.
+    kBiasedShift = kThinLockCountSize + kThinLockCountShift,
+    kBiasedFlag = 1 << kBiasedShift,
 
     // State in the highest bits.
-    kStateShift = kReadBarrierStateSize + kThinLockCountSize + kThinLockCountShift,
+    kStateShift = kReadBarrierStateSize + kBiasedSize + kThinLockCountSize + kThinLockCountShift,
     kStateMask = (1 << kStateSize) - 1,
     kStateMaskShifted = kStateMask << kStateShift,
     kStateThinOrUnlocked = 0,
     kStateFat = 1,
     kStateHash = 2,
     kStateForwardingAddress = 3,
-    kReadBarrierStateShift = kThinLockCountSize + kThinLockCountShift,
+    kReadBarrierStateShift = kBiasedSize + kThinLockCountSize + kThinLockCountShift,
     kReadBarrierStateMask = (1 << kReadBarrierStateSize) - 1,
     kReadBarrierStateMaskShifted = kReadBarrierStateMask << kReadBarrierStateShift,
     kReadBarrierStateMaskShiftedToggled = ~kReadBarrierStateMaskShifted,
@@ -117,6 +133,15 @@ class LockWord {
                     (kStateThinOrUnlocked << kStateShift));
   }
 
+  static LockWord FromBiasedLockId(uint32_t thread_id, uint32_t count, uint32_t rb_state) {
+    CHECK_LE(thread_id, static_cast<uint32_t>(kThinLockMaxOwner));
+    CHECK_LE(count, static_cast<uint32_t>(kThinLockMaxCount));
+    DCHECK_EQ(rb_state & ~kReadBarrierStateMask, 0U);
+    return LockWord((thread_id << kThinLockOwnerShift) | (count << kThinLockCountShift) |
+                    kBiasedFlag | (rb_state << kReadBarrierStateShift) |
+                    (kStateThinOrUnlocked << kStateShift));
+  }
+
   static LockWord FromForwardingAddress(size_t target) {
     DCHECK_ALIGNED(target, (1 << kStateSize));
     return LockWord((target >> kStateSize) | (kStateForwardingAddress << kStateShift));
@@ -146,6 +171,7 @@ class LockWord {
   enum LockState {
     kUnlocked,    // No lock owners.
     kThinLocked,  // Single uncontended owner.
+    kBiased,      // Reserved for a single thread, which may or may not hold the lock.
     kFatLocked,   // See associated monitor.
     kHashCode,    // Lock word contains an identity hash.
     kForwardingAddress,  // Lock word contains the forwarding address of an object.
@@ -160,7 +186,7 @@ class LockWord {
       uint32_t internal_state = (value_ >> kStateShift) & kStateMask;
       switch (internal_state) {
         case kStateThinOrUnlocked:
-          return kThinLocked;
+          return ((value_ & kBiasedFlag) != 0) ? kBiased : kThinLocked;
         case kStateHash:
           return kHashCode;
         case kStateForwardingAddress:
@@ -190,6 +216,12 @@ class LockWord {
   // Return the number of times a lock value has been locked.
   uint32_t ThinLockCount() const;
 
+  // Return the thread id the biased lock is reserved for.
+  uint32_t BiasedLockOwner() const;
+
+  // Return the number of times the owner of the biased lock currently holds it.
+  uint32_t BiasedLockCount() const;
+
   // Return the Monitor encoded in a fat lock.
   Monitor* FatLockMonitor() const;
 
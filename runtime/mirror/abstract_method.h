@@ -39,7 +39,7 @@ class MANAGED AbstractMethod : public AccessibleObject {
       REQUIRES(!Roles::uninterruptible_);
 
   ArtMethod* GetArtMethod() SHARED_REQUIRES(Locks::mutator_lock_);
-  // Only used by the image writer.
+  // Only used by the image writer and when relocating images.
   template <bool kTransactionActive = false>
   void SetArtMethod(ArtMethod* method) SHARED_REQUIRES(Locks::mutator_lock_);
   mirror::Class* GetDeclaringClass() SHARED_REQUIRES(Locks::mutator_lock_);
@@ -17,6 +17,9 @@
 #ifndef ART_RUNTIME_MIRROR_CLASS_H_
 #define ART_RUNTIME_MIRROR_CLASS_H_
 
+#include <atomic>
+#include <type_traits>
+
 #include "base/iteration_range.h"
 #include "dex_file.h"
 #include "class_flags.h"
@@ -53,6 +56,12 @@ class Constructor;
 class DexCache;
 class IfTable;
 class Method;
+class String;
+struct StringDexCachePair;  // Defined in dex_cache.h.
+// Slot of the strings array of a DexCache.
+using StringDexCacheType = std::conditional<kUseHashedDexCacheStrings,
+                                            std::atomic<StringDexCachePair>,
+                                            GcRoot<String>>::type;
 
 // C++ mirror of java.lang.Class
 class MANAGED Class FINAL : public Object {
@@ -241,6 +250,25 @@ class MANAGED Class FINAL : public Object {
     SetAccessFlags(flags | kAccClassIsFinalizable);
   }
 
+  ALWAYS_INLINE bool IsBiasedLockingRevoked() SHARED_REQUIRES(Locks::mutator_lock_) {
+    return (GetAccessFlags() & kAccBiasedLockingRevoked) != 0;
+  }
+
+  // Stop biasing locks of instances of this class. Uses a CAS since, unlike the other
+  // runtime flags, this is set without holding the class lock.
+  void SetBiasedLockingRevoked() SHARED_REQUIRES(Locks::mutator_lock_) {
+    MemberOffset offset = OFFSET_OF_OBJECT_MEMBER(Class, access_flags_);
+    while (true) {
+      int32_t flags = GetField32(offset);
+      if ((flags & kAccBiasedLockingRevoked) != 0 ||
+          CasFieldWeakSequentiallyConsistent32<false>(offset,
+                                                      flags,
+                                                      flags | kAccBiasedLockingRevoked)) {
+        return;
+      }
+    }
+  }
+
   ALWAYS_INLINE bool IsStringClass() SHARED_REQUIRES(Locks::mutator_lock_) {
     return (GetClassFlags() & kClassFlagString) != 0;
   }
@@ -1206,8 +1234,8 @@ class MANAGED Class FINAL : public Object {
   bool GetSlowPathEnabled() SHARED_REQUIRES(Locks::mutator_lock_);
   void SetSlowPath(bool enabled) SHARED_REQUIRES(Locks::mutator_lock_);
 
-  GcRoot<String>* GetDexCacheStrings() SHARED_REQUIRES(Locks::mutator_lock_);
-  void SetDexCacheStrings(GcRoot<String>* new_dex_cache_strings)
+  StringDexCacheType* GetDexCacheStrings() SHARED_REQUIRES(Locks::mutator_lock_);
+  void SetDexCacheStrings(StringDexCacheType* new_dex_cache_strings)
       SHARED_REQUIRES(Locks::mutator_lock_);
   static MemberOffset DexCacheStringsOffset() {
     return OFFSET_OF_OBJECT_MEMBER(Class, dex_cache_strings_);
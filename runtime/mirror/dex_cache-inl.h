@@ -19,6 +19,8 @@
 
 #include "dex_cache.h"
 
+#include <algorithm>
+
 #include "art_field-inl.h"
 #include "art_method-inl.h"
 #include "base/casts.h"
@@ -29,20 +31,123 @@
 namespace art {
 namespace mirror {
 
+inline void StringDexCachePair::Initialize(std::atomic<StringDexCachePair>* dex_cache_strings) {
+  StringDexCachePair first_elem;
+  first_elem.string_pointer = GcRoot<String>(nullptr);
+  first_elem.string_index = 1u;
+  dex_cache_strings[0].store(first_elem, std::memory_order_relaxed);
+}
+
+inline String* StringDexCachePair::Lookup(GcRoot<String>* dex_cache_strings,
+                                          uint32_t string_idx,
+                                          uint32_t cache_size) {
+  DCHECK_LT(string_idx, cache_size);
+  return dex_cache_strings[string_idx].Read();
+}
+
+inline String* StringDexCachePair::Lookup(std::atomic<StringDexCachePair>* dex_cache_strings,
+                                          uint32_t string_idx,
+                                          uint32_t cache_size) {
+  StringDexCachePair pair =
+      dex_cache_strings[string_idx % cache_size].load(std::memory_order_relaxed);
+  if (pair.string_index != string_idx) {
+    return nullptr;
+  }
+  return pair.string_pointer.Read();
+}
+
+inline void StringDexCachePair::Assign(GcRoot<String>* dex_cache_strings,
+                                       uint32_t string_idx,
+                                       uint32_t cache_size,
+                                       String* string) {
+  DCHECK_LT(string_idx, cache_size);
+  dex_cache_strings[string_idx] = GcRoot<String>(string);
+}
+
+inline void StringDexCachePair::Assign(std::atomic<StringDexCachePair>* dex_cache_strings,
+                                       uint32_t string_idx,
+                                       uint32_t cache_size,
+                                       String* string) {
+  StringDexCachePair pair;
+  pair.string_pointer = GcRoot<String>(string);
+  pair.string_index = string_idx;
+  dex_cache_strings[string_idx % cache_size].store(pair, std::memory_order_relaxed);
+}
+
+template <ReadBarrierOption kReadBarrierOption>
+inline String* StringDexCachePair::ReadSlot(GcRoot<String>* dex_cache_strings, size_t slot) {
+  return dex_cache_strings[slot].Read<kReadBarrierOption>();
+}
+
+template <ReadBarrierOption kReadBarrierOption>
+inline String* StringDexCachePair::ReadSlot(std::atomic<StringDexCachePair>* dex_cache_strings,
+                                            size_t slot) {
+  StringDexCachePair pair = dex_cache_strings[slot].load(std::memory_order_relaxed);
+  return pair.string_pointer.Read<kReadBarrierOption>();
+}
+
+inline void StringDexCachePair::UpdateSlot(GcRoot<String>* src ATTRIBUTE_UNUSED,
+                                           GcRoot<String>* dest,
+                                           size_t slot,
+                                           String* string) {
+  dest[slot] = GcRoot<String>(string);
+}
+
+inline void StringDexCachePair::UpdateSlot(std::atomic<StringDexCachePair>* src,
+                                           std::atomic<StringDexCachePair>* dest,
+                                           size_t slot,
+                                           String* string) {
+  StringDexCachePair pair = src[slot].load(std::memory_order_relaxed);
+  pair.string_pointer = GcRoot<String>(string);
+  dest[slot].store(pair, std::memory_order_relaxed);
+}
+
+inline void StringDexCachePair::CopySlots(GcRoot<String>* src,
+                                          GcRoot<String>* dest,
+                                          size_t count) {
+  std::copy_n(src, count, dest);
+}
+
+inline void StringDexCachePair::CopySlots(std::atomic<StringDexCachePair>* src,
+                                          std::atomic<StringDexCachePair>* dest,
+                                          size_t count) {
+  for (size_t i = 0; i != count; ++i) {
+    dest[i].store(src[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+  }
+}
+
+template <typename Visitor>
+inline void StringDexCachePair::VisitSlot(GcRoot<String>* dex_cache_strings,
+                                          size_t slot,
+                                          const Visitor& visitor) {
+  visitor.VisitRootIfNonNull(dex_cache_strings[slot].AddressWithoutBarrier());
+}
+
+template <typename Visitor>
+inline void StringDexCachePair::VisitSlot(std::atomic<StringDexCachePair>* dex_cache_strings,
+                                          size_t slot,
+                                          const Visitor& visitor) {
+  // The pair is only accessed atomically, so visit a copy and write back any update.
+  StringDexCachePair pair = dex_cache_strings[slot].load(std::memory_order_relaxed);
+  String* before = pair.string_pointer.Read<kWithoutReadBarrier>();
+  visitor.VisitRootIfNonNull(pair.string_pointer.AddressWithoutBarrier());
+  if (pair.string_pointer.Read<kWithoutReadBarrier>() != before) {
+    dex_cache_strings[slot].store(pair, std::memory_order_relaxed);
+  }
+}
+
 inline uint32_t DexCache::ClassSize(size_t pointer_size) {
   uint32_t vtable_entries = Object::kVTableLength + 5;
   return Class::ComputeClassSize(true, vtable_entries, 0, 0, 0, 0, 0, pointer_size);
 }
 
 inline String* DexCache::GetResolvedString(uint32_t string_idx) {
-  DCHECK_LT(string_idx, NumStrings());
-  return GetStrings()[string_idx].Read();
+  return StringDexCachePair::Lookup(GetStrings(), string_idx, NumStrings());
 }
 
 inline void DexCache::SetResolvedString(uint32_t string_idx, String* resolved) {
-  DCHECK_LT(string_idx, NumStrings());
   // TODO default transaction support.
-  GetStrings()[string_idx] = GcRoot<String>(resolved);
+  StringDexCachePair::Assign(GetStrings(), string_idx, NumStrings(), resolved);
   // TODO: Fine-grained marking, so that we don't need to go through all arrays in full.
   Runtime::Current()->GetHeap()->WriteBarrierEveryFieldOf(this);
 }
@@ -130,9 +235,9 @@ inline void DexCache::VisitReferences(mirror::Class* klass, const Visitor& visit
   VisitInstanceFieldsReferences<kVerifyFlags, kReadBarrierOption>(klass, visitor);
   // Visit arrays after.
   if (kVisitNativeRoots) {
-    GcRoot<mirror::String>* strings = GetStrings();
+    StringDexCacheType* strings = GetStrings();
     for (size_t i = 0, num_strings = NumStrings(); i != num_strings; ++i) {
-      visitor.VisitRootIfNonNull(strings[i].AddressWithoutBarrier());
+      StringDexCachePair::VisitSlot(strings, i, visitor);
     }
     GcRoot<mirror::Class>* resolved_types = GetResolvedTypes();
     for (size_t i = 0, num_types = NumResolvedTypes(); i != num_types; ++i) {
@@ -142,12 +247,15 @@ inline void DexCache::VisitReferences(mirror::Class* klass, const Visitor& visit
 }
 
 template <ReadBarrierOption kReadBarrierOption, typename Visitor>
-inline void DexCache::FixupStrings(GcRoot<mirror::String>* dest, const Visitor& visitor) {
-  GcRoot<mirror::String>* src = GetStrings();
+inline void DexCache::FixupStrings(StringDexCacheType* dest, const Visitor& visitor) {
+  StringDexCacheType* src = GetStrings();
   for (size_t i = 0, count = NumStrings(); i < count; ++i) {
-    mirror::String* source = src[i].Read<kReadBarrierOption>();
+    mirror::String* source = StringDexCachePair::ReadSlot<kReadBarrierOption>(src, i);
     mirror::String* new_source = visitor(source);
-    dest[i] = GcRoot<mirror::String>(new_source);
+    // When fixing up in place, avoid dirtying pages of entries that do not change.
+    if (dest != src || source != new_source) {
+      StringDexCachePair::UpdateSlot(src, dest, i, new_source);
+    }
   }
 }
 
@@ -157,7 +265,10 @@ inline void DexCache::FixupResolvedTypes(GcRoot<mirror::Class>* dest, const Visi
   for (size_t i = 0, count = NumResolvedTypes(); i < count; ++i) {
     mirror::Class* source = src[i].Read<kReadBarrierOption>();
     mirror::Class* new_source = visitor(source);
-    dest[i] = GcRoot<mirror::Class>(new_source);
+    // When fixing up in place, avoid dirtying pages of entries that do not change.
+    if (dest != src || source != new_source) {
+      dest[i] = GcRoot<mirror::Class>(new_source);
+    }
   }
 }
 
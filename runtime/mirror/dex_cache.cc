@@ -31,9 +31,11 @@
 namespace art {
 namespace mirror {
 
+constexpr size_t DexCache::kDexCacheStringCacheSize;
+
 void DexCache::Init(const DexFile* dex_file,
                     String* location,
-                    GcRoot<String>* strings,
+                    StringDexCacheType* strings,
                     uint32_t num_strings,
                     GcRoot<Class>* resolved_types,
                     uint32_t num_resolved_types,
@@ -45,10 +47,15 @@ void DexCache::Init(const DexFile* dex_file,
   CHECK(dex_file != nullptr);
   CHECK(location != nullptr);
   CHECK_EQ(num_strings != 0u, strings != nullptr);
+  CHECK_EQ(num_strings, StringsArraySize(dex_file->NumStringIds()));
   CHECK_EQ(num_resolved_types != 0u, resolved_types != nullptr);
   CHECK_EQ(num_resolved_methods != 0u, resolved_methods != nullptr);
   CHECK_EQ(num_resolved_fields != 0u, resolved_fields != nullptr);
 
+  if (strings != nullptr) {
+    StringDexCachePair::Initialize(strings);
+  }
+
   SetDexFile(dex_file);
   SetLocation(location);
   SetStrings(strings);
@@ -17,6 +17,8 @@
 #ifndef ART_RUNTIME_MIRROR_DEX_CACHE_H_
 #define ART_RUNTIME_MIRROR_DEX_CACHE_H_
 
+#include <atomic>
+
 #include "array.h"
 #include "art_field.h"
 #include "art_method.h"
@@ -35,9 +37,101 @@ namespace mirror {
 
 class String;
 
+// An entry of the strings array of a DexCache with kUseHashedDexCacheStrings. The array then has
+// at most kDexCacheStringCacheSize slots and string_idx is stored in slot
+// string_idx % NumStrings(), so the index is kept next to the string to tell which of the
+// colliding ids the slot currently holds. The pair is read and written as a single 64-bit value
+// so that readers, including compiled code, never see the string of one id with the index of
+// another. A zero-initialized slot k holds {null, 0} which looks up as unresolved for every
+// k != 0; slot 0 is set to {null, 1} by Initialize() so that an index compare is enough.
+//
+// Without kUseHashedDexCacheStrings, the array has one GcRoot<String> per string id. The static
+// functions access the slots of either kind of array, see StringDexCacheType.
+struct PACKED(8) StringDexCachePair {
+  GcRoot<String> string_pointer;
+  uint32_t string_index;
+
+  static void Initialize(GcRoot<String>* dex_cache_strings ATTRIBUTE_UNUSED) {}
+  static void Initialize(std::atomic<StringDexCachePair>* dex_cache_strings)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
+  // The string resolved for string_idx, or null if it is not in the array.
+  static String* Lookup(GcRoot<String>* dex_cache_strings,
+                        uint32_t string_idx,
+                        uint32_t cache_size)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+  static String* Lookup(std::atomic<StringDexCachePair>* dex_cache_strings,
+                        uint32_t string_idx,
+                        uint32_t cache_size)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
+  static void Assign(GcRoot<String>* dex_cache_strings,
+                     uint32_t string_idx,
+                     uint32_t cache_size,
+                     String* string)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+  static void Assign(std::atomic<StringDexCachePair>* dex_cache_strings,
+                     uint32_t string_idx,
+                     uint32_t cache_size,
+                     String* string)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
+  // The string held by a slot, whichever string id it was resolved for.
+  template <ReadBarrierOption kReadBarrierOption = kWithReadBarrier>
+  static String* ReadSlot(GcRoot<String>* dex_cache_strings, size_t slot)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+  template <ReadBarrierOption kReadBarrierOption = kWithReadBarrier>
+  static String* ReadSlot(std::atomic<StringDexCachePair>* dex_cache_strings, size_t slot)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
+  // Stores the string in the slot of dest, with the string id of the same slot of src.
+  static void UpdateSlot(GcRoot<String>* src,
+                         GcRoot<String>* dest,
+                         size_t slot,
+                         String* string)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+  static void UpdateSlot(std::atomic<StringDexCachePair>* src,
+                         std::atomic<StringDexCachePair>* dest,
+                         size_t slot,
+                         String* string)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
+  static void CopySlots(GcRoot<String>* src, GcRoot<String>* dest, size_t count);
+  static void CopySlots(std::atomic<StringDexCachePair>* src,
+                        std::atomic<StringDexCachePair>* dest,
+                        size_t count);
+
+  template <typename Visitor>
+  static void VisitSlot(GcRoot<String>* dex_cache_strings, size_t slot, const Visitor& visitor)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+  template <typename Visitor>
+  static void VisitSlot(std::atomic<StringDexCachePair>* dex_cache_strings,
+                        size_t slot,
+                        const Visitor& visitor)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+};
+
 // C++ mirror of java.lang.DexCache.
 class MANAGED DexCache FINAL : public Object {
  public:
+  // Maximum number of slots of the strings array with kUseHashedDexCacheStrings. Dex files
+  // with fewer string ids get one slot per id, larger ones share the slots between the ids
+  // with the same remainder.
+  static constexpr size_t kDexCacheStringCacheSize = 1024;
+
+  // Number of slots of the strings array for a dex file with num_string_ids string ids.
+  static constexpr size_t StringsArraySize(size_t num_string_ids) {
+    return (kUseHashedDexCacheStrings && num_string_ids > kDexCacheStringCacheSize)
+        ? kDexCacheStringCacheSize
+        : num_string_ids;
+  }
+
+  // Slot of the strings array holding string_idx. Equal to string_idx % NumStrings() for any
+  // array of StringsArraySize() slots; compiled code uses it to emit a constant offset.
+  static constexpr uint32_t StringSlotIndex(uint32_t string_idx) {
+    return kUseHashedDexCacheStrings ? string_idx % kDexCacheStringCacheSize : string_idx;
+  }
+
   // Size of java.lang.DexCache.class.
   static uint32_t ClassSize(size_t pointer_size);
 
@@ -48,7 +142,7 @@ class MANAGED DexCache FINAL : public Object {
 
   void Init(const DexFile* dex_file,
             String* location,
-            GcRoot<String>* strings,
+            StringDexCacheType* strings,
             uint32_t num_strings,
             GcRoot<Class>* resolved_types,
             uint32_t num_resolved_types,
@@ -61,8 +155,11 @@ class MANAGED DexCache FINAL : public Object {
   void Fixup(ArtMethod* trampoline, size_t pointer_size)
       SHARED_REQUIRES(Locks::mutator_lock_);
 
+  // Copy the strings or types to `dest`, running them through the visitor. When fixing up in place
+  // (`dest` is the current array), only entries that change are written, so that pages of
+  // unchanged entries stay clean.
   template <ReadBarrierOption kReadBarrierOption = kWithReadBarrier, typename Visitor>
-  void FixupStrings(GcRoot<mirror::String>* dest, const Visitor& visitor)
+  void FixupStrings(StringDexCacheType* dest, const Visitor& visitor)
       SHARED_REQUIRES(Locks::mutator_lock_);
 
   template <ReadBarrierOption kReadBarrierOption = kWithReadBarrier, typename Visitor>
@@ -133,11 +230,12 @@ class MANAGED DexCache FINAL : public Object {
   ALWAYS_INLINE void SetResolvedField(uint32_t idx, ArtField* field, size_t ptr_size)
       SHARED_REQUIRES(Locks::mutator_lock_);
 
-  GcRoot<String>* GetStrings() ALWAYS_INLINE SHARED_REQUIRES(Locks::mutator_lock_) {
-    return GetFieldPtr<GcRoot<String>*>(StringsOffset());
+  StringDexCacheType* GetStrings() ALWAYS_INLINE SHARED_REQUIRES(Locks::mutator_lock_) {
+    return GetFieldPtr<StringDexCacheType*>(StringsOffset());
   }
 
-  void SetStrings(GcRoot<String>* strings) ALWAYS_INLINE SHARED_REQUIRES(Locks::mutator_lock_) {
+  void SetStrings(StringDexCacheType* strings) ALWAYS_INLINE
+      SHARED_REQUIRES(Locks::mutator_lock_) {
     SetFieldPtr<false>(StringsOffset(), strings);
   }
 
@@ -171,6 +269,7 @@ class MANAGED DexCache FINAL : public Object {
     SetFieldPtr<false>(ResolvedFieldsOffset(), resolved_fields);
   }
 
+  // Number of slots in the strings array, see StringsArraySize().
   size_t NumStrings() SHARED_REQUIRES(Locks::mutator_lock_) {
     return GetField32(NumStringsOffset());
   }
@@ -222,11 +321,11 @@ class MANAGED DexCache FINAL : public Object {
   uint64_t resolved_fields_;    // ArtField*, array with num_resolved_fields_ elements.
   uint64_t resolved_methods_;   // ArtMethod*, array with num_resolved_methods_ elements.
   uint64_t resolved_types_;     // GcRoot<Class>*, array with num_resolved_types_ elements.
-  uint64_t strings_;            // GcRoot<String>*, array with num_strings_ elements.
+  uint64_t strings_;            // StringDexCacheType*, array with num_strings_ elements.
   uint32_t num_resolved_fields_;    // Number of elements in the resolved_fields_ array.
   uint32_t num_resolved_methods_;   // Number of elements in the resolved_methods_ array.
   uint32_t num_resolved_types_;     // Number of elements in the resolved_types_ array.
-  uint32_t num_strings_;            // Number of elements in the strings_ array.
+  uint32_t num_strings_;            // Number of slots in the strings_ array.
 
   friend struct art::DexCacheOffsets;  // for verifying offset information
   friend class Object;  // For VisitReferences
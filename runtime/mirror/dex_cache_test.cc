@@ -22,6 +22,7 @@
 #include "common_runtime_test.h"
 #include "linear_alloc.h"
 #include "mirror/class_loader-inl.h"
+#include "mirror/dex_cache-inl.h"
 #include "handle_scope-inl.h"
 #include "scoped_thread_state_change.h"
 
@@ -40,12 +41,44 @@ TEST_F(DexCacheTest, Open) {
                                                 Runtime::Current()->GetLinearAlloc())));
   ASSERT_TRUE(dex_cache.Get() != nullptr);
 
-  EXPECT_EQ(java_lang_dex_file_->NumStringIds(), dex_cache->NumStrings());
+  EXPECT_EQ(DexCache::StringsArraySize(java_lang_dex_file_->NumStringIds()),
+            dex_cache->NumStrings());
   EXPECT_EQ(java_lang_dex_file_->NumTypeIds(),   dex_cache->NumResolvedTypes());
   EXPECT_EQ(java_lang_dex_file_->NumMethodIds(), dex_cache->NumResolvedMethods());
   EXPECT_EQ(java_lang_dex_file_->NumFieldIds(),  dex_cache->NumResolvedFields());
 }
 
+TEST_F(DexCacheTest, StringCacheEviction) {
+  if (!kUseHashedDexCacheStrings) {
+    return;
+  }
+  ScopedObjectAccess soa(Thread::Current());
+  StackHandleScope<3> hs(soa.Self());
+  ASSERT_TRUE(java_lang_dex_file_ != nullptr);
+  ASSERT_GT(java_lang_dex_file_->NumStringIds(), DexCache::kDexCacheStringCacheSize);
+  Handle<DexCache> dex_cache(
+      hs.NewHandle(class_linker_->AllocDexCache(soa.Self(),
+                                                *java_lang_dex_file_,
+                                                Runtime::Current()->GetLinearAlloc())));
+  ASSERT_TRUE(dex_cache.Get() != nullptr);
+  ASSERT_EQ(DexCache::kDexCacheStringCacheSize, dex_cache->NumStrings());
+
+  // Both string indexes map to the first slot of the strings cache.
+  const uint32_t first_idx = 0u;
+  const uint32_t second_idx = DexCache::kDexCacheStringCacheSize;
+  Handle<String> first(hs.NewHandle(String::AllocFromModifiedUtf8(soa.Self(), "first")));
+  Handle<String> second(hs.NewHandle(String::AllocFromModifiedUtf8(soa.Self(), "second")));
+  EXPECT_TRUE(dex_cache->GetResolvedString(first_idx) == nullptr);
+
+  dex_cache->SetResolvedString(first_idx, first.Get());
+  EXPECT_EQ(first.Get(), dex_cache->GetResolvedString(first_idx));
+  EXPECT_TRUE(dex_cache->GetResolvedString(second_idx) == nullptr);
+
+  dex_cache->SetResolvedString(second_idx, second.Get());
+  EXPECT_EQ(second.Get(), dex_cache->GetResolvedString(second_idx));
+  EXPECT_TRUE(dex_cache->GetResolvedString(first_idx) == nullptr);
+}
+
 TEST_F(DexCacheTest, LinearAlloc) {
   ScopedObjectAccess soa(Thread::Current());
   jobject jclass_loader(LoadDex("Main"));
@@ -182,6 +182,16 @@ int32_t Object::IdentityHashCode() const {
         current_this = h_this.Get();
         break;
       }
+      case LockWord::kBiased: {
+        // Turn the biased lock into a thin lock which we then inflate. May fail spuriously.
+        Thread* self = Thread::Current();
+        StackHandleScope<1> hs(self);
+        Handle<mirror::Object> h_this(hs.NewHandle(current_this));
+        Monitor::RevokeBias(self, h_this);
+        // A GC may have occurred when we switched to kBlocked.
+        current_this = h_this.Get();
+        break;
+      }
       case LockWord::kFatLocked: {
         // Already inflated, return the hash stored in the monitor.
         Monitor* monitor = lw.FatLockMonitor();
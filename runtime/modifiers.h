@@ -68,7 +68,13 @@ static constexpr uint32_t kAccCompileDontBother =     0x01000000;  // method (ru
 // Set by the verifier for a method that could not be verified to follow structured locking.
 static constexpr uint32_t kAccMustCountLocks =        0x02000000;  // method (runtime)
 
+// Set by the class linker for a static native method annotated @CriticalNative. The native code
+// takes neither a JNIEnv* nor a jclass and is called without leaving the Runnable state.
+static constexpr uint32_t kAccCriticalNative =        0x04000000;  // method (runtime)
+
 // Special runtime-only flags.
+// Instances of the class are no longer biased towards a thread when locked, see Monitor.
+static constexpr uint32_t kAccBiasedLockingRevoked      = 0x10000000;
 // Interface and all its super-interfaces with default methods have been recursively initialized.
 static constexpr uint32_t kAccRecursivelyInitialized    = 0x20000000;
 // Interface declares some default method.
@@ -16,6 +16,8 @@
 
 #include "monitor.h"
 
+#include <algorithm>
+#include <map>
 #include <vector>
 
 #include "art_method-inl.h"
@@ -26,6 +28,9 @@
 #include "class_linker.h"
 #include "dex_file-inl.h"
 #include "dex_instruction-inl.h"
+#include "gc/heap.h"
+#include "handle_scope-inl.h"
+#include "linear_alloc.h"
 #include "lock_word-inl.h"
 #include "mirror/class-inl.h"
 #include "mirror/object-inl.h"
@@ -40,6 +45,33 @@ namespace art {
 
 static constexpr uint64_t kLongWaitMs = 100;
 
+// Number of buckets of the contention wait time histograms. Bucket i counts the waits
+// shorter than 2^i microseconds, the last bucket counts the longer ones.
+static constexpr size_t kContentionHistogramBuckets = 20;
+
+// Contention statistics of a lock acquisition site.
+struct ContentionSite {
+  uint64_t count;
+  uint64_t total_wait_ns;
+  uint64_t max_wait_ns;
+  uint64_t wait_histogram[kContentionHistogramBuckets];
+};
+
+// Contended lock acquisition sites, indexed by method and dex pc. Method names are only
+// computed when dumping; sites are removed when the class loader of their method is unloaded.
+static std::map<std::pair<ArtMethod*, uint32_t>, ContentionSite> contention_sites_;
+
+// Hint to the processor that we are busy-waiting.
+static inline void SpinPause() {
+#if defined(__i386__) || defined(__x86_64__)
+  __builtin_ia32_pause();
+#elif defined(__arm__) || defined(__aarch64__)
+  __asm__ __volatile__("yield" ::: "memory");
+#else
+  __asm__ __volatile__("" ::: "memory");
+#endif
+}
+
 /*
  * Every Object has a monitor associated with it, but not every Object is actually locked.  Even
  * the ones that are locked do not need a full-fledged monitor until a) there is actual contention
@@ -68,19 +100,122 @@ static constexpr uint64_t kLongWaitMs = 100;
  */
 
 uint32_t Monitor::lock_profiling_threshold_ = 0;
+bool Monitor::contention_profiling_ = false;
+Mutex* Monitor::contention_profile_lock_ = nullptr;
+bool Monitor::biased_locking_ = false;
+Mutex* Monitor::bias_revocation_lock_ = nullptr;
+
+// Bias revocation count of a class.
+struct BiasRevocationCount {
+  mirror::Class* klass;
+  uint32_t count;
+  // Time of the last bulk rebias of the instances of klass, 0 if there was none.
+  uint64_t last_bulk_rebias_ns;
+};
 
-void Monitor::Init(uint32_t lock_profiling_threshold) {
+// Bias revocation counts, indexed by a hash of the class of the revoked objects. A class
+// hashing to an entry used by another class takes the entry over: collisions can only make
+// biasing stop later for the classes involved, never earlier. Classes are not moved, and a
+// class allocated where an unloaded one was inherits its count.
+static constexpr size_t kBiasRevocationTableSize = 1024;
+static BiasRevocationCount bias_revocation_counts_[kBiasRevocationTableSize];
+
+void Monitor::Init(uint32_t lock_profiling_threshold,
+                   bool contention_profiling,
+                   bool biased_locking) {
   lock_profiling_threshold_ = lock_profiling_threshold;
+  contention_profiling_ = contention_profiling;
+  biased_locking_ = biased_locking;
+  if (contention_profiling_ && contention_profile_lock_ == nullptr) {
+    contention_profile_lock_ = new Mutex("monitor contention profile lock");
+  }
+  if (biased_locking_ && bias_revocation_lock_ == nullptr) {
+    bias_revocation_lock_ = new Mutex("monitor bias revocation lock");
+  }
+}
+
+void Monitor::RecordContention(Thread* self, uint64_t wait_ns) {
+  DCHECK(contention_profiling_);
+  // Walk the stack before taking the profile lock, which all contended threads go through.
+  uint32_t dex_pc = 0;
+  ArtMethod* method = self->GetCurrentMethod(&dex_pc);
+  size_t bucket = 0;
+  while (bucket < kContentionHistogramBuckets - 1 &&
+         (wait_ns / 1000) >= (UINT64_C(1) << bucket)) {
+    ++bucket;
+  }
+  MutexLock mu(self, *contention_profile_lock_);
+  auto it = contention_sites_.find(std::make_pair(method, dex_pc));
+  if (it == contention_sites_.end()) {
+    ContentionSite site;
+    site.count = 0;
+    site.total_wait_ns = 0;
+    site.max_wait_ns = 0;
+    memset(site.wait_histogram, 0, sizeof(site.wait_histogram));
+    it = contention_sites_.emplace(std::make_pair(method, dex_pc), site).first;
+  }
+  ContentionSite& site = it->second;
+  site.count++;
+  site.total_wait_ns += wait_ns;
+  site.max_wait_ns = std::max(site.max_wait_ns, wait_ns);
+  site.wait_histogram[bucket]++;
+}
+
+void Monitor::RemoveContentionSitesIn(Thread* self, const LinearAlloc& alloc) {
+  if (!contention_profiling_) {
+    return;
+  }
+  MutexLock mu(self, *contention_profile_lock_);
+  for (auto it = contention_sites_.begin(); it != contention_sites_.end();) {
+    if (alloc.ContainsUnsafe(it->first.first)) {
+      it = contention_sites_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void Monitor::DumpContentionProfile(std::ostream& os) {
+  if (!contention_profiling_) {
+    return;
+  }
+  ScopedObjectAccess soa(Thread::Current());
+  using SiteEntry = std::pair<const std::pair<ArtMethod*, uint32_t>, ContentionSite>;
+  std::vector<const SiteEntry*> sites;
+  MutexLock mu(soa.Self(), *contention_profile_lock_);
+  for (const SiteEntry& entry : contention_sites_) {
+    sites.push_back(&entry);
+  }
+  std::sort(sites.begin(), sites.end(), [](const SiteEntry* a, const SiteEntry* b) {
+    return a->second.total_wait_ns > b->second.total_wait_ns;
+  });
+  os << "Monitor contention profile (" << sites.size() << " sites):\n";
+  for (const SiteEntry* entry : sites) {
+    const ContentionSite* site = &entry->second;
+    os << "  " << PrettyMethod(entry->first.first) << " dex_pc=" << entry->first.second
+       << " contentions=" << site->count
+       << " total=" << PrettyDuration(site->total_wait_ns)
+       << " mean=" << PrettyDuration(site->total_wait_ns / site->count)
+       << " max=" << PrettyDuration(site->max_wait_ns)
+       << " histogram(us,log2)=[";
+    for (size_t i = 0; i < kContentionHistogramBuckets; ++i) {
+      os << (i == 0 ? "" : ",") << site->wait_histogram[i];
+    }
+    os << "]\n";
+  }
 }
 
 Monitor::Monitor(Thread* self, Thread* owner, mirror::Object* obj, int32_t hash_code)
     : monitor_lock_("a monitor lock", kMonitorLock),
-      monitor_contenders_("monitor contenders", monitor_lock_),
       num_waiters_(0),
       owner_(owner),
       lock_count_(0),
+      spin_budget_(kInitialMonitorSpins),
       obj_(GcRoot<mirror::Object>(obj)),
       wait_set_(nullptr),
+      notified_set_(nullptr),
+      contenders_head_(nullptr),
+      contenders_tail_(nullptr),
       hash_code_(hash_code),
       locking_method_(nullptr),
       locking_dex_pc_(0),
@@ -98,12 +233,15 @@ Monitor::Monitor(Thread* self, Thread* owner, mirror::Object* obj, int32_t hash_
 Monitor::Monitor(Thread* self, Thread* owner, mirror::Object* obj, int32_t hash_code,
                  MonitorId id)
     : monitor_lock_("a monitor lock", kMonitorLock),
-      monitor_contenders_("monitor contenders", monitor_lock_),
       num_waiters_(0),
       owner_(owner),
       lock_count_(0),
+      spin_budget_(kInitialMonitorSpins),
       obj_(GcRoot<mirror::Object>(obj)),
       wait_set_(nullptr),
+      notified_set_(nullptr),
+      contenders_head_(nullptr),
+      contenders_tail_(nullptr),
       hash_code_(hash_code),
       locking_method_(nullptr),
       locking_dex_pc_(0),
@@ -171,44 +309,112 @@ Monitor::~Monitor() {
   // Deflated monitors have a null object.
 }
 
-void Monitor::AppendToWaitSet(Thread* thread) {
-  DCHECK(owner_ == Thread::Current());
-  DCHECK(thread != nullptr);
+// Append a thread to a list of threads linked through their wait next field.
+static void AppendToThreadList(Thread** list, Thread* thread) {
   DCHECK(thread->GetWaitNext() == nullptr) << thread->GetWaitNext();
-  if (wait_set_ == nullptr) {
-    wait_set_ = thread;
+  if (*list == nullptr) {
+    *list = thread;
     return;
   }
 
   // push_back.
-  Thread* t = wait_set_;
+  Thread* t = *list;
   while (t->GetWaitNext() != nullptr) {
     t = t->GetWaitNext();
   }
   t->SetWaitNext(thread);
 }
 
-void Monitor::RemoveFromWaitSet(Thread *thread) {
-  DCHECK(owner_ == Thread::Current());
-  DCHECK(thread != nullptr);
-  if (wait_set_ == nullptr) {
-    return;
+// Unlink a thread from a list of threads linked through their wait next field. Return whether
+// the thread was found.
+static bool RemoveFromThreadList(Thread** list, Thread* thread) {
+  if (*list == nullptr) {
+    return false;
   }
-  if (wait_set_ == thread) {
-    wait_set_ = thread->GetWaitNext();
+  if (*list == thread) {
+    *list = thread->GetWaitNext();
     thread->SetWaitNext(nullptr);
-    return;
+    return true;
   }
 
-  Thread* t = wait_set_;
+  Thread* t = *list;
   while (t->GetWaitNext() != nullptr) {
     if (t->GetWaitNext() == thread) {
       t->SetWaitNext(thread->GetWaitNext());
       thread->SetWaitNext(nullptr);
-      return;
+      return true;
     }
     t = t->GetWaitNext();
   }
+  return false;
+}
+
+void Monitor::AppendToWaitSet(Thread* thread) {
+  DCHECK(owner_ == Thread::Current());
+  DCHECK(thread != nullptr);
+  AppendToThreadList(&wait_set_, thread);
+}
+
+void Monitor::RemoveFromWaitSet(Thread *thread) {
+  DCHECK(owner_ == Thread::Current());
+  DCHECK(thread != nullptr);
+  // A thread which timed out or was interrupted after being notified is still queued to be woken.
+  if (!RemoveFromThreadList(&wait_set_, thread)) {
+    RemoveFromThreadList(&notified_set_, thread);
+  }
+}
+
+void Monitor::EnqueueContender(LockWaiter* waiter, bool at_front) {
+  DCHECK(waiter->next == nullptr);
+  DCHECK_EQ(waiter->state, LockWaiter::kWaiting);
+  if (contenders_head_ == nullptr) {
+    contenders_head_ = waiter;
+    contenders_tail_ = waiter;
+  } else if (at_front) {
+    waiter->next = contenders_head_;
+    contenders_head_ = waiter;
+  } else {
+    contenders_tail_->next = waiter;
+    contenders_tail_ = waiter;
+  }
+}
+
+void Monitor::WakeNextLocked(Thread* self) {
+  DCHECK(owner_ == nullptr);
+  LockWaiter* waiter = contenders_head_;
+  LockWaiter::State new_state = LockWaiter::kWoken;
+  if (waiter != nullptr &&
+      NanoTime() - waiter->first_enqueue_time_ns >= kMonitorHandoffThresholdNs) {
+    // The oldest blocked thread has waited long enough, don't let running threads barge in
+    // ahead of it again.
+    owner_ = waiter->thread;
+    new_state = LockWaiter::kHandedOff;
+  } else {
+    // Notified threads haven't had a chance to compete for the monitor yet, wake one of them.
+    while (notified_set_ != nullptr) {
+      Thread* thread = notified_set_;
+      notified_set_ = thread->GetWaitNext();
+      thread->SetWaitNext(nullptr);
+
+      // Check to see if the thread is still waiting.
+      MutexLock wait_mu(self, *thread->GetWaitMutex());
+      if (thread->GetWaitMonitor() != nullptr) {
+        thread->GetWaitConditionVariable()->Signal(self);
+        return;
+      }
+    }
+    if (waiter == nullptr) {
+      return;
+    }
+  }
+  contenders_head_ = waiter->next;
+  if (contenders_head_ == nullptr) {
+    contenders_tail_ = nullptr;
+  }
+  waiter->next = nullptr;
+  MutexLock wait_mu(self, *waiter->thread->GetWaitMutex());
+  waiter->state = new_state;
+  waiter->thread->GetWaitConditionVariable()->Signal(self);
 }
 
 void Monitor::SetObject(mirror::Object* object) {
@@ -337,13 +543,54 @@ bool Monitor::TryLock(Thread* self) {
   return TryLockLocked(self);
 }
 
-void Monitor::Lock(Thread* self) {
-  MutexLock mu(self, monitor_lock_);
+bool Monitor::SpinWhileOwnerRunning(Thread* self) {
+  // The owner cannot release the monitor while we hold monitor_lock_, so it is safe to look at it.
+  Thread* owner = owner_;
+  if (owner == nullptr || owner->GetState() != kRunnable) {
+    // Spinning on an owner which is blocked, waiting or suspended is a waste of cycles.
+    return false;
+  }
+  size_t spins = spin_budget_;
+  monitor_lock_.Unlock(self);
+  bool released = false;
+  for (size_t i = 0; i != spins; ++i) {
+    SpinPause();
+    if (GetOwner() == nullptr) {
+      released = true;
+      break;
+    }
+  }
+  monitor_lock_.Lock(self);
+  // Spin longer next time if the owners release the monitor while we spin, shorter otherwise.
+  if (released) {
+    spin_budget_ = std::min(spin_budget_ * 2, static_cast<size_t>(kMaxMonitorSpins));
+  } else {
+    spin_budget_ = std::max(spin_budget_ / 2, static_cast<size_t>(kMinMonitorSpins));
+  }
+  return released;
+}
+
+void Monitor::Lock(Thread* self, uint64_t contention_start_ns) {
+  monitor_lock_.Lock(self);
+  LockWaiter waiter(self);
+  bool requeue = false;
+  bool spun = false;
   while (true) {
     if (TryLockLocked(self)) {
-      return;
+      break;
     }
     // Contended.
+    if (contention_profiling_ && contention_start_ns == 0) {
+      contention_start_ns = NanoTime();
+    }
+    // Spin at most once per Lock call: if the monitor is taken again by another thread while
+    // we retry, we block rather than keep spinning.
+    if (!spun) {
+      spun = true;
+      if (SpinWhileOwnerRunning(self)) {
+        continue;  // The owner released the monitor, try again.
+      }
+    }
     const bool log_contention = (lock_profiling_threshold_ != 0);
     uint64_t wait_start_ms = log_contention ? MilliTime() : 0;
     ArtMethod* owners_method = locking_method_;
@@ -351,15 +598,19 @@ void Monitor::Lock(Thread* self) {
     // Do this before releasing the lock so that we don't get deflated.
     size_t num_waiters = num_waiters_;
     ++num_waiters_;
+    if (!requeue) {
+      waiter.first_enqueue_time_ns = NanoTime();
+    }
+    EnqueueContender(&waiter, requeue);
     monitor_lock_.Unlock(self);  // Let go of locks in order.
     self->SetMonitorEnterObject(GetObject());
     {
       uint32_t original_owner_thread_id = 0u;
       ScopedThreadStateChange tsc(self, kBlocked);  // Change to blocked and give up mutator_lock_.
       {
-        // Reacquire monitor_lock_ without mutator_lock_ for Wait.
+        // Reacquire monitor_lock_ without mutator_lock_ to look at the owner.
         MutexLock mu2(self, monitor_lock_);
-        if (owner_ != nullptr) {  // Did the owner_ give the lock up?
+        if (owner_ != nullptr && owner_ != self) {  // Did the owner_ give the lock up?
           original_owner_thread_id = owner_->GetThreadId();
           if (ATRACE_ENABLED()) {
             std::ostringstream oss;
@@ -381,7 +632,13 @@ void Monitor::Lock(Thread* self) {
                 << line_number << ")";
             ATRACE_BEGIN(oss.str().c_str());
           }
-          monitor_contenders_.Wait(self);  // Still contended so wait.
+        }
+      }
+      {
+        // Sleep until a thread releasing the monitor dequeues us.
+        MutexLock wait_mu(self, *self->GetWaitMutex());
+        while (waiter.state == LockWaiter::kWaiting) {
+          self->GetWaitConditionVariable()->Wait(self);
         }
       }
       if (original_owner_thread_id != 0u) {
@@ -442,6 +699,23 @@ void Monitor::Lock(Thread* self) {
     self->SetMonitorEnterObject(nullptr);
     monitor_lock_.Lock(self);  // Reacquire locks in order.
     --num_waiters_;
+    if (waiter.state == LockWaiter::kHandedOff) {
+      // The releasing thread made us the owner.
+      DCHECK(owner_ == self);
+      DCHECK_EQ(lock_count_, 0);
+      if (lock_profiling_threshold_ != 0) {
+        locking_method_ = self->GetCurrentMethod(&locking_dex_pc_);
+      }
+      AtraceMonitorLock(self, GetObject(), false /* is_wait */);
+      break;
+    }
+    // Woken to compete for the monitor. Requeue at the front if we lose it again.
+    waiter.state = LockWaiter::kWaiting;
+    requeue = true;
+  }
+  monitor_lock_.Unlock(self);
+  if (contention_start_ns != 0) {
+    RecordContention(self, NanoTime() - contention_start_ns);
   }
 }
 
@@ -557,8 +831,8 @@ bool Monitor::Unlock(Thread* self) {
         owner_ = nullptr;
         locking_method_ = nullptr;
         locking_dex_pc_ = 0;
-        // Wake a contender.
-        monitor_contenders_.Signal(self);
+        // Wake a contender, or hand the monitor over to it.
+        WakeNextLocked(self);
       } else {
         --lock_count_;
       }
@@ -631,6 +905,10 @@ void Monitor::Wait(Thread* self, int64_t ms, int32_t ns,
     // our suspend mode before we transition out.
     ScopedThreadSuspension sts(self, why);
 
+    // Wake the next thread before taking our wait mutex, as this takes the wait mutex of the
+    // woken thread. Holding monitor_lock_ keeps it from notifying us before we are waiting.
+    WakeNextLocked(self);
+
     // Pseudo-atomically wait on self's wait_cond_ and release the monitor lock.
     MutexLock mu(self, *self->GetWaitMutex());
 
@@ -641,7 +919,6 @@ void Monitor::Wait(Thread* self, int64_t ms, int32_t ns,
     self->SetWaitMonitor(this);
 
     // Release the monitor lock.
-    monitor_contenders_.Signal(self);
     monitor_lock_.Unlock(self);
 
     // Handle the case where the thread was interrupted before we called wait().
@@ -718,7 +995,8 @@ void Monitor::Notify(Thread* self) {
     ThrowIllegalMonitorStateExceptionF("object not locked by thread before notify()");
     return;
   }
-  // Signal the first waiting thread in the wait set.
+  // Move the first waiting thread in the wait set to the notified threads. It is woken once we
+  // release the monitor, there's no point in it competing for the monitor while we hold it.
   while (wait_set_ != nullptr) {
     Thread* thread = wait_set_;
     wait_set_ = thread->GetWaitNext();
@@ -727,7 +1005,7 @@ void Monitor::Notify(Thread* self) {
     // Check to see if the thread is still waiting.
     MutexLock wait_mu(self, *thread->GetWaitMutex());
     if (thread->GetWaitMonitor() != nullptr) {
-      thread->GetWaitConditionVariable()->Signal(self);
+      AppendToThreadList(&notified_set_, thread);
       return;
     }
   }
@@ -741,12 +1019,19 @@ void Monitor::NotifyAll(Thread* self) {
     ThrowIllegalMonitorStateExceptionF("object not locked by thread before notifyAll()");
     return;
   }
-  // Signal all threads in the wait set.
-  while (wait_set_ != nullptr) {
-    Thread* thread = wait_set_;
-    wait_set_ = thread->GetWaitNext();
-    thread->SetWaitNext(nullptr);
-    thread->Notify();
+  // Move all threads in the wait set to the notified threads without waking them. They are then
+  // woken one at a time as the monitor is released, rather than all competing for it at once.
+  if (wait_set_ != nullptr) {
+    if (notified_set_ == nullptr) {
+      notified_set_ = wait_set_;
+    } else {
+      Thread* t = notified_set_;
+      while (t->GetWaitNext() != nullptr) {
+        t = t->GetWaitNext();
+      }
+      t->SetWaitNext(wait_set_);
+    }
+    wait_set_ = nullptr;
   }
 }
 
@@ -851,6 +1136,134 @@ void Monitor::InflateThinLocked(Thread* self, Handle<mirror::Object> obj, LockWo
   }
 }
 
+bool Monitor::ShouldBias(mirror::Object* obj) {
+  // Class objects are locked by any thread initializing or linking them, don't bias them.
+  return biased_locking_ && !obj->IsClass() && !obj->GetClass()->IsBiasedLockingRevoked();
+}
+
+bool Monitor::CountBiasRevocation(mirror::Class* klass) {
+  if (klass->IsBiasedLockingRevoked()) {
+    return false;
+  }
+  size_t index =
+      (reinterpret_cast<uintptr_t>(klass) / kObjectAlignment) % kBiasRevocationTableSize;
+  uint64_t now_ns = NanoTime();
+  uint32_t count;
+  {
+    MutexLock mu(Thread::Current(), *bias_revocation_lock_);
+    BiasRevocationCount& entry = bias_revocation_counts_[index];
+    if (entry.klass != klass ||
+        (entry.last_bulk_rebias_ns != 0u &&
+         now_ns - entry.last_bulk_rebias_ns >= kBiasDecayTimeNs)) {
+      entry.klass = klass;
+      entry.count = 0u;
+      entry.last_bulk_rebias_ns = 0u;
+    }
+    count = ++entry.count;
+    if (count == kBulkRebiasThreshold) {
+      entry.last_bulk_rebias_ns = now_ns;
+    }
+  }
+  if (count == kBulkRebiasThreshold) {
+    VLOG(monitor) << "Rebias locks of instances of " << PrettyClass(klass);
+    return true;
+  }
+  if (count == kBulkRevokeThreshold) {
+    VLOG(monitor) << "Stop biasing locks of instances of " << PrettyClass(klass);
+    klass->SetBiasedLockingRevoked();
+    return true;
+  }
+  return false;
+}
+
+void Monitor::RevokeInstanceBias(mirror::Object* obj, void* arg) {
+  if (obj->GetClass() != reinterpret_cast<mirror::Class*>(arg)) {
+    return;
+  }
+  // All other threads are suspended, only a weak CAS failing spuriously makes us retry.
+  LockWord lock_word = obj->GetLockWord(false);
+  while (lock_word.GetState() == LockWord::kBiased && !UnbiasLockWord(obj, lock_word)) {
+    lock_word = obj->GetLockWord(false);
+  }
+}
+
+void Monitor::RevokeAllBiases(Thread* self, Handle<mirror::Class> klass) {
+  gc::Heap* heap = Runtime::Current()->GetHeap();
+  if (heap->IsGcConcurrentAndMoving()) {
+    // Walk the heap while the GC isn't running, see Heap::VisitObjects().
+    heap->IncrementDisableMovingGC(self);
+  }
+  {
+    // The owners of the biases lock and unlock without atomic operations, they must be
+    // suspended while their lock words change.
+    ScopedThreadSuspension sts(self, kWaitingForVisitObjects);
+    ScopedSuspendAll ssa(__FUNCTION__);
+    heap->VisitObjectsPaused(RevokeInstanceBias, klass.Get());
+  }
+  if (heap->IsGcConcurrentAndMoving()) {
+    heap->DecrementDisableMovingGC(self);
+  }
+}
+
+bool Monitor::UnbiasLockWord(mirror::Object* obj, LockWord lock_word) {
+  DCHECK_EQ(lock_word.GetState(), LockWord::kBiased);
+  uint32_t count = lock_word.BiasedLockCount();
+  LockWord new_lw = (count == 0)
+      ? LockWord::FromDefault(lock_word.ReadBarrierState())
+      : LockWord::FromThinLockId(lock_word.BiasedLockOwner(),
+                                 count - 1,
+                                 lock_word.ReadBarrierState());
+  // Use CAS as the read barrier state may change concurrently.
+  return obj->CasLockWordWeakSequentiallyConsistent(lock_word, new_lw);
+}
+
+void Monitor::RevokeBias(Thread* self, Handle<mirror::Object> obj) {
+  LockWord lock_word = obj->GetLockWord(true);
+  if (lock_word.GetState() != LockWord::kBiased) {
+    return;
+  }
+  if (CountBiasRevocation(obj->GetClass())) {
+    StackHandleScope<1> hs(self);
+    RevokeAllBiases(self, hs.NewHandle(obj->GetClass()));
+    return;
+  }
+  uint32_t owner_thread_id = lock_word.BiasedLockOwner();
+  if (owner_thread_id == self->GetThreadId()) {
+    // We own the bias, nobody else modifies the lock word but the GC.
+    UnbiasLockWord(obj.Get(), lock_word);
+    return;
+  }
+  ThreadList* thread_list = Runtime::Current()->GetThreadList();
+  {
+    // A thread which is not registered cannot lock objects, and cannot register while we hold
+    // the thread list lock.
+    MutexLock mu(self, *Locks::thread_list_lock_);
+    if (thread_list->FindThreadByThreadId(owner_thread_id) == nullptr) {
+      UnbiasLockWord(obj.Get(), lock_word);
+      return;
+    }
+  }
+  // The owner locks and unlocks the object without atomic operations: suspend it before
+  // changing the lock word. First change to blocked and give up mutator_lock_.
+  self->SetMonitorEnterObject(obj.Get());
+  bool timed_out;
+  Thread* owner;
+  {
+    ScopedThreadSuspension sts(self, kBlocked);
+    owner = thread_list->SuspendThreadByThreadId(owner_thread_id, false, &timed_out);
+  }
+  if (owner != nullptr) {
+    // We succeeded in suspending the thread, check the lock's status didn't change.
+    lock_word = obj->GetLockWord(true);
+    if (lock_word.GetState() == LockWord::kBiased &&
+        lock_word.BiasedLockOwner() == owner_thread_id) {
+      UnbiasLockWord(obj.Get(), lock_word);
+    }
+    thread_list->Resume(owner, false);
+  }
+  self->SetMonitorEnterObject(nullptr);
+}
+
 // Fool annotalysis into thinking that the lock on obj is acquired.
 static mirror::Object* FakeLock(mirror::Object* obj)
     EXCLUSIVE_LOCK_FUNCTION(obj) NO_THREAD_SAFETY_ANALYSIS {
@@ -863,6 +1276,15 @@ static mirror::Object* FakeUnlock(mirror::Object* obj)
   return obj;
 }
 
+// Return whether the thread owning a thin lock is running. An owner which is blocked,
+// waiting or suspended will not release the lock soon.
+static bool IsLockOwnerRunnable(Thread* self, uint32_t owner_thread_id) {
+  MutexLock mu(self, *Locks::thread_list_lock_);
+  Thread* owner = Runtime::Current()->GetThreadList()->FindThreadByThreadId(owner_thread_id);
+  // If the owner is gone, the lock word is about to change: keep spinning.
+  return owner == nullptr || owner->GetState() == kRunnable;
+}
+
 mirror::Object* Monitor::MonitorEnter(Thread* self, mirror::Object* obj, bool trylock) {
   DCHECK(self != nullptr);
   DCHECK(obj != nullptr);
@@ -870,15 +1292,21 @@ mirror::Object* Monitor::MonitorEnter(Thread* self, mirror::Object* obj, bool tr
   obj = FakeLock(obj);
   uint32_t thread_id = self->GetThreadId();
   size_t contention_count = 0;
+  uint64_t contention_start_ns = 0;
   StackHandleScope<1> hs(self);
   Handle<mirror::Object> h_obj(hs.NewHandle(obj));
   while (true) {
     LockWord lock_word = h_obj->GetLockWord(true);
     switch (lock_word.GetState()) {
       case LockWord::kUnlocked: {
-        LockWord thin_locked(LockWord::FromThinLockId(thread_id, 0, lock_word.ReadBarrierState()));
+        LockWord thin_locked(ShouldBias(h_obj.Get())
+            ? LockWord::FromBiasedLockId(thread_id, 1, lock_word.ReadBarrierState())
+            : LockWord::FromThinLockId(thread_id, 0, lock_word.ReadBarrierState()));
         if (h_obj->CasLockWordWeakSequentiallyConsistent(lock_word, thin_locked)) {
           AtraceMonitorLock(self, h_obj.Get(), false /* is_wait */);
+          if (UNLIKELY(contention_start_ns != 0)) {
+            RecordContention(self, NanoTime() - contention_start_ns);
+          }
           // CasLockWord enforces more than the acquire ordering we need here.
           return h_obj.Get();  // Success!
         }
@@ -914,8 +1342,24 @@ mirror::Object* Monitor::MonitorEnter(Thread* self, mirror::Object* obj, bool tr
           }
           // Contention.
           contention_count++;
+          if (contention_profiling_ && contention_start_ns == 0) {
+            contention_start_ns = NanoTime();
+          }
           Runtime* runtime = Runtime::Current();
-          if (contention_count <= runtime->GetMaxSpinsBeforeThinkLockInflation()) {
+          if (contention_count <= kThinLockBusySpinRounds) {
+            // Most thin locks are held for a short time: busy-wait with exponential backoff
+            // before involving the scheduler.
+            for (size_t i = 0, e = (1u << contention_count); i != e; ++i) {
+              SpinPause();
+            }
+          } else if (contention_count == kThinLockBusySpinRounds + 1 &&
+                     !IsLockOwnerRunnable(self, owner_thread_id)) {
+            // The owner is blocked, waiting or suspended, and will not release the lock
+            // soon: inflate right away rather than yielding.
+            contention_count = 0;
+            InflateThinLocked(self, h_obj, lock_word, 0);
+          } else if (contention_count <=
+                     kThinLockBusySpinRounds + runtime->GetMaxSpinsBeforeThinkLockInflation()) {
             // TODO: Consider switching the thread state to kBlocked when we are yielding.
             // Use sched_yield instead of NanoSleep since NanoSleep can wait much longer than the
             // parameter you pass in. This can cause thread suspension to take excessively long
@@ -928,12 +1372,40 @@ mirror::Object* Monitor::MonitorEnter(Thread* self, mirror::Object* obj, bool tr
         }
         continue;  // Start from the beginning.
       }
+      case LockWord::kBiased: {
+        if (lock_word.BiasedLockOwner() == thread_id) {
+          // The lock is reserved for us, increase the hold count.
+          uint32_t new_count = lock_word.BiasedLockCount() + 1;
+          if (LIKELY(new_count <= LockWord::kThinLockMaxCount)) {
+            LockWord biased(LockWord::FromBiasedLockId(thread_id, new_count,
+                                                       lock_word.ReadBarrierState()));
+            if (!kUseReadBarrier) {
+              h_obj->SetLockWord(biased, true);
+              AtraceMonitorLock(self, h_obj.Get(), false /* is_wait */);
+              return h_obj.Get();  // Success!
+            } else {
+              // Use CAS to preserve the read barrier state.
+              if (h_obj->CasLockWordWeakSequentiallyConsistent(lock_word, biased)) {
+                AtraceMonitorLock(self, h_obj.Get(), false /* is_wait */);
+                return h_obj.Get();  // Success!
+              }
+            }
+            continue;  // Go again.
+          }
+          // We'd overflow the hold count, fall back to a thin lock which inflates.
+        } else if (trylock) {
+          // Revoking the bias requires suspending its owner, don't wait for it.
+          return nullptr;
+        }
+        RevokeBias(self, h_obj);
+        continue;  // Start from the beginning.
+      }
       case LockWord::kFatLocked: {
         Monitor* mon = lock_word.FatLockMonitor();
         if (trylock) {
           return mon->TryLock(self) ? h_obj.Get() : nullptr;
         } else {
-          mon->Lock(self);
+          mon->Lock(self, contention_start_ns);
           return h_obj.Get();  // Success!
         }
       }
@@ -996,6 +1468,36 @@ bool Monitor::MonitorExit(Thread* self, mirror::Object* obj) {
           continue;  // Go again.
         }
       }
+      case LockWord::kBiased: {
+        uint32_t thread_id = self->GetThreadId();
+        uint32_t owner_thread_id = lock_word.BiasedLockOwner();
+        if (owner_thread_id != thread_id || lock_word.BiasedLockCount() == 0) {
+          // A biased lock which isn't held has no owner.
+          FailedUnlock(h_obj.Get(),
+                       thread_id,
+                       (lock_word.BiasedLockCount() != 0) ? owner_thread_id : 0u,
+                       nullptr);
+          return false;  // Failure.
+        }
+        // We hold the lock, decrease the hold count but keep the bias.
+        LockWord new_lw = LockWord::FromBiasedLockId(thread_id,
+                                                     lock_word.BiasedLockCount() - 1,
+                                                     lock_word.ReadBarrierState());
+        if (!kUseReadBarrier) {
+          h_obj->SetLockWord(new_lw, true);
+          AtraceMonitorUnlock();
+          // Success!
+          return true;
+        } else {
+          // Use CAS to preserve the read barrier state.
+          if (h_obj->CasLockWordWeakSequentiallyConsistent(lock_word, new_lw)) {
+            AtraceMonitorUnlock();
+            // Success!
+            return true;
+          }
+        }
+        continue;  // Go again.
+      }
       case LockWord::kFatLocked: {
         Monitor* mon = lock_word.FatLockMonitor();
         return mon->Unlock(self);
@@ -1034,6 +1536,18 @@ void Monitor::Wait(Thread* self, mirror::Object *obj, int64_t ms, int32_t ns,
         }
         break;
       }
+      case LockWord::kBiased: {
+        if (lock_word.BiasedLockOwner() != self->GetThreadId() ||
+            lock_word.BiasedLockCount() == 0) {
+          ThrowIllegalMonitorStateExceptionF("object not locked by thread before wait()");
+          return;  // Failure.
+        }
+        // We hold the lock, turn it into a thin lock which we inflate next. May fail spuriously
+        // so re-load.
+        UnbiasLockWord(obj, lock_word);
+        lock_word = obj->GetLockWord(true);
+        break;
+      }
       case LockWord::kFatLocked:  // Unreachable given the loop condition above. Fall-through.
       default: {
         LOG(FATAL) << "Invalid monitor state " << lock_word.GetState();
@@ -1066,6 +1580,15 @@ void Monitor::DoNotify(Thread* self, mirror::Object* obj, bool notify_all) {
         return;  // Success.
       }
     }
+    case LockWord::kBiased: {
+      if (lock_word.BiasedLockOwner() != self->GetThreadId() ||
+          lock_word.BiasedLockCount() == 0) {
+        ThrowIllegalMonitorStateExceptionF("object not locked by thread before notify()");
+        return;  // Failure.
+      }
+      // We hold the lock but there's no Monitor and therefore no waiters.
+      return;  // Success.
+    }
     case LockWord::kFatLocked: {
       Monitor* mon = lock_word.FatLockMonitor();
       if (notify_all) {
@@ -1092,6 +1615,10 @@ uint32_t Monitor::GetLockOwnerThreadId(mirror::Object* obj) {
       return ThreadList::kInvalidThreadId;
     case LockWord::kThinLocked:
       return lock_word.ThinLockOwner();
+    case LockWord::kBiased:
+      return (lock_word.BiasedLockCount() != 0)
+          ? lock_word.BiasedLockOwner()
+          : ThreadList::kInvalidThreadId;
     case LockWord::kFatLocked: {
       Monitor* mon = lock_word.FatLockMonitor();
       return mon->GetOwnerThreadId();
@@ -1129,7 +1656,8 @@ void Monitor::DescribeWait(std::ostream& os, const Thread* thread) {
     if (pretty_object == nullptr) {
       os << wait_message << "an unknown object";
     } else {
-      if ((pretty_object->GetLockWord(true).GetState() == LockWord::kThinLocked) &&
+      LockWord::LockState lock_state = pretty_object->GetLockWord(true).GetState();
+      if ((lock_state == LockWord::kThinLocked || lock_state == LockWord::kBiased) &&
           Locks::mutator_lock_->IsExclusiveHeld(Thread::Current())) {
         // Getting the identity hashcode here would result in lock inflation and suspension of the
         // current thread, which isn't safe if this is the only runnable thread.
@@ -1239,6 +1767,8 @@ bool Monitor::IsValidLockWord(LockWord lock_word) {
     case LockWord::kThinLocked:
       // Basic sanity check of owner.
       return lock_word.ThinLockOwner() != ThreadList::kInvalidThreadId;
+    case LockWord::kBiased:
+      return lock_word.BiasedLockOwner() != ThreadList::kInvalidThreadId;
     case LockWord::kFatLocked: {
       // Check the  monitor appears in the monitor list.
       Monitor* mon = lock_word.FatLockMonitor();
@@ -1398,6 +1928,14 @@ MonitorInfo::MonitorInfo(mirror::Object* obj) : owner_(nullptr), entry_count_(0)
       entry_count_ = 1 + lock_word.ThinLockCount();
       // Thin locks have no waiters.
       break;
+    case LockWord::kBiased:
+      if (lock_word.BiasedLockCount() != 0) {
+        owner_ = Runtime::Current()->GetThreadList()->FindThreadByThreadId(
+            lock_word.BiasedLockOwner());
+        entry_count_ = lock_word.BiasedLockCount();
+      }
+      // Biased locks have no waiters.
+      break;
     case LockWord::kFatLocked: {
       Monitor* mon = lock_word.FatLockMonitor();
       owner_ = mon->owner_;
@@ -1405,6 +1943,12 @@ MonitorInfo::MonitorInfo(mirror::Object* obj) : owner_(nullptr), entry_count_(0)
       for (Thread* waiter = mon->wait_set_; waiter != nullptr; waiter = waiter->GetWaitNext()) {
         waiters_.push_back(waiter);
       }
+      // Notified threads are still waiting until they are woken.
+      for (Thread* waiter = mon->notified_set_;
+           waiter != nullptr;
+           waiter = waiter->GetWaitNext()) {
+        waiters_.push_back(waiter);
+      }
       break;
     }
   }
@@ -37,6 +37,7 @@
 namespace art {
 
 class ArtMethod;
+class LinearAlloc;
 class LockWord;
 template<class T> class Handle;
 class StackVisitor;
@@ -44,6 +45,7 @@ class Thread;
 typedef uint32_t MonitorId;
 
 namespace mirror {
+  class Class;
   class Object;
 }  // namespace mirror
 
@@ -53,9 +55,49 @@ class Monitor {
   // a lock word. See Runtime::max_spins_before_thin_lock_inflation_.
   constexpr static size_t kDefaultMaxSpinsBeforeThinLockInflation = 50;
 
+  // Number of busy-wait rounds, with exponential backoff, done on a contended thin lock before
+  // yielding the processor.
+  constexpr static size_t kThinLockBusySpinRounds = 6;
+
+  // Bounds of the adaptive number of busy-wait iterations a thread does on a contended fat lock
+  // whose owner is running, before blocking.
+  constexpr static size_t kMinMonitorSpins = 16;
+  constexpr static size_t kInitialMonitorSpins = 256;
+  constexpr static size_t kMaxMonitorSpins = 4096;
+
+  // Time after which the oldest thread blocked on a monitor is handed the monitor directly when
+  // it is released, instead of competing with running threads for it.
+  constexpr static uint64_t kMonitorHandoffThresholdNs = 1000000;  // 1ms.
+
+  // Number of bias revocations on instances of a class after which the biases of all its
+  // instances are revoked at once, so that each instance is biased towards its next locker.
+  constexpr static uint32_t kBulkRebiasThreshold = 20;
+
+  // Number of bias revocations after which locks of instances of a class stop being biased.
+  constexpr static uint32_t kBulkRevokeThreshold = 40;
+
+  // Time after a bulk rebias after which the bias revocations of the class are counted from
+  // zero again, so that classes whose biases are only revoked now and then keep being biased.
+  constexpr static uint64_t kBiasDecayTimeNs = UINT64_C(25000000000);  // 25s.
+
   ~Monitor();
 
-  static void Init(uint32_t lock_profiling_threshold);
+  static void Init(uint32_t lock_profiling_threshold,
+                   bool contention_profiling,
+                   bool biased_locking);
+
+  // Whether locks on unlocked objects are biased towards the locking thread.
+  static bool IsBiasedLockingEnabled() {
+    return biased_locking_;
+  }
+
+  // Dump the contended lock acquisition sites recorded when contention profiling is enabled.
+  static void DumpContentionProfile(std::ostream& os)
+      REQUIRES(!*contention_profile_lock_);
+
+  // Drop the contention sites of methods allocated in `alloc`, whose class loader is unloaded.
+  static void RemoveContentionSitesIn(Thread* self, const LinearAlloc& alloc)
+      REQUIRES(!*contention_profile_lock_);
 
   // Return the thread id of the lock owner or 0 when there is no owner.
   static uint32_t GetLockOwnerThreadId(mirror::Object* obj)
@@ -133,6 +175,13 @@ class Monitor {
   static void InflateThinLocked(Thread* self, Handle<mirror::Object> obj, LockWord lock_word,
                                 uint32_t hash_code) SHARED_REQUIRES(Locks::mutator_lock_);
 
+  // Turn a biased lock on obj into a thin lock, or an unlocked lock word if the owner doesn't
+  // hold it, suspending the owner if it is not the current thread. Revoke the biases of all
+  // instances of its class instead once enough biases of the class were revoked. May fail for
+  // spurious reasons, always re-check.
+  static void RevokeBias(Thread* self, Handle<mirror::Object> obj)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
   // Not exclusive because ImageWriter calls this during a Heap::VisitObjects() that
   // does not allow a thread suspension in the middle. TODO: maybe make this exclusive.
   // NO_THREAD_SAFETY_ANALYSIS for monitor->monitor_lock_.
@@ -169,10 +218,39 @@ class Monitor {
   // routine.
   void AppendToWaitSet(Thread* thread) REQUIRES(monitor_lock_);
 
-  // Unlinks a thread from a monitor's wait set.  The monitor lock must be held by the caller of
-  // this routine.
+  // Unlinks a thread from a monitor's wait set, or from the set of notified threads not woken
+  // yet.  The monitor lock must be held by the caller of this routine.
   void RemoveFromWaitSet(Thread* thread) REQUIRES(monitor_lock_);
 
+  // A thread blocked in Lock(). Lives on the stack of the blocked thread, which sleeps on its
+  // wait condition variable until the waiter leaves the kWaiting state.
+  struct LockWaiter {
+    enum State {
+      kWaiting,    // Queued on the monitor.
+      kWoken,      // Dequeued and woken to compete for the monitor.
+      kHandedOff,  // Dequeued and made owner of the monitor.
+    };
+
+    explicit LockWaiter(Thread* t)
+        : thread(t), next(nullptr), first_enqueue_time_ns(0), state(kWaiting) {}
+
+    Thread* const thread;
+    LockWaiter* next;
+    // Time the thread first queued, kept when it is requeued after losing the monitor.
+    uint64_t first_enqueue_time_ns;
+    // Only changed with the monitor lock and the wait mutex of the thread held.
+    State state;
+  };
+
+  // Queue a thread blocked in Lock(). Threads which were woken but lost the monitor to a running
+  // thread are requeued at the front to keep the queue FIFO.
+  void EnqueueContender(LockWaiter* waiter, bool at_front) REQUIRES(monitor_lock_);
+
+  // Wake a single thread after the monitor was released: the oldest blocked thread if it has
+  // waited more than kMonitorHandoffThresholdNs, which is made owner directly, otherwise a
+  // notified thread, otherwise the oldest blocked thread.
+  void WakeNextLocked(Thread* self) REQUIRES(monitor_lock_);
+
   // Changes the shape of a monitor from thin to fat, preserving the internal lock state. The
   // calling thread must own the lock or the owner must be suspended. There's a race with other
   // threads inflating the lock, installing hash codes and spurious failures. The caller should
@@ -202,9 +280,48 @@ class Monitor {
       REQUIRES(monitor_lock_)
       SHARED_REQUIRES(Locks::mutator_lock_);
 
-  void Lock(Thread* self)
+  // Acquire the monitor, blocking if needed. `contention_start_ns` is the time the caller started
+  // waiting for the lock before inflating it, or 0.
+  void Lock(Thread* self, uint64_t contention_start_ns = 0)
       REQUIRES(!monitor_lock_)
       SHARED_REQUIRES(Locks::mutator_lock_);
+
+  // Busy-wait for the owner to release the monitor, if the owner is running. Return whether the
+  // monitor was released. Adapts the number of iterations of the next spins on this monitor
+  // depending on the result.
+  bool SpinWhileOwnerRunning(Thread* self) REQUIRES(monitor_lock_);
+
+  // Record that `self` waited `wait_ns` to acquire a lock at its current method and dex pc.
+  static void RecordContention(Thread* self, uint64_t wait_ns)
+      REQUIRES(!*contention_profile_lock_)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
+  // Whether a lock on the unlocked obj should be biased towards the locking thread. The
+  // art_quick_lock_object fast paths, which compiled code calls for all its monitor operations,
+  // make the same decision from Thread::tls32_.bias_locks and the class access flags.
+  static bool ShouldBias(mirror::Object* obj) SHARED_REQUIRES(Locks::mutator_lock_);
+
+  // Count a bias revocation on an instance of klass. Return whether the biases of all instances
+  // of klass should be revoked, once kBulkRebiasThreshold or kBulkRevokeThreshold is reached.
+  // In the latter case, stop biasing locks of instances of klass.
+  static bool CountBiasRevocation(mirror::Class* klass)
+      REQUIRES(!*bias_revocation_lock_)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
+  // Suspend all threads and revoke the biases of all instances of klass. Instances whose lock
+  // is not held become unlocked, and are biased again by their next locker unless biased
+  // locking was revoked for klass.
+  static void RevokeAllBiases(Thread* self, Handle<mirror::Class> klass)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
+  // Heap visitor callback revoking the bias of obj if it is an instance of the class arg.
+  static void RevokeInstanceBias(mirror::Object* obj, void* arg)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
+  // Turn a biased lock word which cannot be concurrently modified by its owner into the
+  // equivalent thin or unlocked lock word. Return whether the lock word was changed.
+  static bool UnbiasLockWord(mirror::Object* obj, LockWord lock_word)
+      SHARED_REQUIRES(Locks::mutator_lock_);
   bool Unlock(Thread* thread)
       REQUIRES(!monitor_lock_)
       SHARED_REQUIRES(Locks::mutator_lock_);
@@ -272,9 +389,19 @@ class Monitor {
 
   static uint32_t lock_profiling_threshold_;
 
-  Mutex monitor_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  // Whether contended lock acquisitions are recorded, see RecordContention().
+  static bool contention_profiling_;
+
+  // Guards the contention profile.
+  static Mutex* contention_profile_lock_;
+
+  // Whether locks on unlocked objects are biased towards the locking thread, see RevokeBias().
+  static bool biased_locking_;
+
+  // Guards the bias revocation counts.
+  static Mutex* bias_revocation_lock_;
 
-  ConditionVariable monitor_contenders_ GUARDED_BY(monitor_lock_);
+  Mutex monitor_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
 
   // Number of people waiting on the condition.
   size_t num_waiters_ GUARDED_BY(monitor_lock_);
@@ -285,6 +412,10 @@ class Monitor {
   // Owner's recursive lock depth.
   int lock_count_ GUARDED_BY(monitor_lock_);
 
+  // Number of busy-wait iterations for the next contended acquisition, adapted to how
+  // long the owners have been holding the monitor.
+  size_t spin_budget_ GUARDED_BY(monitor_lock_);
+
   // What object are we part of. This is a weak root. Do not access
   // this directly, use GetObject() to read it so it will be guarded
   // by a read barrier.
@@ -293,6 +424,14 @@ class Monitor {
   // Threads currently waiting on this monitor.
   Thread* wait_set_ GUARDED_BY(monitor_lock_);
 
+  // Threads notified while waiting on this monitor. They are woken one at a time as the monitor
+  // is released rather than all at once while the notifying thread still holds it.
+  Thread* notified_set_ GUARDED_BY(monitor_lock_);
+
+  // FIFO queue of threads blocked in Lock().
+  LockWaiter* contenders_head_ GUARDED_BY(monitor_lock_);
+  LockWaiter* contenders_tail_ GUARDED_BY(monitor_lock_);
+
   // Stored object hash code, generated lazily by GetHashCode.
   AtomicInteger hash_code_;
 
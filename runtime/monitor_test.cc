@@ -24,10 +24,13 @@
 #include "class_linker-inl.h"
 #include "common_runtime_test.h"
 #include "handle_scope-inl.h"
+#include "lock_word-inl.h"
+#include "mirror/array-inl.h"
 #include "mirror/class-inl.h"
 #include "mirror/string-inl.h"  // Strings are easiest to allocate
 #include "object_lock.h"
 #include "scoped_thread_state_change.h"
+#include "thread_list.h"
 #include "thread_pool.h"
 
 namespace art {
@@ -430,5 +433,220 @@ TEST_F(MonitorTest, TestTryLock) {
   thread_pool.StopWorkers(self);
 }
 
+class WaitForNotifyAllTask : public Task {
+ public:
+  WaitForNotifyAllTask(Handle<mirror::Object> obj, size_t* waiting, bool* notified)
+      : obj_(obj), waiting_(waiting), notified_(notified) {}
+
+  void Run(Thread* self) {
+    ScopedObjectAccess soa(self);
+    ObjectLock<mirror::Object> lock(self, obj_);
+    ++*waiting_;
+    while (!*notified_) {
+      lock.WaitIgnoringInterrupts();
+    }
+    // Notified threads reacquire the monitor one at a time.
+    --*waiting_;
+  }
+
+  void Finalize() {
+    delete this;
+  }
+
+ private:
+  Handle<mirror::Object> obj_;
+  size_t* const waiting_;
+  bool* const notified_;
+};
+
+// Test that all threads woken by notifyAll() get the monitor.
+TEST_F(MonitorTest, TestNotifyAll) {
+  static constexpr size_t kNumWaiters = 4;
+  Thread* const self = Thread::Current();
+  ThreadPool thread_pool("the pool", kNumWaiters);
+  ScopedObjectAccess soa(self);
+  StackHandleScope<1> hs(self);
+  Handle<mirror::Object> obj(
+      hs.NewHandle<mirror::Object>(mirror::String::AllocFromModifiedUtf8(self, "hello, world!")));
+  size_t waiting = 0;
+  bool notified = false;
+  for (size_t i = 0; i != kNumWaiters; ++i) {
+    thread_pool.AddTask(self, new WaitForNotifyAllTask(obj, &waiting, &notified));
+  }
+  thread_pool.StartWorkers(self);
+  while (true) {
+    ObjectLock<mirror::Object> lock(self, obj);
+    if (waiting == kNumWaiters) {
+      notified = true;
+      lock.NotifyAll();
+      break;
+    }
+    // Release the monitor for a while to let the waiters start waiting.
+    obj->Wait(self, 1, 0);
+    self->AssertNoPendingException();
+  }
+  {
+    ScopedThreadSuspension sts(self, kSuspended);
+    thread_pool.Wait(Thread::Current(), /*do_work*/false, /*may_hold_locks*/false);
+  }
+  thread_pool.StopWorkers(self);
+  self->AssertNoPendingException();
+  EXPECT_EQ(0u, waiting);
+}
+
+class BiasedMonitorTest : public MonitorTest {
+ protected:
+  void SetUpRuntimeOptions(RuntimeOptions *options) OVERRIDE {
+    MonitorTest::SetUpRuntimeOptions(options);
+    options->push_back(std::make_pair("-Xbiasedlocking", nullptr));
+  }
+};
+
+class LockUnlockTask : public Task {
+ public:
+  explicit LockUnlockTask(Handle<mirror::Object> obj) : obj_(obj) {}
+
+  void Run(Thread* self) {
+    ScopedObjectAccess soa(self);
+    // The lock is biased towards another thread, locking revokes the bias and biases the lock
+    // towards this thread instead.
+    ObjectLock<mirror::Object> lock(self, obj_);
+    LockWord lock_word = obj_->GetLockWord(true);
+    ASSERT_EQ(LockWord::kBiased, lock_word.GetState());
+    EXPECT_EQ(self->GetThreadId(), lock_word.BiasedLockOwner());
+    EXPECT_EQ(self->GetThreadId(), Monitor::GetLockOwnerThreadId(obj_.Get()));
+  }
+
+  void Finalize() {
+    delete this;
+  }
+
+ private:
+  Handle<mirror::Object> obj_;
+};
+
+TEST_F(BiasedMonitorTest, BiasedLocking) {
+  Thread* const self = Thread::Current();
+  ThreadPool thread_pool("the pool", 1);
+  ScopedObjectAccess soa(self);
+  StackHandleScope<1> hs(self);
+  Handle<mirror::Object> obj(
+      hs.NewHandle<mirror::Object>(mirror::String::AllocFromModifiedUtf8(self, "hello, world!")));
+  {
+    ObjectLock<mirror::Object> lock1(self, obj);
+    ObjectLock<mirror::Object> lock2(self, obj);
+    LockWord lock_word = obj->GetLockWord(true);
+    ASSERT_EQ(LockWord::kBiased, lock_word.GetState());
+    EXPECT_EQ(self->GetThreadId(), lock_word.BiasedLockOwner());
+    EXPECT_EQ(2u, lock_word.BiasedLockCount());
+    EXPECT_EQ(self->GetThreadId(), Monitor::GetLockOwnerThreadId(obj.Get()));
+  }
+  // Unlocking keeps the bias, but the lock is no longer held.
+  LockWord lock_word = obj->GetLockWord(true);
+  ASSERT_EQ(LockWord::kBiased, lock_word.GetState());
+  EXPECT_EQ(0u, lock_word.BiasedLockCount());
+  EXPECT_EQ(ThreadList::kInvalidThreadId, Monitor::GetLockOwnerThreadId(obj.Get()));
+  // Another thread locking the object revokes the bias.
+  thread_pool.AddTask(self, new LockUnlockTask(obj));
+  thread_pool.StartWorkers(self);
+  {
+    ScopedThreadSuspension sts(self, kSuspended);
+    thread_pool.Wait(Thread::Current(), /*do_work*/false, /*may_hold_locks*/false);
+  }
+  thread_pool.StopWorkers(self);
+  lock_word = obj->GetLockWord(true);
+  ASSERT_EQ(LockWord::kBiased, lock_word.GetState());
+  EXPECT_NE(self->GetThreadId(), lock_word.BiasedLockOwner());
+  EXPECT_EQ(ThreadList::kInvalidThreadId, Monitor::GetLockOwnerThreadId(obj.Get()));
+  // Locking revokes the bias again.
+  {
+    ObjectLock<mirror::Object> lock(self, obj);
+    EXPECT_EQ(self->GetThreadId(), Monitor::GetLockOwnerThreadId(obj.Get()));
+  }
+}
+
+TEST_F(BiasedMonitorTest, BiasedLockingWaitAndHashCode) {
+  Thread* const self = Thread::Current();
+  ScopedObjectAccess soa(self);
+  StackHandleScope<1> hs(self);
+  Handle<mirror::Object> obj(
+      hs.NewHandle<mirror::Object>(mirror::String::AllocFromModifiedUtf8(self, "hello, world!")));
+  {
+    ObjectLock<mirror::Object> lock(self, obj);
+    ASSERT_EQ(LockWord::kBiased, obj->GetLockWord(true).GetState());
+    obj->Notify(self);
+    self->AssertNoPendingException();
+    // Waiting inflates the lock.
+    obj->Wait(self, 1, 0);
+    self->AssertNoPendingException();
+    ASSERT_EQ(LockWord::kFatLocked, obj->GetLockWord(true).GetState());
+  }
+  Handle<mirror::Object> obj2(
+      hs.NewHandle<mirror::Object>(mirror::String::AllocFromModifiedUtf8(self, "hello, world!")));
+  {
+    ObjectLock<mirror::Object> lock(self, obj2);
+  }
+  ASSERT_EQ(LockWord::kBiased, obj2->GetLockWord(true).GetState());
+  // The hash code replaces the bias.
+  int32_t hash_code = obj2->IdentityHashCode();
+  ASSERT_EQ(LockWord::kHashCode, obj2->GetLockWord(true).GetState());
+  EXPECT_EQ(hash_code, obj2->IdentityHashCode());
+}
+
+class LockTask : public Task {
+ public:
+  explicit LockTask(Handle<mirror::Object> obj) : obj_(obj) {}
+
+  void Run(Thread* self) {
+    ScopedObjectAccess soa(self);
+    ObjectLock<mirror::Object> lock(self, obj_);
+  }
+
+  void Finalize() {
+    delete this;
+  }
+
+ private:
+  Handle<mirror::Object> obj_;
+};
+
+TEST_F(BiasedMonitorTest, BulkRebiasAndRevoke) {
+  Thread* const self = Thread::Current();
+  ThreadPool thread_pool("the pool", 1);
+  ScopedObjectAccess soa(self);
+  StackHandleScope<2> hs(self);
+  // No other test biases locks of int arrays, whose bias revocations are counted per class.
+  Handle<mirror::Object> obj(hs.NewHandle<mirror::Object>(mirror::IntArray::Alloc(self, 1)));
+  Handle<mirror::Object> other(hs.NewHandle<mirror::Object>(mirror::IntArray::Alloc(self, 1)));
+  mirror::Class* klass = obj->GetClass();
+  ASSERT_FALSE(klass->IsBiasedLockingRevoked());
+  {
+    ObjectLock<mirror::Object> lock1(self, obj);
+    ObjectLock<mirror::Object> lock2(self, other);
+  }
+  ASSERT_EQ(LockWord::kBiased, other->GetLockWord(true).GetState());
+  // Lock obj from both threads in turn, each lock revoking the bias of the other thread.
+  thread_pool.StartWorkers(self);
+  for (uint32_t revocations = 0; revocations < Monitor::kBulkRevokeThreshold; revocations += 2) {
+    thread_pool.AddTask(self, new LockTask(obj));
+    {
+      ScopedThreadSuspension sts(self, kSuspended);
+      thread_pool.Wait(self, /*do_work*/false, /*may_hold_locks*/false);
+    }
+    ObjectLock<mirror::Object> lock(self, obj);
+    if (revocations + 2 == Monitor::kBulkRebiasThreshold) {
+      // The bias of the other instance was revoked with the others, its next locker gets it.
+      EXPECT_EQ(LockWord::kUnlocked, other->GetLockWord(true).GetState());
+      EXPECT_FALSE(klass->IsBiasedLockingRevoked());
+    }
+  }
+  thread_pool.StopWorkers(self);
+  EXPECT_TRUE(klass->IsBiasedLockingRevoked());
+  {
+    ObjectLock<mirror::Object> lock(self, other);
+    EXPECT_EQ(LockWord::kThinLocked, other->GetLockWord(true).GetState());
+  }
+  EXPECT_EQ(LockWord::kUnlocked, other->GetLockWord(true).GetState());
+}
 
 }  // namespace art
@@ -32,11 +32,14 @@
 #include "gc/space/space-inl.h"
 #include "gc/space/zygote_space.h"
 #include "hprof/hprof.h"
+#include "jit/jit.h"
 #include "jni_internal.h"
 #include "mirror/class.h"
+#include "monitor.h"
 #include "ScopedLocalRef.h"
 #include "ScopedUtfChars.h"
 #include "scoped_fast_native_object_access.h"
+#include "thread_list.h"
 #include "trace.h"
 #include "well_known_classes.h"
 
@@ -358,7 +361,9 @@ static void VMDebug_getHeapSpaceStats(JNIEnv* env, jclass, jlongArray data) {
   env->ReleasePrimitiveArrayCritical(data, arr, 0);
 }
 
-// The runtime stat names for VMDebug.getRuntimeStat().
+// The runtime stat names for VMDebug.getRuntimeStat(). The Java side maps each name to its id
+// in libcore's VMDebug.runtimeStatsMap, so a new id is only reachable from Java once that map
+// has the corresponding name.
 enum class VMDebugRuntimeStatId {
   kArtGcGcCount = 0,
   kArtGcGcTime,
@@ -368,6 +373,9 @@ enum class VMDebugRuntimeStatId {
   kArtGcBlockingGcTime,
   kArtGcGcCountRateHistogram,
   kArtGcBlockingGcCountRateHistogram,
+  kArtJitStats,  // "art.jit.stats"
+  kArtMonitorContention,  // "art.monitor.contention"
+  kArtSafepointLatency,  // "art.safepoint.latency"
   kNumRuntimeStats,
 };
 
@@ -408,6 +416,28 @@ static jobject VMDebug_getRuntimeStatInternal(JNIEnv* env, jclass, jint statId)
       heap->DumpBlockingGcCountRateHistogram(output);
       return env->NewStringUTF(output.str().c_str());
     }
+    case VMDebugRuntimeStatId::kArtJitStats: {
+      jit::Jit* jit = Runtime::Current()->GetJit();
+      if (jit == nullptr) {
+        return nullptr;
+      }
+      std::ostringstream output;
+      {
+        ScopedObjectAccess soa(env);
+        jit->DumpStatsAsJson(output);
+      }
+      return env->NewStringUTF(output.str().c_str());
+    }
+    case VMDebugRuntimeStatId::kArtMonitorContention: {
+      std::ostringstream output;
+      Monitor::DumpContentionProfile(output);
+      return env->NewStringUTF(output.str().c_str());
+    }
+    case VMDebugRuntimeStatId::kArtSafepointLatency: {
+      std::ostringstream output;
+      Runtime::Current()->GetThreadList()->DumpSafepointLatencies(output);
+      return env->NewStringUTF(output.str().c_str());
+    }
     default:
       return nullptr;
   }
@@ -472,6 +502,9 @@ static jobjectArray VMDebug_getRuntimeStatsInternal(JNIEnv* env, jclass) {
       return nullptr;
     }
   }
+  // The JIT statistics, the monitor contention profile and the safepoint latencies contain an
+  // entry for every compiled method or contended or slow site: they are only returned when
+  // explicitly requested through getRuntimeStat().
   return result;
 }
 
@@ -422,7 +422,7 @@ static void PreloadDexCachesStatsTotal(DexCacheStats* total) {
   for (size_t i = 0; i< boot_class_path.size(); i++) {
     const DexFile* dex_file = boot_class_path[i];
     CHECK(dex_file != nullptr);
-    total->num_strings += dex_file->NumStringIds();
+    total->num_strings += mirror::DexCache::StringsArraySize(dex_file->NumStringIds());
     total->num_fields += dex_file->NumFieldIds();
     total->num_methods += dex_file->NumMethodIds();
     total->num_types += dex_file->NumTypeIds();
@@ -443,9 +443,9 @@ static void PreloadDexCachesStatsFilled(DexCacheStats* filled)
     if (dex_cache == nullptr) {
       continue;
     }
+    mirror::StringDexCacheType* const strings = dex_cache->GetStrings();
     for (size_t j = 0; j < dex_cache->NumStrings(); j++) {
-      mirror::String* string = dex_cache->GetResolvedString(j);
-      if (string != nullptr) {
+      if (mirror::StringDexCachePair::ReadSlot(strings, j) != nullptr) {
         filled->num_strings++;
       }
     }
@@ -507,7 +507,7 @@ static void VMRuntime_preloadDexCaches(JNIEnv* env, jobject) {
     Handle<mirror::DexCache> dex_cache(hs.NewHandle(linker->RegisterDexFile(*dex_file, nullptr)));
 
     if (kPreloadDexCachesStrings) {
-      for (size_t j = 0; j < dex_cache->NumStrings(); j++) {
+      for (size_t j = 0; j < dex_file->NumStringIds(); j++) {
         PreloadDexCachesResolveString(dex_cache, j, strings);
       }
     }
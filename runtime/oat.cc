@@ -76,6 +76,7 @@ OatHeader::OatHeader(InstructionSet instruction_set,
       quick_imt_conflict_trampoline_offset_(0),
       quick_resolution_trampoline_offset_(0),
       quick_to_interpreter_bridge_offset_(0),
+      hot_code_size_(0),
       image_patch_delta_(0),
       image_file_location_oat_checksum_(0),
       image_file_location_oat_data_begin_(0) {
@@ -178,6 +179,7 @@ void OatHeader::UpdateChecksumWithHeaderData() {
                  sizeof(quick_resolution_trampoline_offset_));
   UpdateChecksum(&quick_to_interpreter_bridge_offset_,
                  sizeof(quick_to_interpreter_bridge_offset_));
+  UpdateChecksum(&hot_code_size_, sizeof(hot_code_size_));
 }
 
 void OatHeader::UpdateChecksum(const void* data, size_t length) {
@@ -343,6 +345,18 @@ void OatHeader::SetQuickToInterpreterBridgeOffset(uint32_t offset) {
   quick_to_interpreter_bridge_offset_ = offset;
 }
 
+uint32_t OatHeader::GetHotCodeSize() const {
+  DCHECK(IsValid());
+  return hot_code_size_;
+}
+
+void OatHeader::SetHotCodeSize(uint32_t hot_code_size) {
+  DCHECK(IsValid());
+  DCHECK_EQ(hot_code_size_, 0U) << hot_code_size;
+
+  hot_code_size_ = hot_code_size;
+}
+
 int32_t OatHeader::GetImagePatchDelta() const {
   CHECK(IsValid());
   return image_patch_delta_;
@@ -32,7 +32,7 @@ class InstructionSetFeatures;
 class PACKED(4) OatHeader {
  public:
   static constexpr uint8_t kOatMagic[] = { 'o', 'a', 't', '\n' };
-  static constexpr uint8_t kOatVersion[] = { '0', '8', '8', '\0' };
+  static constexpr uint8_t kOatVersion[] = { '0', '9', '1', '\0' };
 
   static constexpr const char* kImageLocationKey = "image-location";
   static constexpr const char* kDex2OatCmdLineKey = "dex2oat-cmdline";
@@ -91,6 +91,11 @@ class PACKED(4) OatHeader {
   uint32_t GetQuickToInterpreterBridgeOffset() const;
   void SetQuickToInterpreterBridgeOffset(uint32_t offset);
 
+  // Size of the code at the start of the executable section that belongs to the classes loaded at
+  // startup according to the profile the oat file was compiled with, 0 without a profile.
+  uint32_t GetHotCodeSize() const;
+  void SetHotCodeSize(uint32_t hot_code_size);
+
   int32_t GetImagePatchDelta() const;
   void RelocateOat(off_t delta);
   void SetImagePatchDelta(int32_t off);
@@ -143,6 +148,7 @@ class PACKED(4) OatHeader {
   uint32_t quick_imt_conflict_trampoline_offset_;
   uint32_t quick_resolution_trampoline_offset_;
   uint32_t quick_to_interpreter_bridge_offset_;
+  uint32_t hot_code_size_;
 
   // The amount that the image this oat is associated with has been patched.
   int32_t image_patch_delta_;
@@ -16,9 +16,12 @@
 
 #include "oat_file_manager.h"
 
+#include <sys/mman.h>
+
 #include <memory>
 #include <queue>
 #include <vector>
+#include <zlib.h>
 
 #include "base/logging.h"
 #include "base/stl_util.h"
@@ -28,17 +31,36 @@
 #include "gc/scoped_gc_critical_section.h"
 #include "gc/space/image_space.h"
 #include "handle_scope-inl.h"
+#include "java_vm_ext.h"
+#include "mirror/class-inl.h"
 #include "mirror/class_loader.h"
 #include "oat_file_assistant.h"
+#include "runtime-inl.h"
 #include "scoped_thread_state_change.h"
 #include "thread-inl.h"
 #include "thread_list.h"
+#include "thread_pool.h"
+#include "type_lookup_table.h"
+#include "verifier/verification_cache.h"
+#include "well_known_classes.h"
 
 namespace art {
 
 // If true, then we attempt to load the application image if it exists.
 static constexpr bool kEnableAppImage = true;
 
+// If true, then we ask the kernel to read ahead the parts of newly opened oat and dex files that
+// are used at startup.
+static constexpr bool kPrefetchStartupRegions = true;
+
+// Background verification should not compete with the threads of the application.
+static constexpr int kVerificationPoolThreadPthreadPriority = 10;
+
+// Number of classes verified by a task of the verification pool. Small enough for the pool to
+// reach the classes of a dex file used at startup early, large enough for the class loader lookup
+// of a task to be amortized.
+static constexpr size_t kPreVerifyBatchSize = 32;
+
 CompilerFilter::Filter OatFileManager::filter_ = CompilerFilter::Filter::kSpeed;
 
 const OatFile* OatFileManager::RegisterOatFile(std::unique_ptr<const OatFile> oat_file) {
@@ -123,12 +145,319 @@ const OatFile* OatFileManager::GetPrimaryOatFile() const {
   return nullptr;
 }
 
+OatFileManager::OatFileManager()
+    : have_non_pic_oat_file_(false),
+      pre_verify_lock_("Pre-verify lock"),
+      num_parked_pre_verify_batches_(0u) {}
+
 OatFileManager::~OatFileManager() {
   // Explicitly clear oat_files_ since the OatFile destructor calls back into OatFileManager for
   // UnRegisterOatFileLocation.
   oat_files_.clear();
 }
 
+struct OatFileManager::PreVerifyBatch {
+  PreVerifyBatch(jweak loader, const DexFile* file, std::vector<uint16_t>&& indexes)
+      : class_loader(loader), dex_file(file), class_def_indexes(std::move(indexes)) {}
+
+  ~PreVerifyBatch() {
+    Runtime::Current()->GetJavaVM()->DeleteWeakGlobalRef(Thread::Current(), class_loader);
+  }
+
+  // The class loader the dex file was opened for. Weak so that the batch does not keep the
+  // classes of an unused class loader alive.
+  const jweak class_loader;
+  const DexFile* const dex_file;
+  const std::vector<uint16_t> class_def_indexes;
+
+  DISALLOW_COPY_AND_ASSIGN(PreVerifyBatch);
+};
+
+// Verifies a batch of the classes queued by OatFileManager::QueuePreVerification.
+class PreVerifyClassesTask FINAL : public Task {
+ public:
+  explicit PreVerifyClassesTask(std::unique_ptr<OatFileManager::PreVerifyBatch> batch)
+      : batch_(std::move(batch)) {}
+
+  void Run(Thread* self) OVERRIDE {
+    Runtime::Current()->GetOatFileManager().RunPreVerifyBatch(self, std::move(batch_));
+  }
+
+  void Finalize() OVERRIDE {
+    delete this;
+  }
+
+ private:
+  std::unique_ptr<OatFileManager::PreVerifyBatch> batch_;
+
+  DISALLOW_COPY_AND_ASSIGN(PreVerifyClassesTask);
+};
+
+void OatFileManager::CreateThreadPool(size_t num_threads) {
+  DCHECK(verification_thread_pool_ == nullptr);
+  // Verification resolves classes through the class loader, which may call into Java.
+  verification_thread_pool_.reset(
+      new ThreadPool("Verification thread pool", num_threads, /* create_peers */ true));
+  verification_thread_pool_->SetPthreadPriority(kVerificationPoolThreadPthreadPriority);
+  verification_thread_pool_->StartWorkers(Thread::Current());
+}
+
+void OatFileManager::DeleteThreadPool() {
+  if (verification_thread_pool_ != nullptr) {
+    Thread* self = Thread::Current();
+    ThreadPool* cache = nullptr;
+    {
+      ScopedSuspendAll ssa(__FUNCTION__);
+      // Clear the field while the threads are suspended, the functions queuing tasks check
+      // against it.
+      cache = verification_thread_pool_.release();
+    }
+    cache->StopWorkers(self);
+    cache->RemoveAllTasks(self);
+    cache->Wait(self, false, false);
+    delete cache;
+    // The batches of the removed tasks are not finalized, only release the parked ones.
+    std::vector<std::unique_ptr<PreVerifyBatch>> batches;
+    {
+      MutexLock mu(self, pre_verify_lock_);
+      batches.swap(parked_pre_verify_batches_);
+      num_parked_pre_verify_batches_.StoreRelaxed(0u);
+    }
+  }
+}
+
+void OatFileManager::QueuePreVerification(
+    Thread* self,
+    jobject class_loader,
+    const std::vector<std::unique_ptr<const DexFile>>& dex_files) {
+  if (class_loader == nullptr || !Runtime::Current()->IsVerificationEnabled()) {
+    return;
+  }
+  ScopedObjectAccess soa(self);
+  // The pool is cleared with all threads suspended, so it cannot go away while we are runnable.
+  ThreadPool* const thread_pool = verification_thread_pool_.get();
+  if (thread_pool == nullptr) {
+    return;
+  }
+  mirror::Object* const loader = soa.Decode<mirror::Object*>(class_loader);
+  // Other class loaders would run their own code on the pool to find the classes.
+  if (!loader->InstanceOf(
+          soa.Decode<mirror::Class*>(WellKnownClasses::dalvik_system_BaseDexClassLoader))) {
+    return;
+  }
+  for (const std::unique_ptr<const DexFile>& dex_file : dex_files) {
+    const OatDexFile* const oat_dex_file = dex_file->GetOatDexFile();
+    std::vector<uint16_t> class_def_indexes;
+    const size_t num_class_defs = dex_file->NumClassDefs();
+    for (size_t i = 0; i < num_class_defs; ++i) {
+      // Verifying these on first use only reads the oat file.
+      if (oat_dex_file == nullptr ||
+          oat_dex_file->GetOatClass(i).GetStatus() < mirror::Class::kStatusVerified) {
+        class_def_indexes.push_back(dchecked_integral_cast<uint16_t>(i));
+      }
+      if (!class_def_indexes.empty() &&
+          (class_def_indexes.size() == kPreVerifyBatchSize || i + 1u == num_class_defs)) {
+        jweak weak_loader = soa.Vm()->AddWeakGlobalRef(self, loader);
+        std::unique_ptr<PreVerifyBatch> batch(
+            new PreVerifyBatch(weak_loader, dex_file.get(), std::move(class_def_indexes)));
+        class_def_indexes.clear();
+        thread_pool->AddTask(self, new PreVerifyClassesTask(std::move(batch)));
+      }
+    }
+  }
+}
+
+void OatFileManager::OnClassDefined(Thread* self, Handle<mirror::Class> klass) {
+  if (num_parked_pre_verify_batches_.LoadRelaxed() != 0u) {
+    ResumePreVerification(self, &klass->GetDexFile());
+  }
+}
+
+void OatFileManager::ResumePreVerification(Thread* self, const DexFile* dex_file) {
+  // The pool is cleared with all threads suspended, so it cannot go away while we are runnable.
+  ThreadPool* const thread_pool = verification_thread_pool_.get();
+  std::vector<std::unique_ptr<PreVerifyBatch>> batches;
+  {
+    MutexLock mu(self, pre_verify_lock_);
+    for (auto it = parked_pre_verify_batches_.begin(); it != parked_pre_verify_batches_.end(); ) {
+      if ((*it)->dex_file == dex_file) {
+        batches.push_back(std::move(*it));
+        it = parked_pre_verify_batches_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    num_parked_pre_verify_batches_.StoreRelaxed(parked_pre_verify_batches_.size());
+  }
+  if (thread_pool != nullptr) {
+    for (std::unique_ptr<PreVerifyBatch>& batch : batches) {
+      thread_pool->AddTask(self, new PreVerifyClassesTask(std::move(batch)));
+    }
+  }
+}
+
+void OatFileManager::RunPreVerifyBatch(Thread* self, std::unique_ptr<PreVerifyBatch> batch) {
+  ScopedTrace trace(__FUNCTION__);
+  {
+    ScopedObjectAccess soa(self);
+    Runtime* const runtime = Runtime::Current();
+    ClassLinker* const class_linker = runtime->GetClassLinker();
+    const DexFile& dex_file = *batch->dex_file;
+    mirror::Object* const loader = soa.Vm()->DecodeWeakGlobal(self, batch->class_loader);
+    if (loader == nullptr || runtime->IsClearedJniWeakGlobal(loader)) {
+      // The class loader has been unloaded.
+      return;
+    }
+    StackHandleScope<2> hs(self);
+    Handle<mirror::ClassLoader> class_loader(hs.NewHandle(loader->AsClassLoader()));
+    if (class_linker->FindDexCache(self, dex_file, /* allow_failure */ true) == nullptr) {
+      // The class loader has not defined any class of the dex file yet, and may not see it yet.
+      {
+        MutexLock mu(self, pre_verify_lock_);
+        parked_pre_verify_batches_.push_back(std::move(batch));
+        num_parked_pre_verify_batches_.StoreRelaxed(parked_pre_verify_batches_.size());
+      }
+      // Check again in case the first class was defined before the batch was parked.
+      if (class_linker->FindDexCache(self, dex_file, /* allow_failure */ true) != nullptr) {
+        ResumePreVerification(self, &dex_file);
+      }
+      return;
+    }
+    MutableHandle<mirror::Class> klass(hs.NewHandle<mirror::Class>(nullptr));
+    for (uint16_t class_def_index : batch->class_def_indexes) {
+      if (runtime->IsShuttingDown(self)) {
+        break;
+      }
+      const char* descriptor = dex_file.GetClassDescriptor(dex_file.GetClassDef(class_def_index));
+      klass.Assign(class_linker->FindClass(self, descriptor, class_loader));
+      if (klass.Get() == nullptr) {
+        // Left to fail again on first use.
+        self->ClearException();
+        continue;
+      }
+      // The class may have been verified on first use in the meantime. VerifyClass waits for
+      // a verification in progress on another thread. The class loader may also have found
+      // another definition of the class first.
+      if (&klass->GetDexFile() == &dex_file && !klass->IsVerified() && !klass->IsErroneous()) {
+        class_linker->VerifyClass(self, klass);
+        // A verification failure is thrown again when the class is used.
+        self->ClearException();
+      }
+    }
+  }
+  // Keep the results for the next run. Done without holding the mutator lock.
+  WriteVerificationCaches(self);
+}
+
+void OatFileManager::WriteVerificationCaches(Thread* self) {
+  std::vector<std::shared_ptr<verifier::VerificationCache>> caches;
+  {
+    ReaderMutexLock mu(self, *Locks::oat_file_manager_lock_);
+    caches = verification_caches_;
+  }
+  for (const std::shared_ptr<verifier::VerificationCache>& cache : caches) {
+    std::string error_msg;
+    if (!cache->Write(&error_msg)) {
+      VLOG(verifier) << "Failed to write verification cache: " << error_msg;
+    }
+  }
+}
+
+bool OatFileManager::WaitForPreVerification(Thread* self) {
+  ThreadPool* const thread_pool = verification_thread_pool_.get();
+  if (thread_pool == nullptr) {
+    return false;
+  }
+  thread_pool->Wait(self, /* do_work */ false, /* may_hold_locks */ false);
+  return true;
+}
+
+// Asks the kernel to read ahead memory ranges of oat and dex files, so that they are read in a few
+// large requests instead of being faulted in one page at a time. Only the ranges are kept, the
+// files may be unloaded before the task runs. MADV_WILLNEED is only a hint, so it is harmless if
+// the ranges have been unmapped or reused by then.
+class PrefetchTask FINAL : public SelfDeletingTask {
+ public:
+  explicit PrefetchTask(std::vector<std::pair<uint8_t*, size_t>>&& ranges)
+      : ranges_(std::move(ranges)) {}
+
+  void Run(Thread* self ATTRIBUTE_UNUSED) OVERRIDE {
+    ScopedTrace trace("Prefetch startup regions");
+    for (const std::pair<uint8_t*, size_t>& range : ranges_) {
+      if (madvise(range.first, range.second, MADV_WILLNEED) != 0) {
+        VLOG(oat) << "madvise(MADV_WILLNEED) failed for " << static_cast<void*>(range.first)
+                  << " size " << range.second << ": " << strerror(errno);
+      }
+    }
+  }
+
+ private:
+  const std::vector<std::pair<uint8_t*, size_t>> ranges_;
+
+  DISALLOW_COPY_AND_ASSIGN(PrefetchTask);
+};
+
+static void AddPrefetchRange(const uint8_t* begin,
+                             size_t size,
+                             /*out*/ std::vector<std::pair<uint8_t*, size_t>>* ranges) {
+  if (begin == nullptr || size == 0u) {
+    return;
+  }
+  uint8_t* const aligned_begin = AlignDown(const_cast<uint8_t*>(begin), kPageSize);
+  uint8_t* const aligned_end = AlignUp(const_cast<uint8_t*>(begin) + size, kPageSize);
+  ranges->emplace_back(aligned_begin, aligned_end - aligned_begin);
+}
+
+void OatFileManager::PrefetchStartupRegions(
+    Thread* self,
+    const OatFile* oat_file,
+    const std::vector<std::unique_ptr<const DexFile>>& dex_files) {
+  if (!kPrefetchStartupRegions) {
+    return;
+  }
+  std::vector<std::pair<uint8_t*, size_t>> ranges;
+  if (oat_file != nullptr && oat_file->IsExecutable()) {
+    // The code of the profiled classes, which dex2oat lays out at the start of the executable
+    // section. Nothing if the oat file was not compiled with a profile.
+    const OatHeader& oat_header = oat_file->GetOatHeader();
+    AddPrefetchRange(oat_file->Begin() + oat_header.GetExecutableOffset(),
+                     oat_header.GetHotCodeSize(),
+                     &ranges);
+  }
+  for (const std::unique_ptr<const DexFile>& dex_file : dex_files) {
+    // The id sections and the class defs, which precede the data section and are used to look up
+    // and link every class.
+    const DexFile::Header& header = dex_file->GetHeader();
+    const size_t ids_size = header.class_defs_off_ +
+        header.class_defs_size_ * sizeof(DexFile::ClassDef);
+    AddPrefetchRange(dex_file->Begin(), std::min(ids_size, dex_file->Size()), &ranges);
+    // The type lookup table, used for every class lookup in the dex file.
+    const OatDexFile* const oat_dex_file = dex_file->GetOatDexFile();
+    if (oat_dex_file != nullptr) {
+      AddPrefetchRange(oat_dex_file->GetLookupTableData(),
+                       TypeLookupTable::RawDataLength(*dex_file),
+                       &ranges);
+    }
+  }
+  if (ranges.empty()) {
+    return;
+  }
+  PrefetchTask* const task = new PrefetchTask(std::move(ranges));
+  {
+    // The pool is cleared with all threads suspended, so it cannot go away while we are runnable.
+    ScopedObjectAccess soa(self);
+    ThreadPool* const thread_pool = verification_thread_pool_.get();
+    if (thread_pool != nullptr) {
+      thread_pool->AddTask(self, task);
+      return;
+    }
+  }
+  // Without a background pool, start the read ahead here. The kernel does not wait for the reads
+  // to complete.
+  task->Run(self);
+  task->Finalize();
+}
+
 std::vector<const OatFile*> OatFileManager::RegisterImageOatFiles(
     std::vector<gc::space::ImageSpace*> spaces) {
   std::vector<const OatFile*> oat_files;
@@ -328,6 +657,49 @@ static bool GetDexFilesFromClassLoader(
   return true;
 }
 
+static bool UpdateClassPathChecksum(ScopedObjectAccessAlreadyRunnable& soa,
+                                    mirror::ClassLoader* class_loader,
+                                    /*inout*/ uint32_t* checksum)
+    SHARED_REQUIRES(Locks::mutator_lock_) {
+  if (ClassLinker::IsBootClassLoader(soa, class_loader)) {
+    for (const DexFile* dex_file : Runtime::Current()->GetClassLinker()->GetBootClassPath()) {
+      const uint32_t location_checksum = dex_file->GetLocationChecksum();
+      *checksum = adler32(*checksum,
+                          reinterpret_cast<const Bytef*>(&location_checksum),
+                          sizeof(location_checksum));
+    }
+    return true;
+  }
+  if (class_loader->GetClass() !=
+      soa.Decode<mirror::Class*>(WellKnownClasses::dalvik_system_PathClassLoader)) {
+    return false;
+  }
+  // The parent is searched first.
+  if (!UpdateClassPathChecksum(soa, class_loader->GetParent(), checksum)) {
+    return false;
+  }
+  auto UpdateChecksumFn = [&] (const DexFile* cp_dex_file) {
+    const uint32_t location_checksum = cp_dex_file->GetLocationChecksum();
+    *checksum = adler32(*checksum,
+                        reinterpret_cast<const Bytef*>(&location_checksum),
+                        sizeof(location_checksum));
+    return true;  // Continue looking.
+  };
+  StackHandleScope<2> hs(soa.Self());
+  MutableHandle<mirror::ObjectArray<mirror::Object>> dex_elements(
+      hs.NewHandle<mirror::ObjectArray<mirror::Object>>(nullptr));
+  Handle<mirror::ClassLoader> h_class_loader(hs.NewHandle(class_loader));
+  IterateOverPathClassLoader(soa, h_class_loader, dex_elements, UpdateChecksumFn);
+  return true;
+}
+
+bool OatFileManager::ComputeClassPathChecksum(mirror::ClassLoader* class_loader,
+                                              uint32_t* checksum) {
+  ScopedObjectAccessUnchecked soa(Thread::Current());
+  *checksum = adler32(0L, Z_NULL, 0);
+  return UpdateClassPathChecksum(soa, class_loader, checksum);
+}
+
 static void GetDexFilesFromDexElementsArray(
     ScopedObjectAccessAlreadyRunnable& soa,
     Handle<mirror::ObjectArray<mirror::Object>> dex_elements,
@@ -709,6 +1081,33 @@ std::vector<std::unique_ptr<const DexFile>> OatFileManager::OpenDexFilesFromOat(
     }
   }
 
+  // Keep the results of verifying classes at runtime if the oat file does not record them, so
+  // that the next run does not have to verify the classes again.
+  const std::string* oat_file_name = oat_file_assistant.OatFileName();
+  if (class_loader != nullptr &&
+      oat_file_name != nullptr &&
+      runtime->IsVerificationEnabled() &&
+      (source_oat_file == nullptr ||
+       !CompilerFilter::IsAsGoodAs(source_oat_file->GetCompilerFilter(),
+                                   CompilerFilter::kInterpretOnly))) {
+    for (size_t i = 0; i < dex_files.size(); ++i) {
+      const std::string cache_filename = (i == 0u)
+          ? *oat_file_name + ".vcache"
+          : StringPrintf("%s.classes%zu.vcache", oat_file_name->c_str(), i + 1u);
+      std::shared_ptr<verifier::VerificationCache> cache(
+          verifier::VerificationCache::Create(*dex_files[i], cache_filename));
+      dex_files[i]->SetVerificationCache(cache);
+      WriterMutexLock mu(self, *Locks::oat_file_manager_lock_);
+      verification_caches_.push_back(std::move(cache));
+    }
+  }
+
+  // Read ahead what startup is going to touch before the classes are verified and used.
+  PrefetchStartupRegions(self, source_oat_file, dex_files);
+
+  // Start verifying the classes that the oat file does not record as verified.
+  QueuePreVerification(self, class_loader, dex_files);
+
   // TODO(calin): Consider optimizing this knowing that is useless to record the
   // use of fully compiled apks.
   Runtime::Current()->NotifyDexLoaded(dex_location);
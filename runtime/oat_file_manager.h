@@ -23,6 +23,7 @@
 #include <unordered_map>
 #include <vector>
 
+#include "atomic.h"
 #include "base/macros.h"
 #include "base/mutex.h"
 #include "compiler_filter.h"
@@ -36,8 +37,19 @@ class ImageSpace;
 }  // namespace space
 }  // namespace gc
 
+namespace mirror {
+class Class;
+class ClassLoader;
+}  // namespace mirror
+
+namespace verifier {
+class VerificationCache;
+}  // namespace verifier
+
 class DexFile;
+template<class T> class Handle;
 class OatFile;
+class ThreadPool;
 
 // Class for dealing with oat file management.
 //
@@ -45,7 +57,10 @@ class OatFile;
 // pointers returned from functions are always valid.
 class OatFileManager {
  public:
-  OatFileManager() : have_non_pic_oat_file_(false) {}
+  // Classes of a dex file to verify in the background. Defined in oat_file_manager.cc.
+  struct PreVerifyBatch;
+
+  OatFileManager();
   ~OatFileManager();
 
   // Add an oat file to the internal accounting, std::aborts if there already exists an oat file
@@ -106,6 +121,38 @@ class OatFileManager {
 
   void DumpForSigQuit(std::ostream& os);
 
+  // Create the pool of threads verifying newly loaded classes, so that the first use of a class
+  // does not have to verify it on the calling thread.
+  void CreateThreadPool(size_t num_threads);
+  void DeleteThreadPool() REQUIRES(!pre_verify_lock_);
+
+  // Called when `klass` has been defined and linked. Starts verifying the batches of its dex file
+  // that were waiting for the class loader to be able to find their classes.
+  void OnClassDefined(Thread* self, Handle<mirror::Class> klass)
+      SHARED_REQUIRES(Locks::mutator_lock_)
+      REQUIRES(!pre_verify_lock_);
+
+  // Verifies the classes of `batch`. The classes are defined through the class loader and verified
+  // with ClassLinker::VerifyClass, so a thread initializing one of them waits for the verification
+  // in progress, or finds the class verified. The batch is parked until the class loader defines
+  // a first class of the dex file, before which it may not be able to find them.
+  void RunPreVerifyBatch(Thread* self, std::unique_ptr<PreVerifyBatch> batch)
+      REQUIRES(!Locks::mutator_lock_, !pre_verify_lock_);
+
+  // Write out the verification results recorded since the last write. Called when the process
+  // goes to the background, by the profile saver and at shutdown, so that the results of
+  // classes verified on first use are kept too.
+  void WriteVerificationCaches(Thread* self) REQUIRES(!Locks::oat_file_manager_lock_);
+
+  // Wait for the queued classes to be verified. Returns false if classes are not verified in the
+  // background. Used by tests.
+  bool WaitForPreVerification(Thread* self) REQUIRES(!Locks::mutator_lock_);
+
+  // Compute a checksum of the dex files that classes of `class_loader` are resolved against, in
+  // lookup order. Returns false if we do not support one of the class loaders in the chain.
+  bool ComputeClassPathChecksum(mirror::ClassLoader* class_loader, /*out*/ uint32_t* checksum)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
   static void SetCompilerFilter(CompilerFilter::Filter filter) {
     filter_ = filter;
   }
@@ -126,9 +173,45 @@ class OatFileManager {
   const OatFile* FindOpenedOatFileFromOatLocationLocked(const std::string& oat_location) const
       REQUIRES(Locks::oat_file_manager_lock_);
 
+  // Queue the classes of `dex_files` that their oat file does not record as verified for
+  // verification on the thread pool, in batches of kPreVerifyBatchSize classes.
+  void QueuePreVerification(Thread* self,
+                            jobject class_loader,
+                            const std::vector<std::unique_ptr<const DexFile>>& dex_files)
+      REQUIRES(!Locks::mutator_lock_, !pre_verify_lock_);
+
+  // Queue the parked batches of `dex_file` on the thread pool again.
+  void ResumePreVerification(Thread* self, const DexFile* dex_file)
+      SHARED_REQUIRES(Locks::mutator_lock_)
+      REQUIRES(!pre_verify_lock_);
+
+  // Ask the kernel to read ahead the code of the profiled classes of the oat file, if any, and the
+  // parts of the dex files that every class lookup touches. Done on the thread pool if there is
+  // one.
+  void PrefetchStartupRegions(Thread* self,
+                              const OatFile* oat_file,
+                              const std::vector<std::unique_ptr<const DexFile>>& dex_files)
+      REQUIRES(!Locks::mutator_lock_);
+
   std::set<std::unique_ptr<const OatFile>> oat_files_ GUARDED_BY(Locks::oat_file_manager_lock_);
   bool have_non_pic_oat_file_;
 
+  // Pool verifying classes and prefetching newly opened oat and dex files in the background, null
+  // if background verification is disabled.
+  std::unique_ptr<ThreadPool> verification_thread_pool_;
+
+  // Batches waiting for their class loader to define a first class of their dex file.
+  Mutex pre_verify_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  std::vector<std::unique_ptr<PreVerifyBatch>> parked_pre_verify_batches_
+      GUARDED_BY(pre_verify_lock_);
+  // Size of parked_pre_verify_batches_, read without the lock on each class definition.
+  Atomic<size_t> num_parked_pre_verify_batches_;
+
+  // Verification caches of the opened dex files. Kept after the dex files are unloaded so that
+  // their results may still be written.
+  std::vector<std::shared_ptr<verifier::VerificationCache>> verification_caches_
+      GUARDED_BY(Locks::oat_file_manager_lock_);
+
   // The compiler filter used for oat files loaded by the oat file manager.
   static CompilerFilter::Filter filter_;
 
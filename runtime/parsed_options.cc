@@ -178,6 +178,9 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-Xjitsaveprofilinginfo")
           .WithValue(true)
           .IntoKey(M::JITSaveProfilingInfo)
+      .Define("-Xjitprecompileprofile")
+          .WithValue(true)
+          .IntoKey(M::JITPrecompileProfile)
       .Define("-XX:HspaceCompactForOOMMinIntervalMs=_")  // in ms
           .WithType<MillisecondsToNanoseconds>()  // store as ns
           .IntoKey(M::HSpaceCompactForOOMMinIntervalsMs)
@@ -225,6 +228,12 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-Xlockprofthreshold:_")
           .WithType<unsigned int>()
           .IntoKey(M::LockProfThreshold)
+      .Define("-Xlockcontentionprofiling")
+          .WithValue(true)
+          .IntoKey(M::LockContentionProfiling)
+      .Define("-Xbiasedlocking")
+          .WithValue(true)
+          .IntoKey(M::BiasedLocking)
       .Define("-Xstacktracefile:_")
           .WithType<std::string>()
           .IntoKey(M::StackTraceFile)
@@ -270,6 +279,9 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
                          {"all",      verifier::VerifyMode::kEnable},
                          {"softfail", verifier::VerifyMode::kSoftFail}})
           .IntoKey(M::Verify)
+      .Define("-Xbackground-verify-threads:_")
+          .WithType<unsigned int>()
+          .IntoKey(M::BackgroundVerifyThreads)
       .Define("-XX:NativeBridge=_")
           .WithType<std::string>()
           .IntoKey(M::NativeBridge)
@@ -280,6 +292,8 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
           .IntoKey(M::NoDexFileFallback)
       .Define("-Xno-sig-chain")
           .IntoKey(M::NoSigChain)
+      .Define("-Ximplicit-suspend-checks")
+          .IntoKey(M::ImplicitSuspendChecks)
       .Define("--cpu-abilist=_")
           .WithType<std::string>()
           .IntoKey(M::CpuAbiList)
@@ -688,6 +702,7 @@ void ParsedOptions::Usage(const char* fmt, ...) {
   UsageMessage(stream, "  -XX:UseTLAB\n");
   UsageMessage(stream, "  -XX:BackgroundGC=none\n");
   UsageMessage(stream, "  -XX:LargeObjectSpace={disabled,map,freelist}\n");
+  UsageMessage(stream, "  -Ximplicit-suspend-checks\n");
   UsageMessage(stream, "  -XX:LargeObjectThreshold=N\n");
   UsageMessage(stream, "  -XX:DumpNativeStackOnSigQuit=booleanvalue\n");
   UsageMessage(stream, "  -Xmethod-trace\n");
@@ -714,6 +729,10 @@ void ParsedOptions::Usage(const char* fmt, ...) {
   UsageMessage(stream, "  -Xjitwarmupthreshold:integervalue\n");
   UsageMessage(stream, "  -Xjitosrthreshold:integervalue\n");
   UsageMessage(stream, "  -Xjitprithreadweight:integervalue\n");
+  UsageMessage(stream, "  -Xjitprecompileprofile\n");
+  UsageMessage(stream, "  -Xlockcontentionprofiling\n");
+  UsageMessage(stream, "  -Xbiasedlocking\n");
+  UsageMessage(stream, "  -Xbackground-verify-threads:integervalue\n");
   UsageMessage(stream, "  -X[no]relocate\n");
   UsageMessage(stream, "  -X[no]dex2oat (Whether to invoke dex2oat on the application)\n");
   UsageMessage(stream, "  -X[no]image-dex2oat (Whether to create and use a boot image)\n");
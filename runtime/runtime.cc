@@ -217,6 +217,7 @@ Runtime::Runtime()
       dump_gc_performance_on_shutdown_(false),
       preinitialization_transaction_(nullptr),
       verify_(verifier::VerifyMode::kNone),
+      background_verify_threads_(0u),
       allow_dex_file_fallback_(true),
       target_sdk_version_(0),
       implicit_null_checks_(false),
@@ -291,6 +292,9 @@ Runtime::~Runtime() {
   // Make sure to let the GC complete if it is running.
   heap_->WaitForGcToComplete(gc::kGcCauseBackground, self);
   heap_->DeleteThreadPool();
+  oat_file_manager_->DeleteThreadPool();
+  // Keep the results of the classes verified during this run.
+  oat_file_manager_->WriteVerificationCaches(self);
   if (jit_ != nullptr) {
     ScopedTrace trace2("Delete jit");
     VLOG(jit) << "Deleting jit thread pool";
@@ -745,6 +749,9 @@ void Runtime::InitNonZygoteOrPostFork(
 
   // Create the thread pools.
   heap_->CreateThreadPool();
+  if (IsVerificationEnabled() && background_verify_threads_ != 0) {
+    oat_file_manager_->CreateThreadPool(background_verify_threads_);
+  }
   // Reset the gc performance data at zygote fork so that the GCs
   // before fork aren't attributed to an app.
   heap_->ResetGcPerformanceInfo();
@@ -948,7 +955,9 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
   oat_file_manager_ = new OatFileManager;
 
   Thread::SetSensitiveThreadHook(runtime_options.GetOrDefault(Opt::HookIsSensitiveThread));
-  Monitor::Init(runtime_options.GetOrDefault(Opt::LockProfThreshold));
+  Monitor::Init(runtime_options.GetOrDefault(Opt::LockProfThreshold),
+                runtime_options.GetOrDefault(Opt::LockContentionProfiling),
+                runtime_options.GetOrDefault(Opt::BiasedLocking));
 
   boot_class_path_string_ = runtime_options.ReleaseOrDefault(Opt::BootClassPath);
   class_path_string_ = runtime_options.ReleaseOrDefault(Opt::ClassPath);
@@ -984,6 +993,7 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
   intern_table_ = new InternTable;
 
   verify_ = runtime_options.GetOrDefault(Opt::Verify);
+  background_verify_threads_ = runtime_options.GetOrDefault(Opt::BackgroundVerifyThreads);
   allow_dex_file_fallback_ = !runtime_options.Exists(Opt::NoDexFileFallback);
 
   no_sig_chain_ = runtime_options.Exists(Opt::NoSigChain);
@@ -1090,6 +1100,10 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
     case kX86:
     case kArm64:
     case kX86_64:
+      // Code compiled with --implicit-suspend-checks polls the suspend trigger
+      // instead of testing the thread flags, and needs the SuspensionHandler.
+      implicit_suspend_checks_ = runtime_options.Exists(Opt::ImplicitSuspendChecks);
+      FALLTHROUGH_INTENDED;
     case kMips:
     case kMips64:
       implicit_null_checks_ = true;
@@ -1433,6 +1447,7 @@ void Runtime::DumpForSigQuit(std::ostream& os) {
   os << "\n";
 
   thread_list_->DumpForSigQuit(os);
+  Monitor::DumpContentionProfile(os);
   BaseMutex::DumpAll(os);
 }
 
@@ -1798,6 +1813,7 @@ void Runtime::RegisterAppInfo(const std::vector<std::string>& code_paths,
                           code_paths,
                           foreign_dex_profile_path,
                           app_dir);
+  jit_->PrecompileMethodsFromProfile(profile_output_filename);
 }
 
 void Runtime::NotifyDexLoaded(const std::string& dex_location) {
@@ -2028,6 +2044,10 @@ void Runtime::UpdateProcessState(ProcessState process_state) {
   ProcessState old_process_state = process_state_;
   process_state_ = process_state;
   GetHeap()->UpdateProcessState(old_process_state, process_state);
+  if (old_process_state != process_state && process_state == kProcessStateJankImperceptible) {
+    // The process may be killed without shutting down the runtime once in the background.
+    GetOatFileManager().WriteVerificationCaches(Thread::Current());
+  }
 }
 
 void Runtime::RegisterSensitiveThread() const {
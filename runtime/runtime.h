@@ -395,6 +395,7 @@ class Runtime {
     kSaveAll,
     kRefsOnly,
     kRefsAndArgs,
+    kSaveEverything,  // All core and floating point registers, for implicit suspend checks.
     kLastCalleeSaveType  // Value used for iteration
   };
 
@@ -528,6 +529,10 @@ class Runtime {
     return !implicit_so_checks_;
   }
 
+  bool ImplicitSuspendChecks() const {
+    return implicit_suspend_checks_;
+  }
+
   bool IsVerificationEnabled() const;
   bool IsVerificationSoftFail() const;
 
@@ -814,6 +819,10 @@ class Runtime {
   // If kNone, verification is disabled. kEnable by default.
   verifier::VerifyMode verify_;
 
+  // Number of threads verifying the classes of newly opened dex files in the background.
+  // Zero disables background verification.
+  unsigned int background_verify_threads_;
+
   // If true, the runtime may use dex files directly with the interpreter if an oat file is not
   // available/usable.
   bool allow_dex_file_fallback_;
@@ -756,8 +756,11 @@ QuickMethodFrameInfo StackVisitor::GetCurrentQuickFrameInfo() const {
   ClassLinker* class_linker = runtime->GetClassLinker();
   const void* entry_point = runtime->GetInstrumentation()->GetQuickCodeFor(method, sizeof(void*));
   DCHECK(class_linker->IsQuickGenericJniStub(entry_point)) << PrettyMethod(method);
-  // Generic JNI frame.
-  uint32_t handle_refs = GetNumberOfReferenceArgsWithoutReceiver(method) + 1;
+  // Generic JNI frame. The handle scope holds the receiver or jclass, except for
+  // @CriticalNative methods which have no reference arguments at all.
+  uint32_t handle_refs = method->IsCriticalNative()
+      ? 0u
+      : GetNumberOfReferenceArgsWithoutReceiver(method) + 1;
   size_t scope_size = HandleScope::SizeOf(handle_refs);
   QuickMethodFrameInfo callee_info = runtime->GetCalleeSaveMethodFrameInfo(Runtime::kRefsAndArgs);
 
@@ -1041,6 +1041,10 @@ bool Thread::ModifySuspendCount(Thread* self, int delta, AtomicInteger* suspend_
 
   if (tls32_.suspend_count == 0) {
     AtomicClearFlag(kSuspendRequest);
+    if (!ReadFlag(kCheckpointRequest)) {
+      // Nothing left for an implicit suspend check to do, stop faulting.
+      RemoveSuspendTrigger();
+    }
   } else {
     // Two bits might be set simultaneously.
     tls32_.state_and_flags.as_atomic_int.FetchAndOrSequentiallyConsistent(flags);
@@ -1073,6 +1077,11 @@ bool Thread::PassActiveSuspendBarriers(Thread* self) {
       tlsPtr_.active_suspend_barriers[i] = nullptr;
     }
     AtomicClearFlag(kActiveSuspendBarrier);
+    if (suspend_request_time_ns_ != 0) {
+      // Read by ThreadList::SuspendAll once every thread has passed its barrier.
+      last_suspend_latency_ns_ = NanoTime() - suspend_request_time_ns_;
+      suspend_request_time_ns_ = 0;
+    }
   }
 
   uint32_t barrier_count = 0;
@@ -1116,6 +1125,8 @@ void Thread::ClearSuspendBarrier(AtomicInteger* target) {
 
 void Thread::RunCheckpointFunction() {
   Closure *checkpoints[kMaxCheckpoints];
+  uint64_t checkpoint_latency = 0;
+  ThreadState checkpoint_request_state = kRunnable;
 
   // Grab the suspend_count lock and copy the current set of
   // checkpoints.  Then clear the list and the flag.  The RequestCheckpoint
@@ -1128,6 +1139,19 @@ void Thread::RunCheckpointFunction() {
       tlsPtr_.checkpoint_functions[i] = nullptr;
     }
     AtomicClearFlag(kCheckpointRequest);
+    if (tls32_.suspend_count == 0) {
+      RemoveSuspendTrigger();
+    }
+    if (checkpoint_request_time_ns_ != 0) {
+      checkpoint_latency = NanoTime() - checkpoint_request_time_ns_;
+      checkpoint_request_time_ns_ = 0;
+      checkpoint_request_state = checkpoint_request_state_;
+    }
+  }
+  if (checkpoint_latency != 0) {
+    // Record before running the checkpoints, which may change the current method.
+    Runtime::Current()->GetThreadList()->RecordTimeToCheckpoint(
+        this, checkpoint_latency, checkpoint_request_state);
   }
 
   // Outside the lock, run all the checkpoint functions that
@@ -1421,7 +1445,8 @@ struct StackDumpVisitor : public StackVisitor {
     if (o == nullptr) {
       os << "an unknown object";
     } else {
-      if ((o->GetLockWord(false).GetState() == LockWord::kThinLocked) &&
+      LockWord::LockState state = o->GetLockWord(false).GetState();
+      if ((state == LockWord::kThinLocked || state == LockWord::kBiased) &&
           Locks::mutator_lock_->IsExclusiveHeld(Thread::Current())) {
         // Getting the identity hashcode here would result in lock inflation and suspension of the
         // current thread, which isn't safe if this is the only runnable thread.
@@ -35,6 +35,7 @@
 #include "globals.h"
 #include "handle_scope.h"
 #include "instrumentation.h"
+#include "interpreter/interpreter_cache.h"
 #include "jvalue.h"
 #include "object_callbacks.h"
 #include "offsets.h"
@@ -551,6 +552,13 @@ class Thread {
         OFFSETOF_MEMBER(tls_32bit_sized_values, is_gc_marking));
   }
 
+  template<size_t pointer_size>
+  static ThreadOffset<pointer_size> BiasLocksOffset() {
+    return ThreadOffset<pointer_size>(
+        OFFSETOF_MEMBER(Thread, tls32_) +
+        OFFSETOF_MEMBER(tls_32bit_sized_values, bias_locks));
+  }
+
   // Deoptimize the Java stack.
   void DeoptimizeWithDeoptimizationException(JValue* result) SHARED_REQUIRES(Locks::mutator_lock_);
 
@@ -675,6 +683,12 @@ class Thread {
                                                                 thread_local_alloc_stack_end));
   }
 
+  template<size_t pointer_size>
+  static ThreadOffset<pointer_size> InterpreterCacheOffset() {
+    return ThreadOffsetFromTlsPtr<pointer_size>(OFFSETOF_MEMBER(tls_ptr_sized_values,
+                                                                interpreter_cache));
+  }
+
   // Size of stack less any space reserved for stack overflow
   size_t GetStackSize() const {
     return tlsPtr_.stack_size - (tlsPtr_.stack_end - tlsPtr_.stack_begin);
@@ -848,6 +862,14 @@ class Thread {
     tls32_.weak_ref_access_enabled = enabled;
   }
 
+  bool GetBiasLocks() const {
+    return tls32_.bias_locks;
+  }
+
+  void SetBiasLocks(bool bias_locks) {
+    tls32_.bias_locks = bias_locks;
+  }
+
   uint32_t GetDisableThreadFlipCount() const {
     CHECK(kUseReadBarrier);
     return tls32_.disable_thread_flip_count;
@@ -993,8 +1015,9 @@ class Thread {
   }
 
   // Remove the suspend trigger for this thread by making the suspend_trigger_ TLS value
-  // equal to a valid pointer.
-  // TODO: does this need to atomic?  I don't think so.
+  // equal to a valid pointer. Called with thread_suspend_count_lock_ held once neither a
+  // suspend nor a checkpoint request is pending, so that the trigger is never left armed
+  // without a request nor removed while one is outstanding.
   void RemoveSuspendTrigger() {
     tlsPtr_.suspend_trigger = reinterpret_cast<uintptr_t*>(&tlsPtr_.suspend_trigger);
   }
@@ -1093,6 +1116,10 @@ class Thread {
     return debug_disallow_read_barrier_;
   }
 
+  InterpreterCache* GetInterpreterCache() {
+    return &tlsPtr_.interpreter_cache;
+  }
+
   // Returns true if the current thread is the jit sensitive thread.
   bool IsJitSensitiveThread() const {
     return this == jit_sensitive_thread_;
@@ -1260,7 +1287,7 @@ class Thread {
       thread_exit_check_count(0), handling_signal_(false),
       suspended_at_suspend_check(false), ready_for_debug_invoke(false),
       debug_method_entry_(false), is_gc_marking(false), weak_ref_access_enabled(true),
-      disable_thread_flip_count(0) {
+      disable_thread_flip_count(0), bias_locks(false) {
     }
 
     union StateAndFlags state_and_flags;
@@ -1332,6 +1359,10 @@ class Thread {
     // levels of (nested) JNI critical sections the thread is in and is used to detect a nested JNI
     // critical section enter.
     uint32_t disable_thread_flip_count;
+
+    // A thread local copy of Monitor::biased_locking_, so that the art_quick_lock_object fast
+    // paths can decide whether to bias locks of unlocked objects towards this thread.
+    bool32_t bias_locks;
   } tls32_;
 
   struct PACKED(8) tls_64bit_sized_values {
@@ -1488,6 +1519,10 @@ class Thread {
     StackReference<mirror::Object>* thread_local_alloc_stack_top;
     StackReference<mirror::Object>* thread_local_alloc_stack_end;
 
+    // Per-instruction cache of resolved fields and methods, only used by this thread's
+    // interpreter frames.
+    InterpreterCache interpreter_cache;
+
     // Support for Mutex lock hierarchy bug detection.
     BaseMutex* held_mutexes[kLockLevelCount];
 
@@ -1518,6 +1553,16 @@ class Thread {
   // Debug disable read barrier count, only is checked for debug builds and only in the runtime.
   uint8_t debug_disallow_read_barrier_ = 0;
 
+  // When the pending suspend request with a barrier and the oldest pending checkpoint request
+  // were made, or 0. Set by the requester and consumed by this thread when it responds.
+  uint64_t suspend_request_time_ns_ GUARDED_BY(Locks::thread_suspend_count_lock_) = 0;
+  uint64_t checkpoint_request_time_ns_ GUARDED_BY(Locks::thread_suspend_count_lock_) = 0;
+  // How long this thread took to pass its last suspend barrier, 0 if it was already suspended.
+  uint64_t last_suspend_latency_ns_ GUARDED_BY(Locks::thread_suspend_count_lock_) = 0;
+  // The state this thread was in when those requests were made, i.e. what delayed its response.
+  ThreadState suspend_request_state_ GUARDED_BY(Locks::thread_suspend_count_lock_) = kRunnable;
+  ThreadState checkpoint_request_state_ GUARDED_BY(Locks::thread_suspend_count_lock_) = kRunnable;
+
   friend class Dbg;  // For SetStateUnsafe.
   friend class gc::collector::SemiSpace;  // For getting stack traces.
   friend class Runtime;  // For CreatePeer.
@@ -33,6 +33,7 @@
 #include "debugger.h"
 #include "gc/collector/concurrent_copying.h"
 #include "jni_internal.h"
+#include "linear_alloc.h"
 #include "lock_word.h"
 #include "monitor.h"
 #include "scoped_thread_state_change.h"
@@ -51,6 +52,9 @@
 namespace art {
 
 static constexpr uint64_t kLongThreadSuspendThreshold = MsToNs(5);
+// Responses to a suspend or checkpoint request slower than this are attributed to the method the
+// thread was in.
+static constexpr uint64_t kSlowSafepointThreshold = MsToNs(1) / 10;
 static constexpr uint64_t kThreadSuspendTimeoutMs = 30 * 1000;  // 30s.
 // Use 0 since we want to yield to prevent blocking for an unpredictable amount of time.
 static constexpr useconds_t kThreadSuspendInitialSleepUs = 0;
@@ -67,7 +71,11 @@ ThreadList::ThreadList()
       debug_suspend_all_count_(0),
       unregistering_count_(0),
       suspend_all_historam_("suspend all histogram", 16, 64),
-      long_suspend_(false) {
+      long_suspend_(false),
+      suspend_all_epoch_(0u),
+      safepoint_latency_lock_("safepoint latency lock"),
+      time_to_suspend_histogram_("time to suspend histogram", 16, 64),
+      time_to_checkpoint_histogram_("time to checkpoint histogram", 16, 64) {
   CHECK(Monitor::IsValidLockWord(LockWord::FromThinLockId(kMaxThreadId, 1, 0U)));
 }
 
@@ -140,6 +148,7 @@ void ThreadList::DumpForSigQuit(std::ostream& os) {
       suspend_all_historam_.PrintConfidenceIntervals(os, 0.99, data);  // Dump time to suspend.
     }
   }
+  DumpSafepointLatencies(os);
   bool dump_native_stack = Runtime::Current()->GetDumpNativeStackOnSigQuit();
   Dump(os, dump_native_stack);
   DumpUnattachedThreads(os, dump_native_stack);
@@ -303,11 +312,16 @@ size_t ThreadList::RunCheckpoint(Closure* checkpoint_function) {
     MutexLock mu(self, *Locks::thread_list_lock_);
     MutexLock mu2(self, *Locks::thread_suspend_count_lock_);
     count = list_.size();
+    const uint64_t request_time = NanoTime();
     for (const auto& thread : list_) {
       if (thread != self) {
         while (true) {
           if (thread->RequestCheckpoint(checkpoint_function)) {
             // This thread will run its checkpoint some time in the near future.
+            if (thread->checkpoint_request_time_ns_ == 0) {
+              thread->checkpoint_request_time_ns_ = request_time;
+              thread->checkpoint_request_state_ = thread->GetState();
+            }
             break;
           } else {
             // We are probably suspended, try to make sure that we stay suspended.
@@ -382,10 +396,15 @@ size_t ThreadList::RunCheckpointOnRunnableThreads(Closure* checkpoint_function)
     // Call a checkpoint function for each non-suspended thread.
     MutexLock mu(self, *Locks::thread_list_lock_);
     MutexLock mu2(self, *Locks::thread_suspend_count_lock_);
+    const uint64_t request_time = NanoTime();
     for (const auto& thread : list_) {
       if (thread != self) {
         if (thread->RequestCheckpoint(checkpoint_function)) {
           // This thread will run its checkpoint some time in the near future.
+          if (thread->checkpoint_request_time_ns_ == 0) {
+            thread->checkpoint_request_time_ns_ = request_time;
+            thread->checkpoint_request_state_ = thread->GetState();
+          }
           count++;
         }
       }
@@ -418,6 +437,7 @@ size_t ThreadList::FlipThreadRoots(Closure* thread_flip_visitor,
   flip_callback->Run(self);
   Locks::mutator_lock_->ExclusiveUnlock(self);
   collector->RegisterPause(NanoTime() - start_time);
+  ClearSuspendLatencies(self);
 
   // Resume runnable threads.
   std::vector<Thread*> runnable_threads;
@@ -503,6 +523,7 @@ void ThreadList::SuspendAll(const char* cause, bool long_suspend) {
 #endif
 
     long_suspend_ = long_suspend;
+    suspend_all_epoch_.FetchAndAddSequentiallyConsistent(1u);
 
     const uint64_t end_time = NanoTime();
     const uint64_t suspend_time = end_time - start_time;
@@ -510,6 +531,7 @@ void ThreadList::SuspendAll(const char* cause, bool long_suspend) {
     if (suspend_time > kLongThreadSuspendThreshold) {
       LOG(WARNING) << "Suspending all threads took: " << PrettyDuration(suspend_time);
     }
+    RecordTimesToSuspend(self);
 
     if (kDebugLocking) {
       // Debug check that all threads are suspended.
@@ -525,6 +547,162 @@ void ThreadList::SuspendAll(const char* cause, bool long_suspend) {
   }
 }
 
+void ThreadList::RecordTimesToSuspend(Thread* self) {
+  uint64_t max_latency = 0;
+  Thread* slowest = nullptr;
+  ThreadState slowest_state = kRunnable;
+  ArtMethod* method = nullptr;
+  uint32_t dex_pc = 0;
+  MutexLock mu(self, *Locks::thread_list_lock_);
+  MutexLock mu2(self, safepoint_latency_lock_);
+  {
+    MutexLock mu3(self, *Locks::thread_suspend_count_lock_);
+    for (const auto& thread : list_) {
+      const uint64_t latency = thread->last_suspend_latency_ns_;
+      if (thread == self || latency == 0) {
+        continue;
+      }
+      thread->last_suspend_latency_ns_ = 0;
+      time_to_suspend_histogram_.AdjustAndAddValue(latency);
+      if (latency > max_latency) {
+        max_latency = latency;
+        slowest = thread;
+        slowest_state = thread->suspend_request_state_;
+      }
+    }
+  }
+  if (max_latency >= kSlowSafepointThreshold) {
+    // The thread is suspended where it passed the barrier and we hold the mutator lock
+    // exclusively, so its top frame can be looked at. Names are only resolved when dumping.
+    method = slowest->GetCurrentMethod(&dex_pc, false);
+    RecordSlowSafepointSite(&slow_suspend_sites_,
+                            method,
+                            dex_pc,
+                            slowest->GetTid(),
+                            slowest_state,
+                            max_latency);
+  }
+}
+
+void ThreadList::ClearSuspendLatencies(Thread* self) {
+  MutexLock mu(self, *Locks::thread_list_lock_);
+  MutexLock mu2(self, *Locks::thread_suspend_count_lock_);
+  for (const auto& thread : list_) {
+    thread->last_suspend_latency_ns_ = 0;
+  }
+}
+
+void ThreadList::RecordTimeToCheckpoint(Thread* self,
+                                        uint64_t latency_ns,
+                                        ThreadState request_state)
+    NO_THREAD_SAFETY_ANALYSIS {
+  // Checkpoints run while the thread is runnable.
+  Locks::mutator_lock_->AssertSharedHeld(self);
+  ArtMethod* method = nullptr;
+  uint32_t dex_pc = 0;
+  if (latency_ns >= kSlowSafepointThreshold) {
+    method = self->GetCurrentMethod(&dex_pc, false);
+  }
+  MutexLock mu(self, safepoint_latency_lock_);
+  time_to_checkpoint_histogram_.AdjustAndAddValue(latency_ns);
+  if (latency_ns >= kSlowSafepointThreshold) {
+    RecordSlowSafepointSite(&slow_checkpoint_sites_,
+                            method,
+                            dex_pc,
+                            self->GetTid(),
+                            request_state,
+                            latency_ns);
+  }
+}
+
+void ThreadList::RecordSlowSafepointSite(SafepointSites* sites,
+                                         ArtMethod* method,
+                                         uint32_t dex_pc,
+                                         pid_t tid,
+                                         ThreadState state,
+                                         uint64_t latency_ns) {
+  // Fixed size so that recording from within a suspend all never allocates. When full, the
+  // site with the least total time makes room for the new one.
+  SafepointSite* site = nullptr;
+  SafepointSite* least = nullptr;
+  for (size_t i = 0; i < sites->size; ++i) {
+    SafepointSite* candidate = &sites->sites[i];
+    if (candidate->method == method && candidate->dex_pc == dex_pc) {
+      site = candidate;
+      break;
+    }
+    if (least == nullptr || candidate->total_ns < least->total_ns) {
+      least = candidate;
+    }
+  }
+  if (site == nullptr) {
+    site = (sites->size < kMaxSlowSafepointSites) ? &sites->sites[sites->size++] : least;
+    site->method = method;
+    site->dex_pc = dex_pc;
+    site->count = 0;
+    site->total_ns = 0;
+    site->max_ns = 0;
+  }
+  site->count++;
+  site->total_ns += latency_ns;
+  if (latency_ns > site->max_ns) {
+    site->max_ns = latency_ns;
+    site->slowest_tid = tid;
+    site->slowest_state = state;
+  }
+}
+
+void ThreadList::RemoveSafepointSitesIn(Thread* self, const LinearAlloc& alloc) {
+  MutexLock mu(self, safepoint_latency_lock_);
+  for (SafepointSites* sites : { &slow_suspend_sites_, &slow_checkpoint_sites_ }) {
+    for (size_t i = 0; i < sites->size;) {
+      if (sites->sites[i].method != nullptr && alloc.ContainsUnsafe(sites->sites[i].method)) {
+        sites->sites[i] = sites->sites[--sites->size];
+      } else {
+        ++i;
+      }
+    }
+  }
+}
+
+void ThreadList::DumpSafepointLatencies(std::ostream& os) {
+  ScopedObjectAccess soa(Thread::Current());
+  MutexLock mu(soa.Self(), safepoint_latency_lock_);
+  for (Histogram<uint64_t>* histogram : { &time_to_suspend_histogram_,
+                                          &time_to_checkpoint_histogram_ }) {
+    // Only print if we have samples.
+    if (histogram->SampleSize() > 0) {
+      Histogram<uint64_t>::CumulativeData data;
+      histogram->CreateHistogram(&data);
+      histogram->PrintConfidenceIntervals(os, 0.99, data);
+    }
+  }
+  for (bool is_checkpoint : { false, true }) {
+    const SafepointSites& sites = is_checkpoint ? slow_checkpoint_sites_ : slow_suspend_sites_;
+    if (sites.size == 0) {
+      continue;
+    }
+    std::vector<const SafepointSite*> sorted_sites;
+    for (size_t i = 0; i < sites.size; ++i) {
+      sorted_sites.push_back(&sites.sites[i]);
+    }
+    std::sort(sorted_sites.begin(),
+              sorted_sites.end(),
+              [](const SafepointSite* a, const SafepointSite* b) {
+                return a->total_ns > b->total_ns;
+              });
+    os << "Slow " << (is_checkpoint ? "checkpoint" : "suspend all") << " responses ("
+       << sorted_sites.size() << " sites):\n";
+    for (const SafepointSite* site : sorted_sites) {
+      os << "  " << PrettyMethod(site->method) << " dex_pc=" << site->dex_pc
+         << " count=" << site->count
+         << " total=" << PrettyDuration(site->total_ns)
+         << " max=" << PrettyDuration(site->max_ns)
+         << " slowest=tid " << site->slowest_tid << " (" << site->slowest_state << ")\n";
+    }
+  }
+}
+
 #if MTK_ART_RUNTIME_FUTEX_USAGE_FIX && ART_USE_FUTEXES
 static bool ComputeRelativeTimeSpec(timespec* result_ts, const timespec& lhs, const timespec& rhs) {
   const int32_t one_sec = 1000 * 1000 * 1000;  // one second in nanoseconds.
@@ -581,6 +759,7 @@ void ThreadList::SuspendAllInternal(Thread* self,
     if (debug_suspend)
       ++debug_suspend_all_count_;
     pending_threads.StoreRelaxed(list_.size() - num_ignored);
+    const uint64_t request_time = NanoTime();
     // Increment everybody's suspend count (except those that should be ignored).
     for (const auto& thread : list_) {
       if (thread == ignore1 || thread == ignore2) {
@@ -613,6 +792,11 @@ void ThreadList::SuspendAllInternal(Thread* self,
         // Only clear the counter for the current thread.
         thread->ClearSuspendBarrier(&pending_threads);
         pending_threads.FetchAndSubSequentiallyConsistent(1);
+        thread->last_suspend_latency_ns_ = 0;
+      } else if (thread->suspend_request_time_ns_ == 0) {
+        // The thread records how long it took when it passes the barrier.
+        thread->suspend_request_time_ns_ = request_time;
+        thread->suspend_request_state_ = thread->GetState();
       }
     }
   }
@@ -1001,6 +1185,8 @@ void ThreadList::SuspendAllForDebugger() {
   Locks::mutator_lock_->ExclusiveLock(self);
   Locks::mutator_lock_->ExclusiveUnlock(self);
 #endif
+  // Debugger suspensions are not counted in the time-to-suspend statistics.
+  ClearSuspendLatencies(self);
   // Disabled for the following race condition:
   // Thread 1 calls SuspendAllForDebugger, gets preempted after pulsing the mutator lock.
   // Thread 2 calls SuspendAll and SetStateUnsafe (perhaps from Dbg::Disconnected).
@@ -1262,6 +1448,7 @@ void ThreadList::Register(Thread* self) {
   }
   CHECK(!Contains(self));
   list_.push_back(self);
+  self->SetBiasLocks(Monitor::IsBiasedLockingEnabled());
   if (kUseReadBarrier) {
     // Initialize according to the state of the CC collector.
     bool is_gc_marking =
@@ -23,6 +23,7 @@
 #include "gc_root.h"
 #include "jni.h"
 #include "object_callbacks.h"
+#include "thread_state.h"
 
 #include <bitset>
 #include <list>
@@ -33,7 +34,9 @@ namespace gc {
     class GarbageCollector;
   }  // namespac collector
 }  // namespace gc
+class ArtMethod;
 class Closure;
+class LinearAlloc;
 class Thread;
 class TimingLogger;
 
@@ -69,6 +72,12 @@ class ThreadList {
                !Locks::thread_suspend_count_lock_,
                !Locks::mutator_lock_);
 
+  // Returns the number of times SuspendAll has suspended all threads. Threads that were runnable
+  // when the count was read have all passed a suspend point once it has increased.
+  uint64_t GetSuspendAllEpoch() const {
+    return suspend_all_epoch_.LoadRelaxed();
+  }
+
   // Suspend a thread using a peer, typically used by the debugger. Returns the thread on success,
   // else null. The peer is used to identify the thread to avoid races with the thread terminating.
   // If the thread should be suspended then value of request_suspension should be true otherwise
@@ -152,6 +161,18 @@ class ThreadList {
   void DumpNativeStacks(std::ostream& os)
       REQUIRES(!Locks::thread_list_lock_);
 
+  // Record that self took latency_ns from a checkpoint request to running it, having been in
+  // request_state when it was made. Called by self while runnable, before running the checkpoint.
+  void RecordTimeToCheckpoint(Thread* self, uint64_t latency_ns, ThreadState request_state)
+      REQUIRES(!safepoint_latency_lock_);
+
+  // Forget the slow sites in methods allocated in alloc, which is about to be freed.
+  void RemoveSafepointSitesIn(Thread* self, const LinearAlloc& alloc)
+      REQUIRES(!safepoint_latency_lock_);
+
+  // Dump the time-to-safepoint histograms and the slowest sites threads responded from.
+  void DumpSafepointLatencies(std::ostream& os) REQUIRES(!safepoint_latency_lock_);
+
  private:
   uint32_t AllocThreadId(Thread* self);
   void ReleaseThreadId(Thread* self, uint32_t id) REQUIRES(!Locks::allocated_thread_ids_lock_);
@@ -182,6 +203,29 @@ class ThreadList {
   void AssertThreadsAreSuspended(Thread* self, Thread* ignore1, Thread* ignore2 = nullptr)
       REQUIRES(!Locks::thread_list_lock_, !Locks::thread_suspend_count_lock_);
 
+  // Record how long each thread took to pass the barrier of the suspend all that just completed,
+  // and where the slowest one was.
+  void RecordTimesToSuspend(Thread* self)
+      REQUIRES(Locks::mutator_lock_,
+               !Locks::thread_list_lock_,
+               !Locks::thread_suspend_count_lock_,
+               !safepoint_latency_lock_);
+
+  // Forget the suspend latencies of a suspend all that does not record them.
+  void ClearSuspendLatencies(Thread* self)
+      REQUIRES(!Locks::thread_list_lock_, !Locks::thread_suspend_count_lock_);
+
+  struct SafepointSites;
+
+  // Add a response from method at dex_pc to sites.
+  void RecordSlowSafepointSite(SafepointSites* sites,
+                               ArtMethod* method,
+                               uint32_t dex_pc,
+                               pid_t tid,
+                               ThreadState state,
+                               uint64_t latency_ns)
+      REQUIRES(safepoint_latency_lock_);
+
   std::bitset<kMaxThreadId> allocated_ids_ GUARDED_BY(Locks::allocated_thread_ids_lock_);
 
   // The actual list of all threads.
@@ -201,6 +245,37 @@ class ThreadList {
   // Whether or not the current thread suspension is long.
   bool long_suspend_;
 
+  // Incremented each time SuspendAll gets exclusive access to the mutator lock.
+  Atomic<uint64_t> suspend_all_epoch_;
+
+  // Guards the time-to-safepoint statistics below.
+  Mutex safepoint_latency_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+
+  // Time from a suspend all or checkpoint request to each thread responding to it. Threads that
+  // were already suspended are not counted.
+  Histogram<uint64_t> time_to_suspend_histogram_ GUARDED_BY(safepoint_latency_lock_);
+  Histogram<uint64_t> time_to_checkpoint_histogram_ GUARDED_BY(safepoint_latency_lock_);
+
+  // Where threads were when they were slow to respond, by method and dex pc. Method names are
+  // only resolved when dumping.
+  static constexpr size_t kMaxSlowSafepointSites = 64;
+  struct SafepointSite {
+    ArtMethod* method;
+    uint32_t dex_pc;
+    uint64_t count;
+    uint64_t total_ns;
+    uint64_t max_ns;
+    // Thread behind max_ns and the state it was in when the request was made.
+    pid_t slowest_tid;
+    ThreadState slowest_state;
+  };
+  struct SafepointSites {
+    size_t size = 0;
+    SafepointSite sites[kMaxSlowSafepointSites];
+  };
+  SafepointSites slow_suspend_sites_ GUARDED_BY(safepoint_latency_lock_);
+  SafepointSites slow_checkpoint_sites_ GUARDED_BY(safepoint_latency_lock_);
+
   friend class Thread;
 
   DISALLOW_COPY_AND_ASSIGN(ThreadList);
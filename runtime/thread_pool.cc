@@ -36,7 +36,8 @@ static constexpr bool kMeasureWaitTime = false;
 ThreadPoolWorker::ThreadPoolWorker(ThreadPool* thread_pool, const std::string& name,
                                    size_t stack_size)
     : thread_pool_(thread_pool),
-      name_(name) {
+      name_(name),
+      thread_(nullptr) {
   // Add an inaccessible page to catch stack overflow.
   stack_size += kPageSize;
   std::string error_msg;
@@ -84,7 +85,12 @@ void ThreadPoolWorker::Run() {
 void* ThreadPoolWorker::Callback(void* arg) {
   ThreadPoolWorker* worker = reinterpret_cast<ThreadPoolWorker*>(arg);
   Runtime* runtime = Runtime::Current();
-  CHECK(runtime->AttachCurrentThread(worker->name_.c_str(), true, nullptr, false));
+  const bool create_peer = worker->thread_pool_->create_peers_;
+  CHECK(runtime->AttachCurrentThread(worker->name_.c_str(),
+                                     true,
+                                     create_peer ? runtime->GetSystemThreadGroup() : nullptr,
+                                     create_peer));
+  worker->thread_ = Thread::Current();
   // Do work until its time to shut down.
   worker->Run();
   runtime->DetachCurrentThread();
@@ -105,7 +111,13 @@ void ThreadPool::RemoveAllTasks(Thread* self) {
   tasks_.clear();
 }
 
-ThreadPool::ThreadPool(const char* name, size_t num_threads)
+ThreadPool::ThreadPool(const char* name, size_t num_threads, bool create_peers)
+    : ThreadPool(name, num_threads, create_peers, /* create_workers */ true) {}
+
+ThreadPool::ThreadPool(const char* name,
+                       size_t num_threads,
+                       bool create_peers,
+                       bool create_workers)
   : name_(name),
     task_queue_lock_("task queue lock"),
     task_queue_condition_("task queue condition", task_queue_lock_),
@@ -117,8 +129,15 @@ ThreadPool::ThreadPool(const char* name, size_t num_threads)
     total_wait_time_(0),
     // Add one since the caller of constructor waits on the barrier too.
     creation_barier_(num_threads + 1),
-    max_active_workers_(num_threads) {
-  Thread* self = Thread::Current();
+    max_active_workers_(num_threads),
+    create_peers_(create_peers) {
+  if (create_workers) {
+    CreateWorkers(Thread::Current(), num_threads);
+  }
+}
+
+void ThreadPool::CreateWorkers(Thread* self, size_t num_threads) {
+  DCHECK_EQ(GetThreadCount(), 0U);
   while (GetThreadCount() < num_threads) {
     const std::string worker_name = StringPrintf("%s worker thread %zu", name_.c_str(),
                                                  GetThreadCount());
@@ -136,8 +155,11 @@ void ThreadPool::SetMaxActiveWorkers(size_t threads) {
 }
 
 ThreadPool::~ThreadPool() {
+  DeleteWorkers(Thread::Current());
+}
+
+void ThreadPool::DeleteWorkers(Thread* self) {
   {
-    Thread* self = Thread::Current();
     MutexLock mu(self, task_queue_lock_);
     // Tell any remaining workers to shut down.
     shutting_down_ = true;
@@ -177,7 +199,7 @@ Task* ThreadPool::GetTask(Thread* self) {
     }
 
     ++waiting_count_;
-    if (waiting_count_ == GetThreadCount() && tasks_.empty()) {
+    if (waiting_count_ == GetThreadCount() && !HasQueuedTasksLocked()) {
       // We may be done, lets broadcast to the completion condition.
       completion_condition_.Broadcast(self);
     }
@@ -218,7 +240,7 @@ void ThreadPool::Wait(Thread* self, bool do_work, bool may_hold_locks) {
   }
   // Wait until each thread is waiting and the task list is empty.
   MutexLock mu(self, task_queue_lock_);
-  while (!shutting_down_ && (waiting_count_ != GetThreadCount() || !tasks_.empty())) {
+  while (!shutting_down_ && (waiting_count_ != GetThreadCount() || HasQueuedTasksLocked())) {
     if (!may_hold_locks) {
       completion_condition_.Wait(self);
     } else {
@@ -238,4 +260,288 @@ void ThreadPool::SetPthreadPriority(int priority) {
   }
 }
 
+// Bounded Chase-Lev deque, see "Correct and Efficient Work-Stealing for Weak Memory Models"
+// (Le et al., PPoPP 2013). The owning worker pushes and pops at the bottom, any thread may steal
+// from the top. Push fails when the deque is full and the caller falls back to the shared queue.
+class WorkStealingTaskDeque {
+ public:
+  WorkStealingTaskDeque() : bottom_(0), top_(0) {
+    for (Atomic<Task*>& slot : tasks_) {
+      slot.StoreRelaxed(nullptr);
+    }
+  }
+
+  // Owner only.
+  bool Push(Task* task) {
+    const int64_t bottom = bottom_.LoadRelaxed();
+    const int64_t top = top_.LoadAcquire();
+    if (bottom - top >= static_cast<int64_t>(kCapacity)) {
+      return false;
+    }
+    tasks_[bottom & kMask].StoreRelaxed(task);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.StoreRelaxed(bottom + 1);
+    return true;
+  }
+
+  // Owner only.
+  Task* Pop() {
+    const int64_t bottom = bottom_.LoadRelaxed() - 1;
+    bottom_.StoreRelaxed(bottom);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t top = top_.LoadRelaxed();
+    Task* task = nullptr;
+    if (top <= bottom) {
+      task = tasks_[bottom & kMask].LoadRelaxed();
+      if (top == bottom) {
+        // Last task, race the thieves for it.
+        if (!top_.CompareExchangeStrongSequentiallyConsistent(top, top + 1)) {
+          task = nullptr;
+        }
+        bottom_.StoreRelaxed(bottom + 1);
+      }
+    } else {
+      bottom_.StoreRelaxed(bottom + 1);
+    }
+    return task;
+  }
+
+  // Any thread. Returns null if the deque is empty or another thread won the race for the task.
+  Task* Steal() {
+    const int64_t top = top_.LoadAcquire();
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t bottom = bottom_.LoadAcquire();
+    if (top < bottom) {
+      Task* task = tasks_[top & kMask].LoadRelaxed();
+      if (top_.CompareExchangeStrongSequentiallyConsistent(top, top + 1)) {
+        return task;
+      }
+    }
+    return nullptr;
+  }
+
+  // Racy unless the owner is not running.
+  bool IsEmpty() const {
+    return top_.LoadAcquire() >= bottom_.LoadAcquire();
+  }
+
+ private:
+  static constexpr size_t kCapacity = 1024;
+  static constexpr int64_t kMask = kCapacity - 1;
+  static_assert(IsPowerOfTwo(kCapacity), "Deque capacity must be a power of two");
+
+  // The owner writes bottom_ and thieves write top_; the slots keep them on different cache lines.
+  Atomic<int64_t> bottom_;
+  Atomic<Task*> tasks_[kCapacity];
+  Atomic<int64_t> top_;
+
+  DISALLOW_COPY_AND_ASSIGN(WorkStealingTaskDeque);
+};
+
+// How many tasks a worker moves from the shared queue into its deque at a time.
+static constexpr size_t kSharedTaskBatchSize = 8;
+
+WorkStealingThreadPool::WorkStealingThreadPool(const char* name, size_t num_threads)
+    : ThreadPool(name, num_threads, /* create_peers */ false, /* create_workers */ false),
+      running_(false),
+      active_worker_limit_(num_threads),
+      deque_task_count_(0),
+      idle_worker_count_(0),
+      steal_count_(0),
+      worker_threads_published_(false) {
+  for (size_t i = 0; i < num_threads; ++i) {
+    deques_.emplace_back(new WorkStealingTaskDeque());
+  }
+  CreateWorkers(Thread::Current(), num_threads);
+  // The workers have attached, remember their threads. Unlike threads_, this stays intact while
+  // DeleteWorkers joins the workers one by one.
+  for (ThreadPoolWorker* worker : threads_) {
+    worker_threads_.push_back(worker->thread_);
+  }
+  worker_threads_published_.StoreRelease(true);
+  Thread* self = Thread::Current();
+  MutexLock mu(self, task_queue_lock_);
+  task_queue_condition_.Broadcast(self);
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+  // Join the workers while the deques are still alive.
+  DeleteWorkers(Thread::Current());
+}
+
+size_t WorkStealingThreadPool::GetWorkerIndex(Thread* self) const {
+  // Pools are small, a linear scan is cheaper than anything keyed on the thread.
+  for (size_t i = 0, count = worker_threads_.size(); i != count; ++i) {
+    if (worker_threads_[i] == self) {
+      return i;
+    }
+  }
+  return kNotAWorker;
+}
+
+void WorkStealingThreadPool::StartWorkers(Thread* self) {
+  running_.StoreSequentiallyConsistent(true);
+  ThreadPool::StartWorkers(self);
+}
+
+void WorkStealingThreadPool::StopWorkers(Thread* self) {
+  ThreadPool::StopWorkers(self);
+  running_.StoreSequentiallyConsistent(false);
+}
+
+void WorkStealingThreadPool::SetMaxActiveWorkers(size_t threads) {
+  ThreadPool::SetMaxActiveWorkers(threads);
+  active_worker_limit_.StoreRelaxed(threads);
+}
+
+void WorkStealingThreadPool::AddTask(Thread* self, Task* task) {
+  const size_t index = GetWorkerIndex(self);
+  if (index == kNotAWorker) {
+    ThreadPool::AddTask(self, task);
+    return;
+  }
+  // Count the task before it becomes visible so that the count never underflows.
+  deque_task_count_.FetchAndAddSequentiallyConsistent(1);
+  if (!deques_[index]->Push(task)) {
+    deque_task_count_.FetchAndSubSequentiallyConsistent(1);
+    ThreadPool::AddTask(self, task);
+    return;
+  }
+  // Pairs with the idle count increment in GetTask: either the idle worker sees the new task or we
+  // see the idle worker and wake it up.
+  if (idle_worker_count_.LoadSequentiallyConsistent() != 0 && running_.LoadRelaxed()) {
+    MutexLock mu(self, task_queue_lock_);
+    task_queue_condition_.Signal(self);
+  }
+}
+
+void WorkStealingThreadPool::RemoveAllTasks(Thread* self) {
+  MutexLock mu(self, task_queue_lock_);
+  tasks_.clear();
+  for (std::unique_ptr<WorkStealingTaskDeque>& deque : deques_) {
+    while (!deque->IsEmpty()) {
+      if (deque->Steal() != nullptr) {
+        deque_task_count_.FetchAndSubSequentiallyConsistent(1);
+      }
+    }
+  }
+}
+
+size_t WorkStealingThreadPool::GetTaskCount(Thread* self) {
+  MutexLock mu(self, task_queue_lock_);
+  return tasks_.size() + deque_task_count_.LoadSequentiallyConsistent();
+}
+
+bool WorkStealingThreadPool::HasQueuedTasksLocked() const {
+  return !tasks_.empty() || deque_task_count_.LoadSequentiallyConsistent() != 0;
+}
+
+Task* WorkStealingThreadPool::TrySteal(size_t thief_index) {
+  const size_t count = deques_.size();
+  // Start after the thief so that thieves spread over the victims.
+  const size_t start = (thief_index == kNotAWorker) ? 0 : thief_index + 1;
+  for (size_t i = 0; i != count; ++i) {
+    const size_t victim = (start + i) % count;
+    if (victim == thief_index) {
+      continue;
+    }
+    Task* task = deques_[victim]->Steal();
+    if (task != nullptr) {
+      deque_task_count_.FetchAndSubSequentiallyConsistent(1);
+      steal_count_.FetchAndAddRelaxed(1);
+      return task;
+    }
+  }
+  return nullptr;
+}
+
+Task* WorkStealingThreadPool::TryGetSharedTasks(Thread* self, size_t index) {
+  MutexLock mu(self, task_queue_lock_);
+  Task* task = TryGetTaskLocked();
+  if (task != nullptr && index != kNotAWorker) {
+    for (size_t i = 1; i < kSharedTaskBatchSize && !tasks_.empty(); ++i) {
+      deque_task_count_.FetchAndAddSequentiallyConsistent(1);
+      if (!deques_[index]->Push(tasks_.front())) {
+        deque_task_count_.FetchAndSubSequentiallyConsistent(1);
+        break;
+      }
+      tasks_.pop_front();
+    }
+    // Let a sleeping worker steal from the batch.
+    if (!deques_[index]->IsEmpty() && idle_worker_count_.LoadSequentiallyConsistent() != 0) {
+      task_queue_condition_.Signal(self);
+    }
+  }
+  return task;
+}
+
+Task* WorkStealingThreadPool::TryGetTaskForWorker(Thread* self, size_t index) {
+  Task* task = deques_[index]->Pop();
+  if (task != nullptr) {
+    deque_task_count_.FetchAndSubSequentiallyConsistent(1);
+    return task;
+  }
+  // Draining the shared queue refills our own deque, only steal once it is empty.
+  task = TryGetSharedTasks(self, index);
+  if (task != nullptr) {
+    return task;
+  }
+  return TrySteal(index);
+}
+
+Task* WorkStealingThreadPool::TryGetTask(Thread* self) {
+  if (!running_.LoadRelaxed()) {
+    return nullptr;
+  }
+  const size_t index = GetWorkerIndex(self);
+  if (index != kNotAWorker) {
+    return TryGetTaskForWorker(self, index);
+  }
+  // Threads outside the pool (e.g. in Wait) help by taking shared tasks first, then stealing.
+  Task* task = TryGetSharedTasks(self, kNotAWorker);
+  return (task != nullptr) ? task : TrySteal(kNotAWorker);
+}
+
+Task* WorkStealingThreadPool::GetTask(Thread* self) {
+  if (UNLIKELY(!worker_threads_published_.LoadAcquire())) {
+    // The workers were released before the constructor recorded their threads.
+    MutexLock mu(self, task_queue_lock_);
+    while (!worker_threads_published_.LoadAcquire()) {
+      task_queue_condition_.Wait(self);
+    }
+  }
+  const size_t index = GetWorkerIndex(self);
+  DCHECK_NE(index, static_cast<size_t>(kNotAWorker));
+  while (true) {
+    if (running_.LoadRelaxed() && index < active_worker_limit_.LoadRelaxed()) {
+      Task* task = TryGetTaskForWorker(self, index);
+      if (task != nullptr) {
+        return task;
+      }
+    }
+    MutexLock mu(self, task_queue_lock_);
+    if (IsShuttingDown()) {
+      // We are shutting down, return null to tell the worker thread to stop looping.
+      return nullptr;
+    }
+    idle_worker_count_.FetchAndAddSequentiallyConsistent(1);
+    // Re-check now that AddTask from another worker would see us as idle.
+    if (!started_ || index >= max_active_workers_ || !HasQueuedTasksLocked()) {
+      ++waiting_count_;
+      if (waiting_count_ == GetThreadCount() && !HasQueuedTasksLocked()) {
+        // We may be done, lets broadcast to the completion condition.
+        completion_condition_.Broadcast(self);
+      }
+      const uint64_t wait_start = kMeasureWaitTime ? NanoTime() : 0;
+      task_queue_condition_.Wait(self);
+      if (kMeasureWaitTime) {
+        const uint64_t wait_end = NanoTime();
+        total_wait_time_ += wait_end - std::max(wait_start, start_time_);
+      }
+      --waiting_count_;
+    }
+    idle_worker_count_.FetchAndSubSequentiallyConsistent(1);
+  }
+}
+
 }  // namespace art
@@ -20,6 +20,7 @@
 #include <deque>
 #include <vector>
 
+#include "atomic.h"
 #include "barrier.h"
 #include "base/mutex.h"
 #include "mem_map.h"
@@ -71,9 +72,12 @@ class ThreadPoolWorker {
   const std::string name_;
   std::unique_ptr<MemMap> stack_;
   pthread_t pthread_;
+  // The attached runtime thread, set before the worker waits on the creation barrier.
+  Thread* thread_;
 
  private:
   friend class ThreadPool;
+  friend class WorkStealingThreadPool;
   DISALLOW_COPY_AND_ASSIGN(ThreadPoolWorker);
 };
 
@@ -85,25 +89,27 @@ class ThreadPool {
   }
 
   // Broadcast to the workers and tell them to empty out the work queue.
-  void StartWorkers(Thread* self) REQUIRES(!task_queue_lock_);
+  virtual void StartWorkers(Thread* self) REQUIRES(!task_queue_lock_);
 
   // Do not allow workers to grab any new tasks.
-  void StopWorkers(Thread* self) REQUIRES(!task_queue_lock_);
+  virtual void StopWorkers(Thread* self) REQUIRES(!task_queue_lock_);
 
   // Add a new task, the first available started worker will process it. Does not delete the task
   // after running it, it is the caller's responsibility.
-  void AddTask(Thread* self, Task* task) REQUIRES(!task_queue_lock_);
+  virtual void AddTask(Thread* self, Task* task) REQUIRES(!task_queue_lock_);
 
   // Remove all tasks in the queue.
-  void RemoveAllTasks(Thread* self) REQUIRES(!task_queue_lock_);
+  virtual void RemoveAllTasks(Thread* self) REQUIRES(!task_queue_lock_);
 
-  ThreadPool(const char* name, size_t num_threads);
+  // If create_peers is true, the workers get a java.lang.Thread peer so that tasks may call into
+  // Java, e.g. to load classes through a class loader.
+  ThreadPool(const char* name, size_t num_threads, bool create_peers = false);
   virtual ~ThreadPool();
 
   // Wait for all tasks currently on queue to get completed.
   void Wait(Thread* self, bool do_work, bool may_hold_locks) REQUIRES(!task_queue_lock_);
 
-  size_t GetTaskCount(Thread* self) REQUIRES(!task_queue_lock_);
+  virtual size_t GetTaskCount(Thread* self) REQUIRES(!task_queue_lock_);
 
   // Returns the total amount of workers waited for tasks.
   uint64_t GetWaitTime() const {
@@ -112,19 +118,35 @@ class ThreadPool {
 
   // Provides a way to bound the maximum number of worker threads, threads must be less the the
   // thread count of the thread pool.
-  void SetMaxActiveWorkers(size_t threads) REQUIRES(!task_queue_lock_);
+  virtual void SetMaxActiveWorkers(size_t threads) REQUIRES(!task_queue_lock_);
 
   // Set the "nice" priorty for threads in the pool.
   void SetPthreadPriority(int priority);
 
  protected:
+  // Subclasses that need their own state set up before the workers start pass false and call
+  // CreateWorkers() at the end of their constructor.
+  ThreadPool(const char* name, size_t num_threads, bool create_peers, bool create_workers);
+
+  // Start the workers and wait for all of them to attach.
+  void CreateWorkers(Thread* self, size_t num_threads);
+
+  // Tell the workers to shut down and join them. Subclasses call this from their destructor so
+  // that no worker touches subclass state after it is gone.
+  void DeleteWorkers(Thread* self) REQUIRES(!task_queue_lock_);
+
   // get a task to run, blocks if there are no tasks left
   virtual Task* GetTask(Thread* self) REQUIRES(!task_queue_lock_);
 
   // Try to get a task, returning null if there is none available.
-  Task* TryGetTask(Thread* self) REQUIRES(!task_queue_lock_);
+  virtual Task* TryGetTask(Thread* self) REQUIRES(!task_queue_lock_);
   Task* TryGetTaskLocked() REQUIRES(task_queue_lock_);
 
+  // Are there tasks queued that have not been handed out yet?
+  virtual bool HasQueuedTasksLocked() const REQUIRES(task_queue_lock_) {
+    return !tasks_.empty();
+  }
+
   // Are we shutting down?
   bool IsShuttingDown() const REQUIRES(task_queue_lock_) {
     return shutting_down_;
@@ -146,6 +168,7 @@ class ThreadPool {
   uint64_t total_wait_time_;
   Barrier creation_barier_;
   size_t max_active_workers_ GUARDED_BY(task_queue_lock_);
+  const bool create_peers_;
 
  private:
   friend class ThreadPoolWorker;
@@ -153,6 +176,64 @@ class ThreadPool {
   DISALLOW_COPY_AND_ASSIGN(ThreadPool);
 };
 
+class WorkStealingTaskDeque;
+
+// A thread pool where every worker has its own task deque. Tasks added by a worker (e.g. a task
+// splitting its work) go to that worker's deque and are popped LIFO without taking
+// task_queue_lock_; idle workers steal FIFO from the other deques. Tasks added from outside the
+// pool go to the shared tasks_ queue, which workers drain in small batches into their deques.
+class WorkStealingThreadPool : public ThreadPool {
+ public:
+  WorkStealingThreadPool(const char* name, size_t num_threads);
+  virtual ~WorkStealingThreadPool();
+
+  void StartWorkers(Thread* self) OVERRIDE REQUIRES(!task_queue_lock_);
+  void StopWorkers(Thread* self) OVERRIDE REQUIRES(!task_queue_lock_);
+  void AddTask(Thread* self, Task* task) OVERRIDE REQUIRES(!task_queue_lock_);
+  void RemoveAllTasks(Thread* self) OVERRIDE REQUIRES(!task_queue_lock_);
+  size_t GetTaskCount(Thread* self) OVERRIDE REQUIRES(!task_queue_lock_);
+  void SetMaxActiveWorkers(size_t threads) OVERRIDE REQUIRES(!task_queue_lock_);
+
+  // Returns how many tasks were taken from another worker's deque.
+  uint64_t GetStealCount() const {
+    return steal_count_.LoadRelaxed();
+  }
+
+ protected:
+  Task* GetTask(Thread* self) OVERRIDE REQUIRES(!task_queue_lock_);
+  Task* TryGetTask(Thread* self) OVERRIDE REQUIRES(!task_queue_lock_);
+  bool HasQueuedTasksLocked() const OVERRIDE REQUIRES(task_queue_lock_);
+
+ private:
+  static constexpr size_t kNotAWorker = static_cast<size_t>(-1);
+
+  // Returns the index of the worker running on self, or kNotAWorker.
+  size_t GetWorkerIndex(Thread* self) const;
+
+  // Own deque, then the shared queue, then the other workers' deques.
+  Task* TryGetTaskForWorker(Thread* self, size_t index) REQUIRES(!task_queue_lock_);
+  // Move up to a batch of tasks from the shared queue into the deque of worker index (if any) and
+  // return the first one.
+  Task* TryGetSharedTasks(Thread* self, size_t index) REQUIRES(!task_queue_lock_);
+  Task* TrySteal(size_t thief_index);
+
+  // One deque per worker, indexed like threads_.
+  std::vector<std::unique_ptr<WorkStealingTaskDeque>> deques_;
+  std::vector<Thread*> worker_threads_;
+  // Mirrors of started_ and max_active_workers_ that workers read without the lock.
+  Atomic<bool> running_;
+  Atomic<size_t> active_worker_limit_;
+  // Number of tasks in all the deques.
+  Atomic<size_t> deque_task_count_;
+  // Number of workers going to sleep or sleeping on task_queue_condition_.
+  Atomic<size_t> idle_worker_count_;
+  Atomic<uint64_t> steal_count_;
+  // Set once worker_threads_ is filled in.
+  Atomic<bool> worker_threads_published_;
+
+  DISALLOW_COPY_AND_ASSIGN(WorkStealingThreadPool);
+};
+
 }  // namespace art
 
 #endif  // ART_RUNTIME_THREAD_POOL_H_
@@ -136,4 +136,59 @@ TEST_F(ThreadPoolTest, RecursiveTest) {
   EXPECT_EQ((1 << depth) - 1, count.LoadSequentiallyConsistent());
 }
 
+TEST_F(ThreadPoolTest, WorkStealingCheckRun) {
+  Thread* self = Thread::Current();
+  WorkStealingThreadPool thread_pool("Work stealing thread pool test thread pool", num_threads);
+  AtomicInteger count(0);
+  static const int32_t num_tasks = num_threads * 4;
+  for (int32_t i = 0; i < num_tasks; ++i) {
+    thread_pool.AddTask(self, new CountTask(&count));
+  }
+  EXPECT_EQ(static_cast<size_t>(num_tasks), thread_pool.GetTaskCount(self));
+  thread_pool.StartWorkers(self);
+  thread_pool.Wait(self, true, false);
+  EXPECT_EQ(num_tasks, count.LoadSequentiallyConsistent());
+  EXPECT_EQ(0U, thread_pool.GetTaskCount(self));
+}
+
+TEST_F(ThreadPoolTest, WorkStealingStopStart) {
+  Thread* self = Thread::Current();
+  WorkStealingThreadPool thread_pool("Work stealing thread pool test thread pool", num_threads);
+  AtomicInteger count(0);
+  static const int32_t num_tasks = num_threads * 4;
+  for (int32_t i = 0; i < num_tasks; ++i) {
+    thread_pool.AddTask(self, new CountTask(&count));
+  }
+  usleep(200);
+  // Check that no threads started prematurely.
+  EXPECT_EQ(0, count.LoadSequentiallyConsistent());
+  thread_pool.StartWorkers(self);
+  usleep(200);
+  thread_pool.StopWorkers(self);
+  AtomicInteger bad_count(0);
+  thread_pool.AddTask(self, new CountTask(&bad_count));
+  usleep(200);
+  // Ensure that the task added after the workers were stopped doesn't get run.
+  EXPECT_EQ(0, bad_count.LoadSequentiallyConsistent());
+  // Allow tasks to finish up and delete themselves.
+  thread_pool.StartWorkers(self);
+  thread_pool.Wait(self, false, false);
+  EXPECT_EQ(num_tasks, count.LoadSequentiallyConsistent());
+  EXPECT_EQ(1, bad_count.LoadSequentiallyConsistent());
+}
+
+// Tasks added by the workers go to their own deques, deep enough to overflow them into the shared
+// queue and to give idle workers something to steal.
+TEST_F(ThreadPoolTest, WorkStealingRecursiveTest) {
+  Thread* self = Thread::Current();
+  WorkStealingThreadPool thread_pool("Work stealing thread pool test thread pool", num_threads);
+  AtomicInteger count(0);
+  static const int depth = 14;
+  thread_pool.AddTask(self, new TreeTask(&thread_pool, &count, depth));
+  thread_pool.StartWorkers(self);
+  thread_pool.Wait(self, true, false);
+  EXPECT_EQ((1 << depth) - 1, count.LoadSequentiallyConsistent());
+  EXPECT_EQ(0U, thread_pool.GetTaskCount(self));
+}
+
 }  // namespace art
@@ -19,10 +19,13 @@
 
 #include "dex_cache_arrays_layout.h"
 
+#include <algorithm>
+
 #include "base/bit_utils.h"
 #include "base/logging.h"
 #include "gc_root.h"
 #include "globals.h"
+#include "mirror/dex_cache.h"
 #include "primitive.h"
 
 namespace art {
@@ -49,10 +52,12 @@ inline DexCacheArraysLayout::DexCacheArraysLayout(size_t pointer_size, const Dex
 inline size_t DexCacheArraysLayout::Alignment() const {
   // GcRoot<> alignment is 4, i.e. lower than or equal to the pointer alignment.
   static_assert(alignof(GcRoot<mirror::Class>) == 4, "Expecting alignof(GcRoot<>) == 4");
-  static_assert(alignof(GcRoot<mirror::String>) == 4, "Expecting alignof(GcRoot<>) == 4");
   DCHECK(pointer_size_ == 4u || pointer_size_ == 8u);
-  // Pointer alignment is the same as pointer size.
-  return pointer_size_;
+  // Pointer alignment is the same as pointer size. The pairs of a hashed strings array are
+  // 8-byte aligned, i.e. higher than or equal to the pointer alignment.
+  static_assert(alignof(mirror::StringDexCacheType) == (kUseHashedDexCacheStrings ? 8u : 4u),
+                "Unexpected alignof(StringDexCacheType)");
+  return std::max(pointer_size_, alignof(mirror::StringDexCacheType));
 }
 
 inline size_t DexCacheArraysLayout::TypeOffset(uint32_t type_idx) const {
@@ -83,15 +88,17 @@ inline size_t DexCacheArraysLayout::MethodsAlignment() const {
 }
 
 inline size_t DexCacheArraysLayout::StringOffset(uint32_t string_idx) const {
-  return strings_offset_ + ElementOffset(sizeof(GcRoot<mirror::String>), string_idx);
+  return strings_offset_ + ElementOffset(sizeof(mirror::StringDexCacheType),
+                                         mirror::DexCache::StringSlotIndex(string_idx));
 }
 
 inline size_t DexCacheArraysLayout::StringsSize(size_t num_elements) const {
-  return ArraySize(sizeof(GcRoot<mirror::String>), num_elements);
+  return ArraySize(sizeof(mirror::StringDexCacheType),
+                   mirror::DexCache::StringsArraySize(num_elements));
 }
 
 inline size_t DexCacheArraysLayout::StringsAlignment() const {
-  return alignof(GcRoot<mirror::String>);
+  return alignof(mirror::StringDexCacheType);
 }
 
 inline size_t DexCacheArraysLayout::FieldOffset(uint32_t field_idx) const {
@@ -25,6 +25,7 @@ namespace art {
  * @class DexCacheArraysLayout
  * @details This class provides the layout information for the type, method, field and
  * string arrays for a DexCache with a fixed arrays' layout (such as in the boot image),
+ * where the strings array may be a fixed-size hashed cache (see mirror::StringDexCachePair).
  */
 class DexCacheArraysLayout {
  public:
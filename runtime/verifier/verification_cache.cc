@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "verification_cache.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "base/logging.h"
+#include "base/stringprintf.h"
+#include "base/unix_file/fd_file.h"
+#include "dex_file.h"
+#include "oat.h"
+#include "os.h"
+#include "thread.h"
+
+namespace art {
+namespace verifier {
+
+static constexpr uint8_t kVerificationCacheMagic[] = { 'v', 'f', 'c', '\n' };
+static constexpr uint8_t kVerificationCacheVersion[] = { '0', '0', '1', '\0' };
+
+struct VerificationCache::Header {
+  uint8_t magic[4];
+  uint8_t version[4];
+  // Results are only valid for the runtime that computed them.
+  uint8_t oat_version[4];
+  uint32_t dex_checksum;
+  uint32_t class_path_checksum;
+  uint32_t num_class_defs;
+};
+
+static size_t NumWords(uint32_t num_class_defs) {
+  return (num_class_defs + 31u) / 32u;
+}
+
+VerificationCache::VerificationCache(const DexFile& dex_file, const std::string& filename)
+    : filename_(filename),
+      dex_checksum_(dex_file.GetLocationChecksum()),
+      num_class_defs_(dex_file.NumClassDefs()),
+      lock_("verification cache lock"),
+      class_path_state_(kClassPathUnknown),
+      class_path_checksum_(0u),
+      file_class_path_checksum_(0u),
+      verified_(NumWords(num_class_defs_), 0u),
+      dirty_(false) {}
+
+std::unique_ptr<VerificationCache> VerificationCache::Create(const DexFile& dex_file,
+                                                             const std::string& filename) {
+  std::unique_ptr<VerificationCache> cache(new VerificationCache(dex_file, filename));
+  cache->Read();
+  return cache;
+}
+
+void VerificationCache::Read() {
+  std::unique_ptr<File> file(OS::OpenFileForReading(filename_.c_str()));
+  if (file == nullptr) {
+    return;
+  }
+  Header header;
+  std::vector<uint32_t> verified(NumWords(num_class_defs_));
+  if (!file->ReadFully(&header, sizeof(header)) ||
+      memcmp(header.magic, kVerificationCacheMagic, sizeof(header.magic)) != 0 ||
+      memcmp(header.version, kVerificationCacheVersion, sizeof(header.version)) != 0 ||
+      memcmp(header.oat_version, OatHeader::kOatVersion, sizeof(header.oat_version)) != 0 ||
+      header.dex_checksum != dex_checksum_ ||
+      header.num_class_defs != num_class_defs_ ||
+      !file->ReadFully(verified.data(), verified.size() * sizeof(uint32_t))) {
+    VLOG(verifier) << "Ignoring stale verification cache " << filename_;
+    return;
+  }
+  MutexLock mu(Thread::Current(), lock_);
+  file_class_path_checksum_ = header.class_path_checksum;
+  verified_.swap(verified);
+}
+
+void VerificationCache::SetClassPathChecksum(uint32_t class_path_checksum) {
+  MutexLock mu(Thread::Current(), lock_);
+  if (class_path_state_ != kClassPathUnknown) {
+    return;
+  }
+  class_path_state_ = kClassPathChecksummed;
+  class_path_checksum_ = class_path_checksum;
+  if (file_class_path_checksum_ != class_path_checksum) {
+    VLOG(verifier) << "Class path changed, dropping verification cache " << filename_;
+    std::fill(verified_.begin(), verified_.end(), 0u);
+  }
+}
+
+void VerificationCache::SetClassPathUnsupported() {
+  MutexLock mu(Thread::Current(), lock_);
+  if (class_path_state_ != kClassPathUnknown) {
+    return;
+  }
+  class_path_state_ = kClassPathUnsupported;
+  std::fill(verified_.begin(), verified_.end(), 0u);
+}
+
+bool VerificationCache::NeedsClassPathChecksum() {
+  MutexLock mu(Thread::Current(), lock_);
+  return class_path_state_ == kClassPathUnknown;
+}
+
+bool VerificationCache::IsVerified(uint16_t class_def_index) {
+  DCHECK_LT(class_def_index, num_class_defs_);
+  MutexLock mu(Thread::Current(), lock_);
+  return class_path_state_ == kClassPathChecksummed &&
+      (verified_[class_def_index / 32u] & (1u << (class_def_index % 32u))) != 0u;
+}
+
+void VerificationCache::RecordVerified(uint16_t class_def_index) {
+  DCHECK_LT(class_def_index, num_class_defs_);
+  MutexLock mu(Thread::Current(), lock_);
+  if (class_path_state_ != kClassPathChecksummed) {
+    return;
+  }
+  uint32_t& word = verified_[class_def_index / 32u];
+  const uint32_t bit = 1u << (class_def_index % 32u);
+  if ((word & bit) == 0u) {
+    word |= bit;
+    dirty_ = true;
+  }
+}
+
+bool VerificationCache::Write(std::string* error_msg) {
+  Header header;
+  std::vector<uint32_t> verified;
+  {
+    MutexLock mu(Thread::Current(), lock_);
+    if (!dirty_) {
+      return true;
+    }
+    dirty_ = false;
+    memcpy(header.magic, kVerificationCacheMagic, sizeof(header.magic));
+    memcpy(header.version, kVerificationCacheVersion, sizeof(header.version));
+    memcpy(header.oat_version, OatHeader::kOatVersion, sizeof(header.oat_version));
+    header.dex_checksum = dex_checksum_;
+    header.class_path_checksum = class_path_checksum_;
+    header.num_class_defs = num_class_defs_;
+    verified = verified_;
+  }
+  // Write to a temporary file and rename it, so that readers never see a partial file.
+  const std::string temp_filename = StringPrintf("%s.%d.tmp", filename_.c_str(), getpid());
+  std::unique_ptr<File> file(OS::CreateEmptyFileWriteOnly(temp_filename.c_str()));
+  if (file == nullptr) {
+    *error_msg = StringPrintf("Could not create %s: %s", temp_filename.c_str(), strerror(errno));
+    return false;
+  }
+  if (!file->WriteFully(&header, sizeof(header)) ||
+      !file->WriteFully(verified.data(), verified.size() * sizeof(uint32_t))) {
+    *error_msg = StringPrintf("Could not write %s: %s", temp_filename.c_str(), strerror(errno));
+    file->Erase();
+    return false;
+  }
+  if (file->FlushCloseOrErase() != 0) {
+    *error_msg = StringPrintf("Could not close %s: %s", temp_filename.c_str(), strerror(errno));
+    return false;
+  }
+  if (rename(temp_filename.c_str(), filename_.c_str()) != 0) {
+    *error_msg = StringPrintf("Could not rename %s to %s: %s",
+                              temp_filename.c_str(),
+                              filename_.c_str(),
+                              strerror(errno));
+    unlink(temp_filename.c_str());
+    return false;
+  }
+  return true;
+}
+
+}  // namespace verifier
+}  // namespace art
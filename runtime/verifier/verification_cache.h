@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_VERIFIER_VERIFICATION_CACHE_H_
+#define ART_RUNTIME_VERIFIER_VERIFICATION_CACHE_H_
+
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/mutex.h"
+
+namespace art {
+
+class DexFile;
+
+namespace verifier {
+
+// Results of verifying the classes of a dex file at runtime, persisted across runs for dex files
+// whose oat file does not record them, e.g. when running from a raw dex file or from an oat file
+// compiled with verify-at-runtime.
+//
+// Only classes that verified without any failure are recorded. Verification results depend on the
+// classes the verifier resolved, so they are tagged with a checksum of the class path the dex file
+// was loaded with (see OatFileManager::ComputeClassPathChecksum) and dropped when it changes.
+class VerificationCache {
+ public:
+  // Creates a cache for `dex_file` backed by `filename`. Results previously written to the file
+  // are kept if the file matches the dex file, but are not used before SetClassPathChecksum.
+  static std::unique_ptr<VerificationCache> Create(const DexFile& dex_file,
+                                                   const std::string& filename);
+
+  // Sets the checksum of the class path the classes are verified against. Drops the results read
+  // from the file if they were computed against another class path.
+  void SetClassPathChecksum(uint32_t class_path_checksum) REQUIRES(!lock_);
+  // Drops all results, for class paths we cannot compute a checksum of.
+  void SetClassPathUnsupported() REQUIRES(!lock_);
+  // Returns true until either of the above has been called.
+  bool NeedsClassPathChecksum() REQUIRES(!lock_);
+
+  bool IsVerified(uint16_t class_def_index) REQUIRES(!lock_);
+  void RecordVerified(uint16_t class_def_index) REQUIRES(!lock_);
+
+  // Writes the results to the backing file if classes were recorded since the last write.
+  bool Write(std::string* error_msg) REQUIRES(!lock_);
+
+ private:
+  struct Header;
+
+  VerificationCache(const DexFile& dex_file, const std::string& filename);
+
+  void Read() REQUIRES(!lock_);
+
+  const std::string filename_;
+  const uint32_t dex_checksum_;
+  const uint32_t num_class_defs_;
+
+  enum ClassPathState {
+    kClassPathUnknown,
+    kClassPathChecksummed,
+    kClassPathUnsupported,
+  };
+
+  Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  ClassPathState class_path_state_ GUARDED_BY(lock_);
+  uint32_t class_path_checksum_ GUARDED_BY(lock_);
+  // Class path checksum of the results read from the file.
+  uint32_t file_class_path_checksum_ GUARDED_BY(lock_);
+  // One bit per class def, set if the class verified without failures.
+  std::vector<uint32_t> verified_ GUARDED_BY(lock_);
+  bool dirty_ GUARDED_BY(lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(VerificationCache);
+};
+
+}  // namespace verifier
+}  // namespace art
+
+#endif  // ART_RUNTIME_VERIFIER_VERIFICATION_CACHE_H_
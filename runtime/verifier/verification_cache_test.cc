@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "verification_cache.h"
+
+#include <memory>
+
+#include "base/unix_file/fd_file.h"
+#include "common_runtime_test.h"
+#include "dex_file.h"
+
+namespace art {
+namespace verifier {
+
+class VerificationCacheTest : public CommonRuntimeTest {};
+
+TEST_F(VerificationCacheTest, WriteAndRead) {
+  std::unique_ptr<const DexFile> dex_file(OpenTestDexFile("Nested"));
+  ASSERT_GT(dex_file->NumClassDefs(), 1u);
+  ScratchFile scratch;
+  std::string error_msg;
+
+  std::unique_ptr<VerificationCache> cache(
+      VerificationCache::Create(*dex_file, scratch.GetFilename()));
+  // Nothing is recorded before the class path is known.
+  EXPECT_TRUE(cache->NeedsClassPathChecksum());
+  cache->RecordVerified(0u);
+  EXPECT_FALSE(cache->IsVerified(0u));
+  cache->SetClassPathChecksum(42u);
+  EXPECT_FALSE(cache->NeedsClassPathChecksum());
+  cache->RecordVerified(1u);
+  EXPECT_FALSE(cache->IsVerified(0u));
+  EXPECT_TRUE(cache->IsVerified(1u));
+  ASSERT_TRUE(cache->Write(&error_msg)) << error_msg;
+
+  // Results are only used against the same class path.
+  cache = VerificationCache::Create(*dex_file, scratch.GetFilename());
+  EXPECT_FALSE(cache->IsVerified(1u));
+  cache->SetClassPathChecksum(42u);
+  EXPECT_FALSE(cache->IsVerified(0u));
+  EXPECT_TRUE(cache->IsVerified(1u));
+
+  cache = VerificationCache::Create(*dex_file, scratch.GetFilename());
+  cache->SetClassPathChecksum(43u);
+  EXPECT_FALSE(cache->IsVerified(1u));
+
+  cache = VerificationCache::Create(*dex_file, scratch.GetFilename());
+  cache->SetClassPathUnsupported();
+  EXPECT_FALSE(cache->NeedsClassPathChecksum());
+  EXPECT_FALSE(cache->IsVerified(1u));
+  cache->RecordVerified(1u);
+  EXPECT_FALSE(cache->IsVerified(1u));
+}
+
+TEST_F(VerificationCacheTest, IgnoresOtherFiles) {
+  std::unique_ptr<const DexFile> dex_file(OpenTestDexFile("Nested"));
+  ScratchFile scratch;
+  ASSERT_TRUE(scratch.GetFile()->WriteFully("garbage", 7u));
+
+  std::unique_ptr<VerificationCache> cache(
+      VerificationCache::Create(*dex_file, scratch.GetFilename()));
+  cache->SetClassPathChecksum(0u);
+  for (size_t i = 0; i != dex_file->NumClassDefs(); ++i) {
+    EXPECT_FALSE(cache->IsVerified(i));
+  }
+}
+
+}  // namespace verifier
+}  // namespace art
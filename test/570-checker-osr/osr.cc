@@ -15,6 +15,7 @@
  */
 
 #include "art_method-inl.h"
+#include "dex_instruction.h"
 #include "jit/jit.h"
 #include "jit/jit_code_cache.h"
 #include "jit/profiling_info.h"
@@ -161,4 +162,58 @@ extern "C" JNIEXPORT void JNICALL Java_Main_ensureHasOsrCode(JNIEnv* env,
   visitor.WalkStack();
 }
 
+class HotLoopsVisitor : public StackVisitor {
+ public:
+  explicit HotLoopsVisitor(Thread* thread, const char* method_name)
+      SHARED_REQUIRES(Locks::mutator_lock_)
+      : StackVisitor(thread, nullptr, StackVisitor::StackWalkKind::kIncludeInlinedFrames),
+        method_name_(method_name),
+        number_of_hot_loops_(0) {}
+
+  bool VisitFrame() SHARED_REQUIRES(Locks::mutator_lock_) {
+    ArtMethod* m = GetMethod();
+    std::string m_name(m->GetName());
+
+    if (m_name.compare(method_name_) == 0) {
+      ProfilingInfo* info = m->GetProfilingInfo(sizeof(void*));
+      CHECK(info != nullptr);
+      // Collect the loop headers like ProfilingInfo::Create does.
+      std::set<uint32_t> loop_headers;
+      const DexFile::CodeItem* code_item = m->GetCodeItem();
+      for (uint32_t dex_pc = 0; dex_pc < code_item->insns_size_in_code_units_;) {
+        const Instruction* instruction = Instruction::At(&code_item->insns_[dex_pc]);
+        if (instruction->IsBranch() && instruction->GetTargetOffset() <= 0) {
+          loop_headers.insert(dex_pc + instruction->GetTargetOffset());
+        }
+        dex_pc += instruction->SizeInCodeUnits();
+      }
+      for (uint32_t header_dex_pc : loop_headers) {
+        if (info->IsHotLoopHeader(header_dex_pc)) {
+          ++number_of_hot_loops_;
+        }
+      }
+      return false;
+    }
+    return true;
+  }
+
+  const char* const method_name_;
+  int number_of_hot_loops_;
+};
+
+extern "C" JNIEXPORT jint JNICALL Java_Main_getNumberOfHotLoops(JNIEnv* env,
+                                                                jclass,
+                                                                jstring method_name) {
+  if (!Runtime::Current()->UseJitCompilation()) {
+    // Just return the expected value for non-jit configurations.
+    return 1;
+  }
+  ScopedUtfChars chars(env, method_name);
+  CHECK(chars.c_str() != nullptr);
+  ScopedObjectAccess soa(Thread::Current());
+  HotLoopsVisitor visitor(soa.Self(), chars.c_str());
+  visitor.WalkStack();
+  return visitor.number_of_hot_loops_;
+}
+
 }  // namespace art
@@ -78,6 +78,8 @@ public class Main {
 
     $opt$noinline$testOsrInlineLoop(null);
     System.out.println("b28210356 passed.");
+
+    $noinline$hotLoop();
   }
 
   public static int $noinline$returnInt() {
@@ -129,6 +131,27 @@ public class Main {
     DeoptimizationController.startDeoptimization();
   }
 
+  public static void $noinline$hotLoop() {
+    if (doThrow) throw new Error("");
+    int sum = 0;
+    int iterations = 0;
+    while (!isInOsrCode("$noinline$hotLoop")) {
+      // The inner loop takes most of the back edges, and is the only hot loop.
+      for (int i = 0; i < 100; ++i) {
+        sum += i;
+      }
+      if ((++iterations & 0xff) == 0) {
+        for (int i = 0; i < 2; ++i) {
+          sum--;
+        }
+      }
+    }
+    int hotLoops = getNumberOfHotLoops("$noinline$hotLoop");
+    if (hotLoops != 1) {
+      throw new Error("Expected 1 hot loop, got " + hotLoops + " (" + sum + ")");
+    }
+  }
+
   public static Class $noinline$inlineCache(Main m, boolean isSecondInvocation) {
     // If we are running in non-JIT mode, or were unlucky enough to get this method
     // already JITted, just return the expected value.
@@ -300,6 +323,7 @@ public class Main {
   public static native boolean isInInterpreter(String methodName);
   public static native void ensureHasProfilingInfo(String methodName);
   public static native void ensureHasOsrCode(String methodName);
+  public static native int getNumberOfHotLoops(String methodName);
 
   public static boolean doThrow = false;
 }
@@ -0,0 +1,325 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+interface Itf {
+  public int value();
+}
+
+// Implemented together with Itf, this interface makes the IMT slot of Itf.value()
+// a conflict: its methods cover every IMT slot with the default IMT size of 64.
+interface Conflicts {
+  public int conflict0();
+  public int conflict1();
+  public int conflict2();
+  public int conflict3();
+  public int conflict4();
+  public int conflict5();
+  public int conflict6();
+  public int conflict7();
+  public int conflict8();
+  public int conflict9();
+  public int conflict10();
+  public int conflict11();
+  public int conflict12();
+  public int conflict13();
+  public int conflict14();
+  public int conflict15();
+  public int conflict16();
+  public int conflict17();
+  public int conflict18();
+  public int conflict19();
+  public int conflict20();
+  public int conflict21();
+  public int conflict22();
+  public int conflict23();
+  public int conflict24();
+  public int conflict25();
+  public int conflict26();
+  public int conflict27();
+  public int conflict28();
+  public int conflict29();
+  public int conflict30();
+  public int conflict31();
+  public int conflict32();
+  public int conflict33();
+  public int conflict34();
+  public int conflict35();
+  public int conflict36();
+  public int conflict37();
+  public int conflict38();
+  public int conflict39();
+  public int conflict40();
+  public int conflict41();
+  public int conflict42();
+  public int conflict43();
+  public int conflict44();
+  public int conflict45();
+  public int conflict46();
+  public int conflict47();
+  public int conflict48();
+  public int conflict49();
+  public int conflict50();
+  public int conflict51();
+  public int conflict52();
+  public int conflict53();
+  public int conflict54();
+  public int conflict55();
+  public int conflict56();
+  public int conflict57();
+  public int conflict58();
+  public int conflict59();
+  public int conflict60();
+  public int conflict61();
+  public int conflict62();
+  public int conflict63();
+}
+
+public class Main implements Itf {
+  public static void assertEquals(int expected, int actual) {
+    if (expected != actual) {
+      throw new Error("Expected " + expected  + ", got " + actual);
+    }
+  }
+
+  public int value() {
+    return 1;
+  }
+
+  public static void main(String[] args) {
+    System.loadLibrary(args[0]);
+
+    // Seven receiver types, six of which share the same implementation. The
+    // inline caches of the call sites are full, and therefore megamorphic.
+    Main[] mains = new Main[] {
+      new Main(), new Sub1(), new Sub2(), new Sub3(), new Sub4(), new Sub5(), new Other()
+    };
+    // Two implementations shared by two receiver types each, and two other types.
+    Main[] pairs = new Main[] {
+      new PairA1(), new PairA2(), new PairB1(), new PairB2(), new Other(), new Sub1()
+    };
+    // Four receiver types sharing an implementation behind an IMT conflict.
+    Itf[] conflicts = new Itf[] {
+      new ConflictBase(), new ConflictSub1(), new ConflictSub2(), new ConflictSub3(),
+      new Main(), new Other()
+    };
+
+    ensureProfilingInfo(Main.class, "$noinline$testInvokeVirtual");
+    ensureProfilingInfo(Main.class, "$noinline$testInvokeInterface");
+    ensureProfilingInfo(Main.class, "$noinline$testTwoSharedTargets");
+    ensureProfilingInfo(Main.class, "$noinline$testImtConflict");
+    for (int i = 0; i < 20000; ++i) {
+      run(mains, pairs, conflicts);
+    }
+    ensureJitCompiled(Main.class, "$noinline$testInvokeVirtual");
+    ensureJitCompiled(Main.class, "$noinline$testInvokeInterface");
+    ensureJitCompiled(Main.class, "$noinline$testTwoSharedTargets");
+    ensureJitCompiled(Main.class, "$noinline$testImtConflict");
+    // Run the compiled code, including its slow paths.
+    run(mains, pairs, conflicts);
+  }
+
+  private static void run(Main[] mains, Main[] pairs, Itf[] conflicts) {
+    for (int j = 0; j < mains.length; ++j) {
+      int expected = (mains[j] instanceof Other) ? 2 : 1;
+      assertEquals(expected, $noinline$testInvokeVirtual(mains[j]));
+      assertEquals(expected, $noinline$testInvokeInterface(mains[j]));
+    }
+    for (int j = 0; j < pairs.length; ++j) {
+      int expected = (pairs[j] instanceof PairA) ? 3 : (pairs[j] instanceof PairB) ? 4 :
+          (pairs[j] instanceof Other) ? 2 : 1;
+      assertEquals(expected, $noinline$testTwoSharedTargets(pairs[j]));
+    }
+    for (int j = 0; j < conflicts.length; ++j) {
+      int expected = (conflicts[j] instanceof ConflictBase) ? 5 :
+          (conflicts[j] instanceof Other) ? 2 : 1;
+      assertEquals(expected, $noinline$testImtConflict(conflicts[j]));
+    }
+  }
+
+  /// CHECK-START-JIT: int Main.$noinline$testInvokeVirtual(Main) inliner (before)
+  /// CHECK-NOT:                    ClassTableGet
+
+  /// CHECK-START-JIT: int Main.$noinline$testInvokeVirtual(Main) inliner (after)
+  /// CHECK-DAG:     <<Class:l\d+>> InstanceFieldGet
+  /// CHECK-DAG:     <<Entry:[ij]\d+>> ClassTableGet [<<Class>>]
+  /// CHECK-DAG:     <<Guard:z\d+>> NotEqual [<<Entry>>,{{[ij]\d+}}]
+  /// CHECK-DAG:                    If [<<Guard>>]
+  /// CHECK-DAG:     <<Call:i\d+>>  InvokeVirtual
+  /// CHECK-DAG:     <<Phi:i\d+>>   Phi [<<Inlined:i\d+>>,<<Call>>]
+  /// CHECK-DAG:                    Return [<<Phi>>]
+  /// CHECK-DAG:     <<Inlined>>    IntConstant 1
+  public static int $noinline$testInvokeVirtual(Main m) {
+    if (doThrow) throw new Error("");
+    return m.value();
+  }
+
+  /// CHECK-START-JIT: int Main.$noinline$testInvokeInterface(Itf) inliner (after)
+  /// CHECK-DAG:     <<Class:l\d+>> InstanceFieldGet
+  /// CHECK-DAG:     <<Entry:[ij]\d+>> ClassTableGet [<<Class>>]
+  /// CHECK-DAG:     <<Guard:z\d+>> NotEqual [<<Entry>>,{{[ij]\d+}}]
+  /// CHECK-DAG:                    If [<<Guard>>]
+  /// CHECK-DAG:     <<Call:i\d+>>  InvokeInterface
+  /// CHECK-DAG:                    Phi [{{i\d+}},<<Call>>]
+  public static int $noinline$testInvokeInterface(Itf itf) {
+    if (doThrow) throw new Error("");
+    return itf.value();
+  }
+
+  /// CHECK-START-JIT: int Main.$noinline$testTwoSharedTargets(Main) inliner (after)
+  /// CHECK-DAG:     <<Entry1:[ij]\d+>> ClassTableGet
+  /// CHECK-DAG:     <<Entry2:[ij]\d+>> ClassTableGet
+  /// CHECK-DAG:     <<Guard1:z\d+>> NotEqual [<<Entry1>>,{{[ij]\d+}}]
+  /// CHECK-DAG:     <<Guard2:z\d+>> NotEqual [<<Entry2>>,{{[ij]\d+}}]
+  /// CHECK-DAG:                    If [<<Guard1>>]
+  /// CHECK-DAG:                    If [<<Guard2>>]
+  /// CHECK-DAG:     <<Call:i\d+>>  InvokeVirtual
+  /// CHECK-DAG:     <<Phi:i\d+>>   Phi [<<Inlined:i\d+>>,<<Call>>]
+  /// CHECK-DAG:                    Phi [<<Inlined2:i\d+>>,<<Phi>>]
+  /// CHECK-DAG:     <<Inlined>>    IntConstant {{3|4}}
+  /// CHECK-DAG:     <<Inlined2>>   IntConstant {{3|4}}
+  public static int $noinline$testTwoSharedTargets(Main m) {
+    if (doThrow) throw new Error("");
+    return m.value();
+  }
+
+  /// CHECK-START-JIT: int Main.$noinline$testImtConflict(Itf) inliner (after)
+  /// CHECK-NOT:                    ClassTableGet
+
+  /// CHECK-START-JIT: int Main.$noinline$testImtConflict(Itf) inliner (after)
+  /// CHECK-DAG:     <<Class:l\d+>> InstanceFieldGet
+  /// CHECK-DAG:     <<Load1:l\d+>> LoadClass
+  /// CHECK-DAG:     <<Load2:l\d+>> LoadClass
+  /// CHECK-DAG:     <<Load3:l\d+>> LoadClass
+  /// CHECK-DAG:     <<Load4:l\d+>> LoadClass
+  /// CHECK-DAG:     <<Ne1:z\d+>>   NotEqual [<<Load1>>,<<Class>>]
+  /// CHECK-DAG:     <<Ne2:z\d+>>   NotEqual [<<Load2>>,<<Class>>]
+  /// CHECK-DAG:     <<And1:i\d+>>  And [<<Ne1>>,<<Ne2>>]
+  /// CHECK-DAG:                    If [<<Guard:i\d+>>]
+  /// CHECK-DAG:     <<Call:i\d+>>  InvokeInterface
+  /// CHECK-DAG:                    Phi [<<Inlined:i\d+>>,<<Call>>]
+  /// CHECK-DAG:     <<Inlined>>    IntConstant 5
+  public static int $noinline$testImtConflict(Itf itf) {
+    if (doThrow) throw new Error("");
+    return itf.value();
+  }
+
+  private static native void ensureProfilingInfo(Class<?> cls, String methodName);
+  private static native void ensureJitCompiled(Class<?> cls, String methodName);
+
+  public static boolean doThrow;
+}
+
+class Sub1 extends Main {}
+class Sub2 extends Main {}
+class Sub3 extends Main {}
+class Sub4 extends Main {}
+class Sub5 extends Main {}
+
+class Other extends Main {
+  public int value() {
+    return 2;
+  }
+}
+
+class PairA extends Main {
+  public int value() {
+    return 3;
+  }
+}
+class PairA1 extends PairA {}
+class PairA2 extends PairA {}
+
+class PairB extends Main {
+  public int value() {
+    return 4;
+  }
+}
+class PairB1 extends PairB {}
+class PairB2 extends PairB {}
+
+class ConflictBase implements Itf, Conflicts {
+  public int value() {
+    return 5;
+  }
+
+  public int conflict0() { return 0; }
+  public int conflict1() { return 1; }
+  public int conflict2() { return 2; }
+  public int conflict3() { return 3; }
+  public int conflict4() { return 4; }
+  public int conflict5() { return 5; }
+  public int conflict6() { return 6; }
+  public int conflict7() { return 7; }
+  public int conflict8() { return 8; }
+  public int conflict9() { return 9; }
+  public int conflict10() { return 10; }
+  public int conflict11() { return 11; }
+  public int conflict12() { return 12; }
+  public int conflict13() { return 13; }
+  public int conflict14() { return 14; }
+  public int conflict15() { return 15; }
+  public int conflict16() { return 16; }
+  public int conflict17() { return 17; }
+  public int conflict18() { return 18; }
+  public int conflict19() { return 19; }
+  public int conflict20() { return 20; }
+  public int conflict21() { return 21; }
+  public int conflict22() { return 22; }
+  public int conflict23() { return 23; }
+  public int conflict24() { return 24; }
+  public int conflict25() { return 25; }
+  public int conflict26() { return 26; }
+  public int conflict27() { return 27; }
+  public int conflict28() { return 28; }
+  public int conflict29() { return 29; }
+  public int conflict30() { return 30; }
+  public int conflict31() { return 31; }
+  public int conflict32() { return 32; }
+  public int conflict33() { return 33; }
+  public int conflict34() { return 34; }
+  public int conflict35() { return 35; }
+  public int conflict36() { return 36; }
+  public int conflict37() { return 37; }
+  public int conflict38() { return 38; }
+  public int conflict39() { return 39; }
+  public int conflict40() { return 40; }
+  public int conflict41() { return 41; }
+  public int conflict42() { return 42; }
+  public int conflict43() { return 43; }
+  public int conflict44() { return 44; }
+  public int conflict45() { return 45; }
+  public int conflict46() { return 46; }
+  public int conflict47() { return 47; }
+  public int conflict48() { return 48; }
+  public int conflict49() { return 49; }
+  public int conflict50() { return 50; }
+  public int conflict51() { return 51; }
+  public int conflict52() { return 52; }
+  public int conflict53() { return 53; }
+  public int conflict54() { return 54; }
+  public int conflict55() { return 55; }
+  public int conflict56() { return 56; }
+  public int conflict57() { return 57; }
+  public int conflict58() { return 58; }
+  public int conflict59() { return 59; }
+  public int conflict60() { return 60; }
+  public int conflict61() { return 61; }
+  public int conflict62() { return 62; }
+  public int conflict63() { return 63; }
+}
+class ConflictSub1 extends ConflictBase {}
+class ConflictSub2 extends ConflictBase {}
+class ConflictSub3 extends ConflictBase {}
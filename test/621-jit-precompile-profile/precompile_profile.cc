@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "art_method-inl.h"
+#include "base/time_utils.h"
+#include "jit/jit.h"
+#include "jit/jit_code_cache.h"
+#include "jit/offline_profiling_info.h"
+#include "jni.h"
+#include "method_reference.h"
+#include "mirror/class-inl.h"
+#include "oat_quick_method_header.h"
+#include "scoped_thread_state_change.h"
+#include "ScopedUtfChars.h"
+#include "thread.h"
+
+namespace art {
+namespace {
+
+static constexpr const char* kStartupMethodPrefix = "$noinline$startup";
+// How long to wait for the JIT to compile the startup methods before failing.
+static constexpr uint64_t kCompilationTimeoutMs = 60 * 1000;
+
+static bool IsStartupMethod(ArtMethod* method) SHARED_REQUIRES(Locks::mutator_lock_) {
+  return strncmp(method->GetName(), kStartupMethodPrefix, strlen(kStartupMethodPrefix)) == 0;
+}
+
+// Writes a profile listing the startup methods of `cls` to `filename`.
+extern "C" JNIEXPORT void JNICALL Java_Main_writeStartupProfile(JNIEnv* env,
+                                                               jclass,
+                                                               jstring filename,
+                                                               jclass cls) {
+  ScopedUtfChars filename_chars(env, filename);
+  CHECK(filename_chars.c_str() != nullptr);
+  std::vector<MethodReference> methods;
+  {
+    ScopedObjectAccess soa(Thread::Current());
+    mirror::Class* klass = soa.Decode<mirror::Class*>(cls);
+    for (ArtMethod& method : klass->GetDirectMethods(sizeof(void*))) {
+      if (IsStartupMethod(&method)) {
+        methods.push_back(MethodReference(method.GetDexFile(), method.GetDexMethodIndex()));
+      }
+    }
+  }
+  CHECK(!methods.empty());
+  ProfileCompilationInfo info;
+  CHECK(info.AddMethodsAndClasses(methods, std::set<DexCacheResolvedClasses>()));
+  int fd = open(filename_chars.c_str(), O_WRONLY | O_TRUNC | O_CLOEXEC);
+  CHECK_GE(fd, 0);
+  CHECK(info.Save(fd));
+  close(fd);
+}
+
+// Waits for the JIT to compile the startup methods of `cls`. Returns false if they are not
+// all compiled before the timeout.
+extern "C" JNIEXPORT jboolean JNICALL Java_Main_waitForStartupMethods(JNIEnv*,
+                                                                     jclass,
+                                                                     jclass cls) {
+  jit::Jit* jit = Runtime::Current()->GetJit();
+  if (jit == nullptr) {
+    // Nothing to compile the profile with.
+    return JNI_TRUE;
+  }
+  jit::JitCodeCache* code_cache = jit->GetCodeCache();
+  uint64_t deadline = NanoTime() + MsToNs(kCompilationTimeoutMs);
+  while (true) {
+    bool all_compiled = true;
+    {
+      ScopedObjectAccess soa(Thread::Current());
+      mirror::Class* klass = soa.Decode<mirror::Class*>(cls);
+      for (ArtMethod& method : klass->GetDirectMethods(sizeof(void*))) {
+        if (IsStartupMethod(&method)) {
+          const OatQuickMethodHeader* header =
+              OatQuickMethodHeader::FromEntryPoint(method.GetEntryPointFromQuickCompiledCode());
+          all_compiled = all_compiled && code_cache->ContainsPc(header->GetCode());
+        }
+      }
+    }
+    if (all_compiled) {
+      return JNI_TRUE;
+    }
+    if (NanoTime() > deadline) {
+      return JNI_FALSE;
+    }
+    // Sleep to yield to the compiler thread.
+    usleep(1000);
+  }
+}
+
+}  // namespace
+}  // namespace art
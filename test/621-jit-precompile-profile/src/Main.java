@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.io.File;
+import java.io.IOException;
+import java.lang.reflect.Method;
+
+public class Main {
+
+  public static void main(String[] args) throws Exception {
+    System.loadLibrary(args[0]);
+
+    File file = null;
+    try {
+      file = createTempFile();
+      // The profile lists more methods than the JIT compiles in one batch, so that it has to
+      // schedule the following batches.
+      writeStartupProfile(file.getPath(), Startup.class);
+      String codePath = System.getenv("DEX_LOCATION") + "/621-jit-precompile-profile.jar";
+      VMRuntime.registerAppInfo(file.getPath(),
+                                System.getenv("DEX_LOCATION"),
+                                new String[] {codePath},
+                                /* foreignProfileDir */ null);
+
+      // The JIT waits for the class to be initialized before compiling its static methods.
+      Startup.initialize();
+      if (!waitForStartupMethods(Startup.class)) {
+        throw new Error("Startup methods not compiled");
+      }
+      System.out.println("Startup methods compiled");
+    } finally {
+      if (file != null) {
+        file.delete();
+      }
+    }
+  }
+
+  // Writes a profile with the methods of `cls` whose name starts with $noinline$startup.
+  public static native void writeStartupProfile(String profile, Class<?> cls);
+  // Waits for the JIT to compile the methods of `cls` whose name starts with $noinline$startup.
+  public static native boolean waitForStartupMethods(Class<?> cls);
+
+  private static final String TEMP_FILE_NAME_PREFIX = "dummy";
+  private static final String TEMP_FILE_NAME_SUFFIX = "-file";
+
+  private static File createTempFile() throws Exception {
+    try {
+      return File.createTempFile(TEMP_FILE_NAME_PREFIX, TEMP_FILE_NAME_SUFFIX);
+    } catch (IOException e) {
+      System.setProperty("java.io.tmpdir", "/data/local/tmp");
+      try {
+        return File.createTempFile(TEMP_FILE_NAME_PREFIX, TEMP_FILE_NAME_SUFFIX);
+      } catch (IOException e2) {
+        System.setProperty("java.io.tmpdir", "/sdcard");
+        return File.createTempFile(TEMP_FILE_NAME_PREFIX, TEMP_FILE_NAME_SUFFIX);
+      }
+    }
+  }
+
+  private static class VMRuntime {
+    private static final Method registerAppInfoMethod;
+    static {
+      try {
+        Class<? extends Object> c = Class.forName("dalvik.system.VMRuntime");
+        registerAppInfoMethod = c.getDeclaredMethod("registerAppInfo",
+            String.class, String.class, String[].class, String.class);
+      } catch (Exception e) {
+        throw new RuntimeException(e);
+      }
+    }
+
+    public static void registerAppInfo(String profile, String appDir,
+                                       String[] codePaths, String foreignDir) throws Exception {
+      registerAppInfoMethod.invoke(null, profile, appDir, codePaths, foreignDir);
+    }
+  }
+}
+
+class Startup {
+  static int value;
+
+  static {
+    value = 42;
+  }
+
+  static void initialize() {}
+
+  static int $noinline$startup0() { return value + 0; }
+  static int $noinline$startup1() { return value + 1; }
+  static int $noinline$startup2() { return value + 2; }
+  static int $noinline$startup3() { return value + 3; }
+  static int $noinline$startup4() { return value + 4; }
+  static int $noinline$startup5() { return value + 5; }
+  static int $noinline$startup6() { return value + 6; }
+  static int $noinline$startup7() { return value + 7; }
+  static int $noinline$startup8() { return value + 8; }
+  static int $noinline$startup9() { return value + 9; }
+  static int $noinline$startup10() { return value + 10; }
+  static int $noinline$startup11() { return value + 11; }
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+  public static void main(String[] args) {
+    System.loadLibrary(args[0]);
+    if (!hasJit()) {
+      // Speculation and deoptimization only apply to JIT compiled code.
+      return;
+    }
+
+    Base[] receivers = { new A0(), new A1(), new A2(), new A3(), new A4() };
+    // Let the interpreter fill the inline cache of the method.
+    ensureProfilingInfo(Main.class, "$noinline$callValue");
+    assertEquals(0, $noinline$callValue(receivers[0]));
+
+    // Each compilation inlines the receiver types seen so far, and guards the last one
+    // with a deoptimization. Passing a new type deoptimizes the method.
+    for (int i = 1; i <= kMaxSpeculativeDeoptimizations; ++i) {
+      ensureJitCompiled(Main.class, "$noinline$callValue");
+      assertEquals(i, $noinline$callValue(receivers[i]));
+      if (hasJitCompiledEntryPoint(Main.class, "$noinline$callValue")) {
+        throw new Error("Expected a deoptimization for receiver type " + i);
+      }
+    }
+
+    // The method deoptimized too often: it is now compiled without speculation, and a new
+    // receiver type goes through the regular virtual call.
+    ensureJitCompiled(Main.class, "$noinline$callValue");
+    assertEquals(4, $noinline$callValue(receivers[4]));
+    if (!hasJitCompiledEntryPoint(Main.class, "$noinline$callValue")) {
+      throw new Error("Expected no deoptimization once speculation is disabled");
+    }
+  }
+
+  public static int $noinline$callValue(Base b) {
+    if (doThrow) throw new Error("");
+    return b.value();
+  }
+
+  public static void assertEquals(int expected, int actual) {
+    if (expected != actual) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+
+  // Must match ProfilingInfo::kMaxSpeculativeDeoptimizations.
+  static final int kMaxSpeculativeDeoptimizations = 3;
+  static boolean doThrow = false;
+
+  private static native boolean hasJit();
+  private static native void ensureProfilingInfo(Class<?> cls, String methodName);
+  private static native void ensureJitCompiled(Class<?> cls, String methodName);
+  private static native boolean hasJitCompiledEntryPoint(Class<?> cls, String methodName);
+}
+
+abstract class Base {
+  abstract int value();
+}
+
+class A0 extends Base {
+  int value() { return 0; }
+}
+
+class A1 extends Base {
+  int value() { return 1; }
+}
+
+class A2 extends Base {
+  int value() { return 2; }
+}
+
+class A3 extends Base {
+  int value() { return 3; }
+}
+
+class A4 extends Base {
+  int value() { return 4; }
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+class Box {
+  Box other;
+  int id;
+}
+
+public class Main {
+  static volatile boolean done = false;
+  static volatile boolean started = false;
+
+  // The loop only polls for suspension through the suspend trigger. `a` and `b`
+  // may live in caller-save registers across the poll, so the GC must find and
+  // update them in the frame saved by the fault handler.
+  static int spin(Box a, int iterations) {
+    int errors = 0;
+    for (int i = 0; i < iterations; ++i) {
+      Box b = a.other;
+      if (b.other != a) {
+        errors++;
+      }
+      a = b;
+    }
+    return errors;
+  }
+
+  static class Worker extends Thread {
+    int errors = 0;
+    int ids = 0;
+
+    public void run() {
+      Box a = new Box();
+      a.other = new Box();
+      a.other.other = a;
+      a.other.id = 1;
+      started = true;
+      // Call repeatedly so that the JIT compiles `spin` rather than only its loop, since
+      // OSR code keeps testing the thread flags.
+      while (!done) {
+        errors += spin(a, 100000);
+      }
+      ids = a.id + a.other.id;
+    }
+  }
+
+  public static void main(String[] args) throws Exception {
+    Worker worker = new Worker();
+    worker.start();
+    while (!started) {
+      Thread.yield();
+    }
+    System.out.println("Worker started");
+    for (int i = 0; i < 50; ++i) {
+      // Garbage to move, then a collection that suspends the worker.
+      Object[] garbage = new Object[1000];
+      for (int j = 0; j < garbage.length; ++j) {
+        garbage[j] = new Box();
+      }
+      Runtime.getRuntime().gc();
+      // Suspend the worker to walk its stack.
+      worker.getStackTrace();
+      Thread.sleep(10);
+    }
+    done = true;
+    worker.join();
+    System.out.println("errors: " + worker.errors);
+    System.out.println("ids: " + worker.ids);
+  }
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+import java.lang.reflect.Method;
+
+import dalvik.system.DexClassLoader;
+
+public class Main {
+  private static final String DEX_FILE =
+      System.getenv("DEX_LOCATION") + "/624-background-verification-ex.jar";
+
+  public static void main(String[] args) throws Exception {
+    System.loadLibrary(args[0]);
+    ClassLoader loader = new DexClassLoader(
+        DEX_FILE, System.getenv("DEX_LOCATION"), null, Main.class.getClassLoader());
+    // Opening the dex file queued its classes for verification, defining a first class lets
+    // the background verification go on.
+    Class<?> cls = Class.forName("Verified", false, loader);
+    if (waitForBackgroundVerification()) {
+      if (!isClassVerified(cls)) {
+        throw new Error("Verified was not verified in the background");
+      }
+      // Never used before the wait, picked up from the same dex file.
+      Class<?> other = Class.forName("AlsoVerified", false, loader);
+      if (!isClassVerified(other)) {
+        throw new Error("AlsoVerified was not verified in the background");
+      }
+    }
+    System.out.println("Before initialization");
+    Method run = cls.getDeclaredMethod("run");
+    run.invoke(null);
+  }
+
+  private static native boolean waitForBackgroundVerification();
+  private static native boolean isClassVerified(Class<?> cls);
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+  public static void main(String[] args) {
+    System.loadLibrary(args[0]);
+    if (!hasJit()) {
+      // Speculation and deoptimization only apply to JIT compiled code.
+      return;
+    }
+
+    // Let the interpreter profile the method: none of the `else` branches is taken.
+    ensureProfilingInfo(Main.class, "$noinline$select");
+    for (int i = 0; i < 10; ++i) {
+      assertEquals(40, $noinline$select(0));
+    }
+
+    // Each compilation assumes the `else` branches not taken so far are never taken.
+    // Taking a new one deoptimizes the method.
+    for (int i = 1; i <= kMaxSpeculativeDeoptimizations; ++i) {
+      ensureJitCompiled(Main.class, "$noinline$select");
+      assertEquals(40, $noinline$select(0));
+      assertEquals(30 + i, $noinline$select(i));
+      if (hasJitCompiledEntryPoint(Main.class, "$noinline$select")) {
+        throw new Error("Expected a deoptimization for branch " + i);
+      }
+    }
+
+    // The method deoptimized too often: it is now compiled without speculation, and
+    // taking the last `else` branch stays in compiled code.
+    ensureJitCompiled(Main.class, "$noinline$select");
+    assertEquals(34, $noinline$select(4));
+    if (!hasJitCompiledEntryPoint(Main.class, "$noinline$select")) {
+      throw new Error("Expected no deoptimization once speculation is disabled");
+    }
+  }
+
+  public static int $noinline$select(int value) {
+    if (doThrow) throw new Error("");
+    int result = 0;
+    if (value != 1) {
+      result += 10;
+    } else {
+      result += 1;
+    }
+    if (value != 2) {
+      result += 10;
+    } else {
+      result += 2;
+    }
+    if (value != 3) {
+      result += 10;
+    } else {
+      result += 3;
+    }
+    if (value != 4) {
+      result += 10;
+    } else {
+      result += 4;
+    }
+    return result;
+  }
+
+  public static void assertEquals(int expected, int actual) {
+    if (expected != actual) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+
+  // Must match ProfilingInfo::kMaxSpeculativeDeoptimizations.
+  static final int kMaxSpeculativeDeoptimizations = 3;
+  static boolean doThrow = false;
+
+  private static native boolean hasJit();
+  private static native void ensureProfilingInfo(Class<?> cls, String methodName);
+  private static native void ensureJitCompiled(Class<?> cls, String methodName);
+  private static native boolean hasJitCompiledEntryPoint(Class<?> cls, String methodName);
+}
@@ -102,4 +102,11 @@ class MyClassNatives {
     static native boolean returnTrue();
     static native boolean returnFalse();
     static native int returnInt();
+
+    @dalvik.annotation.optimization.FastNative
+    static native int fastSII(int x, int y);
+    @dalvik.annotation.optimization.CriticalNative
+    static native int criticalSII(int x, int y);
+    @dalvik.annotation.optimization.CriticalNative
+    static native double criticalSJD(long x, double y);
 }
@@ -22,6 +22,7 @@
 #include "jit/jit_code_cache.h"
 #include "mirror/class-inl.h"
 #include "nth_caller_visitor.h"
+#include "oat_file_manager.h"
 #include "oat_quick_method_header.h"
 #include "runtime.h"
 #include "scoped_thread_state_change.h"
@@ -120,6 +121,26 @@ extern "C" JNIEXPORT jboolean JNICALL Java_Main_compiledWithOptimizing(JNIEnv* e
   return JNI_TRUE;
 }
 
+extern "C" JNIEXPORT void JNICALL Java_Main_ensureProfilingInfo(JNIEnv* env,
+                                                               jclass,
+                                                               jclass cls,
+                                                               jstring method_name) {
+  jit::Jit* jit = Runtime::Current()->GetJit();
+  if (jit == nullptr) {
+    return;
+  }
+
+  ScopedObjectAccess soa(Thread::Current());
+
+  ScopedUtfChars chars(env, method_name);
+  CHECK(chars.c_str() != nullptr);
+
+  mirror::Class* klass = soa.Decode<mirror::Class*>(cls);
+  ArtMethod* method = klass->FindDeclaredDirectMethodByName(chars.c_str(), sizeof(void*));
+  // Let the interpreter fill the inline caches of the method from its first invocation.
+  ProfilingInfo::Create(soa.Self(), method, /* retry_allocation */ true);
+}
+
 extern "C" JNIEXPORT void JNICALL Java_Main_ensureJitCompiled(JNIEnv* env,
                                                              jclass,
                                                              jclass cls,
@@ -154,4 +175,40 @@ extern "C" JNIEXPORT void JNICALL Java_Main_ensureJitCompiled(JNIEnv* env,
   }
 }
 
+extern "C" JNIEXPORT jboolean JNICALL Java_Main_hasJit(JNIEnv*, jclass) {
+  return Runtime::Current()->UseJitCompilation();
+}
+
+extern "C" JNIEXPORT jboolean JNICALL Java_Main_hasJitCompiledEntryPoint(JNIEnv* env,
+                                                                      jclass,
+                                                                      jclass cls,
+                                                                      jstring method_name) {
+  jit::Jit* jit = Runtime::Current()->GetJit();
+  if (jit == nullptr) {
+    return false;
+  }
+
+  ScopedObjectAccess soa(Thread::Current());
+
+  ScopedUtfChars chars(env, method_name);
+  CHECK(chars.c_str() != nullptr);
+
+  mirror::Class* klass = soa.Decode<mirror::Class*>(cls);
+  ArtMethod* method = klass->FindDeclaredDirectMethodByName(chars.c_str(), sizeof(void*));
+  return jit->GetCodeCache()->ContainsPc(method->GetEntryPointFromQuickCompiledCode());
+}
+
+// public static native boolean waitForBackgroundVerification();
+
+extern "C" JNIEXPORT jboolean JNICALL Java_Main_waitForBackgroundVerification(JNIEnv*, jclass) {
+  return Runtime::Current()->GetOatFileManager().WaitForPreVerification(Thread::Current());
+}
+
+// public static native boolean isClassVerified(Class<?> cls);
+
+extern "C" JNIEXPORT jboolean JNICALL Java_Main_isClassVerified(JNIEnv*, jclass, jclass cls) {
+  ScopedObjectAccess soa(Thread::Current());
+  return soa.Decode<mirror::Class*>(cls)->IsVerified();
+}
+
 }  // namespace art
@@ -39,6 +39,8 @@ def ParseArguments():
                       help="Run tests for the specified target architecture.")
   parser.add_argument("--debuggable", action="store_true",
                       help="Run tests for debuggable code.")
+  parser.add_argument("--jit", action="store_true",
+                      help="Run tests for code compiled by the JIT.")
   parser.add_argument("-q", "--quiet", action="store_true",
                       help="print only errors")
   return parser.parse_args()
@@ -85,13 +87,13 @@ def FindCheckerFiles(path):
     Logger.fail("Source path \"" + path + "\" not found")
 
 
-def RunTests(checkPrefix, checkPath, outputFilename, targetArch, debuggableMode):
+def RunTests(checkPrefix, checkPath, outputFilename, targetArch, debuggableMode, jitMode):
   c1File = ParseC1visualizerStream(os.path.basename(outputFilename), open(outputFilename, "r"))
   for checkFilename in FindCheckerFiles(checkPath):
     checkerFile = ParseCheckerStream(os.path.basename(checkFilename),
                                      checkPrefix,
                                      open(checkFilename, "r"))
-    MatchFiles(checkerFile, c1File, targetArch, debuggableMode)
+    MatchFiles(checkerFile, c1File, targetArch, debuggableMode, jitMode)
 
 
 if __name__ == "__main__":
@@ -105,4 +107,5 @@ if __name__ == "__main__":
   elif args.dump_pass:
     DumpPass(args.tested_file, args.dump_pass)
   else:
-    RunTests(args.check_prefix, args.source_path, args.tested_file, args.arch, args.debuggable)
+    RunTests(args.check_prefix, args.source_path, args.tested_file, args.arch, args.debuggable,
+             args.jit)
@@ -22,7 +22,7 @@ import re
 def __isCheckerLine(line):
   return line.startswith("///") or line.startswith("##")
 
-def __extractLine(prefix, line, arch = None, debuggable = False):
+def __extractLine(prefix, line, arch = None, debuggable = False, jit = False):
   """ Attempts to parse a check line. The regex searches for a comment symbol
       followed by the CHECK keyword, given attribute and a colon at the very
       beginning of the line. Whitespaces are ignored.
@@ -31,10 +31,11 @@ def __extractLine(prefix, line, arch = None, debuggable = False):
   rCommentSymbols = [r"///", r"##"]
   arch_specifier = r"-%s" % arch if arch is not None else r""
   dbg_specifier = r"-DEBUGGABLE" if debuggable else r""
+  jit_specifier = r"-JIT" if jit else r""
   regexPrefix = rIgnoreWhitespace + \
                 r"(" + r"|".join(rCommentSymbols) + r")" + \
                 rIgnoreWhitespace + \
-                prefix + arch_specifier + dbg_specifier + r":"
+                prefix + arch_specifier + dbg_specifier + jit_specifier + r":"
 
   # The 'match' function succeeds only if the pattern is matched at the
   # beginning of the line.
@@ -57,11 +58,12 @@ def __processLine(line, lineNo, prefix, fileName):
 
   # Lines beginning with 'CHECK-START' start a new test case.
   # We currently only consider the architecture suffix in "CHECK-START" lines.
-  for debuggable in [True, False]:
-    for arch in [None] + archs_list:
-      startLine = __extractLine(prefix + "-START", line, arch, debuggable)
-      if startLine is not None:
-        return None, startLine, (arch, debuggable)
+  for jit in [True, False]:
+    for debuggable in [True, False]:
+      for arch in [None] + archs_list:
+        startLine = __extractLine(prefix + "-START", line, arch, debuggable, jit)
+        if startLine is not None:
+          return None, startLine, (arch, debuggable, jit)
 
   # Lines starting only with 'CHECK' are matched in order.
   plainLine = __extractLine(prefix, line)
@@ -173,7 +175,8 @@ def ParseCheckerStream(fileName, prefix, stream):
       SplitStream(stream, fnProcessLine, fnLineOutsideChunk):
     testArch = testData[0]
     forDebuggable = testData[1]
-    testCase = TestCase(checkerFile, caseName, startLineNo, testArch, forDebuggable)
+    forJit = testData[2]
+    testCase = TestCase(checkerFile, caseName, startLineNo, testArch, forDebuggable, forJit)
     for caseLine in caseLines:
       ParseCheckerAssertion(testCase, caseLine[0], caseLine[1], caseLine[2])
   return checkerFile
@@ -36,7 +36,8 @@ class CheckerFile(PrintableMixin):
 
 class TestCase(PrintableMixin):
 
-  def __init__(self, parent, name, startLineNo, testArch = None, forDebuggable = False):
+  def __init__(self, parent, name, startLineNo, testArch = None, forDebuggable = False,
+               forJit = False):
     assert isinstance(parent, CheckerFile)
 
     self.parent = parent
@@ -45,6 +46,7 @@ class TestCase(PrintableMixin):
     self.startLineNo = startLineNo
     self.testArch = testArch
     self.forDebuggable = forDebuggable
+    self.forJit = forJit
 
     if not self.name:
       Logger.fail("Test case does not have a name", self.fileName, self.startLineNo)
@@ -366,6 +366,24 @@ class CheckerParser_SuffixTests(unittest.TestCase):
     self.assertTrue(testCase.forDebuggable)
     self.assertEqual(testCase.testArch, "ARM")
 
+  def test_SetJit(self):
+    testCase = self.parse("""
+        /// CHECK-START-JIT: Group
+        /// CHECK: foo
+        """).testCases[0]
+    self.assertTrue(testCase.forJit)
+    self.assertFalse(testCase.forDebuggable)
+    self.assertEqual(testCase.testArch, None)
+
+  def test_SetArchDebugAndJit(self):
+    testCase = self.parse("""
+        /// CHECK-START-ARM-DEBUGGABLE-JIT: Group
+        /// CHECK: foo
+        """).testCases[0]
+    self.assertTrue(testCase.forJit)
+    self.assertTrue(testCase.forDebuggable)
+    self.assertEqual(testCase.testArch, "ARM")
+
 class CheckerParser_EvalTests(unittest.TestCase):
   def parseTestCase(self, string):
     checkerText = u"/// CHECK-START: pass\n" + ToUnicode(string)